@@ -22,6 +22,7 @@
 
 #include "itkImageSamplerBase.h"
 #include "itkGradientImageFilter.h"
+#include "itkTileCachedImageGradient.h"
 #include "itkBSplineInterpolateImageFunction.h"
 #include "itkReducedDimensionBSplineInterpolateImageFunction.h"
 #include "itkAdvancedLinearInterpolateImageFunction.h"
@@ -31,12 +32,15 @@
 #include "vnl/vnl_sparse_matrix.h"
 
 #include "itkImageMaskSpatialObject.h"
+#include "itkRasterizedMask.h"
 
 // Needed for checking for B-spline for faster implementation
 #include "itkAdvancedBSplineDeformableTransform.h"
 #include "itkAdvancedCombinationTransform.h"
 
 #include "itkPlatformMultiThreader.h"
+#include "itkPersistentPlatformMultiThreader.h"
+#include "itkPerformanceTelemetry.h"
 
 namespace itk
 {
@@ -64,7 +68,7 @@ namespace itk
  *   moving image derivatives. This is a kind of fast hack, which makes it possible to
  *   avoid transformation in one direction (x, y, or z). Do not use this functionality
  *   unless you have a good reason for it...
- * \li Some convenience functions are provided, such as the IsInsideMovingMask
+ * \li Some convenience functions are provided, such as IsInsideFixedMask, IsInsideMovingMask
  *   and CheckNumberOfSamples.
  *
  * The parameters used in this class are:
@@ -129,6 +133,8 @@ public:
 
   typedef ImageMaskSpatialObject<Self::FixedImageDimension>  FixedImageMaskSpatialObject2Type;
   typedef ImageMaskSpatialObject<Self::MovingImageDimension> MovingImageMaskSpatialObject2Type;
+  typedef RasterizedMask<Self::FixedImageDimension>          FixedImageRasterizedMaskType;
+  typedef RasterizedMask<Self::MovingImageDimension>         MovingImageRasterizedMaskType;
 
   /** Some useful extra typedefs. */
   typedef typename FixedImageType::PixelType             FixedImagePixelType;
@@ -284,6 +290,13 @@ public:
   itkGetConstReferenceMacro(UseMultiThread, bool);
   itkBooleanMacro(UseMultiThread);
 
+  /** Set/Get the telemetry object in which the metric records the time of
+   * its threaded evaluation and derivative reduction, the number of samples
+   * and valid samples, and the bytes it allocates. Default: null, no recording.
+   */
+  itkSetObjectMacro(PerformanceTelemetry, PerformanceTelemetry);
+  itkGetModifiableObjectMacro(PerformanceTelemetry, PerformanceTelemetry);
+
   /** Contains calls from GetValueAndDerivative that are thread-unsafe,
    * together with preparation for multi-threading.
    * Note that the only reason why this function is not protected, is
@@ -328,6 +341,8 @@ protected:
   typedef typename BSplineInterpolatorType::CovariantVectorType    MovingImageDerivativeType;
   typedef GradientImageFilter<MovingImageType, RealType, RealType> CentralDifferenceGradientFilterType;
   typedef typename CentralDifferenceGradientFilterType::Pointer    CentralDifferenceGradientFilterPointer;
+  typedef TileCachedImageGradient<MovingImageType, typename MovingImageDerivativeType::ValueType>
+    MovingImageGradientType;
 
   /** Typedefs for support of sparse Jacobians and compact support of transformations. */
   typedef typename AdvancedTransformType::NonZeroJacobianIndicesType NonZeroJacobianIndicesType;
@@ -339,6 +354,12 @@ protected:
    */
   mutable ImageSamplerPointer m_ImageSampler;
 
+  /** The rasterized fixed and moving image masks, for fast lookups in IsInsideFixedMask()
+   * and IsInsideMovingMask(). They are rasterized by Initialize().
+   */
+  typename FixedImageRasterizedMaskType::Pointer  m_FixedImageRasterizedMask;
+  typename MovingImageRasterizedMaskType::Pointer m_MovingImageRasterizedMask;
+
   /** Variables for image derivative computation. */
   bool                              m_InterpolatorIsLinear;
   bool                              m_InterpolatorIsBSpline;
@@ -349,7 +370,8 @@ protected:
   BSplineInterpolatorFloatPointer   m_BSplineInterpolatorFloat;
   ReducedBSplineInterpolatorPointer m_ReducedBSplineInterpolator;
 
-  CentralDifferenceGradientFilterPointer m_CentralDifferenceGradientFilter;
+  /** The lazily computed moving image gradient, used for the other interpolators. */
+  typename MovingImageGradientType::Pointer m_MovingImageGradient;
 
   /** Variables to store the AdvancedTransform. */
   bool                                    m_TransformIsAdvanced;
@@ -415,6 +437,9 @@ protected:
   bool m_UseMultiThread;
   bool m_UseOpenMP;
 
+  /** The telemetry object, may be null. */
+  PerformanceTelemetry::Pointer m_PerformanceTelemetry;
+
   /** Helper structs that multi-threads the computation of
    * the metric derivative using ITK threads.
    */
@@ -545,6 +570,10 @@ protected:
                             TransformJacobianType &      jacobian,
                             NonZeroJacobianIndicesType & nzji) const;
 
+  /** Convenience method: check if point is inside the fixed mask. *****************/
+  bool
+  IsInsideFixedMask(const FixedImagePointType & point) const;
+
   /** Convenience method: check if point is inside the moving mask. *****************/
   virtual bool
   IsInsideMovingMask(const MovingImagePointType & point) const;
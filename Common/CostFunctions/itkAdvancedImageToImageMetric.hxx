@@ -21,7 +21,9 @@
 #include "itkAdvancedImageToImageMetric.h"
 
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkBatchDataCache.h"
 #include "itkComputeImageExtremaFilter.h"
+#include "itkSimpleDataObjectDecorator.h"
 
 #ifdef ELASTIX_USE_OPENMP
 #  include <omp.h>
@@ -29,6 +31,9 @@
 
 #include "itkTimeProbe.h"
 
+#include <sstream>
+#include <utility>
+
 namespace itk
 {
 
@@ -49,6 +54,8 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
 
   this->m_ImageSampler = nullptr;
   this->m_UseImageSampler = false;
+  this->m_FixedImageRasterizedMask = FixedImageRasterizedMaskType::New();
+  this->m_MovingImageRasterizedMask = MovingImageRasterizedMaskType::New();
   this->m_RequiredRatioOfValidSamples = 0.25;
 
   this->m_LinearInterpolator = nullptr;
@@ -59,7 +66,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
   this->m_InterpolatorIsBSpline = false;
   this->m_InterpolatorIsBSplineFloat = false;
   this->m_InterpolatorIsReducedBSpline = false;
-  this->m_CentralDifferenceGradientFilter = nullptr;
+  this->m_MovingImageGradient = nullptr;
 
   this->m_AdvancedTransform = nullptr;
   this->m_TransformIsAdvanced = false;
@@ -87,6 +94,13 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AdvancedImageToImageMetri
   this->m_UseMetricSingleThreaded = true;
   this->m_UseMultiThread = false;
 
+  /** Replace the threader of the superclass, which starts new threads for each
+   * evaluation, by one that keeps its threads.
+   */
+  const auto threader = PersistentPlatformMultiThreader::New();
+  threader->SetNumberOfWorkUnits(this->m_Threader->GetNumberOfWorkUnits());
+  this->m_Threader = threader;
+
   /** OpenMP related. Switch to on when available */
 #ifdef ELASTIX_USE_OPENMP
   this->m_UseOpenMP = true;
@@ -157,6 +171,13 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::Initialize(void)
   /** Connect the image sampler */
   this->InitializeImageSampler();
 
+  /** Rasterize the fixed and moving image masks, once per resolution. SetMask()
+   * rasterizes a mask again when it was modified in place since the last call,
+   * so that all GetValue() and GetDerivative() variants see the same raster.
+   */
+  this->m_FixedImageRasterizedMask->SetMask(this->m_FixedImageMask.GetPointer());
+  this->m_MovingImageRasterizedMask->SetMask(this->m_MovingImageMask.GetPointer());
+
   /** Check if the interpolator is a B-spline interpolator. */
   this->CheckForBSplineInterpolator();
 
@@ -219,6 +240,12 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeThreadingParame
 
     this->m_GetValueAndDerivativePerThreadVariables[i].st_NumberOfPixelsCounted = NumericTraits<SizeValueType>::Zero;
     this->m_GetValueAndDerivativePerThreadVariables[i].st_Value = NumericTraits<MeasureType>::Zero;
+    if (this->m_PerformanceTelemetry &&
+        this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.GetSize() != this->GetNumberOfParameters())
+    {
+      this->m_PerformanceTelemetry->AddCount("Metric.BytesAllocated",
+                                             this->GetNumberOfParameters() * sizeof(DerivativeValueType));
+    }
     this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.SetSize(this->GetNumberOfParameters());
     this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.Fill(
       NumericTraits<DerivativeValueType>::ZeroValue());
@@ -246,34 +273,52 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeLimiters(void)
     itk::TimeProbe timer;
     timer.Start();
 
-    typedef typename itk::ComputeImageExtremaFilter<FixedImageType> ComputeFixedImageExtremaFilterType;
-    typename ComputeFixedImageExtremaFilterType::Pointer            computeFixedImageExtrema =
-      ComputeFixedImageExtremaFilterType::New();
-    computeFixedImageExtrema->SetInput(this->GetFixedImage());
-    computeFixedImageExtrema->SetImageRegion(this->GetFixedImageRegion());
-    if (this->m_FixedImageMask.IsNotNull())
+    /** During a batch registration the extrema are shared, see BatchDataCache. */
+    const FixedImageMaskSpatialObject2Type * fMask =
+      dynamic_cast<const FixedImageMaskSpatialObject2Type *>(this->m_FixedImageMask.GetPointer());
+    std::ostringstream key;
+    key << "FixedImageExtrema " << BatchDataCache::MakeImageKey(this->GetFixedImage()) << " region "
+        << this->GetFixedImageRegion().GetIndex() << this->GetFixedImageRegion().GetSize() << " mask ";
+    if (fMask)
     {
-      computeFixedImageExtrema->SetUseMask(true);
+      key << BatchDataCache::MakeImageKey(fMask->GetImage());
+    }
+    else
+    {
+      key << static_cast<const void *>(this->m_FixedImageMask.GetPointer());
+    }
 
-      const FixedImageMaskSpatialObject2Type * fMask =
-        dynamic_cast<const FixedImageMaskSpatialObject2Type *>(this->m_FixedImageMask.GetPointer());
-      if (fMask)
-      {
-        computeFixedImageExtrema->SetImageSpatialMask(fMask);
-      }
-      else
+    typedef SimpleDataObjectDecorator<std::pair<FixedImagePixelType, FixedImagePixelType>> ExtremaDecoratorType;
+    const DataObject::Pointer extrema = BatchDataCache::GetOrCreate(key.str(), [this, fMask] {
+      typedef typename itk::ComputeImageExtremaFilter<FixedImageType> ComputeFixedImageExtremaFilterType;
+      typename ComputeFixedImageExtremaFilterType::Pointer            computeFixedImageExtrema =
+        ComputeFixedImageExtremaFilterType::New();
+      computeFixedImageExtrema->SetInput(this->GetFixedImage());
+      computeFixedImageExtrema->SetImageRegion(this->GetFixedImageRegion());
+      if (this->m_FixedImageMask.IsNotNull())
       {
-        computeFixedImageExtrema->SetImageMask(this->GetFixedImageMask());
+        computeFixedImageExtrema->SetUseMask(true);
+        if (fMask)
+        {
+          computeFixedImageExtrema->SetImageSpatialMask(fMask);
+        }
+        else
+        {
+          computeFixedImageExtrema->SetImageMask(this->GetFixedImageMask());
+        }
       }
-    }
 
-    computeFixedImageExtrema->Update();
+      computeFixedImageExtrema->Update();
+      const auto decorator = ExtremaDecoratorType::New();
+      decorator->Set(std::make_pair(computeFixedImageExtrema->GetMinimum(), computeFixedImageExtrema->GetMaximum()));
+      return DataObject::Pointer(decorator);
+    });
     timer.Stop();
     elxout << "  Computing the fixed image extrema took " << static_cast<long>(timer.GetMean() * 1000) << " ms."
            << std::endl;
 
-    this->m_FixedImageTrueMax = computeFixedImageExtrema->GetMaximum();
-    this->m_FixedImageTrueMin = computeFixedImageExtrema->GetMinimum();
+    this->m_FixedImageTrueMin = static_cast<const ExtremaDecoratorType &>(*extrema).Get().first;
+    this->m_FixedImageTrueMax = static_cast<const ExtremaDecoratorType &>(*extrema).Get().second;
 
     this->m_FixedImageMinLimit = static_cast<FixedImageLimiterOutputType>(
       this->m_FixedImageTrueMin -
@@ -470,17 +515,20 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::CheckForBSplineInterpolat
     if (!this->m_InterpolatorIsBSpline && !this->m_InterpolatorIsBSplineFloat &&
         !this->m_InterpolatorIsReducedBSpline && !this->m_InterpolatorIsLinear && !interpolatorIsRayCast)
     {
-      this->m_CentralDifferenceGradientFilter = CentralDifferenceGradientFilterType::New();
-      this->m_CentralDifferenceGradientFilter->SetUseImageSpacing(true);
-      this->m_CentralDifferenceGradientFilter->SetInput(this->m_MovingImage);
-      this->m_CentralDifferenceGradientFilter->Update();
-      this->m_GradientImage = this->m_CentralDifferenceGradientFilter->GetOutput();
+      /** Instead of a full gradient image, the central differences are computed
+       * on the fly, only in the tiles of the image that are touched by samples.
+       */
+      if (this->m_MovingImageGradient.IsNull())
+      {
+        this->m_MovingImageGradient = MovingImageGradientType::New();
+      }
+      this->m_MovingImageGradient->SetImage(this->m_MovingImage);
     }
     else
     {
-      this->m_CentralDifferenceGradientFilter = nullptr;
-      this->m_GradientImage = nullptr;
+      this->m_MovingImageGradient = nullptr;
     }
+    this->m_GradientImage = nullptr;
   }
 
 } // end CheckForBSplineInterpolator()
@@ -606,7 +654,8 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateMovingImageValueA
       else
       {
         /** Get the gradient by NearestNeighboorInterpolation of the gradient image.
-         * It is assumed that the gradient image is computed.
+         * It is assumed that the gradient image is computed, or else that the
+         * lazy gradient is set.
          */
         movingImageValue = this->m_Interpolator->EvaluateAtContinuousIndex(cindex);
         MovingImageIndexType index;
@@ -614,7 +663,14 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateMovingImageValueA
         {
           index[j] = static_cast<long>(Math::Round<double>(cindex[j]));
         }
-        (*gradient) = this->m_GradientImage->GetPixel(index);
+        if (!this->GetComputeGradient() && this->m_MovingImageGradient.IsNotNull())
+        {
+          this->m_MovingImageGradient->Evaluate(index, *gradient);
+        }
+        else
+        {
+          (*gradient) = this->m_GradientImage->GetPixel(index);
+        }
       }
 
       /** The moving image gradient is multiplied with its scales, when requested. */
@@ -768,6 +824,31 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateTransformJacobian
 } // end EvaluateTransformJacobian()
 
 
+/**
+ * ************************** IsInsideFixedMask *************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+bool
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::IsInsideFixedMask(const FixedImagePointType & point) const
+{
+  /** If a mask has been set: */
+  if (this->m_FixedImageMask.IsNotNull())
+  {
+    /** Use the rasterized mask, unless the mask was replaced after Initialize(). */
+    if (this->m_FixedImageRasterizedMask->GetMask() == this->m_FixedImageMask.GetPointer())
+    {
+      return this->m_FixedImageRasterizedMask->IsInside(point);
+    }
+    return this->m_FixedImageMask->IsInsideInWorldSpace(point);
+  }
+
+  /** If no mask has been set, just return true. */
+  return true;
+
+} // end IsInsideFixedMask()
+
+
 /**
  * ************************** IsInsideMovingMask *************************
  */
@@ -779,6 +860,11 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::IsInsideMovingMask(const
   /** If a mask has been set: */
   if (this->m_MovingImageMask.IsNotNull())
   {
+    /** Use the rasterized mask, unless the mask was replaced after Initialize(). */
+    if (this->m_MovingImageRasterizedMask->GetMask() == this->m_MovingImageMask.GetPointer())
+    {
+      return this->m_MovingImageRasterizedMask->IsInside(point);
+    }
     return this->m_MovingImageMask->IsInsideInWorldSpace(point);
   }
 
@@ -862,6 +948,8 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueThreaderCallback(void) const
 {
+  const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Metric.ThreadedEvaluation");
+
   /** Setup threader. */
   this->m_Threader->SetSingleMethod(this->GetValueThreaderCallback,
                                     const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
@@ -900,6 +988,8 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueAndDerivativeThreaderCallback(void) const
 {
+  const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Metric.ThreadedEvaluation");
+
   /** Setup threader. */
   this->m_Threader->SetSingleMethod(this->GetValueAndDerivativeThreaderCallback,
                                     const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
@@ -924,6 +1014,10 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativesThre
 
   MultiThreaderParameterType * temp = static_cast<MultiThreaderParameterType *>(infoStruct->UserData);
 
+  /** The time is summed over the work units. */
+  const PerformanceTelemetry::ScopedTimer timer(temp->st_Metric->m_PerformanceTelemetry,
+                                                "Metric.DerivativeReductionWorkUnitTime");
+
   const unsigned int numPar = temp->st_Metric->GetNumberOfParameters();
   const unsigned int subSize =
     static_cast<unsigned int>(std::ceil(static_cast<double>(numPar) / static_cast<double>(nrOfThreads)));
@@ -964,6 +1058,11 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::CheckNumberOfSamples(unsi
                                                                             unsigned long found) const
 {
   this->m_NumberOfPixelsCounted = found;
+  if (this->m_PerformanceTelemetry)
+  {
+    this->m_PerformanceTelemetry->AddCount("Metric.Samples", wanted);
+    this->m_PerformanceTelemetry->AddCount("Metric.ValidSamples", found);
+  }
   if (found < wanted * this->GetRequiredRatioOfValidSamples())
   {
     itkExceptionMacro("Too many samples map outside moving image buffer: " << found << " / " << wanted << std::endl);
@@ -1011,8 +1110,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::ostream &
   os << indent.GetNextIndent() << "InterpolatorIsBSplineFloat: " << this->m_InterpolatorIsBSplineFloat << std::endl;
   os << indent.GetNextIndent() << "BSplineInterpolatorFloat: " << this->m_BSplineInterpolatorFloat.GetPointer()
      << std::endl;
-  os << indent.GetNextIndent()
-     << "CentralDifferenceGradientFilter: " << this->m_CentralDifferenceGradientFilter.GetPointer() << std::endl;
+  os << indent.GetNextIndent() << "MovingImageGradient: " << this->m_MovingImageGradient.GetPointer() << std::endl;
 
   /** Variables used when the transform is a B-spline transform. */
   os << indent << "Variables store the transform as an AdvancedTransform: " << std::endl;
@@ -107,6 +107,10 @@ public:
   typedef std::vector<InterpolatorPointer>           InterpolatorVectorType;
   typedef std::vector<FixedImageInterpolatorPointer> FixedImageInterpolatorVectorType;
 
+  /** Typedef's for the rasterized moving image masks. */
+  using typename Superclass::MovingImageRasterizedMaskType;
+  typedef std::vector<typename MovingImageRasterizedMaskType::Pointer> MovingImageRasterizedMaskVectorType;
+
   /** ******************** Fixed images ******************** */
 
   /** Set the fixed images. */
@@ -396,6 +400,9 @@ protected:
   bool                          m_InterpolatorsAreBSpline;
   BSplineInterpolatorVectorType m_BSplineInterpolatorVector;
 
+  /** The rasterized moving image masks, for fast lookups in IsInsideMovingMask(). */
+  MovingImageRasterizedMaskVectorType m_MovingImageRasterizedMaskVector;
+
 private:
   MultiInputImageToImageMetricBase(const Self &) = delete;
   void
@@ -235,6 +235,17 @@ MultiInputImageToImageMetricBase<TFixedImage, TMovingImage>::Initialize(void)
   /** Check for B-spline interpolators. */
   this->CheckForBSplineInterpolators();
 
+  /** Rasterize the moving image masks, once per resolution. */
+  this->m_MovingImageRasterizedMaskVector.resize(this->GetNumberOfMovingImageMasks());
+  for (unsigned int i = 0; i < this->GetNumberOfMovingImageMasks(); ++i)
+  {
+    if (this->m_MovingImageRasterizedMaskVector[i].IsNull())
+    {
+      this->m_MovingImageRasterizedMaskVector[i] = MovingImageRasterizedMaskType::New();
+    }
+    this->m_MovingImageRasterizedMaskVector[i]->SetMask(this->GetMovingImageMask(i));
+  }
+
   /** Call the superclass' implementation. */
   this->Superclass::Initialize();
 
@@ -323,13 +334,22 @@ MultiInputImageToImageMetricBase<TFixedImage, TMovingImage>::IsInsideMovingMask(
    * AND of all masks is returned, i.e. the sample should be inside
    * all masks.
    */
-  bool inside = true;
+  const bool rasterized = this->m_MovingImageRasterizedMaskVector.size() == this->GetNumberOfMovingImageMasks();
+  bool       inside = true;
   for (unsigned int i = 0; i < this->GetNumberOfMovingImageMasks(); ++i)
   {
-    MovingImageMaskPointer movingImageMask = this->GetMovingImageMask(i);
-    if (movingImageMask.IsNotNull())
+    const MovingImageMaskType * movingImageMask = this->GetMovingImageMask(i);
+    if (movingImageMask != nullptr)
     {
-      inside &= movingImageMask->IsInsideInWorldSpace(mappedPoint);
+      /** Use the rasterized mask, unless the mask was replaced after Initialize(). */
+      if (rasterized && this->m_MovingImageRasterizedMaskVector[i]->GetMask() == movingImageMask)
+      {
+        inside &= this->m_MovingImageRasterizedMaskVector[i]->IsInside(mappedPoint);
+      }
+      else
+      {
+        inside &= movingImageMask->IsInsideInWorldSpace(mappedPoint);
+      }
     }
 
     /** If the point falls outside one mask, we can skip the rest. */
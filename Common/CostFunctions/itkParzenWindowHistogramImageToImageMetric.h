@@ -259,6 +259,11 @@ protected:
   typedef IncrementalMarginalPDFType::SizeType         IncrementalMarginalPDFSizeType;
   typedef Array<PDFValueType>                          ParzenValueContainerType;
 
+  /** The Parzen window covers at most 4 bins, for a B-spline kernel of order 3.
+   * The stack allocated Parzen values avoid a heap allocation per sample.
+   */
+  typedef FixedArray<PDFValueType, 4> ParzenWindowValuesType;
+
   /** Typedefs for Parzen kernel. */
   typedef KernelFunctionBase2<PDFValueType>    KernelFunctionType;
   typedef typename KernelFunctionType::Pointer KernelFunctionPointer;
@@ -353,6 +358,28 @@ protected:
                        const KernelFunctionType * kernel,
                        ParzenValueContainerType & parzenValues) const;
 
+  /** Compute the Parzen values of the fixed and moving kernel, and of the
+   * derivative of the moving kernel, like EvaluateParzenValues does.
+   * These functions dispatch once on the B-spline order to the non-virtual,
+   * inlined kernel weights, instead of calling the virtual kernel->Evaluate().
+   * The output array should have room for at least kernel order + 1 values,
+   * and two values for the derivative of a zero order moving kernel.
+   */
+  inline void
+  EvaluateFixedParzenValues(double          parzenWindowTerm,
+                            OffsetValueType parzenWindowIndex,
+                            PDFValueType *  parzenValues) const;
+
+  inline void
+  EvaluateMovingParzenValues(double          parzenWindowTerm,
+                             OffsetValueType parzenWindowIndex,
+                             PDFValueType *  parzenValues) const;
+
+  inline void
+  EvaluateDerivativeMovingParzenValues(double          parzenWindowTerm,
+                                       OffsetValueType parzenWindowIndex,
+                                       PDFValueType *  parzenValues) const;
+
   /** Update the joint PDF with a pixel pair; on demand also updates the
    * pdf derivatives (if the Jacobian pointers are nonzero).
    */
@@ -544,6 +544,100 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateParz
 } // end EvaluateParzenValues()
 
 
+/**
+ * ********************** EvaluateFixedParzenValues ***************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateFixedParzenValues(
+  double          parzenWindowTerm,
+  OffsetValueType parzenWindowIndex,
+  PDFValueType *  parzenValues) const
+{
+  const double u = static_cast<double>(parzenWindowIndex) - parzenWindowTerm;
+  switch (this->m_FixedKernelBSplineOrder)
+  {
+    case 0:
+      BSplineKernelFunction2<0>::FastEvaluate(u, parzenValues);
+      break;
+    case 1:
+      BSplineKernelFunction2<1>::FastEvaluate(u, parzenValues);
+      break;
+    case 2:
+      BSplineKernelFunction2<2>::FastEvaluate(u, parzenValues);
+      break;
+    default:
+      BSplineKernelFunction2<3>::FastEvaluate(u, parzenValues);
+      break;
+  } // end switch FixedKernelBSplineOrder
+
+} // end EvaluateFixedParzenValues()
+
+
+/**
+ * ********************** EvaluateMovingParzenValues ***************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateMovingParzenValues(
+  double          parzenWindowTerm,
+  OffsetValueType parzenWindowIndex,
+  PDFValueType *  parzenValues) const
+{
+  const double u = static_cast<double>(parzenWindowIndex) - parzenWindowTerm;
+  switch (this->m_MovingKernelBSplineOrder)
+  {
+    case 0:
+      BSplineKernelFunction2<0>::FastEvaluate(u, parzenValues);
+      break;
+    case 1:
+      BSplineKernelFunction2<1>::FastEvaluate(u, parzenValues);
+      break;
+    case 2:
+      BSplineKernelFunction2<2>::FastEvaluate(u, parzenValues);
+      break;
+    default:
+      BSplineKernelFunction2<3>::FastEvaluate(u, parzenValues);
+      break;
+  } // end switch MovingKernelBSplineOrder
+
+} // end EvaluateMovingParzenValues()
+
+
+/**
+ * ********************** EvaluateDerivativeMovingParzenValues ***************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::EvaluateDerivativeMovingParzenValues(
+  double          parzenWindowTerm,
+  OffsetValueType parzenWindowIndex,
+  PDFValueType *  parzenValues) const
+{
+  /** Like in InitializeKernels(), the zero order moving kernel uses the
+   * derivative of the first order kernel.
+   */
+  const double u = static_cast<double>(parzenWindowIndex) - parzenWindowTerm;
+  switch (this->m_MovingKernelBSplineOrder)
+  {
+    case 0:
+    case 1:
+      BSplineDerivativeKernelFunction2<1>::FastEvaluate(u, parzenValues);
+      break;
+    case 2:
+      BSplineDerivativeKernelFunction2<2>::FastEvaluate(u, parzenValues);
+      break;
+    default:
+      BSplineDerivativeKernelFunction2<3>::FastEvaluate(u, parzenValues);
+      break;
+  } // end switch MovingKernelBSplineOrder
+
+} // end EvaluateDerivativeMovingParzenValues()
+
+
 /**
  * ********************** UpdateJointPDFAndDerivatives ***************
  */
@@ -557,8 +651,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   const NonZeroJacobianIndicesType * nzji,
   JointPDFType *                     jointPDF) const
 {
-  typedef ImageScanlineIterator<JointPDFType> PDFIteratorType;
-
   /** Determine Parzen window arguments (see eq. 6 of Mattes paper [2]). */
   const double fixedImageParzenWindowTerm =
     fixedImageValue / this->m_FixedImageBinSize - this->m_FixedImageNormalizedMin;
@@ -572,64 +664,65 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
     static_cast<OffsetValueType>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
 
   /** The Parzen values. */
-  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
-  ParzenValueContainerType movingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
-  this->EvaluateParzenValues(
-    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
-  this->EvaluateParzenValues(
-    movingImageParzenWindowTerm, movingImageParzenWindowIndex, this->m_MovingKernel, movingParzenValues);
-
-  /** Position the JointPDFWindow. */
-  JointPDFIndexType pdfWindowIndex;
-  pdfWindowIndex[0] = movingImageParzenWindowIndex;
-  pdfWindowIndex[1] = fixedImageParzenWindowIndex;
-
-  /** For thread-safety, make a local copy of the support region,
-   * and use that one. Because each thread will modify it.
+  ParzenWindowValuesType fixedParzenValues;
+  ParzenWindowValuesType movingParzenValues;
+  this->EvaluateFixedParzenValues(
+    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, fixedParzenValues.GetDataPointer());
+  this->EvaluateMovingParzenValues(
+    movingImageParzenWindowTerm, movingImageParzenWindowIndex, movingParzenValues.GetDataPointer());
+
+  /** The size of the Parzen window. */
+  const unsigned int fixedWindowSize = this->m_JointPDFWindow.GetSize()[1];
+  const unsigned int movingWindowSize = this->m_JointPDFWindow.GetSize()[0];
+
+  /** Get the pointer to the first bin of the Parzen window in the joint pdf.
+   * The moving bins are contiguous in memory, so the inner loops run over
+   * consecutive elements. Each thread passes its own joint pdf.
    */
-  JointPDFRegionType jointPDFWindow = this->m_JointPDFWindow;
-  jointPDFWindow.SetIndex(pdfWindowIndex);
-  PDFIteratorType it(jointPDF, jointPDFWindow);
+  const OffsetValueType pdfLineOffset = jointPDF->GetOffsetTable()[1];
+  PDFValueType *        pdfPtr =
+    jointPDF->GetBufferPointer() + movingImageParzenWindowIndex + fixedImageParzenWindowIndex * pdfLineOffset;
 
   if (!imageJacobian)
   {
     /** Loop over the Parzen window region and increment the values. */
-    for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+    for (unsigned int f = 0; f < fixedWindowSize; ++f)
     {
       const double fv = fixedParzenValues[f];
-      for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+      for (unsigned int m = 0; m < movingWindowSize; ++m)
       {
-        it.Value() += static_cast<PDFValueType>(fv * movingParzenValues[m]);
-        ++it;
+        pdfPtr[m] += static_cast<PDFValueType>(fv * movingParzenValues[m]);
       }
-      it.NextLine();
+      pdfPtr += pdfLineOffset;
     }
   }
   else
   {
     /** Compute the derivatives of the moving Parzen window. */
-    ParzenValueContainerType derivativeMovingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
-    this->EvaluateParzenValues(movingImageParzenWindowTerm,
-                               movingImageParzenWindowIndex,
-                               this->m_DerivativeMovingKernel,
-                               derivativeMovingParzenValues);
+    ParzenWindowValuesType derivativeMovingParzenValues;
+    this->EvaluateDerivativeMovingParzenValues(
+      movingImageParzenWindowTerm, movingImageParzenWindowIndex, derivativeMovingParzenValues.GetDataPointer());
 
     const double et = static_cast<double>(this->m_MovingImageBinSize);
 
     /** Loop over the Parzen window region and increment the values
      * Also update the pdf derivatives.
      */
-    for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+    JointPDFIndexType pdfIndex;
+    pdfIndex[1] = fixedImageParzenWindowIndex;
+    for (unsigned int f = 0; f < fixedWindowSize; ++f)
     {
       const double fv = fixedParzenValues[f];
       const double fv_et = fv / et;
-      for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+      pdfIndex[0] = movingImageParzenWindowIndex;
+      for (unsigned int m = 0; m < movingWindowSize; ++m)
       {
-        it.Value() += static_cast<PDFValueType>(fv * movingParzenValues[m]);
-        this->UpdateJointPDFDerivatives(it.GetIndex(), fv_et * derivativeMovingParzenValues[m], *imageJacobian, *nzji);
-        ++it;
+        pdfPtr[m] += static_cast<PDFValueType>(fv * movingParzenValues[m]);
+        this->UpdateJointPDFDerivatives(pdfIndex, fv_et * derivativeMovingParzenValues[m], *imageJacobian, *nzji);
+        ++(pdfIndex[0]);
       }
-      it.NextLine();
+      pdfPtr += pdfLineOffset;
+      ++(pdfIndex[1]);
     }
   }
 
@@ -653,25 +746,27 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
                                       (pdfIndex[0] * this->m_JointPDFDerivatives->GetOffsetTable()[1]) +
                                       (pdfIndex[1] * this->m_JointPDFDerivatives->GetOffsetTable()[2]);
 
+  /** Raw pointers and a loop count that is known before the loop starts,
+   * so that the compiler can vectorise the loops below.
+   */
+  const DerivativeValueType * imjac = imageJacobian.data_block();
+  const unsigned int          numberOfJacobianValues = imageJacobian.GetSize();
+
   if (nzji.size() == this->GetNumberOfParameters())
   {
     /** Loop over all Jacobians. */
-    typename DerivativeType::const_iterator imjac = imageJacobian.begin();
-    for (unsigned int mu = 0; mu < this->GetNumberOfParameters(); ++mu)
+    for (unsigned int mu = 0; mu < numberOfJacobianValues; ++mu)
     {
-      *(derivPtr) -= static_cast<PDFDerivativeValueType>((*imjac) * factor);
-      ++derivPtr;
-      ++imjac;
+      derivPtr[mu] -= static_cast<PDFDerivativeValueType>(imjac[mu] * factor);
     }
   }
   else
   {
     /** Loop only over the non-zero Jacobians. */
-    for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
+    const typename NonZeroJacobianIndicesType::value_type * nzjiPtr = nzji.data();
+    for (unsigned int i = 0; i < numberOfJacobianValues; ++i)
     {
-      const unsigned int       mu = nzji[i];
-      PDFDerivativeValueType * ptr = derivPtr + mu;
-      *(ptr) -= static_cast<PDFDerivativeValueType>(imageJacobian[i] * factor);
+      derivPtr[nzjiPtr[i]] -= static_cast<PDFDerivativeValueType>(imjac[i] * factor);
     }
   }
 
@@ -831,8 +926,10 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   PDFDerivativeValueType * incLeftBasePtr = this->m_IncrementalJointPDFLeft->GetBufferPointer();
 
   /** The Parzen value containers. */
-  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
-  ParzenValueContainerType movingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
+  ParzenWindowValuesType fixedParzenValues;
+  ParzenWindowValuesType movingParzenValues;
+  const unsigned int     fixedWindowSize = this->m_JointPDFWindow.GetSize()[1];
+  const unsigned int     movingWindowSize = this->m_JointPDFWindow.GetSize()[0];
 
   /** Determine fixed image Parzen window arguments (see eq. 6 of Mattes paper [2]). */
   const double fixedImageParzenWindowTerm =
@@ -841,8 +938,8 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
   /** The lowest bin numbers affected by this pixel: */
   const OffsetValueType fixedImageParzenWindowIndex =
     static_cast<OffsetValueType>(std::floor(fixedImageParzenWindowTerm + this->m_FixedParzenTermToIndexOffset));
-  this->EvaluateParzenValues(
-    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
+  this->EvaluateFixedParzenValues(
+    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, fixedParzenValues.GetDataPointer());
 
   if (movingMaskValue > 1e-10)
   {
@@ -851,8 +948,8 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       movingImageValue / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
     const OffsetValueType movingImageParzenWindowIndex =
       static_cast<OffsetValueType>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
-    this->EvaluateParzenValues(
-      movingImageParzenWindowTerm, movingImageParzenWindowIndex, this->m_MovingKernel, movingParzenValues);
+    this->EvaluateMovingParzenValues(
+      movingImageParzenWindowTerm, movingImageParzenWindowIndex, movingParzenValues.GetDataPointer());
 
     /** Position the JointPDFWindow (set the start index). */
     JointPDFIndexType pdfIndex;
@@ -865,10 +962,10 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
      * m_IncrementalJointPDF<Right/Left>(k,M,F) -= movingMask * fixedParzen(F) * movingParzen(M);
      * for all k with nonzero Jacobian.
      */
-    for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+    for (unsigned int f = 0; f < fixedWindowSize; ++f)
     {
       const double fv_mask = fixedParzenValues[f] * movingMaskValue;
-      for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+      for (unsigned int m = 0; m < movingWindowSize; ++m)
       {
         const PDFValueType fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
         this->m_JointPDF->GetPixel(pdfIndex) += fv_mask_mv;
@@ -924,8 +1021,8 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       const double movParzenWindowTermRight = movr / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
       const OffsetValueType movParzenWindowIndexRight =
         static_cast<OffsetValueType>(std::floor(movParzenWindowTermRight + this->m_MovingParzenTermToIndexOffset));
-      this->EvaluateParzenValues(
-        movParzenWindowTermRight, movParzenWindowIndexRight, this->m_MovingKernel, movingParzenValues);
+      this->EvaluateMovingParzenValues(
+        movParzenWindowTermRight, movParzenWindowIndexRight, movingParzenValues.GetDataPointer());
 
       /** Initialize index in IncrementalJointPDFRight. */
       rindex[0] = mu;
@@ -933,10 +1030,10 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       rindex[2] = fixedImageParzenWindowIndex;
 
       /** Loop over Parzen window and update IncrementalJointPDFRight. */
-      for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+      for (unsigned int f = 0; f < fixedWindowSize; ++f)
       {
         const double fv_mask = fixedParzenValues[f] * maskr;
-        for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+        for (unsigned int m = 0; m < movingWindowSize; ++m)
         {
           const PDFValueType fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
           this->m_IncrementalJointPDFRight->GetPixel(rindex) += fv_mask_mv;
@@ -956,8 +1053,8 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       const double movParzenWindowTermLeft = movl / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
       const OffsetValueType movParzenWindowIndexLeft =
         static_cast<OffsetValueType>(std::floor(movParzenWindowTermLeft + this->m_MovingParzenTermToIndexOffset));
-      this->EvaluateParzenValues(
-        movParzenWindowTermLeft, movParzenWindowIndexLeft, this->m_MovingKernel, movingParzenValues);
+      this->EvaluateMovingParzenValues(
+        movParzenWindowTermLeft, movParzenWindowIndexLeft, movingParzenValues.GetDataPointer());
 
       /** Initialize index in IncrementalJointPDFLeft. */
       lindex[0] = mu;
@@ -965,10 +1062,10 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::UpdateJointP
       lindex[2] = fixedImageParzenWindowIndex;
 
       /** Loop over Parzen window and update IncrementalJointPDFLeft. */
-      for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+      for (unsigned int f = 0; f < fixedWindowSize; ++f)
       {
         const double fv_mask = fixedParzenValues[f] * maskl;
-        for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+        for (unsigned int m = 0; m < movingWindowSize; ++m)
         {
           const PDFValueType fv_mask_mv = static_cast<PDFValueType>(fv_mask * movingParzenValues[m]);
           this->m_IncrementalJointPDFLeft->GetPixel(lindex) += fv_mask_mv;
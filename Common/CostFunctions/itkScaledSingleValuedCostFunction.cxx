@@ -51,18 +51,7 @@ ScaledSingleValuedCostFunction::GetValue(const ParametersType & parameters) cons
     itkExceptionMacro(<< "Number of parameters is not like the unscaled cost function expects.");
   }
 
-  MeasureType returnvalue = NumericTraits<MeasureType>::Zero;
-
-  if (this->m_UseScales)
-  {
-    ParametersType scaledParameters = parameters;
-    this->ConvertScaledToUnscaledParameters(scaledParameters);
-    returnvalue = this->m_UnscaledCostFunction->GetValue(scaledParameters);
-  }
-  else
-  {
-    returnvalue = this->m_UnscaledCostFunction->GetValue(parameters);
-  }
+  const MeasureType returnvalue = this->m_UnscaledCostFunction->GetValue(this->GetUnscaledParameters(parameters));
 
   if (this->GetNegateCostFunction())
   {
@@ -89,27 +78,8 @@ ScaledSingleValuedCostFunction::GetDerivative(const ParametersType & parameters,
     itkExceptionMacro(<< "Number of parameters is not like the unscaled cost function expects.");
   }
 
-  if (this->m_UseScales)
-  {
-    ParametersType scaledParameters = parameters;
-    this->ConvertScaledToUnscaledParameters(scaledParameters);
-    this->m_UnscaledCostFunction->GetDerivative(scaledParameters, derivative);
-
-    const ScalesType & scales = this->GetScales();
-    for (unsigned int i = 0; i < numberOfParameters; ++i)
-    {
-      derivative[i] /= scales[i];
-    }
-  }
-  else
-  {
-    m_UnscaledCostFunction->GetDerivative(parameters, derivative);
-  }
-
-  if (this->GetNegateCostFunction())
-  {
-    derivative = -derivative;
-  }
+  this->m_UnscaledCostFunction->GetDerivative(this->GetUnscaledParameters(parameters), derivative);
+  this->ScaleAndNegateDerivative(derivative);
 
 } // end GetDerivative()
 
@@ -133,31 +103,73 @@ ScaledSingleValuedCostFunction::GetValueAndDerivative(const ParametersType & par
     itkExceptionMacro(<< "Number of parameters is not like the unscaled cost function expects.");
   }
 
-  if (this->m_UseScales)
+  this->m_UnscaledCostFunction->GetValueAndDerivative(this->GetUnscaledParameters(parameters), value, derivative);
+  this->ScaleAndNegateDerivative(derivative);
+
+  if (this->GetNegateCostFunction())
   {
+    value = -value;
+  }
 
-    ParametersType scaledParameters = parameters;
-    this->ConvertScaledToUnscaledParameters(scaledParameters);
-    this->m_UnscaledCostFunction->GetValueAndDerivative(scaledParameters, value, derivative);
+} // end GetValueAndDerivative()
 
+
+/**
+ * **************** GetUnscaledParameters ************************
+ */
+
+const ScaledSingleValuedCostFunction::ParametersType &
+ScaledSingleValuedCostFunction::GetUnscaledParameters(const ParametersType & parameters) const
+{
+  if (!this->m_UseScales)
+  {
+    return parameters;
+  }
+
+  /** The assignment only reallocates when the number of parameters changes. */
+  this->m_UnscaledParameters = parameters;
+  this->ConvertScaledToUnscaledParameters(this->m_UnscaledParameters);
+  return this->m_UnscaledParameters;
+
+} // end GetUnscaledParameters()
+
+
+/**
+ * **************** ScaleAndNegateDerivative ************************
+ */
+
+void
+ScaledSingleValuedCostFunction::ScaleAndNegateDerivative(DerivativeType & derivative) const
+{
+  const unsigned int numberOfParameters = derivative.GetSize();
+
+  if (this->m_UseScales)
+  {
     const ScalesType & scales = this->GetScales();
-    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    if (this->m_NegateCostFunction)
     {
-      derivative[i] /= scales[i];
+      for (unsigned int i = 0; i < numberOfParameters; ++i)
+      {
+        derivative[i] = -(derivative[i] / scales[i]);
+      }
+    }
+    else
+    {
+      for (unsigned int i = 0; i < numberOfParameters; ++i)
+      {
+        derivative[i] /= scales[i];
+      }
     }
   }
-  else
-  {
-    this->m_UnscaledCostFunction->GetValueAndDerivative(parameters, value, derivative);
-  }
-
-  if (this->GetNegateCostFunction())
+  else if (this->m_NegateCostFunction)
   {
-    value = -value;
-    derivative = -derivative;
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      derivative[i] = -derivative[i];
+    }
   }
 
-} // end GetValueAndDerivative()
+} // end ScaleAndNegateDerivative()
 
 
 /**
@@ -147,7 +147,18 @@ private:
   void
   operator=(const Self &) = delete;
 
+  /** Returns the unscaled parameters, x = y/s, in a workspace that is reused
+   * by the next evaluations, so that an iteration does not allocate memory.
+   */
+  const ParametersType &
+  GetUnscaledParameters(const ParametersType & parameters) const;
+
+  /** Divides the derivative by the scales and negates it, in a single pass, in place. */
+  void
+  ScaleAndNegateDerivative(DerivativeType & derivative) const;
+
   /** Member variables. */
+  mutable ParametersType          m_UnscaledParameters;
   ScalesType                      m_Scales;
   ScalesType                      m_SquaredScales;
   SingleValuedCostFunctionPointer m_UnscaledCostFunction;
@@ -40,6 +40,7 @@
 #include "itkMacro.h"
 #include "itkSpatialObject.h"
 #include "itkPointSet.h"
+#include "itkRasterizedMask.h"
 
 namespace itk
 {
@@ -103,6 +104,7 @@ public:
   typedef SpatialObject<Self::MovingPointSetDimension> MovingImageMaskType;
   typedef typename MovingImageMaskType::Pointer        MovingImageMaskPointer;
   typedef typename MovingImageMaskType::ConstPointer   MovingImageMaskConstPointer;
+  typedef RasterizedMask<Self::MovingPointSetDimension> MovingImageRasterizedMaskType;
 
   /**  Type of the measure. */
   using Superclass::MeasureType;
@@ -178,6 +180,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Convenience method: check if point is inside the moving mask. */
+  bool
+  IsInsideMovingMask(const OutputPointType & point) const;
+
   /** Member variables. */
   FixedPointSetConstPointer   m_FixedPointSet;
   MovingPointSetConstPointer  m_MovingPointSet;
@@ -185,6 +191,9 @@ protected:
   MovingImageMaskConstPointer m_MovingImageMask;
   mutable TransformPointer    m_Transform;
 
+  /** The rasterized moving image mask, for fast lookups in IsInsideMovingMask(). */
+  typename MovingImageRasterizedMaskType::Pointer m_MovingImageRasterizedMask;
+
   mutable unsigned int m_NumberOfPointsCounted;
 
   /** Variables for multi-threading. */
@@ -51,6 +51,7 @@ SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::SingleVal
   this->m_Transform = nullptr;      // has to be provided by the user.
   this->m_FixedImageMask = nullptr;
   this->m_MovingImageMask = nullptr;
+  this->m_MovingImageRasterizedMask = MovingImageRasterizedMaskType::New();
 
   this->m_NumberOfPointsCounted = 0;
 
@@ -112,9 +113,38 @@ SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::Initializ
     this->m_FixedPointSet->GetSource()->Update();
   }
 
+  /** Rasterize the moving image mask, once per resolution. */
+  this->m_MovingImageRasterizedMask->SetMask(this->m_MovingImageMask.GetPointer());
+
 } // end Initialize()
 
 
+/**
+ * ******************* IsInsideMovingMask ***********************
+ */
+
+template <class TFixedPointSet, class TMovingPointSet>
+bool
+SingleValuedPointSetToPointSetMetric<TFixedPointSet, TMovingPointSet>::IsInsideMovingMask(
+  const OutputPointType & point) const
+{
+  /** If a mask has been set: */
+  if (this->m_MovingImageMask.IsNotNull())
+  {
+    /** Use the rasterized mask, unless the mask was replaced after Initialize(). */
+    if (this->m_MovingImageRasterizedMask->GetMask() == this->m_MovingImageMask.GetPointer())
+    {
+      return this->m_MovingImageRasterizedMask->IsInside(point);
+    }
+    return this->m_MovingImageMask->IsInsideInWorldSpace(point);
+  }
+
+  /** If no mask has been set, just return true. */
+  return true;
+
+} // end IsInsideMovingMask()
+
+
 /**
  * *********************** BeforeThreadedGetValueAndDerivative ***********************
  */
@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header files to be tested:
+#include "itkANNStandardTreeSearch.h"
+#include "itkANNPriorityTreeSearch.h"
+#include "itkANNFixedRadiusTreeSearch.h"
+
+#include "itkANNkDTree.h"
+#include "itkANNbdTree.h"
+#include "itkListSampleCArray.h"
+
+#include <itkArray.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+using MeasurementVectorType = itk::Array<double>;
+using ListSampleType = itk::Statistics::ListSampleCArray<MeasurementVectorType, double>;
+using BinaryTreeSearchType = itk::BinaryTreeSearchBase<ListSampleType>;
+using IndexArrayType = BinaryTreeSearchType::IndexArrayType;
+using DistanceArrayType = BinaryTreeSearchType::DistanceArrayType;
+
+constexpr unsigned int Dimension = 3;
+constexpr unsigned int NumberOfThreads = 4;
+
+
+/** Creates a list sample of pseudo-random points, for the tree or for the queries. */
+ListSampleType::Pointer
+CreateListSample(const unsigned long numberOfPoints, const std::mt19937::result_type seed)
+{
+  std::mt19937                           randomNumberEngine(seed);
+  std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+
+  const auto listSample = ListSampleType::New();
+  listSample->SetMeasurementVectorSize(Dimension);
+  listSample->Resize(numberOfPoints);
+  for (unsigned long i = 0; i < numberOfPoints; ++i)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      listSample->SetMeasurement(i, d, distribution(randomNumberEngine));
+    }
+  }
+  return listSample;
+}
+
+
+/** Queries the searcher for each point of the query sample, from a single
+ * thread and from several threads at once, sharing the searcher and the tree
+ * just like KNNGraphAlphaMutualInformationImageToImageMetric does, and expects
+ * the concurrent results to equal the serial ones.
+ */
+void
+Expect_concurrent_searches_equal_serial_searches(BinaryTreeSearchType & searcher)
+{
+  const auto          querySample = CreateListSample(2000, 2);
+  const unsigned long numberOfQueries = querySample->GetActualSize();
+
+  std::vector<IndexArrayType>    expectedIndices(numberOfQueries);
+  std::vector<DistanceArrayType> expectedDistances(numberOfQueries);
+  MeasurementVectorType          queryPoint(Dimension);
+
+  for (unsigned long i = 0; i < numberOfQueries; ++i)
+  {
+    querySample->GetMeasurementVector(i, queryPoint);
+    searcher.Search(queryPoint, expectedIndices[i], expectedDistances[i]);
+  }
+
+  std::vector<IndexArrayType>    actualIndices(numberOfQueries);
+  std::vector<DistanceArrayType> actualDistances(numberOfQueries);
+  std::vector<std::thread>       threads;
+
+  for (unsigned int threadId = 0; threadId < NumberOfThreads; ++threadId)
+  {
+    threads.emplace_back([&, threadId] {
+      /** Each thread reuses its own query point and scratch arrays. */
+      MeasurementVectorType threadQueryPoint(Dimension);
+      IndexArrayType        indices;
+      DistanceArrayType     distances;
+
+      for (unsigned long i = threadId; i < numberOfQueries; i += NumberOfThreads)
+      {
+        querySample->GetMeasurementVector(i, threadQueryPoint);
+        searcher.Search(threadQueryPoint, indices, distances);
+        actualIndices[i] = indices;
+        actualDistances[i] = distances;
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  for (unsigned long i = 0; i < numberOfQueries; ++i)
+  {
+    EXPECT_EQ(actualIndices[i], expectedIndices[i]);
+    EXPECT_EQ(actualDistances[i], expectedDistances[i]);
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(ANNTreeSearch, ConcurrentStandardSearchOfkDTreeEqualsSerialSearch)
+{
+  const auto tree = itk::ANNkDTree<ListSampleType>::New();
+  tree->SetSample(CreateListSample(5000, 1));
+  tree->SetBucketSize(10);
+  tree->GenerateTree();
+
+  const auto searcher = itk::ANNStandardTreeSearch<ListSampleType>::New();
+  searcher->SetKNearestNeighbors(20);
+  searcher->SetErrorBound(0.0);
+  searcher->SetBinaryTree(tree);
+
+  Expect_concurrent_searches_equal_serial_searches(*searcher);
+}
+
+
+GTEST_TEST(ANNTreeSearch, ConcurrentStandardSearchOfbdTreeEqualsSerialSearch)
+{
+  const auto tree = itk::ANNbdTree<ListSampleType>::New();
+  tree->SetSample(CreateListSample(5000, 1));
+  tree->SetBucketSize(10);
+  tree->GenerateTree();
+
+  const auto searcher = itk::ANNStandardTreeSearch<ListSampleType>::New();
+  searcher->SetKNearestNeighbors(20);
+  searcher->SetErrorBound(0.0);
+  searcher->SetBinaryTree(tree);
+
+  Expect_concurrent_searches_equal_serial_searches(*searcher);
+}
+
+
+GTEST_TEST(ANNTreeSearch, ConcurrentPrioritySearchEqualsSerialSearch)
+{
+  const auto tree = itk::ANNkDTree<ListSampleType>::New();
+  tree->SetSample(CreateListSample(5000, 1));
+  tree->SetBucketSize(10);
+  tree->GenerateTree();
+
+  const auto searcher = itk::ANNPriorityTreeSearch<ListSampleType>::New();
+  searcher->SetKNearestNeighbors(20);
+  searcher->SetErrorBound(0.5);
+  searcher->SetBinaryTree(tree);
+
+  Expect_concurrent_searches_equal_serial_searches(*searcher);
+}
+
+
+GTEST_TEST(ANNTreeSearch, ConcurrentFixedRadiusSearchEqualsSerialSearch)
+{
+  const auto tree = itk::ANNkDTree<ListSampleType>::New();
+  tree->SetSample(CreateListSample(5000, 1));
+  tree->SetBucketSize(10);
+  tree->GenerateTree();
+
+  /** The squared radius is chosen such that some queries find fewer than k
+   * neighbours, which exercises the padding of the output arrays as well.
+   */
+  const auto searcher = itk::ANNFixedRadiusTreeSearch<ListSampleType>::New();
+  searcher->SetKNearestNeighbors(20);
+  searcher->SetErrorBound(0.0);
+  searcher->SetSquaredRadius(4.0);
+  searcher->SetBinaryTree(tree);
+
+  Expect_concurrent_searches_equal_serial_searches(*searcher);
+}
@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+// First include the header file to be tested:
+#include "itkAdaptiveSampleSizeSchedule.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+
+namespace
+{
+using ScheduleType = itk::AdaptiveSampleSizeSchedule;
+
+/** Runs a schedule on the expected gradient statistics of a registration whose
+ * squared exact gradient magnitude is signal(k) in iteration k, and whose noise
+ * variance is noiseVariance / n with relative number of samples n. Returns the
+ * relative number of samples of the last iteration.
+ */
+template <class TFunction>
+double
+RunSchedule(ScheduleType & schedule, const unsigned int numberOfIterations, TFunction signal, const double noiseVariance)
+{
+  schedule.Initialize(numberOfIterations);
+  for (unsigned int k = 0; k < numberOfIterations; ++k)
+  {
+    const double n = schedule.GetRelativeNumberOfSamples();
+    EXPECT_GE(n, 0.0);
+    EXPECT_LE(n, schedule.GetMaximumRelativeNumberOfSamples());
+    if (k > 0)
+    {
+      schedule.AddGradient(signal(k), signal(k) + noiseVariance / n);
+    }
+    schedule.AdvanceIteration();
+  }
+  return schedule.GetRelativeNumberOfSamples();
+}
+} // namespace
+
+
+GTEST_TEST(AdaptiveSampleSizeSchedule, StaysAtTheMinimumWhileTheSignalIsConstant)
+{
+  const auto schedule = ScheduleType::New();
+  EXPECT_DOUBLE_EQ(RunSchedule(*schedule, 100, [](unsigned int) { return 1.0; }, 1.0), 0.25);
+  EXPECT_DOUBLE_EQ(schedule->GetTotalRelativeNumberOfSamples(), 25.0);
+  EXPECT_EQ(schedule->GetNumberOfCompletedIterations(), 100u);
+}
+
+
+GTEST_TEST(AdaptiveSampleSizeSchedule, GrowsAsTheSignalFades)
+{
+  const auto schedule = ScheduleType::New();
+
+  /** The signal drops by a factor 4, so the number of samples should grow by about that factor. */
+  const auto   signal = [](unsigned int k) { return std::max(0.25, std::pow(0.99, k)); };
+  const double last = RunSchedule(*schedule, 500, signal, 1.0);
+  EXPECT_NEAR(last, 4.0 * 0.25, 0.05);
+
+  /** It uses clearly fewer samples than the reference number of samples in every iteration would. */
+  EXPECT_LT(schedule->GetTotalRelativeNumberOfSamples(), 0.9 * 500.0);
+}
+
+
+GTEST_TEST(AdaptiveSampleSizeSchedule, UsesTheReferenceNoiseToSignalRatio)
+{
+  const auto schedule = ScheduleType::New();
+
+  /** A reference ratio of 1 at n = 1 means a target of 4 at n = 0.25, while the
+   * gradients have a ratio of 0.5 / 0.25 = 2: the minimum suffices throughout.
+   */
+  schedule->SetReferenceNoiseToSignalRatio(1.0);
+  EXPECT_DOUBLE_EQ(RunSchedule(*schedule, 100, [](unsigned int) { return 1.0; }, 0.5), 0.25);
+
+  /** A reference ratio of 0.25 means a target of 1: twice as many samples are needed. */
+  schedule->SetReferenceNoiseToSignalRatio(0.25);
+  EXPECT_NEAR(RunSchedule(*schedule, 100, [](unsigned int) { return 1.0; }, 0.5), 0.5, 1e-6);
+}
+
+
+GTEST_TEST(AdaptiveSampleSizeSchedule, RespectsTheMaximumAndTheBudget)
+{
+  const auto schedule = ScheduleType::New();
+  schedule->SetMaximumRelativeNumberOfSamples(2.0);
+
+  /** A vanishing signal asks for ever more samples. */
+  const auto signal = [](unsigned int k) { return std::pow(0.5, k); };
+  schedule->SetRelativeSampleBudget(10.0);
+  EXPECT_DOUBLE_EQ(RunSchedule(*schedule, 100, signal, 1.0), 2.0);
+
+  /** Over a long resolution, a budget of one per iteration limits the total. */
+  schedule->SetRelativeSampleBudget(1.0);
+  RunSchedule(*schedule, 200, signal, 1.0);
+  EXPECT_LE(schedule->GetTotalRelativeNumberOfSamples(), 200.0 + 1e-9);
+  EXPECT_GT(schedule->GetTotalRelativeNumberOfSamples(), 190.0);
+
+  schedule->SetRelativeSampleBudget(0.5);
+  RunSchedule(*schedule, 200, signal, 1.0);
+  EXPECT_LE(schedule->GetTotalRelativeNumberOfSamples(), 100.0 + 1e-9);
+}
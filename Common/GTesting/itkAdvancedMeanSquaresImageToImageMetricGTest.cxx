@@ -0,0 +1,311 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "AdvancedMeanSquares/itkAdvancedMeanSquaresImageToImageMetric.h"
+
+#include "elxGTestUtilities.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkImageFullSampler.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkLinearInterpolateImageFunction.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+
+namespace
+{
+constexpr unsigned int ImageDimension = 2;
+using ImageType = itk::Image<float, ImageDimension>;
+using MetricType = itk::AdvancedMeanSquaresImageToImageMetric<ImageType, ImageType>;
+
+
+/** Provides the serial assembly of the self-Hessian, as it was before GetSelfHessian() collected
+ * its contributions per chunk of samples: every contribution is inserted into the rows of H
+ * directly, sample after sample. It does not add noise, so it only serves as a reference when the
+ * self-Hessian noise range is zero.
+ */
+class SerialSelfHessianMetric : public MetricType
+{
+public:
+  typedef SerialSelfHessianMetric       Self;
+  typedef MetricType                    Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  itkNewMacro(Self);
+
+  void
+  GetSerialSelfHessian(const TransformParametersType & parameters, HessianType & H) const
+  {
+    typedef HessianType::row    RowType;
+    typedef RowType::iterator   RowIteratorType;
+    typedef HessianType::pair_t ElementType;
+
+    this->SetTransformParameters(parameters);
+    H.set_size(this->GetNumberOfParameters(), this->GetNumberOfParameters());
+
+    /** Smooth the fixed image and sample it, as GetSelfHessian() does. */
+    const auto smoother = SmootherType::New();
+    smoother->SetInput(this->GetFixedImage());
+    smoother->SetSigma(this->GetSelfHessianSmoothingSigma());
+    smoother->Update();
+
+    const auto fixedInterpolator = FixedImageInterpolatorType::New();
+    fixedInterpolator->SetSplineOrder(this->m_BSplineInterpolator.IsNotNull()
+                                        ? this->m_BSplineInterpolator->GetSplineOrder()
+                                        : 1);
+    fixedInterpolator->SetInputImage(smoother->GetOutput());
+
+    const auto sampler = SelfHessianSamplerType::New();
+    sampler->SetInputImageRegion(this->GetImageSampler()->GetInputImageRegion());
+    sampler->SetMask(this->GetImageSampler()->GetMask());
+    sampler->SetInput(smoother->GetInput());
+    sampler->SetNumberOfSamples(this->GetNumberOfSamplesForSelfHessian());
+    sampler->Update();
+
+    NonZeroJacobianIndicesType nzji(this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices());
+    DerivativeType             imageJacobian(nzji.size());
+    TransformJacobianType      jacobian;
+    unsigned long              numberOfPixelsCounted = 0;
+
+    const ImageSampleContainerPointer sampleContainer = sampler->GetOutput();
+    for (auto fiter = sampleContainer->Begin(); fiter != sampleContainer->End(); ++fiter)
+    {
+      const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
+      MovingImagePointType        mappedPoint;
+      MovingImageDerivativeType   movingImageDerivative;
+
+      if (!this->TransformPoint(fixedPoint, mappedPoint) || !this->IsInsideMovingMask(mappedPoint) ||
+          !this->m_Interpolator->IsInsideBuffer(mappedPoint))
+      {
+        continue;
+      }
+      ++numberOfPixelsCounted;
+
+      movingImageDerivative = fixedInterpolator->EvaluateDerivative(fixedPoint);
+      this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
+      this->EvaluateTransformJacobianInnerProduct(jacobian, movingImageDerivative, imageJacobian);
+
+      /** Insert the upper triangular part of the rank-1 update into the rows of H. */
+      const unsigned int imjacsize = imageJacobian.GetSize();
+      for (unsigned int i = 0; i < imjacsize; ++i)
+      {
+        RowType &       rowVector = H.get_row(nzji[i]);
+        RowIteratorType rowIt = rowVector.begin();
+
+        for (unsigned int j = i; j < imjacsize; ++j)
+        {
+          const unsigned int col = nzji[j];
+          const double       val = imageJacobian[i] * imageJacobian[j];
+          if ((val < 1e-14) && (val > -1e-14))
+          {
+            continue;
+          }
+
+          for (; (rowIt != rowVector.end()) && ((*rowIt).first < col); ++rowIt)
+          {
+          }
+
+          if ((rowIt == rowVector.end()) || ((*rowIt).first != col))
+          {
+            rowIt = rowVector.insert(rowIt, ElementType(col, val));
+          }
+          else
+          {
+            (*rowIt).second += val;
+          }
+        }
+      }
+    }
+
+    const double normal_sum = 2.0 * this->m_NormalizationFactor / static_cast<double>(numberOfPixelsCounted);
+    for (unsigned int i = 0; i < this->GetNumberOfParameters(); ++i)
+    {
+      H.scale_row(i, normal_sum);
+    }
+  }
+
+protected:
+  SerialSelfHessianMetric() = default;
+  ~SerialSelfHessianMetric() override = default;
+};
+
+} // namespace
+
+
+// Tests that the self-Hessian does not depend on multi-threading, for a small B-spline problem.
+GTEST_TEST(AdvancedMeanSquaresImageToImageMetric, ThreadedSelfHessianEqualsSingleThreaded)
+{
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, ImageDimension, 3>;
+
+  // A 100x100 image with a smooth blob, so that the self-Hessian samples cover several chunks.
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 100, 100 } });
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - 45.0;
+    const double dy = it.GetIndex()[1] - 52.0;
+    it.Set(static_cast<float>(100.0 * std::exp(-(dx * dx + dy * dy) / 450.0)));
+  }
+
+  const auto                transform = TransformType::New();
+  TransformType::RegionType gridRegion;
+  gridRegion.SetSize(itk::Size<ImageDimension>::Filled(7));
+  TransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(25.0);
+  TransformType::OriginType gridOrigin;
+  gridOrigin.Fill(-25.0);
+  transform->SetGridRegion(gridRegion);
+  transform->SetGridSpacing(gridSpacing);
+  transform->SetGridOrigin(gridOrigin);
+
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  parameters.Fill(0.0);
+  transform->SetParameters(parameters);
+
+  const auto metric = MetricType::New();
+  metric->SetFixedImage(image);
+  metric->SetMovingImage(image);
+  metric->SetFixedImageRegion(image->GetBufferedRegion());
+  metric->SetTransform(transform);
+  metric->SetInterpolator(itk::LinearInterpolateImageFunction<ImageType, double>::New());
+  metric->SetImageSampler(itk::ImageFullSampler<ImageType>::New());
+  metric->SetNumberOfWorkUnits(4);
+
+  // Without noise, the self-Hessian is fully determined by the images and the transform.
+  metric->SetSelfHessianNoiseRange(0.0);
+  metric->Initialize();
+
+  MetricType::HessianType threadedSelfHessian;
+  metric->SetUseMultiThread(true);
+  metric->GetSelfHessian(parameters, threadedSelfHessian);
+
+  MetricType::HessianType singleThreadedSelfHessian;
+  metric->SetUseMultiThread(false);
+  metric->GetSelfHessian(parameters, singleThreadedSelfHessian);
+
+  ASSERT_EQ(threadedSelfHessian.rows(), parameters.GetSize());
+  ASSERT_EQ(singleThreadedSelfHessian.rows(), parameters.GetSize());
+
+  unsigned int numberOfNonZeroEntries = 0;
+  for (unsigned int row = 0; row < parameters.GetSize(); ++row)
+  {
+    const auto & threadedRow = threadedSelfHessian.get_row(row);
+    const auto & singleThreadedRow = singleThreadedSelfHessian.get_row(row);
+    ASSERT_EQ(threadedRow.size(), singleThreadedRow.size());
+
+    for (unsigned int i = 0; i < threadedRow.size(); ++i)
+    {
+      EXPECT_EQ(threadedRow[i].first, singleThreadedRow[i].first);
+      EXPECT_EQ(threadedRow[i].second, singleThreadedRow[i].second);
+    }
+    numberOfNonZeroEntries += threadedRow.size();
+  }
+  EXPECT_GT(numberOfNonZeroEntries, 0U);
+}
+
+
+// Tests that the self-Hessian, assembled per chunk of samples, equals the serial assembly into the rows of H.
+GTEST_TEST(AdvancedMeanSquaresImageToImageMetric, ChunkedSelfHessianEqualsSerialAssembly)
+{
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, ImageDimension, 3>;
+
+  // A 150x130 image with two blobs, sampled by more than 4 chunks of samples.
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 150, 130 } });
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const double dx1 = it.GetIndex()[0] - 50.0;
+    const double dy1 = it.GetIndex()[1] - 60.0;
+    const double dx2 = it.GetIndex()[0] - 105.0;
+    const double dy2 = it.GetIndex()[1] - 75.0;
+    it.Set(static_cast<float>(100.0 * std::exp(-(dx1 * dx1 + dy1 * dy1) / 500.0) +
+                              60.0 * std::exp(-(dx2 * dx2 + dy2 * dy2) / 300.0)));
+  }
+
+  // An anisotropic grid of 11x9 control points that are not at their rest position.
+  const auto                transform = TransformType::New();
+  TransformType::RegionType gridRegion;
+  gridRegion.SetSize(TransformType::RegionType::SizeType{ { 11, 9 } });
+  TransformType::SpacingType gridSpacing;
+  gridSpacing[0] = 18.5;
+  gridSpacing[1] = 21.0;
+  TransformType::OriginType gridOrigin;
+  gridOrigin[0] = -20.0;
+  gridOrigin[1] = -23.0;
+  transform->SetGridRegion(gridRegion);
+  transform->SetGridSpacing(gridSpacing);
+  transform->SetGridOrigin(gridOrigin);
+
+  const auto parameters =
+    elastix::GTestUtilities::GeneratePseudoRandomParameters(transform->GetNumberOfParameters(), -2.0, 2.0);
+  transform->SetParameters(parameters);
+
+  const auto metric = SerialSelfHessianMetric::New();
+  metric->SetFixedImage(image);
+  metric->SetMovingImage(image);
+  metric->SetFixedImageRegion(image->GetBufferedRegion());
+  metric->SetTransform(transform);
+  metric->SetInterpolator(itk::LinearInterpolateImageFunction<ImageType, double>::New());
+  metric->SetImageSampler(itk::ImageFullSampler<ImageType>::New());
+  metric->SetNumberOfWorkUnits(4);
+  metric->SetUseMultiThread(true);
+  metric->SetNumberOfSamplesForSelfHessian(18000);
+
+  // The serial assembly does not add noise, and the chunks draw their noise differently anyway.
+  metric->SetSelfHessianNoiseRange(0.0);
+  metric->Initialize();
+
+  MetricType::HessianType chunkedSelfHessian;
+  metric->GetSelfHessian(parameters, chunkedSelfHessian);
+
+  MetricType::HessianType serialSelfHessian;
+  metric->GetSerialSelfHessian(parameters, serialSelfHessian);
+
+  ASSERT_EQ(chunkedSelfHessian.rows(), parameters.GetSize());
+  ASSERT_EQ(serialSelfHessian.rows(), parameters.GetSize());
+
+  // The entries are summed in a different order, so they may differ by round-off.
+  unsigned int numberOfNonZeroEntries = 0;
+  for (unsigned int row = 0; row < parameters.GetSize(); ++row)
+  {
+    const auto & chunkedRow = chunkedSelfHessian.get_row(row);
+    const auto & serialRow = serialSelfHessian.get_row(row);
+    ASSERT_EQ(chunkedRow.size(), serialRow.size());
+
+    for (unsigned int i = 0; i < chunkedRow.size(); ++i)
+    {
+      EXPECT_EQ(chunkedRow[i].first, serialRow[i].first);
+      EXPECT_NEAR(chunkedRow[i].second, serialRow[i].second, 1e-10 * (1.0 + std::abs(serialRow[i].second)));
+    }
+    numberOfNonZeroEntries += chunkedRow.size();
+  }
+
+  // Each control point is coupled to several others, so H is far from diagonal.
+  EXPECT_GT(numberOfNonZeroEntries, 4 * parameters.GetSize());
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header files to be tested:
+#include "itkBSplineKernelFunction2.h"
+#include "itkBSplineDerivativeKernelFunction2.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace
+{
+
+// The arguments for which the weights are tested: the fractional part of the
+// Parzen window term, from 0 up to and including 1.
+constexpr std::array<double, 5> fractions{ { 0.0, 0.25, 0.5, 0.75, 1.0 } };
+
+// Returns the argument that the Parzen window histogram metrics pass to
+// FastEvaluate, for the specified fraction: the (non-positive) distance from
+// the first point of the support to the Parzen window term.
+double
+GetParzenWindowArgument(const unsigned int splineOrder, const double fraction)
+{
+  return -(fraction + (static_cast<double>(splineOrder) - 1.0) / 2.0);
+}
+
+
+// Expects that each weight of FastEvaluate equals the scalar Evaluate of the
+// kernel at the corresponding point of the support.
+template <typename TKernel>
+void
+Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point()
+{
+  constexpr unsigned int splineOrder = TKernel::SplineOrder;
+  constexpr unsigned int numberOfWeights = splineOrder + 1;
+
+  const auto kernel = TKernel::New();
+
+  for (const double fraction : fractions)
+  {
+    const double u = GetParzenWindowArgument(splineOrder, fraction);
+
+    std::array<double, numberOfWeights> weights;
+    TKernel::FastEvaluate(u, weights.data());
+
+    for (unsigned int i = 0; i < numberOfWeights; ++i)
+    {
+      EXPECT_NEAR(weights[i], kernel->Evaluate(u + i), 1e-15)
+        << kernel->GetNameOfClass() << " order = " << splineOrder << ", u = " << u << ", i = " << i;
+    }
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(BSplineKernelFunction2, FastEvaluateEqualsScalarEvaluateForEachSupportPoint)
+{
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineKernelFunction2<0>>();
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineKernelFunction2<1>>();
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineKernelFunction2<2>>();
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineKernelFunction2<3>>();
+}
+
+
+GTEST_TEST(BSplineDerivativeKernelFunction2, FastEvaluateEqualsScalarEvaluateForEachSupportPoint)
+{
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineDerivativeKernelFunction2<1>>();
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineDerivativeKernelFunction2<2>>();
+  Expect_FastEvaluate_equals_scalar_Evaluate_for_each_support_point<itk::BSplineDerivativeKernelFunction2<3>>();
+}
@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkBatchDataCache.h"
+
+#include <itkImage.h>
+#include <itkSimpleDataObjectDecorator.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+itk::DataObject::Pointer
+CreateDecoratedInt(const int value)
+{
+  const auto decorator = itk::SimpleDataObjectDecorator<int>::New();
+  decorator->Set(value);
+  return decorator.GetPointer();
+}
+
+
+int
+GetDecoratedInt(const itk::DataObject::Pointer & dataObject)
+{
+  return dynamic_cast<const itk::SimpleDataObjectDecorator<int> &>(*dataObject).Get();
+}
+} // namespace
+
+
+GTEST_TEST(BatchDataCache, CreatesEveryTimeOutsideScope)
+{
+  EXPECT_FALSE(itk::BatchDataCache::IsEnabled());
+
+  unsigned int numberOfCalls = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const auto dataObject = itk::BatchDataCache::GetOrCreate("key", [&numberOfCalls, i] {
+      ++numberOfCalls;
+      return CreateDecoratedInt(i);
+    });
+    EXPECT_EQ(GetDecoratedInt(dataObject), i);
+  }
+  EXPECT_EQ(numberOfCalls, 3u);
+  EXPECT_EQ(itk::BatchDataCache::GetNumberOfEntries(), 0u);
+}
+
+
+GTEST_TEST(BatchDataCache, CreatesOncePerKeyWithinScope)
+{
+  std::atomic<unsigned int> numberOfCalls{ 0 };
+  {
+    const itk::BatchDataCache::Scope scope;
+    EXPECT_TRUE(itk::BatchDataCache::IsEnabled());
+
+    /** Many threads ask for the same two keys at the same time. */
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+      results.push_back(std::async(std::launch::async, [&numberOfCalls, i] {
+        const int value = i % 2;
+        return GetDecoratedInt(itk::BatchDataCache::GetOrCreate("key" + std::to_string(value), [&numberOfCalls, value] {
+          ++numberOfCalls;
+          return CreateDecoratedInt(value);
+        }));
+      }));
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+      EXPECT_EQ(results[i].get(), i % 2);
+    }
+    EXPECT_EQ(numberOfCalls, 2u);
+    EXPECT_EQ(itk::BatchDataCache::GetNumberOfEntries(), 2u);
+  }
+
+  /** The cache is emptied when the scope ends. */
+  EXPECT_FALSE(itk::BatchDataCache::IsEnabled());
+  EXPECT_EQ(itk::BatchDataCache::GetNumberOfEntries(), 0u);
+}
+
+
+GTEST_TEST(BatchDataCache, RethrowsExceptionToEveryCaller)
+{
+  const itk::BatchDataCache::Scope scope;
+
+  unsigned int numberOfCalls = 0;
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_THROW(itk::BatchDataCache::GetOrCreate("failing key",
+                                                  [&numberOfCalls]() -> itk::DataObject::Pointer {
+                                                    ++numberOfCalls;
+                                                    throw std::runtime_error("failure");
+                                                  }),
+                 std::runtime_error);
+  }
+  EXPECT_EQ(numberOfCalls, 1u);
+}
+
+
+GTEST_TEST(BatchDataCache, ImageKeyIdentifiesBufferAndGeometry)
+{
+  using ImageType = itk::Image<float, 2>;
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 4, 5 } });
+  image->Allocate();
+
+  /** A graft shares the buffer, so it has the same key. */
+  const auto graft = ImageType::New();
+  graft->Graft(image);
+  EXPECT_EQ(itk::BatchDataCache::MakeImageKey(graft.GetPointer()),
+            itk::BatchDataCache::MakeImageKey(image.GetPointer()));
+
+  /** Another geometry or another buffer gives another key. */
+  graft->SetSpacing(2.0);
+  EXPECT_NE(itk::BatchDataCache::MakeImageKey(graft.GetPointer()),
+            itk::BatchDataCache::MakeImageKey(image.GetPointer()));
+
+  const auto other = ImageType::New();
+  other->SetRegions(ImageType::SizeType{ { 4, 5 } });
+  other->Allocate();
+  EXPECT_NE(itk::BatchDataCache::MakeImageKey(other.GetPointer()),
+            itk::BatchDataCache::MakeImageKey(image.GetPointer()));
+}
+
+
+GTEST_TEST(BatchDataCache, ImageKeyHoldsPixelContainerDuringBatch)
+{
+  using ImageType = itk::Image<float, 2>;
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 4, 5 } });
+  image->Allocate();
+  const ImageType::PixelContainer::Pointer pixelContainer = image->GetPixelContainer();
+  const auto                               referenceCount = pixelContainer->GetReferenceCount();
+
+  /** Outside a batch, the key does not hold a reference. */
+  const std::string key = itk::BatchDataCache::MakeImageKey(image.GetPointer());
+  EXPECT_EQ(pixelContainer->GetReferenceCount(), referenceCount);
+
+  {
+    const itk::BatchDataCache::Scope scope;
+
+    /** During a batch, the address of the buffer cannot be reused, as the cache holds its container. */
+    EXPECT_EQ(itk::BatchDataCache::MakeImageKey(image.GetPointer()), key);
+    EXPECT_EQ(pixelContainer->GetReferenceCount(), referenceCount + 1);
+  }
+  EXPECT_EQ(pixelContainer->GetReferenceCount(), referenceCount);
+
+  /** A modified pixel container gives another key. */
+  pixelContainer->Modified();
+  EXPECT_NE(itk::BatchDataCache::MakeImageKey(image.GetPointer()), key);
+}
@@ -0,0 +1,157 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkComputePreconditionerUsingDisplacementDistribution.h"
+
+#include "AdvancedMeanSquares/itkAdvancedMeanSquaresImageToImageMetric.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkImageFullSampler.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkLinearInterpolateImageFunction.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace
+{
+constexpr unsigned int ImageDimension = 2;
+using ImageType = itk::Image<float, ImageDimension>;
+using AdvancedTransformType = itk::AdvancedTransform<double, ImageDimension, ImageDimension>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, ImageDimension, 3>;
+using MetricType = itk::AdvancedMeanSquaresImageToImageMetric<ImageType, ImageType>;
+using EstimatorType = itk::ComputePreconditionerUsingDisplacementDistribution<ImageType, AdvancedTransformType>;
+
+
+// Creates a 100x100 image with a smooth blob, centered at the specified index.
+ImageType::Pointer
+CreateBlobImage(const double centerX, const double centerY)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 100, 100 } });
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(static_cast<float>(100.0 * std::exp(-(dx * dx + dy * dy) / 450.0) + 0.1 * it.GetIndex()[0]));
+  }
+  return image;
+}
+
+
+// Creates a B-spline transform with a 7x7 grid over the image, and non-zero parameters.
+BSplineTransformType::Pointer
+CreateBSplineTransform(BSplineTransformType::ParametersType & parameters)
+{
+  const auto                       transform = BSplineTransformType::New();
+  BSplineTransformType::RegionType gridRegion;
+  gridRegion.SetSize(itk::Size<ImageDimension>::Filled(7));
+  BSplineTransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(25.0);
+  BSplineTransformType::OriginType gridOrigin;
+  gridOrigin.Fill(-25.0);
+  transform->SetGridRegion(gridRegion);
+  transform->SetGridSpacing(gridSpacing);
+  transform->SetGridOrigin(gridOrigin);
+
+  parameters.SetSize(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.5 * std::sin(0.7 * i);
+  }
+  transform->SetParameters(parameters);
+  return transform;
+}
+
+} // namespace
+
+
+// Tests that the preconditioner does not depend on the number of work units, for a small B-spline problem.
+GTEST_TEST(ComputePreconditionerUsingDisplacementDistribution, ThreadedEqualsSingleThreaded)
+{
+  BSplineTransformType::ParametersType parameters;
+  const auto                           transform = CreateBSplineTransform(parameters);
+  const auto                           fixedImage = CreateBlobImage(45.0, 52.0);
+
+  const auto metric = MetricType::New();
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(CreateBlobImage(50.0, 48.0));
+  metric->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+  metric->SetTransform(transform);
+  metric->SetInterpolator(itk::LinearInterpolateImageFunction<ImageType, double>::New());
+  metric->SetImageSampler(itk::ImageFullSampler<ImageType>::New());
+  metric->SetUseMultiThread(false);
+  metric->Initialize();
+
+  const auto computePreconditioners = [&](const itk::ThreadIdType numberOfWorkUnits,
+                                          EstimatorType::ParametersType & preconditioner,
+                                          EstimatorType::ParametersType & jacobiTypePreconditioner,
+                                          double &                        maxJJ,
+                                          double &                        jacobiTypeMaxJJ) {
+    const auto estimator = EstimatorType::New();
+    estimator->SetFixedImage(fixedImage);
+    estimator->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+    estimator->SetTransform(transform);
+    estimator->SetCostFunction(metric);
+    estimator->SetNumberOfJacobianMeasurements(5000);
+    estimator->SetUseScales(false);
+    estimator->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+    preconditioner.SetSize(parameters.GetSize());
+    preconditioner.Fill(0.0);
+    estimator->Compute(parameters, maxJJ, preconditioner);
+    jacobiTypePreconditioner.SetSize(parameters.GetSize());
+    jacobiTypePreconditioner.Fill(0.0);
+    estimator->ComputeJacobiTypePreconditioner(parameters, jacobiTypeMaxJJ, jacobiTypePreconditioner);
+  };
+
+  EstimatorType::ParametersType singleThreadedPreconditioner;
+  EstimatorType::ParametersType singleThreadedJacobiTypePreconditioner;
+  double                        singleThreadedMaxJJ{};
+  double                        singleThreadedJacobiTypeMaxJJ{};
+  computePreconditioners(1,
+                         singleThreadedPreconditioner,
+                         singleThreadedJacobiTypePreconditioner,
+                         singleThreadedMaxJJ,
+                         singleThreadedJacobiTypeMaxJJ);
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 2, 3, 8 })
+  {
+    EstimatorType::ParametersType preconditioner;
+    EstimatorType::ParametersType jacobiTypePreconditioner;
+    double                        maxJJ{};
+    double                        jacobiTypeMaxJJ{};
+    computePreconditioners(numberOfWorkUnits, preconditioner, jacobiTypePreconditioner, maxJJ, jacobiTypeMaxJJ);
+
+    EXPECT_EQ(maxJJ, singleThreadedMaxJJ);
+    EXPECT_EQ(jacobiTypeMaxJJ, singleThreadedJacobiTypeMaxJJ);
+    EXPECT_EQ(preconditioner, singleThreadedPreconditioner);
+    EXPECT_EQ(jacobiTypePreconditioner, singleThreadedJacobiTypePreconditioner);
+  }
+
+  // The Jacobian measurements cover several chunks, and the preconditioner is non-trivial.
+  EXPECT_GT(singleThreadedMaxJJ, 0.0);
+  EXPECT_NE(singleThreadedPreconditioner, EstimatorType::ParametersType(parameters.GetSize(), 0.0));
+}
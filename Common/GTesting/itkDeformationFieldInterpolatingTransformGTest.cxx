@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "DeformationFieldTransform/itkDeformationFieldInterpolatingTransform.h"
+
+#include <itkImageRegionIterator.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+
+GTEST_TEST(DeformationFieldInterpolatingTransform, InlinedInterpolationEqualsInterpolator)
+{
+  using TransformType = itk::DeformationFieldInterpolatingTransform<double, 3, float>;
+  using DeformationFieldType = TransformType::DeformationFieldType;
+  using InterpolatorType = TransformType::DeformationFieldInterpolatorType;
+
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<float>  displacementDistribution(-3.0f, 3.0f);
+  std::uniform_real_distribution<double> pointDistribution(-20.0, 40.0);
+
+  /** A deformation field with a non-trivial geometry. */
+  DeformationFieldType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 0.8;
+  spacing[2] = 2.0;
+  DeformationFieldType::PointType origin;
+  origin[0] = -3.0;
+  origin[1] = 1.0;
+  origin[2] = 0.5;
+  DeformationFieldType::DirectionType direction;
+  direction.SetIdentity();
+  direction(0, 0) = std::cos(0.2);
+  direction(0, 1) = -std::sin(0.2);
+  direction(1, 0) = std::sin(0.2);
+  direction(1, 1) = std::cos(0.2);
+
+  const auto field = DeformationFieldType::New();
+  field->SetRegions(DeformationFieldType::RegionType(DeformationFieldType::IndexType{ { 2, -1, 0 } },
+                                                    DeformationFieldType::SizeType{ { 11, 14, 9 } }));
+  field->SetSpacing(spacing);
+  field->SetOrigin(origin);
+  field->SetDirection(direction);
+  field->Allocate();
+
+  itk::ImageRegionIterator<DeformationFieldType> it(field, field->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    TransformType::DeformationFieldVectorType displacement;
+    for (auto & component : displacement)
+    {
+      component = displacementDistribution(randomNumberEngine);
+    }
+    it.Set(displacement);
+  }
+
+  for (const bool linear : { false, true })
+  {
+    /** The interpolator of the transform, and a separate one for the expected displacement. */
+    InterpolatorType::Pointer interpolator;
+    InterpolatorType::Pointer expectedInterpolator;
+    if (linear)
+    {
+      interpolator = TransformType::LinearDeformationFieldInterpolatorType::New();
+      expectedInterpolator = TransformType::LinearDeformationFieldInterpolatorType::New();
+    }
+    else
+    {
+      interpolator = TransformType::DefaultDeformationFieldInterpolatorType::New();
+      expectedInterpolator = TransformType::DefaultDeformationFieldInterpolatorType::New();
+    }
+    expectedInterpolator->SetInputImage(field);
+
+    const auto transform = TransformType::New();
+    transform->SetDeformationField(field);
+    transform->SetDeformationFieldInterpolator(interpolator);
+    ASSERT_TRUE(transform->GetUseInlinedInterpolation());
+
+    /** Random points, both inside and outside the deformation field. */
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+      TransformType::InputPointType point;
+      for (auto & coordinate : point)
+      {
+        coordinate = pointDistribution(randomNumberEngine);
+      }
+
+      TransformType::OutputPointType        expectedPoint = point;
+      InterpolatorType::ContinuousIndexType cindex;
+      expectedInterpolator->ConvertPointToContinuousIndex(point, cindex);
+      if (expectedInterpolator->IsInsideBuffer(cindex))
+      {
+        const auto displacement = expectedInterpolator->EvaluateAtContinuousIndex(cindex);
+        for (unsigned int d = 0; d < 3; ++d)
+        {
+          expectedPoint[d] += displacement[d];
+        }
+      }
+
+      const auto actualPoint = transform->TransformPoint(point);
+      for (unsigned int d = 0; d < 3; ++d)
+      {
+        EXPECT_DOUBLE_EQ(actualPoint[d], expectedPoint[d]);
+      }
+    }
+  }
+}
+
+
+GTEST_TEST(DeformationFieldInterpolatingTransform, IdentityByDefault)
+{
+  using TransformType = itk::DeformationFieldInterpolatingTransform<double, 2, float>;
+
+  const auto transform = TransformType::New();
+  EXPECT_TRUE(transform->GetUseInlinedInterpolation());
+
+  TransformType::InputPointType point;
+  point[0] = 1.5;
+  point[1] = -2.5;
+  EXPECT_EQ(transform->TransformPoint(point), point);
+}
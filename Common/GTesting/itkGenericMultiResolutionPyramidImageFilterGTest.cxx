@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkGenericMultiResolutionPyramidImageFilter.h"
+
+#include <itkImage.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // For minmax_element.
+#include <cmath>
+
+
+// Tests that the cascaded pyramid yields the same geometry as the non-cascaded
+// reference pyramid, and approximately the same pixel values, for an image
+// that is the sum of a ramp and a sinusoid. The values differ slightly, because
+// the cascade uses a truncated, sampled Gaussian instead of the recursive one.
+GTEST_TEST(GenericMultiResolutionPyramidImageFilter, CascadeApproximatesReferencePyramid)
+{
+  using ImageType = itk::Image<float, 2>;
+  using PyramidType = itk::GenericMultiResolutionPyramidImageFilter<ImageType, ImageType>;
+  constexpr unsigned int numberOfLevels = 3;
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 2.0;
+  ImageType::PointType origin;
+  origin[0] = -3.0;
+  origin[1] = 5.0;
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 40, 33 } });
+  image->SetSpacing(spacing);
+  image->SetOrigin(origin);
+  image->Allocate();
+
+  const double pi = 3.14159265358979323846;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const double x = static_cast<double>(it.GetIndex()[0]);
+    const double y = static_cast<double>(it.GetIndex()[1]);
+    it.Set(static_cast<float>(0.5 * x + 0.25 * y + 10.0 * std::sin(2.0 * pi * x / 16.0) +
+                              5.0 * std::cos(2.0 * pi * y / 16.0)));
+  }
+
+  for (const bool useShrinkImageFilter : { false, true })
+  {
+    const auto referencePyramid = PyramidType::New();
+    referencePyramid->SetInput(image);
+    referencePyramid->SetNumberOfLevels(numberOfLevels);
+    referencePyramid->SetUseShrinkImageFilter(useShrinkImageFilter);
+    referencePyramid->Update();
+
+    const auto cascadedPyramid = PyramidType::New();
+    cascadedPyramid->SetInput(image);
+    cascadedPyramid->SetNumberOfLevels(numberOfLevels);
+    cascadedPyramid->SetUseShrinkImageFilter(useShrinkImageFilter);
+    cascadedPyramid->SetUseCascade(true);
+    cascadedPyramid->Update();
+
+    for (unsigned int level = 0; level < numberOfLevels; ++level)
+    {
+      const ImageType * const expected = referencePyramid->GetOutput(level);
+      const ImageType * const actual = cascadedPyramid->GetOutput(level);
+
+      ASSERT_EQ(actual->GetBufferedRegion(), expected->GetBufferedRegion());
+      EXPECT_EQ(actual->GetSpacing(), expected->GetSpacing());
+      EXPECT_EQ(actual->GetOrigin(), expected->GetOrigin());
+
+      // Allow a difference of 5 percent of the range of the reference values.
+      const float * const expectedBuffer = expected->GetBufferPointer();
+      const auto          numberOfPixels = expected->GetBufferedRegion().GetNumberOfPixels();
+      const auto          minmax = std::minmax_element(expectedBuffer, expectedBuffer + numberOfPixels);
+      const double        tolerance = 0.05 * (*minmax.second - *minmax.first);
+
+      itk::ImageRegionConstIterator<ImageType> expectedIt(expected, expected->GetBufferedRegion());
+      itk::ImageRegionConstIterator<ImageType> actualIt(actual, actual->GetBufferedRegion());
+      for (; !actualIt.IsAtEnd(); ++actualIt, ++expectedIt)
+      {
+        EXPECT_NEAR(actualIt.Get(), expectedIt.Get(), tolerance)
+          << "level = " << level << ", shrink = " << useShrinkImageFilter << ", index = " << actualIt.GetIndex();
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkMemoryMappedImageContainer.h"
+
+#include <itkImage.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+
+#include <gtest/gtest.h>
+
+
+GTEST_TEST(MemoryMappedImageContainer, ImageKeepsItsPixels)
+{
+  using ImageType = itk::Image<float, 3>;
+  using PixelContainerType = itk::MemoryMappedImageContainer<itk::SizeValueType, float>;
+
+  const ImageType::RegionType region(ImageType::IndexType{ { 2, -1, 0 } }, ImageType::SizeType{ { 17, 9, 5 } });
+
+  const auto pixelContainer = PixelContainerType::New();
+  pixelContainer->MapTemporaryFile(".", region.GetNumberOfPixels());
+  ASSERT_TRUE(pixelContainer->GetIsMemoryMapped());
+
+  const auto image = ImageType::New();
+  image->SetRegions(region);
+  image->SetPixelContainer(pixelContainer);
+  EXPECT_EQ(image->GetPixelContainer()->Size(), region.GetNumberOfPixels());
+
+  /** Allocate() on the same region keeps the mapped memory. */
+  image->Allocate();
+  EXPECT_EQ(image->GetPixelContainer(), pixelContainer.GetPointer());
+
+  float value = 0.0f;
+  for (itk::ImageRegionIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value += 0.5f;
+  }
+
+  value = 0.0f;
+  for (itk::ImageRegionConstIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    EXPECT_EQ(it.Get(), value);
+    value += 0.5f;
+  }
+}
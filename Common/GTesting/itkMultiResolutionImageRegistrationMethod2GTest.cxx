@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkMultiResolutionImageRegistrationMethod2.h"
+
+#include "itkAdvancedTranslationTransform.h"
+
+#include <itkImage.h>
+#include <itkImageBufferRange.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+constexpr unsigned int ImageDimension = 2;
+using ImageType = itk::Image<float, ImageDimension>;
+using RegistrationMethodType = itk::MultiResolutionImageRegistrationMethod2<ImageType, ImageType>;
+
+
+/** Gives the tests access to the protected PreparePyramids(). */
+class PyramidPreparingRegistrationMethod : public RegistrationMethodType
+{
+public:
+  typedef PyramidPreparingRegistrationMethod Self;
+  typedef RegistrationMethodType             Superclass;
+  typedef itk::SmartPointer<Self>            Pointer;
+  typedef itk::SmartPointer<const Self>      ConstPointer;
+
+  itkNewMacro(Self);
+
+  using Superclass::PreparePyramids;
+
+protected:
+  PyramidPreparingRegistrationMethod() = default;
+  ~PyramidPreparingRegistrationMethod() override = default;
+};
+
+
+ImageType::Pointer
+CreateImage(const double centerX, const double centerY)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 97, 83 } });
+  image->Allocate();
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.2;
+  image->SetSpacing(spacing);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(static_cast<float>(100.0 * std::exp(-(dx * dx + dy * dy) / 300.0) + 0.1 * it.GetIndex()[0]));
+  }
+  return image;
+}
+
+
+/** Prepares the pyramids of the specified images, concurrently or serially, and returns the
+ * registration method, which holds on to the pyramids.
+ */
+PyramidPreparingRegistrationMethod::Pointer
+CreateMethodWithPreparedPyramids(const ImageType * const fixedImage,
+                                 const ImageType * const movingImage,
+                                 const bool              computePyramidsConcurrently)
+{
+  const auto transform = itk::AdvancedTranslationTransform<double, ImageDimension>::New();
+  const auto method = PyramidPreparingRegistrationMethod::New();
+
+  method->SetFixedImage(fixedImage);
+  method->SetMovingImage(movingImage);
+  method->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+  method->SetTransform(transform);
+  method->SetInitialTransformParameters(transform->GetParameters());
+  method->SetFixedImagePyramid(RegistrationMethodType::FixedImagePyramidType::New());
+  method->SetMovingImagePyramid(RegistrationMethodType::MovingImagePyramidType::New());
+  method->SetNumberOfLevels(3);
+  method->SetComputePyramidsConcurrently(computePyramidsConcurrently);
+  method->PreparePyramids();
+  return method;
+}
+
+
+void
+ExpectEqualImages(const ImageType & actualImage, const ImageType & expectedImage)
+{
+  EXPECT_EQ(actualImage.GetBufferedRegion(), expectedImage.GetBufferedRegion());
+  EXPECT_EQ(actualImage.GetSpacing(), expectedImage.GetSpacing());
+  EXPECT_EQ(actualImage.GetOrigin(), expectedImage.GetOrigin());
+
+  const itk::ImageBufferRange<const ImageType> actualPixels(actualImage);
+  const itk::ImageBufferRange<const ImageType> expectedPixels(expectedImage);
+  ASSERT_EQ(actualPixels.size(), expectedPixels.size());
+  EXPECT_TRUE(std::equal(actualPixels.cbegin(), actualPixels.cend(), expectedPixels.cbegin()));
+}
+
+} // namespace
+
+
+// Tests that the fixed and moving image pyramids computed concurrently equal those computed serially.
+GTEST_TEST(MultiResolutionImageRegistrationMethod2, ConcurrentPyramidsEqualSerialPyramids)
+{
+  const auto fixedImage = CreateImage(40.0, 45.0);
+  const auto movingImage = CreateImage(47.0, 38.0);
+
+  const auto concurrentMethod = CreateMethodWithPreparedPyramids(fixedImage, movingImage, true);
+  const auto serialMethod = CreateMethodWithPreparedPyramids(fixedImage, movingImage, false);
+
+  for (unsigned int level = 0; level < 3; ++level)
+  {
+    ExpectEqualImages(*concurrentMethod->GetFixedImagePyramid()->GetOutput(level),
+                      *serialMethod->GetFixedImagePyramid()->GetOutput(level));
+    ExpectEqualImages(*concurrentMethod->GetMovingImagePyramid()->GetOutput(level),
+                      *serialMethod->GetMovingImagePyramid()->GetOutput(level));
+  }
+
+  // The coarsest levels are actually downsampled, and the fixed and moving pyramids differ.
+  const ImageType & coarsestFixedImage = *concurrentMethod->GetFixedImagePyramid()->GetOutput(0);
+  const ImageType & coarsestMovingImage = *concurrentMethod->GetMovingImagePyramid()->GetOutput(0);
+  EXPECT_LT(coarsestFixedImage.GetBufferedRegion().GetNumberOfPixels(),
+            fixedImage->GetBufferedRegion().GetNumberOfPixels());
+  EXPECT_FALSE(std::equal(itk::ImageBufferRange<const ImageType>(coarsestFixedImage).cbegin(),
+                          itk::ImageBufferRange<const ImageType>(coarsestFixedImage).cend(),
+                          itk::ImageBufferRange<const ImageType>(coarsestMovingImage).cbegin()));
+
+  // The input images must be left as they are.
+  ExpectEqualImages(*fixedImage, *CreateImage(40.0, 45.0));
+  ExpectEqualImages(*movingImage, *CreateImage(47.0, 38.0));
+}
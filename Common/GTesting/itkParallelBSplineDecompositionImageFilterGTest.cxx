@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkParallelBSplineDecompositionImageFilter.h"
+
+#include "itkParallelBSplineInterpolateImageFunction.h"
+
+#include <itkBSplineDecompositionImageFilter.h>
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+
+namespace
+{
+using ImageType = itk::Image<double, 3>;
+
+/** Creates an image of random values, with an odd size, a size larger than
+ * the horizon of the causal initialization, and a dimension of size 1. */
+ImageType::Pointer
+CreateRandomImage()
+{
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 9, 37, 1 } });
+  image->Allocate();
+
+  itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    it.Set(distribution(randomNumberEngine));
+  }
+  return image;
+}
+
+} // namespace
+
+
+GTEST_TEST(ParallelBSplineDecompositionImageFilter, GivesSameCoefficientsAsBSplineDecompositionImageFilter)
+{
+  using FilterType = itk::ParallelBSplineDecompositionImageFilter<ImageType, ImageType>;
+  using ExpectedFilterType = itk::BSplineDecompositionImageFilter<ImageType, ImageType>;
+
+  const auto image = CreateRandomImage();
+
+  for (unsigned int splineOrder = 0; splineOrder <= 5; ++splineOrder)
+  {
+    const auto expectedFilter = ExpectedFilterType::New();
+    expectedFilter->SetSplineOrder(splineOrder);
+    expectedFilter->SetInput(image);
+    expectedFilter->Update();
+
+    /** A small block size, so that the last block of lines is partial. */
+    const auto filter = FilterType::New();
+    filter->SetSplineOrder(splineOrder);
+    filter->SetBlockSize(4);
+    filter->SetInput(image);
+    filter->Update();
+
+    const auto expectedOutput = expectedFilter->GetOutput();
+    const auto output = filter->GetOutput();
+    ASSERT_EQ(output->GetBufferedRegion(), expectedOutput->GetBufferedRegion());
+
+    itk::ImageRegionConstIterator<ImageType> expectedIt(expectedOutput, expectedOutput->GetBufferedRegion());
+    itk::ImageRegionConstIterator<ImageType> it(output, output->GetBufferedRegion());
+    for (; !it.IsAtEnd(); ++it, ++expectedIt)
+    {
+      EXPECT_NEAR(it.Get(), expectedIt.Get(), 1e-10);
+    }
+  }
+}
+
+
+GTEST_TEST(ParallelBSplineDecompositionImageFilter, ThrowsOnUnsupportedSplineOrder)
+{
+  using FilterType = itk::ParallelBSplineDecompositionImageFilter<ImageType, ImageType>;
+
+  const auto filter = FilterType::New();
+  EXPECT_THROW(filter->SetSplineOrder(6), itk::ExceptionObject);
+  EXPECT_THROW(filter->SetSplineOrder(1, 6), itk::ExceptionObject);
+  EXPECT_EQ(filter->GetSplineOrder(1), 3u);
+}
+
+
+GTEST_TEST(ParallelBSplineInterpolateImageFunction, EvaluatesLikeBSplineInterpolateImageFunction)
+{
+  using InterpolatorType = itk::ParallelBSplineInterpolateImageFunction<ImageType>;
+  using ExpectedInterpolatorType = itk::BSplineInterpolateImageFunction<ImageType>;
+
+  const auto image = CreateRandomImage();
+
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+  for (unsigned int splineOrder = 1; splineOrder <= 5; ++splineOrder)
+  {
+    const auto expectedInterpolator = ExpectedInterpolatorType::New();
+    expectedInterpolator->SetSplineOrder(splineOrder);
+    expectedInterpolator->SetInputImage(image);
+
+    const auto interpolator = InterpolatorType::New();
+    interpolator->SetSplineOrder(splineOrder);
+    interpolator->SetInputImage(image);
+
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+      InterpolatorType::ContinuousIndexType index;
+      index[0] = 8.0 * distribution(randomNumberEngine);
+      index[1] = 36.0 * distribution(randomNumberEngine);
+      index[2] = 0.0;
+
+      EXPECT_NEAR(interpolator->EvaluateAtContinuousIndex(index),
+                  expectedInterpolator->EvaluateAtContinuousIndex(index),
+                  1e-10);
+    }
+  }
+}
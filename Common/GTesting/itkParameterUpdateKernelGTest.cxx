@@ -0,0 +1,190 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkParameterUpdateKernel.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+
+namespace
+{
+using KernelType = itk::ParameterUpdateKernel;
+using VectorType = KernelType::VectorType;
+
+/** A number of parameters that spans several blocks, with a partial last block. */
+constexpr unsigned int NumberOfParameters = 10 * KernelType::BlockSize + 123;
+
+
+VectorType
+MakeVector(const double offset, const unsigned int numberOfParameters = NumberOfParameters)
+{
+  VectorType vector(numberOfParameters);
+  for (unsigned int j = 0; j < numberOfParameters; ++j)
+  {
+    vector[j] = std::sin(offset + 0.001 * j);
+  }
+  return vector;
+}
+
+
+/** Returns a kernel that runs on one work unit, or on several. */
+KernelType::Pointer
+MakeKernel(const bool threaded)
+{
+  const auto kernel = KernelType::New();
+  kernel->SetNumberOfWorkUnits(threaded ? 4 : 1);
+  kernel->SetMinimumNumberOfParametersPerWorkUnit(KernelType::BlockSize);
+  return kernel;
+}
+} // namespace
+
+
+GTEST_TEST(ParameterUpdateKernel, Step)
+{
+  for (const bool threaded : { false, true })
+  {
+    VectorType       position = MakeVector(1.0);
+    const VectorType direction = MakeVector(2.0);
+
+    VectorType expectedPosition = position;
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      expectedPosition[j] -= 0.5 * direction[j];
+    }
+
+    MakeKernel(threaded)->Step(position, -0.5, direction);
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      ASSERT_EQ(position[j], expectedPosition[j]);
+    }
+  }
+}
+
+
+GTEST_TEST(ParameterUpdateKernel, PreconditionedStep)
+{
+  for (const bool threaded : { false, true })
+  {
+    VectorType       position = MakeVector(1.0);
+    const VectorType preconditioner = MakeVector(2.0);
+    const VectorType gradient = MakeVector(3.0);
+    VectorType       searchDirection;
+
+    VectorType expectedPosition = position;
+    VectorType expectedSearchDirection(NumberOfParameters);
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      expectedSearchDirection[j] = preconditioner[j] * gradient[j];
+      expectedPosition[j] -= 0.5 * expectedSearchDirection[j];
+    }
+
+    MakeKernel(threaded)->PreconditionedStep(position, -0.5, preconditioner, gradient, searchDirection);
+    ASSERT_EQ(searchDirection.GetSize(), NumberOfParameters);
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      ASSERT_EQ(searchDirection[j], expectedSearchDirection[j]);
+      ASSERT_EQ(position[j], expectedPosition[j]);
+    }
+  }
+}
+
+
+GTEST_TEST(ParameterUpdateKernel, AdaptiveStep)
+{
+  for (const bool threaded : { false, true })
+  {
+    VectorType       position = MakeVector(1.0);
+    VectorType       squaredGradientSum = MakeVector(2.0);
+    const VectorType gradient = MakeVector(3.0);
+    VectorType       searchDirection(NumberOfParameters);
+
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      squaredGradientSum[j] *= squaredGradientSum[j];
+    }
+    VectorType expectedPosition = position;
+    VectorType expectedSquaredGradientSum = squaredGradientSum;
+    VectorType expectedSearchDirection(NumberOfParameters);
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      expectedSquaredGradientSum[j] += gradient[j] * gradient[j];
+      expectedSearchDirection[j] = gradient[j] / std::sqrt(expectedSquaredGradientSum[j] + 1e-14);
+      expectedPosition[j] -= 0.5 * expectedSearchDirection[j];
+    }
+
+    MakeKernel(threaded)->AdaptiveStep(position, -0.5, squaredGradientSum, gradient, searchDirection, 1e-14);
+    for (unsigned int j = 0; j < NumberOfParameters; ++j)
+    {
+      ASSERT_EQ(squaredGradientSum[j], expectedSquaredGradientSum[j]);
+      ASSERT_EQ(searchDirection[j], expectedSearchDirection[j]);
+      ASSERT_EQ(position[j], expectedPosition[j]);
+    }
+  }
+}
+
+
+GTEST_TEST(ParameterUpdateKernel, InnerProductAndAssignDoesNotDependOnNumberOfWorkUnits)
+{
+  const VectorType current = MakeVector(2.0);
+  const VectorType next = MakeVector(3.0);
+
+  VectorType   serialPrevious = MakeVector(1.0);
+  const double expectedInnerProduct = inner_product(serialPrevious, current);
+  const double serialInnerProduct = MakeKernel(false)->InnerProductAndAssign(serialPrevious, current, next);
+  EXPECT_NEAR(serialInnerProduct, expectedInnerProduct, 1e-9 * std::abs(expectedInnerProduct));
+  EXPECT_EQ(serialPrevious, next);
+
+  for (const unsigned int numberOfWorkUnits : { 2, 3, 4, 7 })
+  {
+    const auto kernel = MakeKernel(true);
+    kernel->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+    VectorType previous = MakeVector(1.0);
+    EXPECT_EQ(kernel->InnerProductAndAssign(previous, current, next), serialInnerProduct);
+    EXPECT_EQ(previous, next);
+  }
+
+  /** The vector that is assigned may be the same as the current vector. */
+  VectorType previous = MakeVector(1.0);
+  MakeKernel(true)->InnerProductAndAssign(previous, current, current);
+  EXPECT_EQ(previous, current);
+}
+
+
+GTEST_TEST(ParameterUpdateKernel, SmallUpdatesMatchPlainLoop)
+{
+  /** Below one block, the inner product is summed in the same order as inner_product(). */
+  VectorType       previous = MakeVector(1.0, 100);
+  const VectorType current = MakeVector(2.0, 100);
+  const double expectedInnerProduct = inner_product(previous, current);
+  EXPECT_EQ(KernelType::New()->InnerProductAndAssign(previous, current, current), expectedInnerProduct);
+}
+
+
+GTEST_TEST(ParameterUpdateKernel, ThrowsOnSizeMismatch)
+{
+  const auto kernel = KernelType::New();
+  VectorType position = MakeVector(1.0, 10);
+  VectorType previous = MakeVector(1.0, 11);
+
+  EXPECT_THROW(kernel->Step(position, 1.0, MakeVector(2.0, 9)), itk::ExceptionObject);
+  EXPECT_THROW(kernel->InnerProductAndAssign(previous, position, position), itk::ExceptionObject);
+}
@@ -0,0 +1,76 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkPerformanceTelemetry.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+
+GTEST_TEST(PerformanceTelemetry, CollectReturnsSortedStatisticsAndResets)
+{
+  const auto telemetry = itk::PerformanceTelemetry::New();
+
+  telemetry->AddCount("B.Samples", 10);
+  telemetry->AddCount("B.Samples", 5);
+  telemetry->AddTime("A.Update", 0.5);
+  telemetry->AddTime("A.Update", 0.25);
+
+  const auto statistics = telemetry->Collect();
+  ASSERT_EQ(statistics.size(), 2u);
+  EXPECT_EQ(statistics[0].m_Name, "A.Update");
+  EXPECT_TRUE(statistics[0].m_IsTimer);
+  EXPECT_EQ(statistics[0].m_Count, 2u);
+  EXPECT_DOUBLE_EQ(statistics[0].m_Seconds, 0.75);
+  EXPECT_EQ(statistics[1].m_Name, "B.Samples");
+  EXPECT_FALSE(statistics[1].m_IsTimer);
+  EXPECT_EQ(itk::PerformanceTelemetry::GetCount(statistics, "B.Samples"), 15u);
+  EXPECT_EQ(itk::PerformanceTelemetry::GetCount(statistics, "C.Missing"), 0u);
+
+  /** The next collection only has what was added since. */
+  telemetry->AddCount("B.Samples", 1);
+  auto total = statistics;
+  itk::PerformanceTelemetry::Accumulate(total, telemetry->Collect());
+  EXPECT_EQ(itk::PerformanceTelemetry::GetCount(total, "B.Samples"), 16u);
+  EXPECT_EQ(itk::PerformanceTelemetry::GetCount(total, "A.Update"), 2u);
+
+  std::ostringstream os;
+  itk::PerformanceTelemetry::WriteJSON(os, total);
+  EXPECT_EQ(os.str(), "{\"A.Update\":{\"count\":2,\"timeMs\":750},\"B.Samples\":16}");
+}
+
+
+GTEST_TEST(PerformanceTelemetry, ScopedTimerWithoutTelemetryDoesNothing)
+{
+  {
+    const itk::PerformanceTelemetry::ScopedTimer timer(nullptr, "Nothing");
+  }
+
+  const auto telemetry = itk::PerformanceTelemetry::New();
+  {
+    const itk::PerformanceTelemetry::ScopedTimer timer(telemetry, "Scope");
+  }
+  const auto statistics = telemetry->Collect();
+  ASSERT_EQ(statistics.size(), 1u);
+  EXPECT_TRUE(statistics[0].m_IsTimer);
+  EXPECT_EQ(statistics[0].m_Count, 1u);
+  EXPECT_GE(statistics[0].m_Seconds, 0.0);
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkRasterizedMask.h"
+
+#include <itkEllipseSpatialObject.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkImageMaskSpatialObject.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+GTEST_TEST(RasterizedMask, IsInsideEqualsIsInsideInWorldSpaceOfImageMask)
+{
+  using RasterizedMaskType = itk::RasterizedMask<2>;
+  using MaskSpatialObjectType = RasterizedMaskType::ImageMaskSpatialObjectType;
+  using MaskImageType = RasterizedMaskType::MaskImageType;
+
+  /** A mask with a non-trivial geometry: a disk, plus some isolated voxels, so
+   * that the occupancy grid has empty, full and mixed blocks.
+   */
+  MaskImageType::SpacingType spacing;
+  spacing[0] = 0.7;
+  spacing[1] = 1.3;
+  MaskImageType::PointType origin;
+  origin[0] = -12.0;
+  origin[1] = 4.5;
+  MaskImageType::DirectionType direction;
+  direction(0, 0) = std::cos(0.3);
+  direction(0, 1) = -std::sin(0.3);
+  direction(1, 0) = std::sin(0.3);
+  direction(1, 1) = std::cos(0.3);
+
+  const auto maskImage = MaskImageType::New();
+  maskImage->SetRegions(MaskImageType::RegionType(MaskImageType::IndexType{ { 3, -2 } },
+                                                  MaskImageType::SizeType{ { 45, 38 } }));
+  maskImage->SetSpacing(spacing);
+  maskImage->SetOrigin(origin);
+  maskImage->SetDirection(direction);
+  maskImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<MaskImageType> it(maskImage, maskImage->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const auto   index = it.GetIndex();
+    const double dx = index[0] - 25.0;
+    const double dy = index[1] - 17.0;
+    const bool   inDisk = dx * dx + dy * dy < 14.0 * 14.0;
+    const bool   isolated = (index[0] % 11 == 0) && (index[1] % 7 == 0);
+    it.Set((inDisk || isolated) ? 1 : 0);
+  }
+
+  const auto maskSpatialObject = MaskSpatialObjectType::New();
+  maskSpatialObject->SetImage(maskImage);
+  maskSpatialObject->Update();
+
+  const auto rasterizedMask = RasterizedMaskType::New();
+  rasterizedMask->SetMask(maskSpatialObject);
+  ASSERT_TRUE(rasterizedMask->GetIsRasterized());
+
+  /** Compare with IsInsideInWorldSpace, at random points in and around the mask. */
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> distribution(-30.0, 60.0);
+
+  std::vector<RasterizedMaskType::PointType> points(10000);
+  for (auto & point : points)
+  {
+    point[0] = distribution(randomNumberEngine);
+    point[1] = distribution(randomNumberEngine);
+    EXPECT_EQ(rasterizedMask->IsInside(point), maskSpatialObject->IsInsideInWorldSpace(point));
+  }
+
+  /** The batched lookup must give the same result. */
+  std::unique_ptr<bool[]> inside(new bool[points.size()]);
+  rasterizedMask->IsInside(points.data(), points.size(), inside.get());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    EXPECT_EQ(inside[i], rasterizedMask->IsInside(points[i]));
+  }
+}
+
+
+GTEST_TEST(RasterizedMask, FallsBackOnNonImageMask)
+{
+  using RasterizedMaskType = itk::RasterizedMask<2>;
+  using EllipseType = itk::EllipseSpatialObject<2>;
+
+  const auto ellipse = EllipseType::New();
+  ellipse->SetRadiusInObjectSpace(5.0);
+  ellipse->Update();
+
+  const auto rasterizedMask = RasterizedMaskType::New();
+  rasterizedMask->SetMask(ellipse);
+  EXPECT_FALSE(rasterizedMask->GetIsRasterized());
+
+  RasterizedMaskType::PointType point;
+  point.Fill(1.0);
+  EXPECT_TRUE(rasterizedMask->IsInside(point));
+  point.Fill(10.0);
+  EXPECT_FALSE(rasterizedMask->IsInside(point));
+}
+
+
+GTEST_TEST(RasterizedMask, RasterizesAgainWhenMaskImageIsModifiedInPlace)
+{
+  using RasterizedMaskType = itk::RasterizedMask<2>;
+  using MaskSpatialObjectType = RasterizedMaskType::ImageMaskSpatialObjectType;
+  using MaskImageType = RasterizedMaskType::MaskImageType;
+
+  const auto maskImage = MaskImageType::New();
+  maskImage->SetRegions(MaskImageType::SizeType{ { 10, 10 } });
+  maskImage->Allocate(true);
+  maskImage->SetPixel({ { 2, 2 } }, 1);
+
+  const auto maskSpatialObject = MaskSpatialObjectType::New();
+  maskSpatialObject->SetImage(maskImage);
+  maskSpatialObject->Update();
+
+  const auto rasterizedMask = RasterizedMaskType::New();
+  rasterizedMask->SetMask(maskSpatialObject);
+
+  RasterizedMaskType::PointType point;
+  point[0] = 4.0;
+  point[1] = 5.0;
+  EXPECT_FALSE(rasterizedMask->IsInside(point));
+
+  /** Modify the mask image in place, and let the mask know. */
+  maskImage->SetPixel({ { 4, 5 } }, 1);
+  maskImage->Modified();
+
+  rasterizedMask->Update();
+  EXPECT_TRUE(rasterizedMask->IsInside(point));
+
+  /** Calling SetMask again with the same, modified mask has the same effect. */
+  maskImage->SetPixel({ { 4, 5 } }, 0);
+  maskImage->Modified();
+
+  rasterizedMask->SetMask(maskSpatialObject);
+  EXPECT_FALSE(rasterizedMask->IsInside(point));
+}
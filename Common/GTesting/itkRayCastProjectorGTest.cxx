@@ -0,0 +1,427 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkRayCastProjector.h"
+
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedEuler3DTransform.h"
+#include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkRayCastResampleImageFilter.h"
+#include "itkRecursiveBSplineTransform.h"
+
+#include <itkEuler3DTransform.h>
+#include <itkImage.h>
+#include <itkImageBufferRange.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkRayCastInterpolateImageFunction.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+using VolumeType = itk::Image<short, 3>;
+using ProjectorType = itk::RayCastProjector<VolumeType, double>;
+using InterpolatorType = itk::AdvancedRayCastInterpolateImageFunction<VolumeType, double>;
+using DetectorType = itk::Image<float, 3>;
+
+VolumeType::Pointer
+CreateConstantVolume(const short value)
+{
+  const auto volume = VolumeType::New();
+  volume->SetRegions(VolumeType::SizeType{ { 20, 20, 20 } });
+  volume->Allocate();
+  volume->FillBuffer(value);
+  return volume;
+}
+
+
+/** Creates a 20x24x18 volume with anisotropic spacing, centred on the origin. */
+VolumeType::Pointer
+CreateNonConstantVolume()
+{
+  const auto volume = VolumeType::New();
+  volume->SetRegions(VolumeType::SizeType{ { 20, 24, 18 } });
+  VolumeType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 0.8;
+  spacing[2] = 1.2;
+  volume->SetSpacing(spacing);
+
+  VolumeType::PointType origin;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    origin[i] = -0.5 * (volume->GetLargestPossibleRegion().GetSize(i) - 1) * spacing[i];
+  }
+  volume->SetOrigin(origin);
+  volume->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<VolumeType> it(volume, volume->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto index = it.GetIndex();
+    it.Set(static_cast<short>((7 * index[0] + 3 * index[1] + 5 * index[2]) % 50 + index[0] * index[2] / 10));
+  }
+  return volume;
+}
+
+
+/** Returns the point on the detector plane z = -30 that the ray from the focal point through the given point hits. */
+ProjectorType::PointType
+ProjectOnDetectorPlane(const ProjectorType::PointType & focalPoint, const ProjectorType::PointType & point)
+{
+  const double scale = (-30.0 - focalPoint[2]) / (point[2] - focalPoint[2]);
+  return focalPoint + (point - focalPoint) * scale;
+}
+
+
+/** Creates a 41x41 detector on the plane z = -30, of which the four corner pixels lie on the rays from the focal point
+ * through the four corners of the face z = faceZ of the volume of CreateNonConstantVolume(). The pixels along the
+ * borders of the detector lie on the rays through the edges of that face, and those of the middle row and column on
+ * the rays through the midpoints of its edges.
+ */
+DetectorType::Pointer
+CreateDetectorThroughCorners(const ProjectorType::PointType & focalPoint, const double faceZ)
+{
+  /** The projector places the volume with its extent centred on the origin. */
+  ProjectorType::PointType firstCorner;
+  firstCorner[0] = -10.0;
+  firstCorner[1] = -9.6;
+  firstCorner[2] = faceZ;
+  ProjectorType::PointType lastCorner = firstCorner;
+  lastCorner[0] = 10.0;
+  lastCorner[1] = 9.6;
+  const auto firstPixel = ProjectOnDetectorPlane(focalPoint, firstCorner);
+  const auto lastPixel = ProjectOnDetectorPlane(focalPoint, lastCorner);
+
+  const auto detector = DetectorType::New();
+  detector->SetRegions(DetectorType::SizeType{ { 41, 41, 1 } });
+  DetectorType::SpacingType spacing;
+  spacing[0] = (lastPixel[0] - firstPixel[0]) / 40.0;
+  spacing[1] = (lastPixel[1] - firstPixel[1]) / 40.0;
+  spacing[2] = 1.0;
+  detector->SetSpacing(spacing);
+  detector->SetOrigin(firstPixel);
+  detector->Allocate();
+  return detector;
+}
+
+
+/** Expects that each pixel of the projection equals the per-ray evaluation of the interpolator at the position of the
+ * pixel, mapped by the transform, as ResampleImageFilter does for each output pixel.
+ */
+void
+ExpectProjectionEqualsPerRayEvaluation(InterpolatorType & interpolator, DetectorType & detector)
+{
+  detector.FillBuffer(-1.0f);
+  interpolator.GenerateProjection(&detector);
+
+  unsigned int numberOfNonZeroPixels = 0;
+  for (itk::ImageRegionIteratorWithIndex<DetectorType> it(&detector, detector.GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    DetectorType::PointType detectorPoint;
+    detector.TransformIndexToPhysicalPoint(it.GetIndex(), detectorPoint);
+    const auto expected =
+      static_cast<float>(interpolator.Evaluate(interpolator.GetTransform()->TransformPoint(detectorPoint)));
+    EXPECT_EQ(it.Get(), expected) << "at index " << it.GetIndex();
+    numberOfNonZeroPixels += expected > 0.0f ? 1 : 0;
+  }
+  EXPECT_GT(numberOfNonZeroPixels, 0U);
+}
+} // namespace
+
+
+GTEST_TEST(RayCastProjector, IntegrateRayThroughConstantVolume)
+{
+  const auto projector = ProjectorType::New();
+  projector->SetVolume(CreateConstantVolume(2));
+
+  /** A ray along the z-axis crosses the centres of the 20 voxel planes, which
+   * are 19 mm apart.
+   */
+  ProjectorType::PointType point;
+  point.Fill(0.0);
+  point[0] = 0.3;
+  point[1] = -0.2;
+  ProjectorType::DirectionType direction;
+  direction.Fill(0.0);
+  direction[2] = 1.0;
+  EXPECT_NEAR(projector->IntegrateRay(point, direction, 0.0), 2.0 * 19.0, 1e-6);
+
+  /** Voxels below the threshold do not contribute. */
+  EXPECT_EQ(projector->IntegrateRay(point, direction, 3.0), 0.0);
+
+  /** A ray that misses the volume. */
+  point[0] = 100.0;
+  EXPECT_EQ(projector->IntegrateRay(point, direction, 0.0), 0.0);
+}
+
+
+// Tests that the projector, used through AdvancedRayCastInterpolateImageFunction, gives the same integrals as ITK's
+// RayCastInterpolateImageFunction, of which the previous implementation of the interpolator was a copy. Besides rays
+// through the inside of the volume, the rays through the corners and the midpoints of the edges of the volume, and
+// rays just inside and outside of those, are compared.
+GTEST_TEST(RayCastProjector, EqualsRayCastInterpolateImageFunctionOnNonConstantVolume)
+{
+  const auto volume = CreateNonConstantVolume();
+  const auto transform = itk::Euler3DTransform<double>::New();
+
+  InterpolatorType::InputPointType focalPoint;
+  focalPoint.Fill(0.0);
+  focalPoint[2] = 500.0;
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(volume);
+  interpolator->SetTransform(transform);
+  interpolator->SetFocalPoint(focalPoint);
+  interpolator->SetThreshold(1.0);
+
+  const auto referenceInterpolator = itk::RayCastInterpolateImageFunction<VolumeType, double>::New();
+  referenceInterpolator->SetInputImage(volume);
+  referenceInterpolator->SetTransform(transform);
+  referenceInterpolator->SetFocalPoint(focalPoint);
+  referenceInterpolator->SetThreshold(1.0);
+
+  std::vector<InterpolatorType::PointType> detectorPoints;
+  for (double y = -5.0; y <= 5.0; y += 0.7)
+  {
+    for (double x = -5.0; x <= 5.0; x += 0.7)
+    {
+      InterpolatorType::PointType detectorPoint;
+      detectorPoint[0] = x;
+      detectorPoint[1] = y;
+      detectorPoint[2] = -30.0;
+      detectorPoints.push_back(detectorPoint);
+    }
+  }
+
+  /** The corners and the midpoints of the edges of the volume, of which the extent is centred on the origin. */
+  for (const double z : { -10.8, 0.0, 10.8 })
+  {
+    for (const double y : { -9.6, 0.0, 9.6 })
+    {
+      for (const double x : { -10.0, 0.0, 10.0 })
+      {
+        const unsigned int numberOfBoundaryCoordinates = (x != 0.0) + (y != 0.0) + (z != 0.0);
+        if (numberOfBoundaryCoordinates < 2)
+        {
+          continue;
+        }
+        ProjectorType::PointType point;
+        point[0] = x;
+        point[1] = y;
+        point[2] = z;
+        const auto detectorPoint = ProjectOnDetectorPlane(focalPoint, point);
+        for (const double shift : { -1e-3, 0.0, 1e-3 })
+        {
+          auto shiftedPoint = detectorPoint;
+          shiftedPoint[0] += shift;
+          shiftedPoint[1] -= shift;
+          detectorPoints.push_back(shiftedPoint);
+        }
+      }
+    }
+  }
+
+  unsigned int numberOfNonZeroIntegrals = 0;
+  for (const double angle : { 0.0, 0.05, -0.08 })
+  {
+    transform->SetRotation(angle, -0.5 * angle, 0.3 * angle);
+
+    for (const auto & detectorPoint : detectorPoints)
+    {
+      const double expected = referenceInterpolator->Evaluate(detectorPoint);
+      EXPECT_NEAR(interpolator->Evaluate(detectorPoint), expected, 1e-9 * std::abs(expected) + 1e-9)
+        << "at " << detectorPoint;
+      numberOfNonZeroIntegrals += expected > 0.0 ? 1 : 0;
+    }
+  }
+  EXPECT_GT(numberOfNonZeroIntegrals, 0U);
+}
+
+
+// Tests that GenerateProjection() equals the per-ray evaluation, pixel by pixel, for a rigid transform, including the
+// rays through the corners and edges of the volume, and the rays that miss it.
+GTEST_TEST(RayCastProjector, ProjectionEqualsPerRayEvaluationForRigidTransform)
+{
+  const auto transform = itk::Euler3DTransform<double>::New();
+
+  InterpolatorType::InputPointType focalPoint;
+  focalPoint.Fill(0.0);
+  focalPoint[2] = 500.0;
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(CreateNonConstantVolume());
+  interpolator->SetTransform(transform);
+  interpolator->SetFocalPoint(focalPoint);
+  interpolator->SetThreshold(1.0);
+
+  for (const double faceZ : { -10.8, 10.8 })
+  {
+    const auto detector = CreateDetectorThroughCorners(focalPoint, faceZ);
+    for (const double angle : { 0.0, 0.05, -0.08 })
+    {
+      transform->SetRotation(angle, -0.5 * angle, 0.3 * angle);
+      ExpectProjectionEqualsPerRayEvaluation(*interpolator, *detector);
+    }
+  }
+
+  /** A detector of several slices and with a size that is not a multiple of the tile size. */
+  const auto detector = DetectorType::New();
+  detector->SetRegions(DetectorType::SizeType{ { 53, 47, 2 } });
+  DetectorType::SpacingType spacing;
+  spacing.Fill(0.5);
+  detector->SetSpacing(spacing);
+  DetectorType::PointType origin;
+  origin[0] = -13.0;
+  origin[1] = -11.5;
+  origin[2] = -30.0;
+  detector->SetOrigin(origin);
+  detector->Allocate();
+  ExpectProjectionEqualsPerRayEvaluation(*interpolator, *detector);
+}
+
+
+// Tests that GenerateProjection() equals the per-ray evaluation, pixel by pixel, for the composition of a rigid
+// transform with a non-rigid initial transform. The non-rigid mapping of the rays is cached: it must be reused after
+// changing only the rigid parameters, and recomputed after changing the non-rigid parameters.
+GTEST_TEST(RayCastProjector, ProjectionEqualsPerRayEvaluationForCombinationTransform)
+{
+  using BSplineTransformType = itk::RecursiveBSplineTransform<double, 3, 3>;
+  using EulerTransformType = itk::AdvancedEuler3DTransform<double>;
+  using CombinationTransformType = itk::AdvancedCombinationTransform<double, 3>;
+
+  const auto bsplineTransform = BSplineTransformType::New();
+  BSplineTransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(4.0);
+  bsplineTransform->SetGridSpacing(gridSpacing);
+  BSplineTransformType::OriginType gridOrigin;
+  gridOrigin[0] = -20.0;
+  gridOrigin[1] = -20.0;
+  gridOrigin[2] = -36.0;
+  bsplineTransform->SetGridOrigin(gridOrigin);
+  bsplineTransform->SetGridRegion(BSplineTransformType::RegionType(BSplineTransformType::SizeType{ { 12, 12, 14 } }));
+
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> parameterDistribution(-1.0, 1.0);
+  BSplineTransformType::ParametersType   bsplineParameters(bsplineTransform->GetNumberOfParameters());
+  for (auto & parameter : bsplineParameters)
+  {
+    parameter = parameterDistribution(randomNumberEngine);
+  }
+  bsplineTransform->SetParametersByValue(bsplineParameters);
+
+  const auto eulerTransform = EulerTransformType::New();
+  const auto transform = CombinationTransformType::New();
+  transform->SetUseComposition(true);
+  transform->SetInitialTransform(bsplineTransform);
+  transform->SetCurrentTransform(eulerTransform);
+  ASSERT_FALSE(transform->IsLinear());
+
+  InterpolatorType::InputPointType focalPoint;
+  focalPoint.Fill(0.0);
+  focalPoint[2] = 500.0;
+
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(CreateNonConstantVolume());
+  interpolator->SetTransform(transform);
+  interpolator->SetFocalPoint(focalPoint);
+  interpolator->SetThreshold(1.0);
+
+  const auto detector = CreateDetectorThroughCorners(focalPoint, 10.8);
+  ExpectProjectionEqualsPerRayEvaluation(*interpolator, *detector);
+
+  /** Change only the rigid parameters. */
+  eulerTransform->SetRotation(0.05, -0.02, 0.03);
+  ExpectProjectionEqualsPerRayEvaluation(*interpolator, *detector);
+
+  /** Change the non-rigid parameters. */
+  for (auto & parameter : bsplineParameters)
+  {
+    parameter = -2.0 * parameter;
+  }
+  bsplineTransform->SetParametersByValue(bsplineParameters);
+  ExpectProjectionEqualsPerRayEvaluation(*interpolator, *detector);
+}
+
+
+// Tests that RayCastResampleImageFilter computes the projection of its ray cast interpolator.
+GTEST_TEST(RayCastProjector, RayCastResampleImageFilterGeneratesProjection)
+{
+  const auto transform = itk::Euler3DTransform<double>::New();
+  transform->SetRotation(0.05, -0.025, 0.015);
+
+  InterpolatorType::InputPointType focalPoint;
+  focalPoint.Fill(0.0);
+  focalPoint[2] = 500.0;
+
+  const auto volume = CreateNonConstantVolume();
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(volume);
+  interpolator->SetTransform(transform);
+  interpolator->SetFocalPoint(focalPoint);
+  interpolator->SetThreshold(1.0);
+
+  const auto expectedDetector = CreateDetectorThroughCorners(focalPoint, 10.8);
+  interpolator->GenerateProjection(expectedDetector.GetPointer());
+
+  const auto filter = itk::RayCastResampleImageFilter<VolumeType, DetectorType>::New();
+  filter->SetInput(volume);
+  filter->SetTransform(transform);
+  filter->SetInterpolator(interpolator);
+  filter->SetOutputParametersFromImage(expectedDetector);
+  filter->Update();
+
+  const DetectorType & actualDetector = *filter->GetOutput();
+  EXPECT_EQ(actualDetector.GetBufferedRegion(), expectedDetector->GetBufferedRegion());
+  const itk::ImageBufferRange<const DetectorType> actualPixels(actualDetector);
+  const itk::ImageBufferRange<const DetectorType> expectedPixels(*expectedDetector);
+  ASSERT_EQ(actualPixels.size(), expectedPixels.size());
+  EXPECT_TRUE(std::equal(actualPixels.cbegin(), actualPixels.cend(), expectedPixels.cbegin()));
+}
+
+
+// Tests that the geometry of the volume is computed again when the volume is modified.
+GTEST_TEST(RayCastProjector, IntegrateRayFollowsModifiedVolume)
+{
+  const auto volume = CreateConstantVolume(2);
+
+  const auto projector = ProjectorType::New();
+  projector->SetVolume(volume);
+
+  ProjectorType::PointType point;
+  point.Fill(0.0);
+  point[0] = 0.3;
+  point[1] = -0.2;
+  ProjectorType::DirectionType direction;
+  direction.Fill(0.0);
+  direction[2] = 1.0;
+  EXPECT_NEAR(projector->IntegrateRay(point, direction, 0.0), 2.0 * 19.0, 1e-6);
+
+  /** With twice the spacing, the voxel planes are twice as far apart. */
+  VolumeType::SpacingType spacing;
+  spacing.Fill(2.0);
+  volume->SetSpacing(spacing);
+  EXPECT_NEAR(projector->IntegrateRay(point, direction, 0.0), 2.0 * 2.0 * 19.0, 1e-6);
+}
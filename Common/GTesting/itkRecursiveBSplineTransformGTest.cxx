@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkRecursiveBSplineTransform.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+
+GTEST_TEST(RecursiveBSplineTransform, InterleavedCoefficientsGiveSameResults)
+{
+  using TransformType = itk::RecursiveBSplineTransform<double, 3, 3>;
+
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> parameterDistribution(-2.0, 2.0);
+  std::uniform_real_distribution<double> pointDistribution(2.0, 8.0);
+
+  TransformType::SpacingType spacing;
+  spacing.Fill(2.0);
+  TransformType::OriginType origin;
+  origin.Fill(-1.0);
+  const TransformType::RegionType gridRegion(TransformType::SizeType{ { 7, 8, 9 } });
+
+  const auto transform = TransformType::New();
+  const auto interleavedTransform = TransformType::New();
+  interleavedTransform->SetUseInterleavedCoefficients(true);
+
+  for (const auto & t : { transform, interleavedTransform })
+  {
+    t->SetGridSpacing(spacing);
+    t->SetGridOrigin(origin);
+    t->SetGridRegion(gridRegion);
+  }
+
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  for (auto & parameter : parameters)
+  {
+    parameter = parameterDistribution(randomNumberEngine);
+  }
+  transform->SetParameters(parameters);
+  interleavedTransform->SetParameters(parameters);
+
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    TransformType::InputPointType point;
+    for (auto & coordinate : point)
+    {
+      coordinate = pointDistribution(randomNumberEngine);
+    }
+
+    const auto expectedPoint = transform->TransformPoint(point);
+    const auto actualPoint = interleavedTransform->TransformPoint(point);
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      EXPECT_DOUBLE_EQ(actualPoint[d], expectedPoint[d]);
+    }
+
+    TransformType::SpatialJacobianType expectedSpatialJacobian;
+    TransformType::SpatialJacobianType actualSpatialJacobian;
+    transform->GetSpatialJacobian(point, expectedSpatialJacobian);
+    interleavedTransform->GetSpatialJacobian(point, actualSpatialJacobian);
+    for (unsigned int r = 0; r < 3; ++r)
+    {
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        EXPECT_DOUBLE_EQ(actualSpatialJacobian(r, c), expectedSpatialJacobian(r, c));
+      }
+    }
+  }
+
+  /** New parameters must be picked up by the interleaved copy. */
+  parameters.Fill(0.0);
+  interleavedTransform->SetParameters(parameters);
+  TransformType::InputPointType point;
+  point.Fill(5.0);
+  const auto outputPoint = interleavedTransform->TransformPoint(point);
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    EXPECT_EQ(outputPoint[d], point[d]);
+  }
+}
+
+
+GTEST_TEST(RecursiveBSplineTransform, SinglePrecisionCoefficientsGiveSameResultsWithinTolerance)
+{
+  using TransformType = itk::RecursiveBSplineTransform<double, 3, 3>;
+
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> parameterDistribution(-2.0, 2.0);
+  std::uniform_real_distribution<double> pointDistribution(2.0, 8.0);
+
+  TransformType::SpacingType spacing;
+  spacing.Fill(2.0);
+  const TransformType::RegionType gridRegion(TransformType::SizeType{ { 7, 8, 9 } });
+
+  const auto transform = TransformType::New();
+  const auto singlePrecisionTransform = TransformType::New();
+  singlePrecisionTransform->SetUseSinglePrecisionCoefficients(true);
+
+  for (const auto & t : { transform, singlePrecisionTransform })
+  {
+    t->SetGridSpacing(spacing);
+    t->SetGridRegion(gridRegion);
+  }
+
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  for (auto & parameter : parameters)
+  {
+    parameter = parameterDistribution(randomNumberEngine);
+  }
+  transform->SetParameters(parameters);
+  singlePrecisionTransform->SetParameters(parameters);
+
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    TransformType::InputPointType point;
+    for (auto & coordinate : point)
+    {
+      coordinate = pointDistribution(randomNumberEngine);
+    }
+
+    const auto expectedPoint = transform->TransformPoint(point);
+    const auto actualPoint = singlePrecisionTransform->TransformPoint(point);
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      EXPECT_NEAR(actualPoint[d], expectedPoint[d], 1e-5);
+    }
+
+    TransformType::SpatialJacobianType expectedSpatialJacobian;
+    TransformType::SpatialJacobianType actualSpatialJacobian;
+    transform->GetSpatialJacobian(point, expectedSpatialJacobian);
+    singlePrecisionTransform->GetSpatialJacobian(point, actualSpatialJacobian);
+    for (unsigned int r = 0; r < 3; ++r)
+    {
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        EXPECT_NEAR(actualSpatialJacobian(r, c), expectedSpatialJacobian(r, c), 1e-5);
+      }
+    }
+  }
+}
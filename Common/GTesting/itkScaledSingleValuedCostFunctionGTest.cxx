@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkScaledSingleValuedCostFunction.h"
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+using ScalesType = itk::ScaledSingleValuedCostFunction::ScalesType;
+using ParametersType = itk::ScaledSingleValuedCostFunction::ParametersType;
+using DerivativeType = itk::ScaledSingleValuedCostFunction::DerivativeType;
+
+
+/** f(x) = sum_i (i + 1) x_i^2, which records the address of the parameters it gets. */
+class QuadraticCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+  using Self = QuadraticCostFunction;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  static constexpr unsigned int NumberOfParameters = 4;
+
+  unsigned int
+  GetNumberOfParameters() const override
+  {
+    return NumberOfParameters;
+  }
+
+  MeasureType
+  GetValue(const ParametersType & parameters) const override
+  {
+    m_LastParametersPointer = parameters.data_block();
+    MeasureType value = 0.0;
+    for (unsigned int i = 0; i < NumberOfParameters; ++i)
+    {
+      value += (i + 1.0) * parameters[i] * parameters[i];
+    }
+    return value;
+  }
+
+  void
+  GetDerivative(const ParametersType & parameters, DerivativeType & derivative) const override
+  {
+    m_LastParametersPointer = parameters.data_block();
+    derivative.SetSize(NumberOfParameters);
+    for (unsigned int i = 0; i < NumberOfParameters; ++i)
+    {
+      derivative[i] = 2.0 * (i + 1.0) * parameters[i];
+    }
+  }
+
+  mutable const double * m_LastParametersPointer{ nullptr };
+};
+} // namespace
+
+
+GTEST_TEST(ScaledSingleValuedCostFunction, ScalesAndNegates)
+{
+  const auto costFunction = QuadraticCostFunction::New();
+  const auto scaledCostFunction = itk::ScaledSingleValuedCostFunction::New();
+  scaledCostFunction->SetUnscaledCostFunction(costFunction);
+
+  ScalesType     scales(QuadraticCostFunction::NumberOfParameters);
+  ParametersType parameters(QuadraticCostFunction::NumberOfParameters);
+  for (unsigned int i = 0; i < QuadraticCostFunction::NumberOfParameters; ++i)
+  {
+    scales[i] = 0.5 * (i + 1.0);
+    parameters[i] = 1.0 - i;
+  }
+  scaledCostFunction->SetScales(scales);
+  scaledCostFunction->SetUseScales(true);
+  scaledCostFunction->SetNegateCostFunction(true);
+
+  double         value = 0.0;
+  DerivativeType derivative;
+  scaledCostFunction->GetValueAndDerivative(parameters, value, derivative);
+
+  /** F(y) = -f(y/s) and dF/dy = -1/s * df/dx(y/s). */
+  double expectedValue = 0.0;
+  for (unsigned int i = 0; i < QuadraticCostFunction::NumberOfParameters; ++i)
+  {
+    const double x = parameters[i] / scales[i];
+    expectedValue -= (i + 1.0) * x * x;
+    EXPECT_DOUBLE_EQ(derivative[i], -2.0 * (i + 1.0) * x / scales[i]);
+  }
+  EXPECT_DOUBLE_EQ(value, expectedValue);
+  EXPECT_DOUBLE_EQ(scaledCostFunction->GetValue(parameters), expectedValue);
+}
+
+
+GTEST_TEST(ScaledSingleValuedCostFunction, ReusesBuffersBetweenEvaluations)
+{
+  const auto costFunction = QuadraticCostFunction::New();
+  const auto scaledCostFunction = itk::ScaledSingleValuedCostFunction::New();
+  scaledCostFunction->SetUnscaledCostFunction(costFunction);
+
+  ParametersType parameters(QuadraticCostFunction::NumberOfParameters);
+  parameters.Fill(1.0);
+  DerivativeType       derivative(QuadraticCostFunction::NumberOfParameters);
+  const double * const derivativePointer = derivative.data_block();
+  double               value = 0.0;
+
+  /** Without scales, the parameters are passed on as they are. */
+  scaledCostFunction->SetNegateCostFunction(true);
+  scaledCostFunction->GetValueAndDerivative(parameters, value, derivative);
+  EXPECT_EQ(costFunction->m_LastParametersPointer, parameters.data_block());
+  EXPECT_EQ(derivative.data_block(), derivativePointer);
+
+  /** With scales, the unscaled parameters are computed in the same workspace every iteration. */
+  scaledCostFunction->SetScales(ScalesType(QuadraticCostFunction::NumberOfParameters, 2.0));
+  scaledCostFunction->SetUseScales(true);
+  scaledCostFunction->GetValueAndDerivative(parameters, value, derivative);
+  const double * const workspacePointer = costFunction->m_LastParametersPointer;
+  EXPECT_NE(workspacePointer, parameters.data_block());
+
+  for (unsigned int iteration = 0; iteration < 3; ++iteration)
+  {
+    parameters[0] += 1.0;
+    scaledCostFunction->GetValueAndDerivative(parameters, value, derivative);
+    EXPECT_EQ(costFunction->m_LastParametersPointer, workspacePointer);
+    EXPECT_EQ(derivative.data_block(), derivativePointer);
+    EXPECT_DOUBLE_EQ(derivative[0], -2.0 * (parameters[0] / 2.0) / 2.0);
+  }
+}
@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+// First include the header file to be tested:
+#include "itkStochasticConvergenceMonitor.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+
+namespace
+{
+using MonitorType = itk::StochasticConvergenceMonitor;
+
+/** Deterministic noise in [-1, 1], uncorrelated enough for the regression. */
+double
+Noise(const unsigned int iteration)
+{
+  const double x = std::sin(12.9898 * iteration + 78.233) * 43758.5453;
+  return 2.0 * (x - std::floor(x)) - 1.0;
+}
+
+
+/** Adds value(k) for k = 0, 1, ..., and returns the first iteration at which the
+ * monitor reports convergence, or the number of iterations when it never does.
+ */
+template <class TFunction>
+unsigned int
+FindConvergedIteration(MonitorType & monitor, const unsigned int numberOfIterations, TFunction value)
+{
+  for (unsigned int k = 0; k < numberOfIterations; ++k)
+  {
+    if (monitor.AddValue(value(k)))
+    {
+      return k;
+    }
+  }
+  return numberOfIterations;
+}
+} // namespace
+
+
+GTEST_TEST(StochasticConvergenceMonitor, IsDisabledByDefault)
+{
+  const auto monitor = MonitorType::New();
+  EXPECT_EQ(monitor->GetWindowSize(), 0u);
+  EXPECT_EQ(FindConvergedIteration(*monitor, 100, [](unsigned int) { return 1.0; }), 100u);
+
+  monitor->Initialize(0, 2.0);
+  EXPECT_EQ(FindConvergedIteration(*monitor, 100, [](unsigned int) { return 1.0; }), 100u);
+}
+
+
+GTEST_TEST(StochasticConvergenceMonitor, ClampsSmallWindowSizes)
+{
+  const auto monitor = MonitorType::New();
+  monitor->Initialize(1, 2.0);
+  EXPECT_EQ(monitor->GetWindowSize(), 3u);
+}
+
+
+GTEST_TEST(StochasticConvergenceMonitor, DoesNotStopANoisyDecrease)
+{
+  const auto monitor = MonitorType::New();
+  monitor->Initialize(50, 2.0);
+  EXPECT_EQ(FindConvergedIteration(*monitor, 1000, [](unsigned int k) { return -0.1 * k + Noise(k); }), 1000u);
+  EXPECT_NEAR(monitor->GetDecreasePerIteration(), 0.1, 0.05);
+  EXPECT_GT(monitor->GetStandardError(), 0.0);
+}
+
+
+GTEST_TEST(StochasticConvergenceMonitor, StopsNoiseWithoutTrend)
+{
+  const auto monitor = MonitorType::New();
+  monitor->Initialize(50, 2.0);
+
+  /** A constant value converges as soon as the window is full, and not before. */
+  EXPECT_EQ(FindConvergedIteration(*monitor, 1000, [](unsigned int) { return 3.0; }), 49u);
+  EXPECT_TRUE(monitor->GetHasConverged());
+
+  /** Initialize() forgets the previous values. */
+  monitor->Initialize(50, 2.0);
+  EXPECT_FALSE(monitor->GetHasConverged());
+
+  /** A decrease that levels off into noise converges once the window only holds the noise. */
+  const auto decreaseThenNoise = [](unsigned int k) { return (k < 200 ? 200.0 - k : 0.0) + Noise(k); };
+  const unsigned int convergedIteration = FindConvergedIteration(*monitor, 1000, decreaseThenNoise);
+  EXPECT_GE(convergedIteration, 200u);
+  EXPECT_LT(convergedIteration, 1000u);
+}
+
+
+GTEST_TEST(StochasticConvergenceMonitor, StopsAnIncrease)
+{
+  const auto monitor = MonitorType::New();
+  monitor->Initialize(10, 2.0);
+  EXPECT_EQ(FindConvergedIteration(*monitor, 100, [](unsigned int k) { return 0.5 * k; }), 9u);
+  EXPECT_DOUBLE_EQ(monitor->GetDecreasePerIteration(), -0.5);
+}
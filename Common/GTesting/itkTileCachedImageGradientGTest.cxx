@@ -0,0 +1,101 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkTileCachedImageGradient.h"
+
+#include <itkGradientImageFilter.h>
+#include <itkImage.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkImageRegionIterator.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+
+GTEST_TEST(TileCachedImageGradient, EqualsGradientImageFilter)
+{
+  using ImageType = itk::Image<short, 3>;
+  using GradientType = itk::TileCachedImageGradient<ImageType>;
+  using GradientFilterType = itk::GradientImageFilter<ImageType, double, double>;
+
+  /** An image with an anisotropic spacing, a rotated direction, a non-zero
+   * start index, and a size that is not a multiple of the tile size.
+   */
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.7;
+  spacing[1] = 1.3;
+  spacing[2] = 2.1;
+  ImageType::DirectionType direction;
+  direction.SetIdentity();
+  direction(0, 0) = std::cos(0.4);
+  direction(0, 1) = -std::sin(0.4);
+  direction(1, 0) = std::sin(0.4);
+  direction(1, 1) = std::cos(0.4);
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(ImageType::IndexType{ { 3, -2, 5 } }, ImageType::SizeType{ { 21, 9, 17 } }));
+  image->SetSpacing(spacing);
+  image->SetDirection(direction);
+  image->Allocate();
+
+  std::mt19937 randomNumberEngine;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(randomNumberEngine() % 1000));
+  }
+
+  const auto filter = GradientFilterType::New();
+  filter->SetUseImageSpacing(true);
+  filter->SetInput(image);
+  filter->Update();
+
+  const auto gradient = GradientType::New();
+  gradient->SetImage(image);
+  EXPECT_EQ(gradient->GetNumberOfComputedTiles(), 0u);
+
+  const auto gradientImage = filter->GetOutput();
+  for (itk::ImageRegionConstIteratorWithIndex<GradientFilterType::OutputImageType> it(
+         gradientImage, gradientImage->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    GradientType::CovariantVectorType actual;
+    gradient->Evaluate(it.GetIndex(), actual);
+    const auto expected = it.Get();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      EXPECT_NEAR(actual[i], expected[i], 1e-5 * (1.0 + std::abs(expected[i])));
+    }
+  }
+
+  /** All 3 x 2 x 3 tiles are computed now. Setting the same image again keeps them. */
+  EXPECT_EQ(gradient->GetNumberOfComputedTiles(), 18u);
+  gradient->SetImage(image);
+  EXPECT_EQ(gradient->GetNumberOfComputedTiles(), 18u);
+
+  /** Only the touched tile is computed after the image is modified. */
+  image->Modified();
+  gradient->SetImage(image);
+  GradientType::CovariantVectorType actual;
+  gradient->Evaluate(ImageType::IndexType{ { 3, -2, 5 } }, actual);
+  EXPECT_EQ(gradient->GetNumberOfComputedTiles(), 1u);
+}
@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "BendingEnergyPenalty/itkTransformBendingEnergyPenaltyTerm.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkImageFullSampler.h"
+
+#include <itkImage.h>
+#include <itkLinearInterpolateImageFunction.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr unsigned int ImageDimension = 2;
+using ImageType = itk::Image<float, ImageDimension>;
+using TransformType = itk::AdvancedBSplineDeformableTransform<double, ImageDimension, 3>;
+using PenaltyTermType = itk::TransformBendingEnergyPenaltyTerm<ImageType, double>;
+
+
+// A 145x145 image with a voxel spacing of 0.25, inside the valid region of the B-spline grid below.
+ImageType::Pointer
+CreateImage()
+{
+  ImageType::SpacingType spacing;
+  spacing.Fill(0.25);
+  ImageType::PointType origin;
+  origin.Fill(12.0);
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 145, 145 } });
+  image->SetSpacing(spacing);
+  image->SetOrigin(origin);
+  image->Allocate(true);
+  return image;
+}
+
+
+// A third order B-spline transform on an 8x8 grid with a spacing of 10, and non-zero parameters.
+TransformType::Pointer
+CreateTransform(TransformType::ParametersType & parameters)
+{
+  const auto                transform = TransformType::New();
+  TransformType::RegionType gridRegion;
+  gridRegion.SetSize(itk::Size<ImageDimension>::Filled(8));
+  TransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(10.0);
+  TransformType::OriginType gridOrigin;
+  gridOrigin.Fill(0.0);
+  transform->SetGridRegion(gridRegion);
+  transform->SetGridSpacing(gridSpacing);
+  transform->SetGridOrigin(gridOrigin);
+
+  parameters.SetSize(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 2.5 * std::sin(0.7 * i);
+  }
+  transform->SetParameters(parameters);
+  return transform;
+}
+
+
+PenaltyTermType::Pointer
+CreatePenaltyTerm(const ImageType & image, TransformType & transform, const bool useExactBendingEnergy)
+{
+  const auto penaltyTerm = PenaltyTermType::New();
+  penaltyTerm->SetFixedImage(&image);
+  penaltyTerm->SetMovingImage(&image);
+  penaltyTerm->SetFixedImageRegion(image.GetBufferedRegion());
+  penaltyTerm->SetTransform(&transform);
+  penaltyTerm->SetInterpolator(itk::LinearInterpolateImageFunction<ImageType, double>::New());
+  penaltyTerm->SetImageSampler(itk::ImageFullSampler<ImageType>::New());
+  penaltyTerm->SetUseExactBendingEnergy(useExactBendingEnergy);
+  penaltyTerm->Initialize();
+  return penaltyTerm;
+}
+
+} // namespace
+
+
+// Tests that the exact bending energy approximates the average over all voxels, as computed by sampling.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, ExactValueApproximatesFullySampledValue)
+{
+  const auto                    image = CreateImage();
+  TransformType::ParametersType parameters;
+  const auto                    transform = CreateTransform(parameters);
+
+  const double sampledValue = CreatePenaltyTerm(*image, *transform, false)->GetValue(parameters);
+  const double exactValue = CreatePenaltyTerm(*image, *transform, true)->GetValue(parameters);
+
+  // The samples are at the voxel centers, so the sampled value is a Riemann sum of the exact integral.
+  EXPECT_GT(exactValue, 0.0);
+  EXPECT_NEAR(sampledValue, exactValue, 0.01 * exactValue);
+}
+
+
+// Tests that the exact derivative equals the central finite differences of the exact value.
+GTEST_TEST(TransformBendingEnergyPenaltyTerm, ExactDerivativeEqualsCentralDifferences)
+{
+  const auto                    image = CreateImage();
+  TransformType::ParametersType parameters;
+  const auto                    transform = CreateTransform(parameters);
+  const auto                    penaltyTerm = CreatePenaltyTerm(*image, *transform, true);
+
+  PenaltyTermType::MeasureType    value{};
+  PenaltyTermType::DerivativeType derivative;
+  penaltyTerm->GetValueAndDerivative(parameters, value, derivative);
+  ASSERT_EQ(derivative.GetSize(), parameters.GetSize());
+  EXPECT_EQ(value, penaltyTerm->GetValue(parameters));
+
+  // The energy is a quadratic form, so central differences are exact, apart from rounding errors.
+  const double                  delta = 1e-3;
+  TransformType::ParametersType perturbedParameters = parameters;
+  double                        maximumAbsoluteDerivative = 0.0;
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    perturbedParameters[i] = parameters[i] + delta;
+    const double forwardValue = penaltyTerm->GetValue(perturbedParameters);
+    perturbedParameters[i] = parameters[i] - delta;
+    const double backwardValue = penaltyTerm->GetValue(perturbedParameters);
+    perturbedParameters[i] = parameters[i];
+
+    EXPECT_NEAR(derivative[i], (forwardValue - backwardValue) / (2.0 * delta), 1e-6 * std::abs(value) + 1e-12);
+    maximumAbsoluteDerivative = std::max(maximumAbsoluteDerivative, std::abs(derivative[i]));
+  }
+  EXPECT_GT(maximumAbsoluteDerivative, 0.0);
+}
@@ -0,0 +1,118 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+// First include the header file to be tested:
+#include "itkTransformToDeterminantOfSpatialJacobianSource.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+
+#include <itkImage.h>
+#include <itkImageBufferRange.h>
+#include <itkStreamingImageFilter.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr unsigned int ImageDimension = 2;
+using ImageType = itk::Image<float, ImageDimension>;
+using SourceType = itk::TransformToDeterminantOfSpatialJacobianSource<ImageType>;
+
+
+// Generates the determinant image in the specified number of chunks.
+ImageType::Pointer
+GenerateStreamed(SourceType & source, const unsigned int numberOfStreamDivisions)
+{
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(source.GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+} // namespace
+
+
+// Tests that the statistics of a nonlinear transform cover all chunks of a streamed update.
+GTEST_TEST(TransformToDeterminantOfSpatialJacobianSource, StatisticsOfStreamedZeroBSpline)
+{
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, ImageDimension, 3>;
+
+  const auto                transform = TransformType::New();
+  TransformType::RegionType gridRegion;
+  gridRegion.SetSize(itk::Size<ImageDimension>::Filled(8));
+  TransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(2.0);
+  TransformType::OriginType gridOrigin;
+  gridOrigin.Fill(-4.0);
+  transform->SetGridRegion(gridRegion);
+  transform->SetGridSpacing(gridSpacing);
+  transform->SetGridOrigin(gridOrigin);
+
+  // Zero parameters: the identity transform, so the determinant is 1 everywhere.
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  parameters.Fill(0.0);
+  transform->SetParameters(parameters);
+
+  const auto source = SourceType::New();
+  source->SetTransform(transform);
+  source->SetOutputSize(itk::Size<ImageDimension>{ { 6, 7 } });
+
+  const auto image = GenerateStreamed(*source, 3);
+
+  for (const float pixelValue : itk::ImageBufferRange<const ImageType>(*image))
+  {
+    EXPECT_FLOAT_EQ(pixelValue, 1.0f);
+  }
+  EXPECT_DOUBLE_EQ(source->GetMinimumDeterminant(), 1.0);
+  EXPECT_DOUBLE_EQ(source->GetMaximumDeterminant(), 1.0);
+  EXPECT_EQ(source->GetNumberOfGeneratedVoxels(), 6U * 7U);
+  EXPECT_EQ(source->GetNumberOfFoldingVoxels(), 0U);
+  EXPECT_EQ(source->GetFractionOfFoldingVoxels(), 0.0);
+}
+
+
+// Tests that a mirroring (linear) transform is reported as folding everywhere.
+GTEST_TEST(TransformToDeterminantOfSpatialJacobianSource, StatisticsOfStreamedMirroring)
+{
+  using TransformType = itk::AdvancedMatrixOffsetTransformBase<double, ImageDimension, ImageDimension>;
+
+  const auto                transform = TransformType::New();
+  TransformType::MatrixType matrix;
+  matrix.SetIdentity();
+  matrix[0][0] = -2.0;
+  transform->SetMatrix(matrix);
+
+  const auto source = SourceType::New();
+  source->SetTransform(transform);
+  source->SetOutputSize(itk::Size<ImageDimension>{ { 5, 4 } });
+
+  const auto image = GenerateStreamed(*source, 2);
+
+  for (const float pixelValue : itk::ImageBufferRange<const ImageType>(*image))
+  {
+    EXPECT_FLOAT_EQ(pixelValue, -2.0f);
+  }
+  EXPECT_DOUBLE_EQ(source->GetMinimumDeterminant(), -2.0);
+  EXPECT_DOUBLE_EQ(source->GetMaximumDeterminant(), -2.0);
+  EXPECT_EQ(source->GetNumberOfGeneratedVoxels(), 5U * 4U);
+  EXPECT_EQ(source->GetNumberOfFoldingVoxels(), 5U * 4U);
+  EXPECT_EQ(source->GetFractionOfFoldingVoxels(), 1.0);
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkTransformToInverseDisplacementFieldSource.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+
+#include <itkImage.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkStreamingImageFilter.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace
+{
+constexpr unsigned int ImageDimension = 2;
+using ImageType = itk::Image<itk::Vector<float, ImageDimension>, ImageDimension>;
+using SourceType = itk::TransformToInverseDisplacementFieldSource<ImageType>;
+
+
+// Generates the inverse displacement field in the specified number of chunks.
+ImageType::Pointer
+GenerateStreamed(SourceType & source, const unsigned int numberOfStreamDivisions)
+{
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(source.GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+
+
+// Expects that the transform maps each point plus its inverse displacement back onto the point.
+void
+ExpectInverse(const SourceType::TransformType & transform, const ImageType & image, const double tolerance)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(&image, image.GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    SourceType::InputPointType point;
+    image.TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    SourceType::InputPointType inversePoint;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      inversePoint[i] = point[i] + it.Get()[i];
+    }
+    EXPECT_LE(point.EuclideanDistanceTo(transform.TransformPoint(inversePoint)), tolerance);
+  }
+}
+
+} // namespace
+
+
+// Tests that the inverse of a linear transform is found in a single iteration.
+GTEST_TEST(TransformToInverseDisplacementFieldSource, InvertsAffineInOneIteration)
+{
+  using TransformType = itk::AdvancedMatrixOffsetTransformBase<double, ImageDimension, ImageDimension>;
+
+  const auto                transform = TransformType::New();
+  TransformType::MatrixType matrix;
+  matrix[0][0] = 0.5;
+  matrix[0][1] = 0.8;
+  matrix[1][0] = -0.8;
+  matrix[1][1] = 1.5;
+  transform->SetMatrix(matrix);
+  TransformType::OutputVectorType translation;
+  translation[0] = 3.0;
+  translation[1] = -2.0;
+  transform->SetTranslation(translation);
+
+  const auto source = SourceType::New();
+  source->SetTransform(transform);
+  source->SetOutputSize(itk::Size<ImageDimension>{ { 9, 7 } });
+  source->SetTolerance(1e-6);
+
+  const auto image = GenerateStreamed(*source, 2);
+
+  ExpectInverse(*transform, *image, 1e-4);
+  EXPECT_EQ(source->GetNumberOfGeneratedVoxels(), 9U * 7U);
+  EXPECT_EQ(source->GetNumberOfNonConvergedVoxels(), 0U);
+  EXPECT_LE(source->GetMeanNumberOfIterations(), 1.0);
+}
+
+
+// Tests the inverse of a smooth B-spline deformation, with and without the coarse inverse.
+GTEST_TEST(TransformToInverseDisplacementFieldSource, InvertsBSpline)
+{
+  using TransformType = itk::AdvancedBSplineDeformableTransform<double, ImageDimension, 3>;
+
+  const auto                transform = TransformType::New();
+  TransformType::RegionType gridRegion;
+  gridRegion.SetSize(itk::Size<ImageDimension>::Filled(12));
+  TransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(4.0);
+  TransformType::OriginType gridOrigin;
+  gridOrigin.Fill(-12.0);
+  transform->SetGridRegion(gridRegion);
+  transform->SetGridSpacing(gridSpacing);
+  transform->SetGridOrigin(gridOrigin);
+
+  // A smooth displacement of at most half a voxel, well within the invertible range. The grid
+  // extends beyond the output image, so that the inverse is never sought outside its support.
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.5 * std::sin(0.7 * i);
+  }
+  transform->SetParameters(parameters);
+
+  for (const unsigned int coarseGridShrinkFactor : { 1U, 4U })
+  {
+    const auto source = SourceType::New();
+    source->SetTransform(transform);
+    source->SetOutputSize(itk::Size<ImageDimension>{ { 16, 15 } });
+    source->SetTolerance(1e-4);
+    source->SetCoarseGridShrinkFactor(coarseGridShrinkFactor);
+
+    const auto image = GenerateStreamed(*source, 3);
+
+    ExpectInverse(*transform, *image, 1e-3);
+    EXPECT_EQ(source->GetNumberOfGeneratedVoxels(), 16U * 15U);
+    EXPECT_EQ(source->GetNumberOfNonConvergedVoxels(), 0U);
+    EXPECT_LE(source->GetMaximumResidual(), 1e-4);
+  }
+}
@@ -106,6 +106,12 @@ protected:
   void
   ThreadedGenerateData(const InputImageRegionType & inputRegionForThread, ThreadIdType threadId) override;
 
+  /** Appends the samples of the region that are inside the (rasterized) mask.
+   * The mask is evaluated for a whole scanline at once.
+   */
+  void
+  SampleInsideMask(const InputImageRegionType & region, ImageSampleContainerType & sampleContainer) const;
+
 private:
   /** The deleted copy constructor. */
   ImageFullSampler(const Self &) = delete;
@@ -21,6 +21,9 @@
 #include "itkImageFullSampler.h"
 
 #include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageScanlineConstIterator.h"
+
+#include <memory>
 
 namespace itk
 {
@@ -96,32 +99,10 @@ ImageFullSampler<TInputImage>::GenerateData(void)
   }   // end if no mask
   else
   {
-    if (mask->GetSource())
-    {
-      mask->GetSource()->Update();
-    }
-
     /** Loop over the image and check if the points falls within the mask. */
-    ImageSampleType tempSample;
-    for (iter.GoToBegin(); !iter.IsAtEnd(); ++iter)
-    {
-      /** Get sampled index. */
-      InputImageIndexType index = iter.GetIndex();
-
-      /** Translate index to point. */
-      inputImage->TransformIndexToPhysicalPoint(index, tempSample.m_ImageCoordinates);
-
-      if (mask->IsInsideInWorldSpace(tempSample.m_ImageCoordinates))
-      {
-        /** Get sampled image value. */
-        tempSample.m_ImageValue = iter.Get();
-
-        /** Store in container. */
-        sampleContainer->push_back(tempSample);
-
-      } // end if
-    }   // end for
-  }     // end else (if mask exists)
+    this->UpdateAllMasks();
+    this->SampleInsideMask(this->GetCroppedInputImageRegion(), *sampleContainer);
+  } // end else (if mask exists)
 
 } // end GenerateData()
 
@@ -191,34 +172,59 @@ ImageFullSampler<TInputImage>::ThreadedGenerateData(const InputImageRegionType &
   }   // end if no mask
   else
   {
-    if (mask->GetSource())
+    /** Loop over the image and check if the points falls within the mask.
+     * The masks were updated in BeforeThreadedGenerateData().
+     */
+    this->SampleInsideMask(inputRegionForThread, *sampleContainerThisThread);
+  } // end else (if mask exists)
+
+} // end ThreadedGenerateData()
+
+
+/**
+ * ******************* SampleInsideMask *******************
+ */
+
+template <class TInputImage>
+void
+ImageFullSampler<TInputImage>::SampleInsideMask(const InputImageRegionType & region,
+                                                ImageSampleContainerType &   sampleContainer) const
+{
+  InputImageConstPointer                          inputImage = this->GetInput();
+  const typename Superclass::RasterizedMaskType * mask = this->GetRasterizedMask();
+
+  /** Buffers for the points and mask values of one scanline. */
+  const SizeValueType                    lineLength = region.GetSize(0);
+  std::unique_ptr<InputImagePointType[]> points(new InputImagePointType[lineLength]);
+  std::unique_ptr<bool[]>                inside(new bool[lineLength]);
+
+  typedef ImageScanlineConstIterator<InputImageType> InputImageIterator;
+  InputImageIterator                                 iter(inputImage, region);
+  ImageSampleType                                    tempSample;
+  while (!iter.IsAtEnd())
+  {
+    /** Translate the indices of the scanline to points, and look them all up at once. */
+    InputImageIndexType index = iter.GetIndex();
+    for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
     {
-      mask->GetSource()->Update();
+      inputImage->TransformIndexToPhysicalPoint(index, points[i]);
     }
+    mask->IsInside(points.get(), lineLength, inside.get());
 
-    /** Loop over the image and check if the points falls within the mask. */
-    ImageSampleType tempSample;
-    for (iter.GoToBegin(); !iter.IsAtEnd(); ++iter)
+    /** Store the samples inside the mask. */
+    for (SizeValueType i = 0; i < lineLength; ++i, ++iter)
     {
-      /** Get sampled index. */
-      InputImageIndexType index = iter.GetIndex();
-
-      /** Translate index to point. */
-      inputImage->TransformIndexToPhysicalPoint(index, tempSample.m_ImageCoordinates);
-
-      if (mask->IsInsideInWorldSpace(tempSample.m_ImageCoordinates))
+      if (inside[i])
       {
-        /** Get sampled image value. */
+        tempSample.m_ImageCoordinates = points[i];
         tempSample.m_ImageValue = iter.Get();
+        sampleContainer.push_back(tempSample);
+      }
+    }
+    iter.NextLine();
+  }
 
-        /**  Store in container. */
-        sampleContainerThisThread->push_back(tempSample);
-
-      } // end if
-    }   // end for
-  }     // end else (if mask exists)
-
-} // end ThreadedGenerateData()
+} // end SampleInsideMask()
 
 
 /**
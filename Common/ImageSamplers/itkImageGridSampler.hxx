@@ -158,10 +158,9 @@ ImageGridSampler<TInputImage>::GenerateData(void)
   } // end if no mask
   else
   {
-    if (mask->GetSource())
-    {
-      mask->GetSource()->Update();
-    }
+    this->UpdateAllMasks();
+    const typename Superclass::RasterizedMaskType * rasterizedMask = this->GetRasterizedMask();
+
     /* Ugly loop over the grid; checks also if a sample falls within the mask. */
     for (unsigned int t = 0; t < dim_t; ++t)
     {
@@ -176,7 +175,7 @@ ImageGridSampler<TInputImage>::GenerateData(void)
             // Translate index to point.
             inputImage->TransformIndexToPhysicalPoint(index, tempsample.m_ImageCoordinates);
 
-            if (mask->IsInsideInWorldSpace(tempsample.m_ImageCoordinates))
+            if (rasterizedMask->IsInside(tempsample.m_ImageCoordinates))
             {
               // Get sampled fixed image value.
               tempsample.m_ImageValue = inputImage->GetPixel(index);
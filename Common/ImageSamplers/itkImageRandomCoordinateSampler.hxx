@@ -111,11 +111,10 @@ ImageRandomCoordinateSampler<TInputImage>::GenerateData(void)
   }   // end if no mask
   else
   {
-    /** Update the mask. */
-    if (mask->GetSource())
-    {
-      mask->GetSource()->Update();
-    }
+    /** Update the mask, and get its rasterized version for fast lookups. */
+    this->UpdateAllMasks();
+    const typename Superclass::RasterizedMaskType * rasterizedMask = this->GetRasterizedMask();
+
     /** Set up some variable that are used to make sure we are not forever
      * walking around on this image, trying to look for valid samples. */
     unsigned long numberOfSamplesTried = 0;
@@ -148,7 +147,7 @@ ImageRandomCoordinateSampler<TInputImage>::GenerateData(void)
         this->GenerateRandomCoordinate(smallestContIndex, largestContIndex, sampleContIndex);
         inputImage->TransformContinuousIndexToPhysicalPoint(sampleContIndex, samplePoint);
 
-      } while (!interpolator->IsInsideBuffer(sampleContIndex) || !mask->IsInsideInWorldSpace(samplePoint));
+      } while (!interpolator->IsInsideBuffer(sampleContIndex) || !rasterizedMask->IsInside(samplePoint));
 
       /** Compute the value at the point. */
       sampleValue = static_cast<ImageSampleValueType>(this->m_Interpolator->EvaluateAtContinuousIndex(sampleContIndex));
@@ -78,11 +78,9 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
   }   // end if no mask
   else
   {
-    /** Update the mask. */
-    if (mask->GetSource())
-    {
-      mask->GetSource()->Update();
-    }
+    /** Update the mask, and get its rasterized version for fast lookups. */
+    this->UpdateAllMasks();
+    const typename Superclass::RasterizedMaskType * rasterizedMask = this->GetRasterizedMask();
 
     /** Make sure we are not eternally trying to find samples: */
     randIter.SetNumberOfSamples(10 * this->GetNumberOfSamples());
@@ -112,7 +110,7 @@ ImageRandomSampler<TInputImage>::GenerateData(void)
         InputImageIndexType index = randIter.GetIndex();
         inputImage->TransformIndexToPhysicalPoint(index, inputPoint);
         /** Check if it's inside the mask. */
-        insideMask = mask->IsInsideInWorldSpace(inputPoint);
+        insideMask = rasterizedMask->IsInside(inputPoint);
       } while (!insideMask);
 
       /** Put the coordinates and the value in the sample. */
@@ -22,6 +22,8 @@
 #include "itkImageSample.h"
 #include "itkVectorDataContainer.h"
 #include "itkSpatialObject.h"
+#include "itkRasterizedMask.h"
+#include "itkPerformanceTelemetry.h"
 
 namespace itk
 {
@@ -82,6 +84,8 @@ public:
   typedef typename MaskType::Pointer                        MaskPointer;
   typedef typename MaskType::ConstPointer                   MaskConstPointer;
   typedef std::vector<MaskConstPointer>                     MaskVectorType;
+  typedef RasterizedMask<Self::InputImageDimension>         RasterizedMaskType;
+  typedef std::vector<typename RasterizedMaskType::Pointer> RasterizedMaskVectorType;
   typedef std::vector<InputImageRegionType>                 InputImageRegionVectorType;
 
   /** ******************** Masks ******************** */
@@ -179,6 +183,17 @@ public:
   /** \todo: Temporary, should think about interface. */
   itkSetMacro(UseMultiThread, bool);
 
+  /** Set/Get the telemetry object in which the sampler records the time of
+   * each update, the number of samples, and the bytes allocated for the
+   * sample container. Default: null, no recording.
+   */
+  itkSetObjectMacro(PerformanceTelemetry, PerformanceTelemetry);
+  itkGetModifiableObjectMacro(PerformanceTelemetry, PerformanceTelemetry);
+
+  /** Calls the superclass, and records the update in the telemetry object, if any. */
+  void
+  UpdateOutputData(DataObject * output) override;
+
 protected:
   /** The constructor. */
   ImageSamplerBase();
@@ -198,10 +213,22 @@ protected:
   virtual bool
   IsInsideAllMasks(const InputImagePointType & point) const;
 
-  /** UpdateAllMasks. */
+  /** UpdateAllMasks. Updates the sources of the masks, and (re)rasterizes
+   * the masks that changed, see RasterizedMask.
+   */
   virtual void
   UpdateAllMasks(void);
 
+  /** Get the rasterized version of the mask at the given position, for fast
+   * lookups in the sampling loops. Only valid after UpdateAllMasks().
+   */
+  const RasterizedMaskType *
+  GetRasterizedMask(unsigned int pos = 0) const
+  {
+    return this->m_RasterizedMaskVector[pos].GetPointer();
+  }
+
+
   /** Checks if the InputImageRegions are a subregion of the
    * LargestPossibleRegions.
    */
@@ -226,6 +253,9 @@ protected:
   // tmp?
   bool m_UseMultiThread;
 
+  /** The telemetry object, may be null. */
+  PerformanceTelemetry::Pointer m_PerformanceTelemetry;
+
 private:
   /** The deleted copy constructor. */
   ImageSamplerBase(const Self &) = delete;
@@ -236,6 +266,7 @@ private:
   /** Member variables. */
   MaskConstPointer           m_Mask;
   MaskVectorType             m_MaskVector;
+  RasterizedMaskVectorType   m_RasterizedMaskVector;
   unsigned int               m_NumberOfMasks;
   InputImageRegionType       m_InputImageRegion;
   InputImageRegionVectorType m_InputImageRegionVector;
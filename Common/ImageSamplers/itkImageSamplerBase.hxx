@@ -253,13 +253,18 @@ template <class TInputImage>
 bool
 ImageSamplerBase<TInputImage>::IsInsideAllMasks(const InputImagePointType & point) const
 {
-  bool ret = true;
+  const bool rasterized = this->m_RasterizedMaskVector.size() == this->m_NumberOfMasks;
   for (unsigned int i = 0; i < this->m_NumberOfMasks; ++i)
   {
-    ret &= this->GetMask(i)->IsInsideInWorldSpace(point);
+    const bool inside = rasterized ? this->m_RasterizedMaskVector[i]->IsInside(point)
+                                   : this->GetMask(i)->IsInsideInWorldSpace(point);
+    if (!inside)
+    {
+      return false;
+    }
   }
 
-  return ret;
+  return true;
 
 } // end IsInsideAllMasks()
 
@@ -281,6 +286,17 @@ ImageSamplerBase<TInputImage>::UpdateAllMasks(void)
     }
   }
 
+  /** Rasterize the masks. This only does work for masks that changed. */
+  this->m_RasterizedMaskVector.resize(this->m_NumberOfMasks);
+  for (unsigned int i = 0; i < this->m_NumberOfMasks; ++i)
+  {
+    if (this->m_RasterizedMaskVector[i].IsNull())
+    {
+      this->m_RasterizedMaskVector[i] = RasterizedMaskType::New();
+    }
+    this->m_RasterizedMaskVector[i]->SetMask(this->GetMask(i));
+  }
+
 } // end UpdateAllMasks()
 
 
@@ -405,9 +421,42 @@ ImageSamplerBase<TInputImage>::BeforeThreadedGenerateData(void)
     this->m_ThreaderSampleContainer[i] = ImageSampleContainerType::New();
   }
 
+  /** Update and rasterize the masks once, before the threads use them. */
+  this->UpdateAllMasks();
+
 } // end BeforeThreadedGenerateData()
 
 
+/**
+ * ******************* UpdateOutputData *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::UpdateOutputData(DataObject * output)
+{
+  if (this->m_PerformanceTelemetry.IsNull())
+  {
+    this->Superclass::UpdateOutputData(output);
+    return;
+  }
+
+  const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Sampler.Update");
+  const std::size_t                       capacityBefore = this->GetOutput()->capacity();
+
+  this->Superclass::UpdateOutputData(output);
+
+  const ImageSampleContainerType * sampleContainer = this->GetOutput();
+  this->m_PerformanceTelemetry->AddCount("Sampler.Samples", sampleContainer->size());
+  if (sampleContainer->capacity() > capacityBefore)
+  {
+    this->m_PerformanceTelemetry->AddCount("Sampler.BytesAllocated",
+                                           (sampleContainer->capacity() - capacityBefore) * sizeof(ImageSampleType));
+  }
+
+} // end UpdateOutputData()
+
+
 /**
  * ******************* AfterThreadedGenerateData *******************
  */
@@ -157,6 +157,9 @@ public:
   class Iterator
   {
   public:
+    /** The signed type of the distance between two iterators. */
+    typedef typename VectorIterator::difference_type difference_type;
+
     Iterator() = default;
     Iterator(size_type d, const VectorIterator & i)
       : m_Pos(d)
@@ -181,14 +184,14 @@ public:
       return temp;
     }
     Iterator
-    operator+=(int j)
+    operator+=(difference_type j)
     {
       m_Pos += j;
       m_Iter += j;
       return *this;
     }
     Iterator
-    operator-=(int j)
+    operator-=(difference_type j)
     {
       m_Pos -= j;
       m_Iter -= j;
@@ -256,6 +259,9 @@ public:
   class ConstIterator
   {
   public:
+    /** The signed type of the distance between two iterators. */
+    typedef typename VectorConstIterator::difference_type difference_type;
+
     ConstIterator() = default;
     ConstIterator(size_type d, const VectorConstIterator & i)
       : m_Pos(d)
@@ -285,14 +291,14 @@ public:
       return temp;
     }
     ConstIterator
-    operator+=(int j)
+    operator+=(difference_type j)
     {
       m_Pos += j;
       m_Iter += j;
       return *this;
     }
     ConstIterator
-    operator-=(int j)
+    operator-=(difference_type j)
     {
       m_Pos -= j;
       m_Iter -= j;
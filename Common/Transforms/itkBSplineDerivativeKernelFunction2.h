@@ -89,6 +89,16 @@ public:
   }
 
 
+  /** Evaluate the function at the entire support, without the overhead of a
+   * virtual function call.
+   */
+  static inline void
+  FastEvaluate(const double & u, double * weights)
+  {
+    Self::Evaluate(Dispatch<VSplineOrder>(), u, weights);
+  }
+
+
 protected:
   BSplineDerivativeKernelFunction2() = default;
   ~BSplineDerivativeKernelFunction2() override = default;
@@ -137,26 +147,26 @@ private:
   }
 
 
-  inline void
-  Evaluate(const Dispatch<1> &, const double & u, double * weights) const
+  /** The weights at the support points u and u + 1, for -1 <= u <= 0. */
+  static inline void
+  Evaluate(const Dispatch<1> &, const double & u, double * weights)
   {
-    // MS \todo: check
     const double absValue = std::abs(u);
 
     if (absValue < 1.0 && absValue > 0.0)
     {
-      weights[0] = -1.0;
-      weights[1] = 1.0;
+      weights[0] = 1.0;
+      weights[1] = -1.0;
     }
     else if (absValue == 1)
     {
-      weights[0] = -0.5;
+      weights[0] = 0.5;
       weights[1] = 0.0;
     }
     else
     {
       weights[0] = 0.0;
-      weights[1] = 0.5;
+      weights[1] = -0.5;
     }
   }
 
@@ -182,13 +192,13 @@ private:
   }
 
 
-  inline void
-  Evaluate(const Dispatch<2> &, const double & u, double * weights) const
+  /** The weights at the support points u, u + 1 and u + 2, for -1.5 <= u <= -0.5. */
+  static inline void
+  Evaluate(const Dispatch<2> &, const double & u, double * weights)
   {
-    // MS \todo: check
-    weights[0] = u - 1.5;
-    weights[1] = -2.0 * u + 2.0;
-    weights[2] = u - 0.5;
+    weights[0] = u + 1.5;
+    weights[1] = -2.0 * (u + 1.0);
+    weights[2] = u + 0.5;
   }
 
 
@@ -232,8 +242,8 @@ private:
   }
 
 
-  inline void
-  Evaluate(const Dispatch<3> &, const double & u, double * weights) const
+  static inline void
+  Evaluate(const Dispatch<3> &, const double & u, double * weights)
   {
     const double absValue = std::abs(u);
     const double sqrValue = u * u;
@@ -256,10 +266,10 @@ private:
 
 
   /** Unimplemented spline order */
-  inline void
-  Evaluate(const DispatchBase &, const double &, double *) const
+  static inline void
+  Evaluate(const DispatchBase &, const double &, double *)
   {
-    itkExceptionMacro("Evaluate not implemented for spline order " << SplineOrder);
+    itkGenericExceptionMacro("Evaluate not implemented for spline order " << SplineOrder);
   }
 };
 
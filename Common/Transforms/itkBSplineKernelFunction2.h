@@ -94,6 +94,17 @@ public:
   }
 
 
+  /** Evaluate the function at the entire support, without the overhead of a
+   * virtual function call. Allows the compiler to inline the weights for a
+   * spline order that is known at compile time.
+   */
+  static inline void
+  FastEvaluate(const double & u, double * weights)
+  {
+    Self::Evaluate(Dispatch<VSplineOrder>(), u, weights);
+  }
+
+
 protected:
   BSplineKernelFunction2() = default;
   ~BSplineKernelFunction2() override = default;
@@ -217,8 +228,8 @@ private:
    */
 
   /** Zeroth order spline. */
-  inline void
-  Evaluate(const Dispatch<0> &, const double & u, double * weights) const
+  static inline void
+  Evaluate(const Dispatch<0> &, const double & u, double * weights)
   {
     const double absValue = std::abs(u);
 
@@ -238,8 +249,8 @@ private:
 
 
   /** First order spline */
-  inline void
-  Evaluate(const Dispatch<1> &, const double & u, double * weights) const
+  static inline void
+  Evaluate(const Dispatch<1> &, const double & u, double * weights)
   {
     const double absValue = std::abs(u);
 
@@ -249,8 +260,8 @@ private:
 
 
   /** Second order spline. */
-  inline void
-  Evaluate(const Dispatch<2> &, const double & u, double * weights) const
+  static inline void
+  Evaluate(const Dispatch<2> &, const double & u, double * weights)
   {
     const double absValue = std::abs(u);
     const double sqrValue = u * u;
@@ -262,8 +273,8 @@ private:
 
 
   /**  Third order spline. */
-  inline void
-  Evaluate(const Dispatch<3> &, const double & u, double * weights) const
+  static inline void
+  Evaluate(const Dispatch<3> &, const double & u, double * weights)
   {
     const double absValue = std::abs(u);
     const double sqrValue = u * u;
@@ -280,11 +291,10 @@ private:
 
 
   /** Unimplemented spline order. */
-  inline double
-  Evaluate(const DispatchBase &, const double &, double *) const
+  static inline void
+  Evaluate(const DispatchBase &, const double &, double *)
   {
-    itkExceptionMacro(<< "Evaluate not implemented for spline order " << SplineOrder);
-    return 0.0;
+    itkGenericExceptionMacro(<< "Evaluate not implemented for spline order " << SplineOrder);
   }
 };
 
@@ -22,6 +22,10 @@
 
 #include "itkRecursiveBSplineInterpolationWeightFunction.h"
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 namespace itk
 {
 /** \class RecursiveBSplineTransform
@@ -30,6 +34,19 @@ namespace itk
  * The class is templated coordinate representation type (float or double),
  * the space dimension and the spline order.
  *
+ * Optionally, TransformPoint() and GetSpatialJacobian() read the coefficients from
+ * an interleaved copy, in which the SpaceDimension coefficients of a control point are
+ * stored next to each other, instead of from SpaceDimension separate coefficient images.
+ * This replaces SpaceDimension scattered loads per support point by one contiguous load.
+ * The copy is (re)built lazily, on the first call after the transform was modified,
+ * e.g. by SetParameters(). The parameters themselves keep the ITK ordering.
+ * Note that changing the parameter values in place, without calling SetParameters(),
+ * is not noticed when this option is used.
+ *
+ * With UseSinglePrecisionCoefficients, the interleaved copy is stored in float, which halves
+ * the memory traffic of the coefficients. The weights and the sums remain in ScalarType, so
+ * the only loss of precision is the rounding of the coefficients.
+ *
  * \ingroup ITKTransform
  */
 
@@ -123,6 +140,18 @@ public:
   typename DerivativeKernelType::Pointer            m_DerivativeKernel;
   typename SecondOrderDerivativeKernelType::Pointer m_SecondOrderDerivativeKernel;
 
+  /** Set/Get whether to use an interleaved copy of the coefficients. Default: false. */
+  itkSetMacro(UseInterleavedCoefficients, bool);
+  itkGetConstMacro(UseInterleavedCoefficients, bool);
+  itkBooleanMacro(UseInterleavedCoefficients);
+
+  /** Set/Get whether to use an interleaved single precision copy of the coefficients.
+   * This implies UseInterleavedCoefficients. Default: false.
+   */
+  itkSetMacro(UseSinglePrecisionCoefficients, bool);
+  itkGetConstMacro(UseSinglePrecisionCoefficients, bool);
+  itkBooleanMacro(UseSinglePrecisionCoefficients);
+
   /** Compute point transformation. This one is commonly used.
    * It calls RecursiveBSplineTransformImplementation2::InterpolateTransformPoint
    * for a recursive implementation.
@@ -201,6 +230,21 @@ private:
   RecursiveBSplineTransform(const Self &) = delete;
   void
   operator=(const Self &) = delete;
+
+  /** Returns the interleaved coefficients, stored in the given vector, and rebuilds them when
+   * the transform was modified. Thread-safe.
+   */
+  template <class TCoefficient>
+  const TCoefficient *
+  GetInterleavedCoefficients(std::vector<TCoefficient> & interleavedCoefficients) const;
+
+  /** Variables for the interleaved coefficients. */
+  bool                                  m_UseInterleavedCoefficients;
+  bool                                  m_UseSinglePrecisionCoefficients;
+  mutable std::vector<ScalarType>       m_InterleavedCoefficients;
+  mutable std::vector<float>            m_InterleavedCoefficientsFloat;
+  mutable std::atomic<ModifiedTimeType> m_InterleavedCoefficientsMTime;
+  mutable std::mutex                    m_InterleavedCoefficientsMutex;
 };
 
 } // end namespace itk
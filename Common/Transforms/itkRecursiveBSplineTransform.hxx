@@ -33,7 +33,10 @@ namespace itk
 template <typename TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
 RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::RecursiveBSplineTransform()
   : Superclass()
+  , m_InterleavedCoefficientsMTime(0)
 {
+  this->m_UseInterleavedCoefficients = false;
+  this->m_UseSinglePrecisionCoefficients = false;
   this->m_RecursiveBSplineWeightFunction = RecursiveBSplineWeightFunctionType::New();
   this->m_Kernel = KernelType::New();
   this->m_DerivativeKernel = DerivativeKernelType::New();
@@ -92,16 +95,32 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoint(co
     totalOffsetToSupportIndex += supportIndex[j] * bsplineOffsetTable[j];
   }
 
-  ScalarType * mu[SpaceDimension];
-  for (unsigned int j = 0; j < SpaceDimension; ++j)
-  {
-    mu[j] = this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
-  }
-
   /** Call the recursive TransformPoint function. */
   ScalarType displacement[SpaceDimension];
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::TransformPoint(
-    displacement, mu, bsplineOffsetTable, weightsArray1D);
+  if (this->m_UseSinglePrecisionCoefficients)
+  {
+    const float * mu = this->GetInterleavedCoefficients(this->m_InterleavedCoefficientsFloat) +
+                       totalOffsetToSupportIndex * SpaceDimension;
+    RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::
+      TransformPointInterleaved(displacement, mu, bsplineOffsetTable, weightsArray1D);
+  }
+  else if (this->m_UseInterleavedCoefficients)
+  {
+    const ScalarType * mu = this->GetInterleavedCoefficients(this->m_InterleavedCoefficients) +
+                            totalOffsetToSupportIndex * SpaceDimension;
+    RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::
+      TransformPointInterleaved(displacement, mu, bsplineOffsetTable, weightsArray1D);
+  }
+  else
+  {
+    ScalarType * mu[SpaceDimension];
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      mu[j] = this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
+    }
+    RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::TransformPoint(
+      displacement, mu, bsplineOffsetTable, weightsArray1D);
+  }
 
   // The output point is the start point + displacement.
   for (unsigned int j = 0; j < SpaceDimension; ++j)
@@ -297,17 +316,33 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetSpatialJacobia
     totalOffsetToSupportIndex += supportIndex[j] * bsplineOffsetTable[j];
   }
 
-  /** Get handles to the mu's. */
-  ScalarType * mu[SpaceDimension];
-  for (unsigned int j = 0; j < SpaceDimension; ++j)
-  {
-    mu[j] = this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
-  }
-
   /** Recursively compute the spatial Jacobian. */
   double spatialJacobian[SpaceDimension * (SpaceDimension + 1)]; // double
-  RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::GetSpatialJacobian(
-    spatialJacobian, mu, bsplineOffsetTable, weightsPointer, derivativeWeightsPointer);
+  if (this->m_UseSinglePrecisionCoefficients)
+  {
+    const float * mu = this->GetInterleavedCoefficients(this->m_InterleavedCoefficientsFloat) +
+                       totalOffsetToSupportIndex * SpaceDimension;
+    RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::
+      GetSpatialJacobianInterleaved(spatialJacobian, mu, bsplineOffsetTable, weightsPointer, derivativeWeightsPointer);
+  }
+  else if (this->m_UseInterleavedCoefficients)
+  {
+    const ScalarType * mu = this->GetInterleavedCoefficients(this->m_InterleavedCoefficients) +
+                            totalOffsetToSupportIndex * SpaceDimension;
+    RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::
+      GetSpatialJacobianInterleaved(spatialJacobian, mu, bsplineOffsetTable, weightsPointer, derivativeWeightsPointer);
+  }
+  else
+  {
+    /** Get handles to the mu's. */
+    ScalarType * mu[SpaceDimension];
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      mu[j] = this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
+    }
+    RecursiveBSplineTransformImplementation<SpaceDimension, SpaceDimension, SplineOrder, TScalar>::GetSpatialJacobian(
+      spatialJacobian, mu, bsplineOffsetTable, weightsPointer, derivativeWeightsPointer);
+  }
 
   /** Copy the correct elements to the spatial Jacobian.
    * The first SpaceDimension elements are actually the displacement, i.e. the recursive
@@ -674,6 +709,46 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::ComputeNonZeroJac
 } // end ComputeNonZeroJacobianIndices()
 
 
+/**
+ * ********************* GetInterleavedCoefficients ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+template <class TCoefficient>
+const TCoefficient *
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetInterleavedCoefficients(
+  std::vector<TCoefficient> & interleavedCoefficients) const
+{
+  /** Rebuild the interleaved copy only when the transform was modified since the last build.
+   * The MTime is checked again after locking, so that only one thread does the work.
+   */
+  const ModifiedTimeType mtime = this->GetMTime();
+  if (this->m_InterleavedCoefficientsMTime.load(std::memory_order_acquire) != mtime)
+  {
+    const std::lock_guard<std::mutex> lock(this->m_InterleavedCoefficientsMutex);
+    if (this->m_InterleavedCoefficientsMTime.load(std::memory_order_relaxed) != mtime)
+    {
+      const SizeValueType numberOfControlPoints = this->m_CoefficientImages[0]->GetBufferedRegion().GetNumberOfPixels();
+      interleavedCoefficients.resize(numberOfControlPoints * SpaceDimension);
+
+      TCoefficient * interleaved = interleavedCoefficients.data();
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        const ScalarType * coefficients = this->m_CoefficientImages[j]->GetBufferPointer();
+        for (SizeValueType i = 0; i < numberOfControlPoints; ++i)
+        {
+          interleaved[i * SpaceDimension + j] = static_cast<TCoefficient>(coefficients[i]);
+        }
+      }
+      this->m_InterleavedCoefficientsMTime.store(mtime, std::memory_order_release);
+    }
+  }
+
+  return interleavedCoefficients.data();
+
+} // end GetInterleavedCoefficients()
+
+
 } // end namespace itk
 
 #endif
@@ -102,6 +102,45 @@ public:
   } // end TransformPoint()
 
 
+  /** TransformPoint recursive implementation, for interleaved coefficients.
+   * The OutputDimension coefficients of a control point are stored contiguously,
+   * so mu is a single pointer, and the grid offsets are multiplied by OutputDimension.
+   * The coefficients may be stored in single precision; the sums are computed in ScalarType.
+   */
+  template <class TCoefficient>
+  static inline void
+  TransformPointInterleaved(OutputPointType         opp,
+                            const TCoefficient *    mu,
+                            const OffsetValueType * gridOffsetTable,
+                            const double *          weights1D)
+  {
+    /** Create a temporary opp and initialize the original. */
+    ScalarType tmp_opp[OutputDimension];
+    for (unsigned int j = 0; j < OutputDimension; ++j)
+    {
+      opp[j] = 0.0;
+    }
+
+    const OffsetValueType bot = gridOffsetTable[SpaceDimension - 1] * OutputDimension;
+    for (unsigned int k = 0; k <= SplineOrder; ++k)
+    {
+      /** Recurse. */
+      RecursiveBSplineTransformImplementation<OutputDimension, SpaceDimension - 1, SplineOrder, TScalar>::
+        TransformPointInterleaved(tmp_opp, mu, gridOffsetTable, weights1D);
+
+      /** Accumulate the weights. */
+      const double w = weights1D[k + HelperConstVariable];
+      for (unsigned int j = 0; j < OutputDimension; ++j)
+      {
+        opp[j] += tmp_opp[j] * w;
+      }
+
+      // move to the next mu
+      mu += bot;
+    }
+  } // end TransformPointInterleaved()
+
+
   /** GetJacobian recursive implementation. */
   static inline void
   GetJacobian(ScalarType *& jacobians, const double * weights1D, double value)
@@ -201,6 +240,47 @@ public:
   } // end GetSpatialJacobian()
 
 
+  /** GetSpatialJacobian recursive implementation, for interleaved coefficients. */
+  template <class TCoefficient>
+  static inline void
+  GetSpatialJacobianInterleaved(InternalFloatType *     sj,
+                                const TCoefficient *    mu,
+                                const OffsetValueType * gridOffsetTable,
+                                const double *          weights1D, // normal B-spline weights
+                                const double *          derivativeWeights1D) // 1st derivative of B-spline
+  {
+    /** Create a temporary sj and initialize the original. */
+    InternalFloatType tmp_sj[OutputDimension * SpaceDimension];
+    for (unsigned int n = 0; n < OutputDimension * (SpaceDimension + 1); ++n)
+    {
+      sj[n] = 0.0;
+    }
+
+    const OffsetValueType bot = gridOffsetTable[SpaceDimension - 1] * OutputDimension;
+    for (unsigned int k = 0; k <= SplineOrder; ++k)
+    {
+      /** Recurse. */
+      RecursiveBSplineTransformImplementation<OutputDimension, SpaceDimension - 1, SplineOrder, TScalar>::
+        GetSpatialJacobianInterleaved(tmp_sj, mu, gridOffsetTable, weights1D, derivativeWeights1D);
+
+      /** Accumulate the weights part. */
+      for (unsigned int n = 0; n < OutputDimension * SpaceDimension; ++n)
+      {
+        sj[n] += tmp_sj[n] * weights1D[k + HelperConstVariable];
+      }
+
+      /** Accumulate the derivative weights part. */
+      for (unsigned int j = 0; j < OutputDimension; ++j)
+      {
+        sj[OutputDimension * SpaceDimension + j] += tmp_sj[j] * derivativeWeights1D[k + HelperConstVariable];
+      }
+
+      // move to the next mu
+      mu += bot;
+    }
+  } // end GetSpatialJacobianInterleaved()
+
+
   /** GetSpatialHessian recursive implementation.
    * As an (almost) free by-product this function delivers the displacement,
    * i.e. the TransformPoint() function, as well as the SpatialJacobian.
@@ -403,6 +483,21 @@ public:
   } // end TransformPoint()
 
 
+  /** TransformPoint recursive implementation, for interleaved coefficients. */
+  template <class TCoefficient>
+  static inline void
+  TransformPointInterleaved(OutputPointType         opp,
+                            const TCoefficient *    mu,
+                            const OffsetValueType * gridOffsetTable,
+                            const double *          weights1D)
+  {
+    for (unsigned int j = 0; j < OutputDimension; ++j)
+    {
+      opp[j] = mu[j];
+    }
+  } // end TransformPointInterleaved()
+
+
   /** GetJacobian recursive implementation. */
   static inline void
   GetJacobian(ScalarType *& jacobians, const double * weights1D, double value)
@@ -462,6 +557,22 @@ public:
   } // end GetSpatialJacobian()
 
 
+  /** GetSpatialJacobian recursive implementation, for interleaved coefficients. */
+  template <class TCoefficient>
+  static inline void
+  GetSpatialJacobianInterleaved(InternalFloatType *     sj,
+                                const TCoefficient *    mu,
+                                const OffsetValueType * gridOffsetTable,
+                                const double *          weights1D, // normal B-spline weights
+                                const double *          derivativeWeights1D) // 1st derivative of B-spline
+  {
+    for (unsigned int j = 0; j < OutputDimension; ++j)
+    {
+      sj[j] = mu[j];
+    }
+  } // end GetSpatialJacobianInterleaved()
+
+
   /** GetSpatialHessian recursive implementation. */
   static inline void
   GetSpatialHessian(InternalFloatType *                sh,
@@ -37,6 +37,8 @@
 #include "itkAdvancedTransform.h"
 #include "itkImageSource.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -60,7 +62,13 @@ namespace itk
  * ProcessObject::GenerateOutputInformation().
  *
  * This filter is implemented as a multithreaded filter.  It provides a
- * ThreadedGenerateData() method for its implementation.
+ * ThreadedGenerateData() method for its implementation. It supports streaming,
+ * so the output may be generated (and written) region by region.
+ *
+ * While generating the output, the minimum and maximum determinant, and the
+ * number of folding voxels (determinant <= 0) are gathered. These statistics
+ * cover all regions generated since the last call to GenerateOutputInformation(),
+ * so after a (streamed) update they describe the whole output image.
  *
  * \author Marius Staring, Leiden University Medical Center, The Netherlands.
  *
@@ -185,6 +193,16 @@ public:
   ModifiedTimeType
   GetMTime(void) const override;
 
+  /** Statistics of the determinant over the generated voxels. */
+  itkGetConstMacro(MinimumDeterminant, double);
+  itkGetConstMacro(MaximumDeterminant, double);
+  itkGetConstMacro(NumberOfFoldingVoxels, SizeValueType);
+  itkGetConstMacro(NumberOfGeneratedVoxels, SizeValueType);
+
+  /** Returns the number of folding voxels divided by the number of generated voxels. */
+  double
+  GetFractionOfFoldingVoxels(void) const;
+
 protected:
   TransformToDeterminantOfSpatialJacobianSource();
   ~TransformToDeterminantOfSpatialJacobianSource() override = default;
@@ -198,6 +216,10 @@ protected:
   void
   ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId) override;
 
+  /** Merges the statistics of the threads. */
+  void
+  AfterThreadedGenerateData(void) override;
+
   /** Default implementation for resampling that works for any
    * transformation type.
    */
@@ -220,6 +242,22 @@ private:
   SpacingType          m_OutputSpacing;   // output image spacing
   OriginType           m_OutputOrigin;    // output image origin
   DirectionType        m_OutputDirection; // output image direction cosines
+
+  /** Statistics, gathered over all generated regions. */
+  double        m_MinimumDeterminant;
+  double        m_MaximumDeterminant;
+  SizeValueType m_NumberOfFoldingVoxels;
+  SizeValueType m_NumberOfGeneratedVoxels;
+
+  /** Statistics per thread, for the region that is currently generated. */
+  struct ThreadStatisticsType
+  {
+    double        st_MinimumDeterminant;
+    double        st_MaximumDeterminant;
+    SizeValueType st_NumberOfFoldingVoxels;
+    SizeValueType st_NumberOfGeneratedVoxels;
+  };
+  std::vector<ThreadStatisticsType> m_ThreadStatistics;
 };
 
 } // end namespace itk
@@ -38,9 +38,11 @@
 
 #include "itkAdvancedIdentityTransform.h"
 #include "itkProgressReporter.h"
-#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "vnl/vnl_det.h"
 
+#include <algorithm> // For min and max.
+
 namespace itk
 {
 
@@ -65,6 +67,11 @@ TransformToDeterminantOfSpatialJacobianSource<TOutputImage,
 
   this->m_Transform = AdvancedIdentityTransform<TTransformPrecisionType, ImageDimension>::New();
 
+  this->m_MinimumDeterminant = NumericTraits<double>::max();
+  this->m_MaximumDeterminant = NumericTraits<double>::NonpositiveMin();
+  this->m_NumberOfFoldingVoxels = 0;
+  this->m_NumberOfGeneratedVoxels = 0;
+
   // Use the classic (ITK4) threading model, to ensure ThreadedGenerateData is being called.
   this->itk::ImageSource<TOutputImage>::DynamicMultiThreadingOff();
 
@@ -196,6 +203,12 @@ TransformToDeterminantOfSpatialJacobianSource<TOutputImage, TTransformPrecisionT
     itkExceptionMacro(<< "Transform not set");
   }
 
+  // Initialize the statistics of each thread
+  const ThreadStatisticsType emptyStatistics = {
+    NumericTraits<double>::max(), NumericTraits<double>::NonpositiveMin(), 0, 0
+  };
+  this->m_ThreadStatistics.assign(this->GetNumberOfWorkUnits(), emptyStatistics);
+
   // Check whether we can use a fast path for resampling. Fast path
   // can be used if the transformation is linear. Transform respond
   // to the IsLinear() call.
@@ -240,35 +253,102 @@ TransformToDeterminantOfSpatialJacobianSource<TOutputImage, TTransformPrecisionT
   OutputImagePointer outputPtr = this->GetOutput();
 
   // Create an iterator that will walk the output region for this thread.
-  typedef ImageRegionIteratorWithIndex<TOutputImage> OutputIteratorType;
-  OutputIteratorType                                 it(outputPtr, outputRegionForThread);
-  it.GoToBegin();
+  typedef ImageScanlineIterator<TOutputImage> OutputIteratorType;
+  OutputIteratorType                          it(outputPtr, outputRegionForThread);
 
-  // pixel coordinates
-  PointType point;
+  // The physical step between two consecutive voxels on a scanline
+  typename PointType::VectorType scanlineStep;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    scanlineStep[i] = outputPtr->GetDirection()[i][0] * outputPtr->GetSpacing()[0];
+  }
+
+  // Statistics of this thread
+  double        minimum = NumericTraits<double>::max();
+  double        maximum = NumericTraits<double>::NonpositiveMin();
+  SizeValueType numberOfFoldingVoxels = 0;
 
   // Support for progress methods/callbacks
   ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
   // Walk the output region
+  SpatialJacobianType sj;
   while (!it.IsAtEnd())
   {
-    // Determine the coordinates of the current voxel
+    // Determine the coordinates of the first voxel of this line
+    PointType point;
     outputPtr->TransformIndexToPhysicalPoint(it.GetIndex(), point);
 
-    SpatialJacobianType sj;
-    this->m_Transform->GetSpatialJacobian(point, sj);
-    const PixelType detjac = static_cast<PixelType>(vnl_det(sj.GetVnlMatrix()));
+    while (!it.IsAtEndOfLine())
+    {
+      this->m_Transform->GetSpatialJacobian(point, sj);
+      const double detjac = vnl_det(sj.GetVnlMatrix());
+
+      // Set it
+      it.Set(static_cast<PixelType>(detjac));
+
+      // Update the statistics
+      minimum = std::min(minimum, detjac);
+      maximum = std::max(maximum, detjac);
+      if (detjac <= 0.0)
+      {
+        ++numberOfFoldingVoxels;
+      }
+
+      // Update progress, iterator and coordinates
+      progress.CompletedPixel();
+      point += scanlineStep;
+      ++it;
+    }
+    it.NextLine();
+  }
+
+  // Store the statistics of this thread
+  ThreadStatisticsType & threadStatistics = this->m_ThreadStatistics[threadId];
+  threadStatistics.st_MinimumDeterminant = minimum;
+  threadStatistics.st_MaximumDeterminant = maximum;
+  threadStatistics.st_NumberOfFoldingVoxels = numberOfFoldingVoxels;
+  threadStatistics.st_NumberOfGeneratedVoxels = outputRegionForThread.GetNumberOfPixels();
+
+} // end NonlinearThreadedGenerateData()
+
+
+/**
+ * AfterThreadedGenerateData
+ */
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDeterminantOfSpatialJacobianSource<TOutputImage, TTransformPrecisionType>::AfterThreadedGenerateData(void)
+{
+  for (const ThreadStatisticsType & threadStatistics : this->m_ThreadStatistics)
+  {
+    if (threadStatistics.st_NumberOfGeneratedVoxels > 0)
+    {
+      this->m_MinimumDeterminant = std::min(this->m_MinimumDeterminant, threadStatistics.st_MinimumDeterminant);
+      this->m_MaximumDeterminant = std::max(this->m_MaximumDeterminant, threadStatistics.st_MaximumDeterminant);
+      this->m_NumberOfFoldingVoxels += threadStatistics.st_NumberOfFoldingVoxels;
+      this->m_NumberOfGeneratedVoxels += threadStatistics.st_NumberOfGeneratedVoxels;
+    }
+  }
+
+} // end AfterThreadedGenerateData()
 
-    // Set it
-    it.Set(detjac);
 
-    // Update progress and iterator
-    progress.CompletedPixel();
-    ++it;
+/**
+ * GetFractionOfFoldingVoxels
+ */
+template <class TOutputImage, class TTransformPrecisionType>
+double
+TransformToDeterminantOfSpatialJacobianSource<TOutputImage, TTransformPrecisionType>::GetFractionOfFoldingVoxels(
+  void) const
+{
+  if (this->m_NumberOfGeneratedVoxels == 0)
+  {
+    return 0.0;
   }
+  return static_cast<double>(this->m_NumberOfFoldingVoxels) / static_cast<double>(this->m_NumberOfGeneratedVoxels);
 
-} // end NonlinearThreadedGenerateData()
+} // end GetFractionOfFoldingVoxels()
 
 
 template <class TOutputImage, class TTransformPrecisionType>
@@ -289,9 +369,16 @@ TransformToDeterminantOfSpatialJacobianSource<TOutputImage, TTransformPrecisionT
   outputPtr->TransformIndexToPhysicalPoint(index, point);
   SpatialJacobianType sj;
   this->m_Transform->GetSpatialJacobian(point, sj);
-  const PixelType detjac = static_cast<PixelType>(vnl_det(sj.GetVnlMatrix()));
+  const double detjac = vnl_det(sj.GetVnlMatrix());
 
-  outputPtr->FillBuffer(detjac);
+  outputPtr->FillBuffer(static_cast<PixelType>(detjac));
+
+  // Update the statistics; the determinant is the same for all voxels
+  const SizeValueType numberOfVoxels = outputPtr->GetBufferedRegion().GetNumberOfPixels();
+  this->m_MinimumDeterminant = std::min(this->m_MinimumDeterminant, detjac);
+  this->m_MaximumDeterminant = std::max(this->m_MaximumDeterminant, detjac);
+  this->m_NumberOfFoldingVoxels += (detjac <= 0.0) ? numberOfVoxels : 0;
+  this->m_NumberOfGeneratedVoxels += numberOfVoxels;
 
 } // end LinearThreadedGenerateData()
 
@@ -317,7 +404,13 @@ TransformToDeterminantOfSpatialJacobianSource<TOutputImage, TTransformPrecisionT
   outputPtr->SetSpacing(m_OutputSpacing);
   outputPtr->SetOrigin(m_OutputOrigin);
   outputPtr->SetDirection(m_OutputDirection);
-  outputPtr->Allocate();
+
+  // Start gathering the statistics. The output is not allocated here, but
+  // region by region, to support streaming.
+  this->m_MinimumDeterminant = NumericTraits<double>::max();
+  this->m_MaximumDeterminant = NumericTraits<double>::NonpositiveMin();
+  this->m_NumberOfFoldingVoxels = 0;
+  this->m_NumberOfGeneratedVoxels = 0;
 
 } // end GenerateOutputInformation()
 
@@ -0,0 +1,256 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTransformToInverseDisplacementFieldSource_h
+#define itkTransformToInverseDisplacementFieldSource_h
+
+#include "itkAdvancedTransform.h"
+#include "itkImageSource.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class TransformToInverseDisplacementFieldSource
+ * \brief Generate the displacement field of the inverse of a coordinate transform
+ *
+ * For every voxel y of the output image, the point x with T(x) = y is searched by the
+ * fixed-point iteration x <- x + J^{-1} ( y - T(x) ), in which J is the spatial Jacobian
+ * of T at the starting point x. The output pixel is the inverse displacement x - y.
+ * The iteration stops when the residual |y - T(x)| is below the Tolerance (in physical
+ * units), or after MaximumNumberOfIterations. For linear transforms it converges in
+ * one iteration.
+ *
+ * The starting point of each voxel is taken from a coarse inverse, which is generated
+ * first, by this same filter, on a grid that is CoarseGridShrinkFactor times coarser
+ * than the output grid. The coarse inverse is linearly interpolated. A shrink factor
+ * of 1 turns this off, in which case the iteration starts at x = y.
+ *
+ * Output information (spacing, size and direction) for the output image should be
+ * set, like for the TransformToDeterminantOfSpatialJacobianSource. The domain of the
+ * output is the domain of the inverse, so typically the moving image domain of a
+ * registration.
+ *
+ * While generating the output, the maximum residual and the number of voxels for which
+ * the iteration did not converge are gathered. These statistics cover all regions
+ * generated since the last call to GenerateOutputInformation().
+ *
+ * This filter is implemented as a multithreaded filter. It supports streaming.
+ *
+ * \ingroup GeometricTransforms
+ */
+template <class TOutputImage, class TTransformPrecisionType = double>
+class ITK_TEMPLATE_EXPORT TransformToInverseDisplacementFieldSource : public ImageSource<TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(TransformToInverseDisplacementFieldSource);
+
+  /** Standard class typedefs. */
+  typedef TransformToInverseDisplacementFieldSource Self;
+  typedef ImageSource<TOutputImage>                 Superclass;
+  typedef SmartPointer<Self>                        Pointer;
+  typedef SmartPointer<const Self>                  ConstPointer;
+
+  typedef TOutputImage                           OutputImageType;
+  typedef typename OutputImageType::Pointer      OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType   OutputImageRegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TransformToInverseDisplacementFieldSource, ImageSource);
+
+  /** Number of dimensions. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  /** Typedefs for transform. */
+  typedef AdvancedTransform<TTransformPrecisionType, Self::ImageDimension, Self::ImageDimension> TransformType;
+  typedef typename TransformType::ConstPointer                                                   TransformPointerType;
+  typedef typename TransformType::InputPointType                                                 InputPointType;
+  typedef typename TransformType::OutputVectorType                                               OutputVectorType;
+  typedef typename TransformType::SpatialJacobianType                                            SpatialJacobianType;
+
+  /** Typedefs for output image. */
+  typedef typename OutputImageType::PixelType     PixelType;
+  typedef typename OutputImageType::RegionType    RegionType;
+  typedef typename RegionType::SizeType           SizeType;
+  typedef typename OutputImageType::IndexType     IndexType;
+  typedef typename OutputImageType::PointType     PointType;
+  typedef typename OutputImageType::SpacingType   SpacingType;
+  typedef typename OutputImageType::PointType     OriginType;
+  typedef typename OutputImageType::DirectionType DirectionType;
+
+  /** Typedefs for base image. */
+  typedef ImageBase<Self::ImageDimension> ImageBaseType;
+
+  /** Set the coordinate transformation, of which the inverse is generated. */
+  itkSetConstObjectMacro(Transform, TransformType);
+
+  /** Get a pointer to the coordinate transform. */
+  itkGetConstObjectMacro(Transform, TransformType);
+
+  /** Set the size of the output image. */
+  virtual void
+  SetOutputSize(const SizeType & size);
+
+  /** Get the size of the output image. */
+  virtual const SizeType &
+  GetOutputSize();
+
+  /** Set the start index of the output largest possible region.
+   * The default is an index of all zeros. */
+  virtual void
+  SetOutputIndex(const IndexType & index);
+
+  /** Get the start index of the output largest possible region. */
+  virtual const IndexType &
+  GetOutputIndex();
+
+  /** Set the region of the output image. */
+  itkSetMacro(OutputRegion, OutputImageRegionType);
+
+  /** Get the region of the output image. */
+  itkGetConstReferenceMacro(OutputRegion, OutputImageRegionType);
+
+  /** Set the output image spacing. */
+  itkSetMacro(OutputSpacing, SpacingType);
+  virtual void
+  SetOutputSpacing(const double * values);
+
+  /** Get the output image spacing. */
+  itkGetConstReferenceMacro(OutputSpacing, SpacingType);
+
+  /** Set the output image origin. */
+  itkSetMacro(OutputOrigin, OriginType);
+  virtual void
+  SetOutputOrigin(const double * values);
+
+  /** Get the output image origin. */
+  itkGetConstReferenceMacro(OutputOrigin, OriginType);
+
+  /** Set the output direction cosine matrix. */
+  itkSetMacro(OutputDirection, DirectionType);
+  itkGetConstReferenceMacro(OutputDirection, DirectionType);
+
+  /** Helper method to set the output parameters based on this image */
+  void
+  SetOutputParametersFromImage(const ImageBaseType * image);
+
+  /** Set/Get the maximum number of fixed-point iterations per voxel. Default: 20. */
+  itkSetMacro(MaximumNumberOfIterations, unsigned int);
+  itkGetConstMacro(MaximumNumberOfIterations, unsigned int);
+
+  /** Set/Get the residual |y - T(x)|, in physical units, below which the iteration
+   * has converged. Default: 0.01.
+   */
+  itkSetMacro(Tolerance, double);
+  itkGetConstMacro(Tolerance, double);
+
+  /** Set/Get the factor by which the grid of the coarse inverse, that gives the starting
+   * points, is coarser than the output grid. Default: 4. A factor of 1 turns it off.
+   */
+  itkSetClampMacro(CoarseGridShrinkFactor, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(CoarseGridShrinkFactor, unsigned int);
+
+  /** TransformToInverseDisplacementFieldSource produces a vector image. */
+  void
+  GenerateOutputInformation(void) override;
+
+  /** Checks if the transform is set, and generates the coarse inverse. */
+  void
+  BeforeThreadedGenerateData(void) override;
+
+  /** Compute the Modified Time based on changes to the components. */
+  ModifiedTimeType
+  GetMTime(void) const override;
+
+  /** Statistics of the iteration over the generated voxels. */
+  itkGetConstMacro(MaximumResidual, double);
+  itkGetConstMacro(NumberOfNonConvergedVoxels, SizeValueType);
+  itkGetConstMacro(NumberOfGeneratedVoxels, SizeValueType);
+
+  /** Returns the mean number of iterations per generated voxel. */
+  double
+  GetMeanNumberOfIterations(void) const;
+
+protected:
+  TransformToInverseDisplacementFieldSource();
+  ~TransformToInverseDisplacementFieldSource() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** TransformToInverseDisplacementFieldSource is implemented as a multithreaded filter. */
+  void
+  ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId) override;
+
+  /** Merges the statistics of the threads. */
+  void
+  AfterThreadedGenerateData(void) override;
+
+  /** Searches the point x with T(x) = y, starting at the given x. On return, x is the
+   * point with the smallest residual that was visited. Returns whether the iteration
+   * converged.
+   */
+  bool
+  InvertPoint(const InputPointType & y, InputPointType & x, double & residual, unsigned int & iterations) const;
+
+private:
+  typedef VectorLinearInterpolateImageFunction<TOutputImage, TTransformPrecisionType> CoarseInverseInterpolatorType;
+
+  /** Member variables. */
+  RegionType           m_OutputRegion;    // region of the output image
+  TransformPointerType m_Transform;       // Coordinate transform to use
+  SpacingType          m_OutputSpacing;   // output image spacing
+  OriginType           m_OutputOrigin;    // output image origin
+  DirectionType        m_OutputDirection; // output image direction cosines
+
+  unsigned int m_MaximumNumberOfIterations{ 20 };
+  double       m_Tolerance{ 0.01 };
+  unsigned int m_CoarseGridShrinkFactor{ 4 };
+
+  /** The coarse inverse, generated once per update, before the first region. */
+  typename CoarseInverseInterpolatorType::Pointer m_CoarseInverseInterpolator;
+
+  /** Statistics, gathered over all generated regions. */
+  double        m_MaximumResidual{ 0.0 };
+  SizeValueType m_NumberOfNonConvergedVoxels{ 0 };
+  SizeValueType m_NumberOfGeneratedVoxels{ 0 };
+  SizeValueType m_TotalNumberOfIterations{ 0 };
+
+  /** Statistics per thread, for the region that is currently generated. */
+  struct ThreadStatisticsType
+  {
+    double        st_MaximumResidual;
+    SizeValueType st_NumberOfNonConvergedVoxels;
+    SizeValueType st_NumberOfGeneratedVoxels;
+    SizeValueType st_TotalNumberOfIterations;
+  };
+  std::vector<ThreadStatisticsType> m_ThreadStatistics;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTransformToInverseDisplacementFieldSource.hxx"
+#endif
+
+#endif // end #ifndef itkTransformToInverseDisplacementFieldSource_h
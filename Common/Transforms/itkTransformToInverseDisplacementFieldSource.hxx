@@ -0,0 +1,497 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTransformToInverseDisplacementFieldSource_hxx
+#define itkTransformToInverseDisplacementFieldSource_hxx
+
+#include "itkTransformToInverseDisplacementFieldSource.h"
+
+#include "itkAdvancedIdentityTransform.h"
+#include "itkProgressReporter.h"
+#include "itkImageScanlineIterator.h"
+#include "vnl/vnl_det.h"
+
+#include <algorithm> // For max.
+#include <cmath>     // For abs.
+
+namespace itk
+{
+
+/**
+ * ********************* Constructor ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::
+  TransformToInverseDisplacementFieldSource()
+{
+  this->m_OutputSpacing.Fill(1.0);
+  this->m_OutputOrigin.Fill(0.0);
+  this->m_OutputDirection.SetIdentity();
+
+  SizeType size;
+  size.Fill(0);
+  this->m_OutputRegion.SetSize(size);
+
+  IndexType index;
+  index.Fill(0);
+  this->m_OutputRegion.SetIndex(index);
+
+  this->m_Transform = AdvancedIdentityTransform<TTransformPrecisionType, ImageDimension>::New();
+
+  // Use the classic (ITK4) threading model, to ensure ThreadedGenerateData is being called.
+  this->itk::ImageSource<TOutputImage>::DynamicMultiThreadingOff();
+
+} // end Constructor
+
+
+/**
+ * ********************* PrintSelf ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::PrintSelf(std::ostream & os,
+                                                                                            Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "OutputRegion: " << this->m_OutputRegion << std::endl;
+  os << indent << "OutputSpacing: " << this->m_OutputSpacing << std::endl;
+  os << indent << "OutputOrigin: " << this->m_OutputOrigin << std::endl;
+  os << indent << "OutputDirection: " << this->m_OutputDirection << std::endl;
+  os << indent << "Transform: " << this->m_Transform.GetPointer() << std::endl;
+  os << indent << "MaximumNumberOfIterations: " << this->m_MaximumNumberOfIterations << std::endl;
+  os << indent << "Tolerance: " << this->m_Tolerance << std::endl;
+  os << indent << "CoarseGridShrinkFactor: " << this->m_CoarseGridShrinkFactor << std::endl;
+
+} // end PrintSelf()
+
+
+/**
+ * ********************* SetOutputSize ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputSize(const SizeType & size)
+{
+  this->m_OutputRegion.SetSize(size);
+}
+
+
+/**
+ * ********************* GetOutputSize ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+const typename TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SizeType &
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetOutputSize()
+{
+  return this->m_OutputRegion.GetSize();
+}
+
+
+/**
+ * ********************* SetOutputIndex ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputIndex(
+  const IndexType & index)
+{
+  this->m_OutputRegion.SetIndex(index);
+}
+
+
+/**
+ * ********************* GetOutputIndex ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+const typename TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::IndexType &
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetOutputIndex()
+{
+  return this->m_OutputRegion.GetIndex();
+}
+
+
+/**
+ * ********************* SetOutputSpacing ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputSpacing(
+  const double * spacing)
+{
+  SpacingType s(spacing);
+  this->SetOutputSpacing(s);
+
+} // end SetOutputSpacing()
+
+
+/**
+ * ********************* SetOutputOrigin ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputOrigin(
+  const double * origin)
+{
+  OriginType p(origin);
+  this->SetOutputOrigin(p);
+
+} // end SetOutputOrigin()
+
+
+/**
+ * ********************* SetOutputParametersFromImage ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputParametersFromImage(
+  const ImageBaseType * image)
+{
+  if (!image)
+  {
+    itkExceptionMacro(<< "Cannot use a null image reference");
+  }
+
+  this->SetOutputOrigin(image->GetOrigin());
+  this->SetOutputSpacing(image->GetSpacing());
+  this->SetOutputDirection(image->GetDirection());
+  this->SetOutputRegion(image->GetLargestPossibleRegion());
+
+} // end SetOutputParametersFromImage()
+
+
+/**
+ * ********************* BeforeThreadedGenerateData ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::BeforeThreadedGenerateData(void)
+{
+  if (!this->m_Transform)
+  {
+    itkExceptionMacro(<< "Transform not set");
+  }
+
+  // Initialize the statistics of each thread
+  const ThreadStatisticsType emptyStatistics = { 0.0, 0, 0, 0 };
+  this->m_ThreadStatistics.assign(this->GetNumberOfWorkUnits(), emptyStatistics);
+
+  // Generate the coarse inverse, once for all regions of a streamed update.
+  const SizeValueType shrinkFactor = this->m_CoarseGridShrinkFactor;
+  if (shrinkFactor <= 1 || this->m_CoarseInverseInterpolator)
+  {
+    return;
+  }
+
+  // The coarse grid starts at the first voxel of the output, and covers its last voxel.
+  OutputImagePointer outputPtr = this->GetOutput();
+  const RegionType & region = outputPtr->GetLargestPossibleRegion();
+  SizeType           coarseSize;
+  SpacingType        coarseSpacing;
+  bool               isCoarser = false;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    const SizeValueType size = std::max<SizeValueType>(region.GetSize()[i], 1);
+    coarseSize[i] = (size - 1 + shrinkFactor - 1) / shrinkFactor + 1;
+    coarseSpacing[i] = outputPtr->GetSpacing()[i] * shrinkFactor;
+    isCoarser |= (coarseSize[i] < size);
+  }
+  if (!isCoarser)
+  {
+    return;
+  }
+  PointType coarseOrigin;
+  outputPtr->TransformIndexToPhysicalPoint(region.GetIndex(), coarseOrigin);
+
+  const auto coarseSource = Self::New();
+  coarseSource->SetTransform(this->m_Transform);
+  coarseSource->SetOutputSize(coarseSize);
+  coarseSource->SetOutputSpacing(coarseSpacing);
+  coarseSource->SetOutputOrigin(coarseOrigin);
+  coarseSource->SetOutputDirection(outputPtr->GetDirection());
+  coarseSource->SetMaximumNumberOfIterations(this->m_MaximumNumberOfIterations);
+  coarseSource->SetTolerance(this->m_Tolerance);
+  coarseSource->SetCoarseGridShrinkFactor(1);
+  coarseSource->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  coarseSource->Update();
+
+  this->m_CoarseInverseInterpolator = CoarseInverseInterpolatorType::New();
+  this->m_CoarseInverseInterpolator->SetInputImage(coarseSource->GetOutput());
+
+} // end BeforeThreadedGenerateData()
+
+
+/**
+ * ********************* ThreadedGenerateData ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType                  threadId)
+{
+  // Get the output pointer
+  OutputImagePointer outputPtr = this->GetOutput();
+
+  // Create an iterator that will walk the output region for this thread.
+  typedef ImageScanlineIterator<TOutputImage> OutputIteratorType;
+  OutputIteratorType                          it(outputPtr, outputRegionForThread);
+
+  // The physical step between two consecutive voxels on a scanline
+  typename PointType::VectorType scanlineStep;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    scanlineStep[i] = outputPtr->GetDirection()[i][0] * outputPtr->GetSpacing()[0];
+  }
+
+  const CoarseInverseInterpolatorType * const coarseInverse = this->m_CoarseInverseInterpolator.GetPointer();
+
+  // Statistics of this thread
+  double        maximumResidual = 0.0;
+  SizeValueType numberOfNonConvergedVoxels = 0;
+  SizeValueType totalNumberOfIterations = 0;
+
+  // Support for progress methods/callbacks
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // Walk the output region
+  while (!it.IsAtEnd())
+  {
+    // Determine the coordinates of the first voxel of this line
+    PointType point;
+    outputPtr->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+
+    while (!it.IsAtEndOfLine())
+    {
+      // Start at the coarse inverse, if available, or else at the point itself
+      InputPointType y;
+      InputPointType x;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        y[i] = static_cast<TTransformPrecisionType>(point[i]);
+      }
+      x = y;
+      if (coarseInverse != nullptr && coarseInverse->IsInsideBuffer(y))
+      {
+        const auto coarseDisplacement = coarseInverse->Evaluate(y);
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          x[i] += coarseDisplacement[i];
+        }
+      }
+
+      double       residual = 0.0;
+      unsigned int iterations = 0;
+      if (!this->InvertPoint(y, x, residual, iterations))
+      {
+        ++numberOfNonConvergedVoxels;
+      }
+
+      // Set the inverse displacement
+      PixelType displacement;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        displacement[i] = static_cast<typename PixelType::ValueType>(x[i] - y[i]);
+      }
+      it.Set(displacement);
+
+      // Update the statistics
+      maximumResidual = std::max(maximumResidual, residual);
+      totalNumberOfIterations += iterations;
+
+      // Update progress, iterator and coordinates
+      progress.CompletedPixel();
+      point += scanlineStep;
+      ++it;
+    }
+    it.NextLine();
+  }
+
+  // Store the statistics of this thread
+  ThreadStatisticsType & threadStatistics = this->m_ThreadStatistics[threadId];
+  threadStatistics.st_MaximumResidual = maximumResidual;
+  threadStatistics.st_NumberOfNonConvergedVoxels = numberOfNonConvergedVoxels;
+  threadStatistics.st_NumberOfGeneratedVoxels = outputRegionForThread.GetNumberOfPixels();
+  threadStatistics.st_TotalNumberOfIterations = totalNumberOfIterations;
+
+} // end ThreadedGenerateData()
+
+
+/**
+ * ********************* InvertPoint ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+bool
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::InvertPoint(
+  const InputPointType & y,
+  InputPointType &       x,
+  double &               residual,
+  unsigned int &         iterations) const
+{
+  // The step is preconditioned with the inverse spatial Jacobian at the starting point,
+  // which is kept fixed, so that each iteration costs only one point transformation.
+  // If the Jacobian is (nearly) singular, the plain fixed-point step x <- x + (y - T(x)) is taken.
+  SpatialJacobianType sj;
+  this->m_Transform->GetSpatialJacobian(x, sj);
+  SpatialJacobianType preconditioner;
+  if (std::abs(vnl_det(sj.GetVnlMatrix())) > 1e-6)
+  {
+    preconditioner = sj.GetInverse();
+  }
+  else
+  {
+    preconditioner.SetIdentity();
+  }
+
+  InputPointType bestPoint = x;
+  double         bestResidual = NumericTraits<double>::max();
+  iterations = 0;
+  while (true)
+  {
+    const OutputVectorType difference = y - this->m_Transform->TransformPoint(x);
+    const double           norm = difference.GetNorm();
+    if (norm < bestResidual)
+    {
+      bestResidual = norm;
+      bestPoint = x;
+    }
+    if (norm <= this->m_Tolerance || iterations >= this->m_MaximumNumberOfIterations)
+    {
+      break;
+    }
+    x += preconditioner * difference;
+    ++iterations;
+  }
+
+  x = bestPoint;
+  residual = bestResidual;
+  return bestResidual <= this->m_Tolerance;
+
+} // end InvertPoint()
+
+
+/**
+ * ********************* AfterThreadedGenerateData ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::AfterThreadedGenerateData(void)
+{
+  for (const ThreadStatisticsType & threadStatistics : this->m_ThreadStatistics)
+  {
+    if (threadStatistics.st_NumberOfGeneratedVoxels > 0)
+    {
+      this->m_MaximumResidual = std::max(this->m_MaximumResidual, threadStatistics.st_MaximumResidual);
+      this->m_NumberOfNonConvergedVoxels += threadStatistics.st_NumberOfNonConvergedVoxels;
+      this->m_NumberOfGeneratedVoxels += threadStatistics.st_NumberOfGeneratedVoxels;
+      this->m_TotalNumberOfIterations += threadStatistics.st_TotalNumberOfIterations;
+    }
+  }
+
+} // end AfterThreadedGenerateData()
+
+
+/**
+ * ********************* GetMeanNumberOfIterations ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+double
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetMeanNumberOfIterations(
+  void) const
+{
+  if (this->m_NumberOfGeneratedVoxels == 0)
+  {
+    return 0.0;
+  }
+  return static_cast<double>(this->m_TotalNumberOfIterations) / static_cast<double>(this->m_NumberOfGeneratedVoxels);
+
+} // end GetMeanNumberOfIterations()
+
+
+/**
+ * ********************* GenerateOutputInformation ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GenerateOutputInformation(void)
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateOutputInformation();
+
+  // get pointer to the output
+  OutputImagePointer outputPtr = this->GetOutput();
+  if (!outputPtr)
+  {
+    return;
+  }
+
+  outputPtr->SetLargestPossibleRegion(m_OutputRegion);
+  outputPtr->SetSpacing(m_OutputSpacing);
+  outputPtr->SetOrigin(m_OutputOrigin);
+  outputPtr->SetDirection(m_OutputDirection);
+
+  // Start a new update: regenerate the coarse inverse, and restart gathering the statistics.
+  this->m_CoarseInverseInterpolator = nullptr;
+  this->m_MaximumResidual = 0.0;
+  this->m_NumberOfNonConvergedVoxels = 0;
+  this->m_NumberOfGeneratedVoxels = 0;
+  this->m_TotalNumberOfIterations = 0;
+
+} // end GenerateOutputInformation()
+
+
+/**
+ * ********************* GetMTime ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+ModifiedTimeType
+TransformToInverseDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetMTime(void) const
+{
+  ModifiedTimeType latestTime = Object::GetMTime();
+
+  if (this->m_Transform)
+  {
+    if (latestTime < this->m_Transform->GetMTime())
+    {
+      latestTime = this->m_Transform->GetMTime();
+    }
+  }
+
+  return latestTime;
+
+} // end GetMTime()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkTransformToInverseDisplacementFieldSource_hxx
@@ -52,7 +52,8 @@ namespace itk
  * ProcessObject::GenerateOutputInformation().
  *
  * This filter is implemented as a multithreaded filter.  It provides a
- * ThreadedGenerateData() method for its implementation.
+ * ThreadedGenerateData() method for its implementation. It supports streaming,
+ * so the output may be generated (and written) region by region.
  *
  * \author Stefan Klein, Erasmus MC, The Netherlands.
  *
@@ -317,7 +317,8 @@ TransformToSpatialJacobianSource<TOutputImage, TTransformPrecisionType>::Generat
   outputPtr->SetSpacing(m_OutputSpacing);
   outputPtr->SetOrigin(m_OutputOrigin);
   outputPtr->SetDirection(m_OutputDirection);
-  outputPtr->Allocate();
+
+  // The output is not allocated here, but region by region, to support streaming.
 
 } // end GenerateOutputInformation()
 
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAdaptiveSampleSizeSchedule.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+namespace
+{
+/** The weight of the newest gradient in the smoothed signal and noise estimates. */
+constexpr double SmoothingFactor = 0.1;
+} // namespace
+
+
+/**
+ * ****************** Initialize *********************************
+ */
+
+void
+AdaptiveSampleSizeSchedule::Initialize(const SizeValueType numberOfIterations)
+{
+  this->m_NumberOfIterations = numberOfIterations;
+  this->m_NumberOfCompletedIterations = 0;
+  this->m_RelativeNumberOfSamples =
+    std::min(this->m_MinimumRelativeNumberOfSamples, this->m_MaximumRelativeNumberOfSamples);
+  this->m_TotalRelativeNumberOfSamples = 0.0;
+  this->m_HasGradientStatistics = false;
+  this->m_Signal = 0.0;
+  this->m_NoiseVariance = 0.0;
+
+  /** Keep the noise-to-signal ratio that the first iteration has. */
+  this->m_TargetNoiseToSignalRatio = this->m_ReferenceNoiseToSignalRatio / this->m_RelativeNumberOfSamples;
+
+} // end Initialize()
+
+
+/**
+ * ****************** AddGradient *********************************
+ */
+
+void
+AdaptiveSampleSizeSchedule::AddGradient(const double innerProductWithPreviousGradient, const double squaredMagnitude)
+{
+  const double noiseVariance =
+    std::max(0.0, squaredMagnitude - innerProductWithPreviousGradient) * this->m_RelativeNumberOfSamples;
+
+  if (this->m_HasGradientStatistics)
+  {
+    this->m_Signal += SmoothingFactor * (innerProductWithPreviousGradient - this->m_Signal);
+    this->m_NoiseVariance += SmoothingFactor * (noiseVariance - this->m_NoiseVariance);
+  }
+  else
+  {
+    this->m_Signal = innerProductWithPreviousGradient;
+    this->m_NoiseVariance = noiseVariance;
+    this->m_HasGradientStatistics = true;
+  }
+
+  /** Without a reference, the first gradient with a signal sets the target. */
+  if (this->m_TargetNoiseToSignalRatio <= 0.0 && this->m_Signal > 0.0 && this->m_NoiseVariance > 0.0)
+  {
+    this->m_TargetNoiseToSignalRatio = this->m_NoiseVariance / (this->m_Signal * this->m_RelativeNumberOfSamples);
+  }
+
+} // end AddGradient()
+
+
+/**
+ * ****************** AdvanceIteration *********************************
+ */
+
+double
+AdaptiveSampleSizeSchedule::AdvanceIteration(void)
+{
+  this->m_TotalRelativeNumberOfSamples += this->m_RelativeNumberOfSamples;
+  ++this->m_NumberOfCompletedIterations;
+
+  /** The number of samples for which the noise-to-signal ratio equals the target. When
+   * the smoothed inner product is not positive, the noise dominates the signal entirely.
+   */
+  double next = this->m_RelativeNumberOfSamples;
+  if (this->m_HasGradientStatistics && this->m_TargetNoiseToSignalRatio > 0.0)
+  {
+    const double needed = (this->m_Signal > 0.0)
+                            ? this->m_NoiseVariance / (this->m_TargetNoiseToSignalRatio * this->m_Signal)
+                            : this->m_MaximumRelativeNumberOfSamples;
+    next = std::max(next, needed);
+  }
+  next = std::min(next, this->m_MaximumRelativeNumberOfSamples);
+
+  /** Spread what is left of the budget evenly over the remaining iterations, at most. */
+  if (this->m_NumberOfCompletedIterations < this->m_NumberOfIterations)
+  {
+    const double budget = this->m_RelativeSampleBudget * static_cast<double>(this->m_NumberOfIterations);
+    const double remainingIterations =
+      static_cast<double>(this->m_NumberOfIterations - this->m_NumberOfCompletedIterations);
+    next = std::min(next, std::max(0.0, budget - this->m_TotalRelativeNumberOfSamples) / remainingIterations);
+  }
+
+  this->m_RelativeNumberOfSamples = next;
+  return next;
+
+} // end AdvanceIteration()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+AdaptiveSampleSizeSchedule::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MinimumRelativeNumberOfSamples: " << this->m_MinimumRelativeNumberOfSamples << std::endl;
+  os << indent << "MaximumRelativeNumberOfSamples: " << this->m_MaximumRelativeNumberOfSamples << std::endl;
+  os << indent << "RelativeSampleBudget: " << this->m_RelativeSampleBudget << std::endl;
+  os << indent << "ReferenceNoiseToSignalRatio: " << this->m_ReferenceNoiseToSignalRatio << std::endl;
+  os << indent << "NumberOfIterations: " << this->m_NumberOfIterations << std::endl;
+  os << indent << "NumberOfCompletedIterations: " << this->m_NumberOfCompletedIterations << std::endl;
+  os << indent << "RelativeNumberOfSamples: " << this->m_RelativeNumberOfSamples << std::endl;
+  os << indent << "TotalRelativeNumberOfSamples: " << this->m_TotalRelativeNumberOfSamples << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
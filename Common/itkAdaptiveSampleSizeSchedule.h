@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAdaptiveSampleSizeSchedule_h
+#define itkAdaptiveSampleSizeSchedule_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+/** \class AdaptiveSampleSizeSchedule
+ * \brief Chooses the number of samples of each iteration of a stochastic optimizer.
+ *
+ * A stochastic gradient is the sum of the exact gradient (the signal) and an
+ * approximation error (the noise), whose variance is inversely proportional
+ * to the number of samples. Early in a resolution the signal is strong, and
+ * few samples suffice; near convergence the signal fades, and more samples
+ * are needed to keep the same noise-to-signal ratio. This class grows the
+ * number of samples accordingly. All numbers of samples are relative to the
+ * number of samples that the user specified, the "reference".
+ *
+ * The optimizer passes the statistics of each gradient to AddGradient(): its
+ * squared magnitude, and its inner product with the previous gradient. Because
+ * the noise of consecutive gradients is independent, the inner product
+ * estimates the squared magnitude of the exact gradient, and the difference
+ * of the two estimates the variance of the noise. Both are smoothed over
+ * iterations. AdvanceIteration() then returns the relative number of samples
+ * of the next iteration, which keeps the noise-to-signal ratio at the value
+ * that the minimum relative number of samples gave at the start. That value
+ * follows from the ReferenceNoiseToSignalRatio, when the optimizer has
+ * measured it, or else from the first gradients.
+ *
+ * The number of samples never decreases within a resolution, except to stay
+ * within the budget: over a resolution of N iterations, the sum of the
+ * relative numbers of samples is at most RelativeSampleBudget * N. The default
+ * budget of one ensures that the schedule never evaluates more samples than
+ * the reference number of samples in every iteration would.
+ *
+ * \ingroup Common
+ */
+
+class AdaptiveSampleSizeSchedule : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef AdaptiveSampleSizeSchedule Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer<Self>         Pointer;
+  typedef SmartPointer<const Self>   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(AdaptiveSampleSizeSchedule, Object);
+
+  /** The relative number of samples of the first iteration. Default: 0.25. */
+  itkSetClampMacro(MinimumRelativeNumberOfSamples, double, NumericTraits<double>::min(), NumericTraits<double>::max());
+  itkGetConstMacro(MinimumRelativeNumberOfSamples, double);
+
+  /** The largest relative number of samples of an iteration. Default: 4. */
+  itkSetClampMacro(MaximumRelativeNumberOfSamples, double, NumericTraits<double>::min(), NumericTraits<double>::max());
+  itkGetConstMacro(MaximumRelativeNumberOfSamples, double);
+
+  /** The mean relative number of samples per iteration, over a resolution, may not exceed this value. Default: 1. */
+  itkSetClampMacro(RelativeSampleBudget, double, 0.0, NumericTraits<double>::max());
+  itkGetConstMacro(RelativeSampleBudget, double);
+
+  /** The noise-to-signal ratio, that is the squared magnitude of the approximation
+   * error over that of the exact gradient, with the reference number of samples at the
+   * start of the resolution. Default: 0, which means that it is estimated from the first
+   * gradients instead.
+   */
+  itkSetClampMacro(ReferenceNoiseToSignalRatio, double, 0.0, NumericTraits<double>::max());
+  itkGetConstMacro(ReferenceNoiseToSignalRatio, double);
+
+  /** Starts a resolution of the given number of iterations, at the minimum relative number of samples. */
+  void
+  Initialize(SizeValueType numberOfIterations);
+
+  /** Adds the statistics of the gradient of the current iteration: its inner product
+   * with the gradient of the previous iteration, and its squared magnitude.
+   */
+  void
+  AddGradient(double innerProductWithPreviousGradient, double squaredMagnitude);
+
+  /** Ends the current iteration, and returns the relative number of samples of the next one. */
+  double
+  AdvanceIteration(void);
+
+  /** The relative number of samples of the current iteration. */
+  itkGetConstMacro(RelativeNumberOfSamples, double);
+
+  /** The sum of the relative numbers of samples of the iterations that have ended. */
+  itkGetConstMacro(TotalRelativeNumberOfSamples, double);
+
+  /** The number of iterations that have ended. */
+  itkGetConstMacro(NumberOfCompletedIterations, SizeValueType);
+
+protected:
+  AdaptiveSampleSizeSchedule() = default;
+  ~AdaptiveSampleSizeSchedule() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  AdaptiveSampleSizeSchedule(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  double m_MinimumRelativeNumberOfSamples{ 0.25 };
+  double m_MaximumRelativeNumberOfSamples{ 4.0 };
+  double m_RelativeSampleBudget{ 1.0 };
+  double m_ReferenceNoiseToSignalRatio{ 0.0 };
+
+  /** The state of the current resolution. The noise variance is per unit of the
+   * relative number of samples, so that it does not change when the number does.
+   */
+  SizeValueType m_NumberOfIterations{ 0 };
+  SizeValueType m_NumberOfCompletedIterations{ 0 };
+  double        m_RelativeNumberOfSamples{ 0.25 };
+  double        m_TotalRelativeNumberOfSamples{ 0.0 };
+  double        m_TargetNoiseToSignalRatio{ 0.0 };
+  bool          m_HasGradientStatistics{ false };
+  double        m_Signal{ 0.0 };
+  double        m_NoiseVariance{ 0.0 };
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkAdaptiveSampleSizeSchedule_h
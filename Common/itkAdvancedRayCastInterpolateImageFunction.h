@@ -35,6 +35,7 @@ PURPOSE.  See the above copyright notices for more information.
 #define itkAdvancedRayCastInterpolateImageFunction_h
 
 #include "itkInterpolateImageFunction.h"
+#include "itkRayCastProjector.h"
 #include "itkTransform.h"
 #include "itkVector.h"
 
@@ -48,6 +49,11 @@ namespace itk
  * image and uses bilinear interpolation to integrate each plane of
  * voxels traversed.
  *
+ * The rays are cast by a RayCastProjector, which computes the geometry of the
+ * image once per modification of the image, instead of once per ray.
+ * GenerateProjection() casts the rays of a whole detector at once, which is
+ * what the RayCastResampleImageFilter does.
+ *
  * \warning This interpolator works for 3-dimensional images only.
  *
  * \ingroup ImageFunctions
@@ -89,6 +95,10 @@ public:
 
   typedef typename InterpolatorType::Pointer InterpolatorPointer;
 
+  /** Type of the projector that casts the rays. */
+  typedef RayCastProjector<TInputImage, TCoordRep> ProjectorType;
+  typedef typename ProjectorType::Pointer          ProjectorPointer;
+
   /** Run-time type information (and related methods). */
   itkTypeMacro(AdvancedRayCastInterpolateImageFunction, InterpolateImageFunction);
 
@@ -143,6 +153,24 @@ public:
   OutputType
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override;
 
+  /** Set the input image, and pass it to the projector. */
+  void
+  SetInputImage(const InputImageType * ptr) override;
+
+  /** Computes the projection on the buffered region of the 3D detector image,
+   * multi-threaded, through the projector. Each detector pixel gets the value
+   * of Evaluate() at the position of the pixel, mapped by the transform.
+   */
+  template <class TDetectorImage>
+  void
+  GenerateProjection(TDetectorImage * detector)
+  {
+    m_Projector->GenerateProjection(m_Transform.GetPointer(), m_FocalPoint, m_Threshold, detector);
+  }
+
+  /** Get the projector that casts the rays. */
+  itkGetModifiableObjectMacro(Projector, ProjectorType);
+
   /** Connect the Transform. */
   itkSetObjectMacro(Transform, TransformType);
   /** Get a pointer to the Transform.  */
@@ -210,6 +238,9 @@ protected:
   /// Pointer to the interpolator
   InterpolatorPointer m_Interpolator;
 
+  /// The projector that casts the rays
+  ProjectorPointer m_Projector;
+
 private:
   AdvancedRayCastInterpolateImageFunction(const Self &) = delete;
   void
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBatchDataCache.h"
+
+#include <future>
+#include <map>
+#include <mutex>
+
+namespace itk
+{
+
+namespace
+{
+/** The state of the cache, shared by the whole process. */
+struct CacheData
+{
+  std::mutex                                                     Mutex;
+  unsigned int                                                   NumberOfScopes{ 0 };
+  std::map<std::string, std::shared_future<DataObject::Pointer>> Entries;
+  std::map<const Object *, Object::ConstPointer>                 KeyObjects;
+};
+
+CacheData &
+GetCacheData(void)
+{
+  static CacheData cacheData;
+  return cacheData;
+}
+
+} // end namespace
+
+
+/**
+ * ****************** Scope *********************************
+ */
+
+BatchDataCache::Scope::Scope()
+{
+  CacheData &                       cacheData = GetCacheData();
+  const std::lock_guard<std::mutex> lock(cacheData.Mutex);
+  ++cacheData.NumberOfScopes;
+
+} // end Scope()
+
+
+BatchDataCache::Scope::~Scope()
+{
+  /** Release the data outside the lock. */
+  std::map<std::string, std::shared_future<DataObject::Pointer>> entries;
+  std::map<const Object *, Object::ConstPointer>                 keyObjects;
+  {
+    CacheData &                       cacheData = GetCacheData();
+    const std::lock_guard<std::mutex> lock(cacheData.Mutex);
+    if (--cacheData.NumberOfScopes == 0)
+    {
+      entries.swap(cacheData.Entries);
+      keyObjects.swap(cacheData.KeyObjects);
+    }
+  }
+
+} // end ~Scope()
+
+
+/**
+ * ****************** IsEnabled *********************************
+ */
+
+bool
+BatchDataCache::IsEnabled(void)
+{
+  CacheData &                       cacheData = GetCacheData();
+  const std::lock_guard<std::mutex> lock(cacheData.Mutex);
+  return cacheData.NumberOfScopes > 0;
+
+} // end IsEnabled()
+
+
+/**
+ * ****************** GetOrCreate *********************************
+ */
+
+DataObject::Pointer
+BatchDataCache::GetOrCreate(const std::string & key, const std::function<DataObject::Pointer()> & createData)
+{
+  CacheData &                             cacheData = GetCacheData();
+  std::promise<DataObject::Pointer>       promise;
+  std::shared_future<DataObject::Pointer> future;
+  bool                                    isCreator = false;
+  {
+    const std::lock_guard<std::mutex> lock(cacheData.Mutex);
+    if (cacheData.NumberOfScopes > 0)
+    {
+      const auto found = cacheData.Entries.find(key);
+      if (found != cacheData.Entries.end())
+      {
+        future = found->second;
+      }
+      else
+      {
+        future = promise.get_future().share();
+        cacheData.Entries[key] = future;
+        isCreator = true;
+      }
+    }
+  }
+
+  /** Not in a batch: nothing is shared. */
+  if (!future.valid())
+  {
+    return createData();
+  }
+
+  /** Create the data outside the lock, so that other keys are not blocked. */
+  if (isCreator)
+  {
+    try
+    {
+      promise.set_value(createData());
+    }
+    catch (...)
+    {
+      promise.set_exception(std::current_exception());
+    }
+  }
+  return future.get();
+
+} // end GetOrCreate()
+
+
+/**
+ * ****************** MakeObjectKey *********************************
+ */
+
+std::string
+BatchDataCache::MakeObjectKey(const Object * object)
+{
+  if (object == nullptr)
+  {
+    return "null";
+  }
+
+  {
+    CacheData &                       cacheData = GetCacheData();
+    const std::lock_guard<std::mutex> lock(cacheData.Mutex);
+    if (cacheData.NumberOfScopes > 0)
+    {
+      cacheData.KeyObjects.emplace(object, object);
+    }
+  }
+
+  std::ostringstream key;
+  key << static_cast<const void *>(object) << " mtime " << object->GetMTime();
+  return key.str();
+
+} // end MakeObjectKey()
+
+
+/**
+ * ****************** GetNumberOfEntries *********************************
+ */
+
+std::size_t
+BatchDataCache::GetNumberOfEntries(void)
+{
+  CacheData &                       cacheData = GetCacheData();
+  const std::lock_guard<std::mutex> lock(cacheData.Mutex);
+  return cacheData.Entries.size();
+
+} // end GetNumberOfEntries()
+
+
+} // end namespace itk
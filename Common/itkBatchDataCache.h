@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchDataCache_h
+#define itkBatchDataCache_h
+
+#include "itkDataObject.h"
+#include "itkMacro.h"
+
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace itk
+{
+/** \class BatchDataCache
+ * \brief A process-wide cache of the data that the registrations of a batch share.
+ *
+ * When one fixed image is registered to many moving images with the same
+ * parameters, each registration computes the same fixed image pyramid, the
+ * same eroded fixed masks and the same fixed image extrema. While a
+ * BatchDataCache::Scope is alive, the components look up such data by a key
+ * that identifies their input and settings. Only the first registration that
+ * asks for a key computes its data; registrations that ask for the same key
+ * meanwhile wait for it. The data is shared read-only afterwards.
+ *
+ * Outside a scope, IsEnabled() returns false and the components compute
+ * their data as before. The cache is emptied when the last scope ends, so
+ * that it holds no memory after the batch.
+ *
+ * \ingroup Common
+ */
+
+class BatchDataCache
+{
+public:
+  /** Enables the cache during its lifetime. */
+  class Scope
+  {
+  public:
+    ITK_DISALLOW_COPY_AND_MOVE(Scope);
+    Scope();
+    ~Scope();
+  };
+
+  /** Returns true when at least one scope is alive. */
+  static bool
+  IsEnabled(void);
+
+  /** Returns the data of the key. When the key is not in the cache yet, the
+   * data is created by the given function first. An exception thrown by the
+   * function is rethrown to every caller that asks for the key.
+   */
+  static DataObject::Pointer
+  GetOrCreate(const std::string & key, const std::function<DataObject::Pointer()> & createData);
+
+  /** The number of keys in the cache. */
+  static std::size_t
+  GetNumberOfEntries(void);
+
+  /** Returns a key that identifies the pixel buffer and the geometry of an image.
+   * The pixel buffer is identified by its pixel container, see MakeObjectKey().
+   */
+  template <class TImage>
+  static std::string
+  MakeImageKey(const TImage * image)
+  {
+    std::ostringstream key;
+    key.precision(std::numeric_limits<double>::max_digits10);
+    if (image == nullptr)
+    {
+      key << "null";
+      return key.str();
+    }
+    key << MakeObjectKey(image->GetPixelContainer()) << " region " << image->GetBufferedRegion().GetIndex()
+        << image->GetBufferedRegion().GetSize() << " spacing " << image->GetSpacing() << " origin "
+        << image->GetOrigin() << " direction " << image->GetDirection().GetVnlMatrix();
+    return key.str();
+  }
+
+  /** Returns a key that identifies an object by its address and its modification
+   * time. While the cache is enabled, the cache holds a reference to the object,
+   * so that its address cannot be reused by another object during the batch.
+   */
+  static std::string
+  MakeObjectKey(const Object * object);
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkBatchDataCache_h
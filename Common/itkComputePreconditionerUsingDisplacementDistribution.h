@@ -20,6 +20,10 @@
 
 #include "itkComputeDisplacementDistribution.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 
 namespace itk
 {
@@ -139,6 +143,73 @@ protected:
   using typename Superclass::CoordinateRepresentationType;
   using typename Superclass::NumberOfParametersType;
 
+  /** The contribution of one or more samples to the preconditioner computations of a parameter. */
+  struct PreconditionerTermType
+  {
+    unsigned int m_Parameter;
+    double       m_Sum;
+    double       m_SquaredSum;
+    double       m_BinCount;
+  };
+
+  /** The contributions of a chunk of samples. They are stored sparsely, as a list that is sorted by
+   * parameter and compacted whenever it has doubled in size, so that the memory of a chunk is
+   * bounded by the number of parameters that its samples touch, instead of by all parameters.
+   */
+  struct ChunkTermsType
+  {
+    std::vector<PreconditionerTermType> m_Terms;
+    std::size_t                         m_CompactedSize{ 0 };
+    double                              m_MaxJJ{ 0.0 };
+
+    void
+    Add(const unsigned int parameter, const double sum, const double squaredSum, const double binCount)
+    {
+      this->m_Terms.push_back({ parameter, sum, squaredSum, binCount });
+      if (this->m_Terms.size() > std::max<std::size_t>(2 * this->m_CompactedSize, 4096))
+      {
+        Self::CompactPreconditionerTerms(this->m_Terms);
+        this->m_CompactedSize = this->m_Terms.size();
+      }
+    }
+  };
+
+  /** The sums over all samples, per parameter, of the preconditioner computations.
+   * m_SquaredSum is left empty when the squared sums are not requested.
+   */
+  struct PreconditionerTermsType
+  {
+    std::vector<double> m_Sum;
+    std::vector<double> m_SquaredSum;
+    std::vector<double> m_BinCount;
+    double              m_MaxJJ;
+  };
+
+  /** Adds the contributions of the samples [first, last) to the terms of a chunk. */
+  typedef std::function<void(SizeValueType, SizeValueType, ChunkTermsType &)> ComputeChunkFunctionType;
+
+  /** The number of samples per chunk. It is fixed, so that neither the chunks nor the order in
+   * which their terms are summed depend on the number of work units.
+   */
+  static constexpr SizeValueType NumberOfSamplesPerChunk = 1024;
+
+  /** Splits the samples in chunks of NumberOfSamplesPerChunk samples, and calls computeChunk()
+   * for each chunk. The chunks are processed in parallel, unless multi-threading is switched
+   * off. The terms of all chunks are then summed in chunk order, in parallel over blocks of
+   * parameters, and maxJJ is the maximum over all chunks. The result is therefore the same for
+   * any number of threads.
+   */
+  void
+  ComputePreconditionerTerms(const SizeValueType              numberOfSamples,
+                             const SizeValueType              numberOfParameters,
+                             const bool                       computeSquaredSum,
+                             const ComputeChunkFunctionType & computeChunk,
+                             PreconditionerTermsType &        terms) const;
+
+  /** Sorts the terms by parameter, and sums the terms of the same parameter, in list order. */
+  static void
+  CompactPreconditionerTerms(std::vector<PreconditionerTermType> & terms);
+
   double m_MaximumStepLength;
   double m_RegularizationKappa;
   double m_ConditionNumber;
@@ -29,6 +29,7 @@
 #include "itkZeroFluxNeumannPadImageFilter.h"
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
 
+#include <algorithm>
 #include <cmath> // For abs.
 
 
@@ -48,6 +49,138 @@ ComputePreconditionerUsingDisplacementDistribution<TFixedImage,
 } // end Constructor
 
 
+/**
+ * ************************* ComputePreconditionerTerms ************************
+ */
+
+template <class TFixedImage, class TTransform>
+void
+ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::ComputePreconditionerTerms(
+  const SizeValueType              numberOfSamples,
+  const SizeValueType              numberOfParameters,
+  const bool                       computeSquaredSum,
+  const ComputeChunkFunctionType & computeChunk,
+  PreconditionerTermsType &        terms) const
+{
+  /** Split the samples in contiguous chunks of a fixed size. */
+  const SizeValueType numberOfChunks =
+    std::max<SizeValueType>((numberOfSamples + NumberOfSamplesPerChunk - 1) / NumberOfSamplesPerChunk, 1);
+  std::vector<ChunkTermsType> chunkTerms(numberOfChunks);
+
+  const auto computeTermsOfChunk = [&](const SizeValueType chunk) {
+    ChunkTermsType & termsOfChunk = chunkTerms[chunk];
+    computeChunk(std::min(chunk * NumberOfSamplesPerChunk, numberOfSamples),
+                 std::min((chunk + 1) * NumberOfSamplesPerChunk, numberOfSamples),
+                 termsOfChunk);
+    Self::CompactPreconditionerTerms(termsOfChunk.m_Terms);
+  };
+
+  const bool useMultiThread = this->m_UseMultiThread && this->m_Threader->GetNumberOfWorkUnits() > 1;
+  if (useMultiThread && numberOfChunks > 1)
+  {
+    this->m_Threader->ParallelizeArray(0, numberOfChunks, computeTermsOfChunk, nullptr);
+  }
+  else
+  {
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      computeTermsOfChunk(chunk);
+    }
+  }
+
+  terms.m_Sum.assign(numberOfParameters, 0.0);
+  terms.m_BinCount.assign(numberOfParameters, 0.0);
+  if (computeSquaredSum)
+  {
+    terms.m_SquaredSum.assign(numberOfParameters, 0.0);
+  }
+  else
+  {
+    terms.m_SquaredSum.clear();
+  }
+  terms.m_MaxJJ = 0.0;
+
+  /** Sum the sorted terms of all chunks, in chunk order. Blocks of parameters are summed in
+   * parallel; each block only writes its own parameters, so no locking is needed.
+   */
+  const SizeValueType numberOfBlocks = useMultiThread ? 4 * this->m_Threader->GetNumberOfWorkUnits() : 1;
+  const auto          sumBlock = [&](const SizeValueType block) {
+    const unsigned int first = static_cast<unsigned int>(numberOfParameters * block / numberOfBlocks);
+    const unsigned int last = static_cast<unsigned int>(numberOfParameters * (block + 1) / numberOfBlocks);
+    for (const ChunkTermsType & termsOfChunk : chunkTerms)
+    {
+      auto it = std::lower_bound(termsOfChunk.m_Terms.cbegin(),
+                                 termsOfChunk.m_Terms.cend(),
+                                 first,
+                                 [](const PreconditionerTermType & term, const unsigned int parameter) {
+                                   return term.m_Parameter < parameter;
+                                 });
+      for (; (it != termsOfChunk.m_Terms.cend()) && (it->m_Parameter < last); ++it)
+      {
+        terms.m_Sum[it->m_Parameter] += it->m_Sum;
+        terms.m_BinCount[it->m_Parameter] += it->m_BinCount;
+        if (computeSquaredSum)
+        {
+          terms.m_SquaredSum[it->m_Parameter] += it->m_SquaredSum;
+        }
+      }
+    }
+  };
+
+  if (numberOfBlocks > 1)
+  {
+    this->m_Threader->ParallelizeArray(0, numberOfBlocks, sumBlock, nullptr);
+  }
+  else
+  {
+    sumBlock(0);
+  }
+
+  for (const ChunkTermsType & termsOfChunk : chunkTerms)
+  {
+    terms.m_MaxJJ = std::max(terms.m_MaxJJ, termsOfChunk.m_MaxJJ);
+  }
+
+} // end ComputePreconditionerTerms()
+
+
+/**
+ * ************************* CompactPreconditionerTerms ************************
+ */
+
+template <class TFixedImage, class TTransform>
+void
+ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::CompactPreconditionerTerms(
+  std::vector<PreconditionerTermType> & terms)
+{
+  /** Sort by parameter. The sort is stable, so that the terms of a parameter are summed in the
+   * order in which they were added.
+   */
+  std::stable_sort(terms.begin(), terms.end(), [](const PreconditionerTermType & a, const PreconditionerTermType & b) {
+    return a.m_Parameter < b.m_Parameter;
+  });
+
+  /** Sum the terms of the same parameter. */
+  auto last = terms.begin();
+  for (auto it = terms.begin(); it != terms.end(); ++it)
+  {
+    if ((last != terms.begin()) && ((last - 1)->m_Parameter == it->m_Parameter))
+    {
+      (last - 1)->m_Sum += it->m_Sum;
+      (last - 1)->m_SquaredSum += it->m_SquaredSum;
+      (last - 1)->m_BinCount += it->m_BinCount;
+    }
+    else
+    {
+      *last = *it;
+      ++last;
+    }
+  }
+  terms.erase(last, terms.end());
+
+} // end CompactPreconditionerTerms()
+
+
 /**
  * ************************* Compute ************************
  */
@@ -367,165 +500,173 @@ ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::Com
   this->SampleFixedImageForJacobianTerms(sampleContainer);
   const SizeValueType nrofsamples = sampleContainer->Size();
 
-  /** Get transform and set current position. */
-  typename TransformType::Pointer transform = this->m_Transform;
-  const unsigned int              outdim = this->m_Transform->GetOutputSpaceDimension();
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator iter;
-  typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator end = sampleContainer->End();
-
-  /** Variables for nonzerojacobian indices and the Jacobian. */
+  /** Get the output space dimension and the number of nonzero Jacobian indices. */
+  const unsigned int  outdim = this->m_Transform->GetOutputSpaceDimension();
   const SizeValueType sizejacind = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
-  JacobianType        jacj(outdim, sizejacind);
-  jacj.Fill(0.0);
-  NonZeroJacobianIndicesType jacind(sizejacind);
-
-  /** Declare temporary variables. Not needed for all methods. check later */
-  DerivativeType jacj_g(outdim);
-  jacj_g.Fill(0.0);
-  JacobianType        jacjjacj(outdim, outdim);
   const double        sqrt2 = std::sqrt(static_cast<double>(2.0));
-  std::vector<double> localStepSizeSquared(P, 0.0);
-  ParametersType      binCount(P);
-  binCount.Fill(0.0);
 
-  /** Loop over all voxels in the sample container. */
-  for (iter = begin; iter != end; ++iter)
-  {
-    /** Read fixed coordinates and get Jacobian. */
-    const FixedImagePointType & point = (*iter).Value().m_ImageCoordinates;
-    this->m_Transform->GetJacobian(point, jacj, jacind);
+  /** Loop over all voxels in the sample container, in parallel over chunks of samples. */
+  const auto computeChunk = [&](const SizeValueType first, const SizeValueType last, ChunkTermsType & terms) {
+    /** Variables for nonzerojacobian indices and the Jacobian. */
+    JacobianType jacj(outdim, sizejacind);
+    jacj.Fill(0.0);
+    NonZeroJacobianIndicesType jacind(sizejacind);
+
+    /** Declare temporary variables. Not needed for all methods. check later */
+    DerivativeType jacj_g(outdim);
+    jacj_g.Fill(0.0);
+    JacobianType jacjjacj(outdim, outdim);
+
+    /** Create iterator over the samples of this chunk. */
+    typename ImageSampleContainerType::ConstIterator iter;
+    typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator end = sampleContainer->Begin();
+    begin += static_cast<typename ImageSampleContainerType::ConstIterator::difference_type>(first);
+    end += static_cast<typename ImageSampleContainerType::ConstIterator::difference_type>(last);
+
+    for (iter = begin; iter != end; ++iter)
+    {
+      /** Read fixed coordinates and get Jacobian. */
+      const FixedImagePointType & point = (*iter).Value().m_ImageCoordinates;
+      this->m_Transform->GetJacobian(point, jacj, jacind);
 
-    /** Compute 1st part of JJ: ||J_j||_F^2. */
-    double JJ_j = vnl_math::sqr(jacj.frobenius_norm());
+      /** Compute 1st part of JJ: ||J_j||_F^2. */
+      double JJ_j = vnl_math::sqr(jacj.frobenius_norm());
 
-    /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
-    vnl_fastops::ABt(jacjjacj, jacj, jacj);
-    JJ_j += 2.0 * sqrt2 * jacjjacj.frobenius_norm();
+      /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
+      vnl_fastops::ABt(jacjjacj, jacj, jacj);
+      JJ_j += 2.0 * sqrt2 * jacjjacj.frobenius_norm();
 
-    /** Max_j [JJ_j]. */
-    maxJJ = std::max(maxJJ, JJ_j);
+      /** Max_j [JJ_j]. */
+      terms.m_MaxJJ = std::max(terms.m_MaxJJ, JJ_j);
 
-    double displacement2_j = 0.0;
-    if (transformIsBSpline)
-    {
-      for (unsigned int i = 0; i < outdim; ++i)
+      double displacement2_j = 0.0;
+      if (transformIsBSpline)
       {
-        double temp = 0.0;
-        for (unsigned int j = 0; j < sizejacind; ++j)
+        for (unsigned int i = 0; i < outdim; ++i)
         {
-          int pj = jacind[j];
-          temp += jacj(i, j) * exactgradient(pj);
-        }
-
-        // Use the absolute value
-        jacj_g(i) = std::abs(temp);
-      }
-      displacement2_j = jacj_g.magnitude();
-    }
+          double temp = 0.0;
+          for (unsigned int j = 0; j < sizejacind; ++j)
+          {
+            int pj = jacind[j];
+            temp += jacj(i, j) * exactgradient(pj);
+          }
 
-    /** Update all entries of the pre-conditioner. */
-    for (unsigned int j = 0; j < sizejacind; ++j)
-    {
-      const unsigned int pj = jacind[j];
-      double             displacement_j = 0.0;
-      double             jacj_current = 0.0;
-      for (unsigned int i = 0; i < outdim; ++i)
-      {
-        jacj_current += std::abs(jacj(i, j));
+          // Use the absolute value
+          jacj_g(i) = std::abs(temp);
+        }
+        displacement2_j = jacj_g.magnitude();
       }
-      displacement_j = std::abs(jacj_current * exactgradient(pj));
 
-      if (transformIsBSpline)
+      /** Update all entries of the pre-conditioner. */
+      for (unsigned int j = 0; j < sizejacind; ++j)
       {
-        displacement_j =
-          displacement_j * this->m_RegularizationKappa + (1.0 - this->m_RegularizationKappa) * displacement2_j;
-      }
-      else
-      { // else for affine and rigid
-        double diff_jacobian = 0;
-        double weight = 0;
-        double sum_displacement = 0;
-        double sum_weight = 0;
-        double weight_sigma = 0.01;
-        double maxdiff = 0.0;
-        double mindiff = 0.0;
-        bool   mindiffCheck = true;
-
-        /** Obtain the maximum and minimum difference of absolute jacobian. */
-        for (unsigned int k = 0; k < sizejacind; ++k)
+        const unsigned int pj = jacind[j];
+        double             displacement_j = 0.0;
+        double             jacj_current = 0.0;
+        for (unsigned int i = 0; i < outdim; ++i)
         {
-          if (k != j)
-          {
-            double jacj_k = 0.0;
-            for (unsigned int i = 0; i < outdim; ++i)
-            {
-              jacj_k += std::abs(jacj(i, k));
-            }
-            diff_jacobian = std::abs(jacj_k - jacj_current);
-            if (diff_jacobian > 0 && mindiffCheck)
-            {
-              mindiff = diff_jacobian;
-              mindiffCheck = false;
-            }
-            if (diff_jacobian > 0 && !mindiffCheck)
-            {
-              mindiff = diff_jacobian < mindiff ? diff_jacobian : mindiff;
-            }
-            maxdiff = diff_jacobian > maxdiff ? diff_jacobian : maxdiff;
-          } // end if
-        }   // end for
+          jacj_current += std::abs(jacj(i, j));
+        }
+        displacement_j = std::abs(jacj_current * exactgradient(pj));
 
-        if (maxdiff > 0)
+        if (transformIsBSpline)
         {
-          weight_sigma = mindiff / maxdiff;
+          displacement_j =
+            displacement_j * this->m_RegularizationKappa + (1.0 - this->m_RegularizationKappa) * displacement2_j;
         }
         else
-        {
-          weight_sigma = 1e-9;
-        }
+        { // else for affine and rigid
+          double diff_jacobian = 0;
+          double weight = 0;
+          double sum_displacement = 0;
+          double sum_weight = 0;
+          double weight_sigma = 0.01;
+          double maxdiff = 0.0;
+          double mindiff = 0.0;
+          bool   mindiffCheck = true;
+
+          /** Obtain the maximum and minimum difference of absolute jacobian. */
+          for (unsigned int k = 0; k < sizejacind; ++k)
+          {
+            if (k != j)
+            {
+              double jacj_k = 0.0;
+              for (unsigned int i = 0; i < outdim; ++i)
+              {
+                jacj_k += std::abs(jacj(i, k));
+              }
+              diff_jacobian = std::abs(jacj_k - jacj_current);
+              if (diff_jacobian > 0 && mindiffCheck)
+              {
+                mindiff = diff_jacobian;
+                mindiffCheck = false;
+              }
+              if (diff_jacobian > 0 && !mindiffCheck)
+              {
+                mindiff = diff_jacobian < mindiff ? diff_jacobian : mindiff;
+              }
+              maxdiff = diff_jacobian > maxdiff ? diff_jacobian : maxdiff;
+            } // end if
+          }   // end for
+
+          if (maxdiff > 0)
+          {
+            weight_sigma = mindiff / maxdiff;
+          }
+          else
+          {
+            weight_sigma = 1e-9;
+          }
 
-        /** To regularize the other entries using the neighborhood information. */
-        for (unsigned int k = 0; k < sizejacind; ++k)
-        {
-          const unsigned int pk = jacind[k];
-          if (k != j)
+          /** To regularize the other entries using the neighborhood information. */
+          for (unsigned int k = 0; k < sizejacind; ++k)
           {
-            double jacj_k = 0.0;
-            for (unsigned int i = 0; i < outdim; ++i)
+            const unsigned int pk = jacind[k];
+            if (k != j)
             {
-              jacj_k += std::abs(jacj(i, k));
-            }
+              double jacj_k = 0.0;
+              for (unsigned int i = 0; i < outdim; ++i)
+              {
+                jacj_k += std::abs(jacj(i, k));
+              }
 
-            diff_jacobian = std::abs(jacj_k - jacj_current);
-            weight = std::exp(-(vnl_math::sqr(diff_jacobian / weight_sigma) / 2.0));
+              diff_jacobian = std::abs(jacj_k - jacj_current);
+              weight = std::exp(-(vnl_math::sqr(diff_jacobian / weight_sigma) / 2.0));
 
-            sum_displacement += std::abs(jacj_k * exactgradient(pk)) * weight;
-            sum_weight += weight;
-          } // end if
-        }   // end for loop regularization
+              sum_displacement += std::abs(jacj_k * exactgradient(pk)) * weight;
+              sum_weight += weight;
+            } // end if
+          }   // end for loop regularization
 
-        if (sum_weight > 0.0)
-        {
-          sum_displacement /= sum_weight;
+          if (sum_weight > 0.0)
+          {
+            sum_displacement /= sum_weight;
 
-          /** regularize. */
-          displacement_j =
-            displacement_j * this->m_RegularizationKappa + (1.0 - this->m_RegularizationKappa) * sum_displacement;
-        }
-      } // end else for affine and rigid
+            /** regularize. */
+            displacement_j =
+              displacement_j * this->m_RegularizationKappa + (1.0 - this->m_RegularizationKappa) * sum_displacement;
+          }
+        } // end else for affine and rigid
 
-      /** Compute the displacement due to a change in this parameter. */
-      /** localStepSize keeps track of the mean displacement.
-       * localStepSizeSquared keeps track of the standard deviation.
-       */
-      preconditioner[pj] += displacement_j;
-      localStepSizeSquared[pj] += displacement_j * displacement_j;
-      binCount[pj] += 1.0;
-    }
-  } // end loop over sample container
+        /** Compute the displacement due to a change in this parameter. */
+        /** localStepSize keeps track of the mean displacement.
+         * localStepSizeSquared keeps track of the standard deviation.
+         */
+        terms.Add(pj, displacement_j, displacement_j * displacement_j, 1.0);
+      }
+    } // end loop over the samples of this chunk
+  };
+
+  PreconditionerTermsType terms;
+  this->ComputePreconditionerTerms(nrofsamples, P, true, computeChunk, terms);
+  maxJJ = terms.m_MaxJJ;
+  const std::vector<double> & localStepSizeSquared = terms.m_SquaredSum;
+  const std::vector<double> & binCount = terms.m_BinCount;
+  for (unsigned int i = 0; i < P; ++i)
+  {
+    preconditioner[i] += terms.m_Sum[i];
+  }
 
 
   /** Compute the mean local step sizes and apply the 2 sigma rule. */
@@ -614,50 +755,61 @@ ComputePreconditionerUsingDisplacementDistribution<TFixedImage, TTransform>::Com
   this->SampleFixedImageForJacobianTerms(sampleContainer);
   const SizeValueType nrofsamples = sampleContainer->Size();
 
-  /** Get transform and set current position. */
-  typename TransformType::Pointer transform = this->m_Transform;
-  const unsigned int              outdim = this->m_Transform->GetOutputSpaceDimension();
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator iter;
-  typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator end = sampleContainer->End();
-
-  /** Variables for nonzerojacobian indices and the Jacobian. */
+  /** Get the output space dimension and the number of nonzero Jacobian indices. */
+  const unsigned int  outdim = this->m_Transform->GetOutputSpaceDimension();
   const SizeValueType sizejacind = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
-  JacobianType        jacj(outdim, sizejacind);
-  jacj.Fill(0.0);
-  JacobianType               jacjjacj(outdim, outdim);
-  const double               sqrt2 = std::sqrt(static_cast<double>(2.0));
-  NonZeroJacobianIndicesType jacind(sizejacind);
-  ParametersType             binCount(P, 0.0);
+  const double        sqrt2 = std::sqrt(static_cast<double>(2.0));
 
-  /** Loop over all voxels in the sample container. */
-  for (iter = begin; iter != end; ++iter)
-  {
-    /** Read fixed coordinates and get Jacobian. */
-    const FixedImagePointType & point = (*iter).Value().m_ImageCoordinates;
-    this->m_Transform->GetJacobian(point, jacj, jacind);
+  /** Loop over all voxels in the sample container, in parallel over chunks of samples. */
+  const auto computeChunk = [&](const SizeValueType first, const SizeValueType last, ChunkTermsType & terms) {
+    /** Variables for nonzerojacobian indices and the Jacobian. */
+    JacobianType jacj(outdim, sizejacind);
+    jacj.Fill(0.0);
+    JacobianType               jacjjacj(outdim, outdim);
+    NonZeroJacobianIndicesType jacind(sizejacind);
+
+    /** Create iterator over the samples of this chunk. */
+    typename ImageSampleContainerType::ConstIterator iter;
+    typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator end = sampleContainer->Begin();
+    begin += static_cast<typename ImageSampleContainerType::ConstIterator::difference_type>(first);
+    end += static_cast<typename ImageSampleContainerType::ConstIterator::difference_type>(last);
+
+    for (iter = begin; iter != end; ++iter)
+    {
+      /** Read fixed coordinates and get Jacobian. */
+      const FixedImagePointType & point = (*iter).Value().m_ImageCoordinates;
+      this->m_Transform->GetJacobian(point, jacj, jacind);
 
-    /** Compute 1st part of JJ: ||J_j||_F^2. */
-    double JJ_j = vnl_math::sqr(jacj.frobenius_norm());
+      /** Compute 1st part of JJ: ||J_j||_F^2. */
+      double JJ_j = vnl_math::sqr(jacj.frobenius_norm());
 
-    /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
-    vnl_fastops::ABt(jacjjacj, jacj, jacj);
-    JJ_j += 2.0 * sqrt2 * jacjjacj.frobenius_norm();
+      /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
+      vnl_fastops::ABt(jacjjacj, jacj, jacj);
+      JJ_j += 2.0 * sqrt2 * jacjjacj.frobenius_norm();
 
-    /** Max_j [JJ_j]. */
-    maxJJ = std::max(maxJJ, JJ_j);
+      /** Max_j [JJ_j]. */
+      terms.m_MaxJJ = std::max(terms.m_MaxJJ, JJ_j);
 
-    for (unsigned int i = 0; i < outdim; ++i)
-    {
       for (unsigned int j = 0; j < sizejacind; ++j)
       {
-        const unsigned int pj = jacind[j];
-        preconditioner[pj] += vnl_math::sqr(jacj(i, j));
-        binCount[pj] += 1;
+        double sum_j = 0.0;
+        for (unsigned int i = 0; i < outdim; ++i)
+        {
+          sum_j += vnl_math::sqr(jacj(i, j));
+        }
+        terms.Add(jacind[j], sum_j, 0.0, outdim);
       }
-    }
+    } // end loop over the samples of this chunk
+  };
+
+  PreconditionerTermsType terms;
+  this->ComputePreconditionerTerms(nrofsamples, P, false, computeChunk, terms);
+  maxJJ = terms.m_MaxJJ;
+  const std::vector<double> & binCount = terms.m_BinCount;
+  for (unsigned int i = 0; i < P; ++i)
+  {
+    preconditioner[i] += terms.m_Sum[i];
   }
 
   double maxEigenvalue = -1e+9;
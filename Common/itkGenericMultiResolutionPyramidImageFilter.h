@@ -98,6 +98,15 @@ namespace itk
  * compute only single level of the pyramid via SetCurrentLevel() and
  * SetComputeOnlyForCurrentLevel() methods.
  *
+ * With SetUseCascade() the levels are computed as a cascade, from fine to
+ * coarse: each level is derived from the previously computed, finer level,
+ * which is smoothed with the incremental sigma sqrt( sigma_k^2 - sigma_{k+1}^2 ).
+ * Smoothing and rescaling are then fused: a separable, truncated Gaussian kernel
+ * is evaluated only at the voxels of the output grid, one dimension at a time,
+ * so that each pass works on an image that is already decimated along the
+ * previous dimensions. The results differ slightly from the recursive Gaussian
+ * smoothing that is used otherwise.
+ *
  * \author Denis P. Shamonin and Marius Staring. Division of Image Processing,
  * Department of Radiology, Leiden, The Netherlands
  *
@@ -223,6 +232,15 @@ public:
   itkGetConstMacro(ComputeOnlyForCurrentLevel, bool);
   itkBooleanMacro(ComputeOnlyForCurrentLevel);
 
+  /** Set/Get whether the levels are computed as a cascade, with fused smoothing
+   * and rescaling. When ComputeOnlyForCurrentLevel is set, there is no finer
+   * level to start from, and the level is derived from the input image.
+   * Default false.
+   */
+  itkSetMacro(UseCascade, bool);
+  itkGetConstMacro(UseCascade, bool);
+  itkBooleanMacro(UseCascade);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<ImageDimension, OutputImageDimension>));
@@ -272,6 +290,7 @@ protected:
   unsigned int          m_CurrentLevel;
   bool                  m_ComputeOnlyForCurrentLevel;
   bool                  m_SmoothingScheduleDefined;
+  bool                  m_UseCascade;
 
 private:
   /** Typedef for smoother. Smooth always happens first, then only from
@@ -314,6 +333,18 @@ private:
                             typename ImageToImageFilterSameTypes::Pointer &      rescaleSameTypes,
                             typename ImageToImageFilterDifferentTypes::Pointer & rescaleDifferentTypes);
 
+  /** Generate the output data in cascaded mode, from fine to coarse. */
+  void
+  GenerateDataCascaded(void);
+
+  /** Smooth the source image with the given sigmas and rescale it to the grid
+   * of the output image, in one fused, separable pass per dimension.
+   * The source image should have the same direction as the output image.
+   */
+  template <class TSourceImage>
+  void
+  FusedSmoothAndRescale(const TSourceImage * source, const SigmaArrayType & sigmaArray, OutputImageType * output);
+
   /** Initialize m_SmoothingSchedule to default values for backward compatibility. */
   void
   SetSmoothingScheduleToDefault(void);
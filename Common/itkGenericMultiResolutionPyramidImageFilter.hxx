@@ -23,6 +23,11 @@
 #include "itkResampleImageFilter.h"
 #include "itkShrinkImageFilter.h"
 #include "itkImageAlgorithm.h"
+#include "itkMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace // anonymous namespace
 {
@@ -46,6 +51,55 @@ UpdateAndGraft(typename GenericMultiResolutionPyramidImageFilterType::Pointer th
 } // end UpdateAndGraft()
 
 
+/**
+ * ******************* ConvolveAndDecimate ***********************
+ *
+ * Filters a buffer along one dimension, and computes only the samples
+ * of the output grid along that dimension. The buffer is seen as
+ * numberOfBlocks blocks of inputLength lines of innerLength values,
+ * where innerLength is the stride of the filtered dimension. Each output
+ * sample j is the weighted sum of the numberOfTaps input lines given by
+ * tapIndices[ j * numberOfTaps + t ] and tapWeights[ j * numberOfTaps + t ].
+ */
+
+template <class TInputValue, class TOutputValue>
+void
+ConvolveAndDecimate(const TInputValue *                     input,
+                    TOutputValue *                          output,
+                    const std::vector<itk::SizeValueType> & tapIndices,
+                    const std::vector<double> &             tapWeights,
+                    const unsigned int                      numberOfTaps,
+                    const itk::SizeValueType                inputLength,
+                    const itk::SizeValueType                outputLength,
+                    const itk::SizeValueType                innerLength,
+                    const itk::SizeValueType                numberOfBlocks,
+                    itk::MultiThreaderBase *                threader)
+{
+  threader->ParallelizeArray(
+    0,
+    numberOfBlocks * outputLength,
+    [&](itk::SizeValueType outputLine) {
+      const itk::SizeValueType  block = outputLine / outputLength;
+      const itk::SizeValueType  j = outputLine % outputLength;
+      const TInputValue * const inputBlock = input + block * inputLength * innerLength;
+      TOutputValue * const      outputRow = output + outputLine * innerLength;
+
+      std::fill(outputRow, outputRow + innerLength, TOutputValue{ 0 });
+      for (unsigned int t = 0; t < numberOfTaps; ++t)
+      {
+        const auto                weight = static_cast<TOutputValue>(tapWeights[j * numberOfTaps + t]);
+        const TInputValue * const inputRow = inputBlock + tapIndices[j * numberOfTaps + t] * innerLength;
+        for (itk::SizeValueType i = 0; i < innerLength; ++i)
+        {
+          outputRow[i] += weight * static_cast<TOutputValue>(inputRow[i]);
+        }
+      }
+    },
+    nullptr);
+
+} // end ConvolveAndDecimate()
+
+
 } // namespace
 
 namespace itk
@@ -64,6 +118,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   temp.Fill(NumericTraits<ScalarRealType>::ZeroValue());
   this->m_SmoothingSchedule = temp;
   this->m_SmoothingScheduleDefined = false;
+  this->m_UseCascade = false;
 } // end Constructor
 
 
@@ -325,6 +380,13 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
     this->SetSmoothingScheduleToDefault();
   }
 
+  // The cascaded mode derives each level from the next finer level
+  if (this->m_UseCascade)
+  {
+    this->GenerateDataCascaded();
+    return;
+  }
+
   typename SmootherType::Pointer                     smoother;
   typename ImageToImageFilterSameTypes::Pointer      rescaleSameTypes;
   typename ImageToImageFilterDifferentTypes::Pointer rescaleDifferentTypes;
@@ -377,6 +439,238 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
 } // end GenerateData()
 
 
+/**
+ * ******************* GenerateDataCascaded ***********************
+ */
+
+template <class TInputImage, class TOutputImage, class TPrecisionType>
+void
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::GenerateDataCascaded(void)
+{
+  InputImageConstPointer input = this->GetInput();
+
+  /** The previously computed, finer level and its sigmas. */
+  OutputImagePointer previousOutput;
+  SigmaArrayType     previousSigmaArray;
+  previousSigmaArray.Fill(0);
+
+  // Loop from the finest to the coarsest level
+  for (unsigned int i = 0; i < this->m_NumberOfLevels; ++i)
+  {
+    const unsigned int level = this->m_NumberOfLevels - 1 - i;
+    if (!this->m_ComputeOnlyForCurrentLevel)
+    {
+      this->UpdateProgress(static_cast<float>(i) / static_cast<float>(this->m_NumberOfLevels));
+    }
+
+    if (!this->ComputeForCurrentLevel(level))
+    {
+      continue;
+    }
+
+    // Allocate memory for the output
+    OutputImagePointer outputPtr = this->GetOutput(level);
+    outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+    outputPtr->Allocate();
+
+    SigmaArrayType sigmaArray;
+    this->GetSigma(level, sigmaArray);
+
+    if (previousOutput.IsNull())
+    {
+      // Derive the level from the input image
+      RescaleFactorArrayType shrinkFactors;
+      this->GetShrinkFactors(level, shrinkFactors);
+      if (this->AreSigmasAllZeros(sigmaArray) && this->AreRescaleFactorsAllOnes(shrinkFactors))
+      {
+        ImageAlgorithm::Copy(input.GetPointer(),
+                             outputPtr.GetPointer(),
+                             input->GetLargestPossibleRegion(),
+                             outputPtr->GetLargestPossibleRegion());
+      }
+      else
+      {
+        this->FusedSmoothAndRescale(input.GetPointer(), sigmaArray, outputPtr.GetPointer());
+      }
+    }
+    else
+    {
+      // Derive the level from the finer level, which is already smoothed
+      SigmaArrayType incrementalSigmaArray;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        const double incrementalVariance =
+          sigmaArray[dim] * sigmaArray[dim] - previousSigmaArray[dim] * previousSigmaArray[dim];
+        incrementalSigmaArray[dim] = std::sqrt(std::max(incrementalVariance, 0.0));
+      }
+      this->FusedSmoothAndRescale(previousOutput.GetPointer(), incrementalSigmaArray, outputPtr.GetPointer());
+    }
+
+    previousOutput = outputPtr;
+    previousSigmaArray = sigmaArray;
+  } // end for i
+
+} // end GenerateDataCascaded()
+
+
+/**
+ * ******************* FusedSmoothAndRescale ***********************
+ */
+
+template <class TInputImage, class TOutputImage, class TPrecisionType>
+template <class TSourceImage>
+void
+GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionType>::FusedSmoothAndRescale(
+  const TSourceImage *   source,
+  const SigmaArrayType & sigmaArray,
+  OutputImageType *      output)
+{
+  typedef typename OutputImageType::PixelType                OutputPixelType;
+  typedef typename NumericTraits<OutputPixelType>::FloatType IntermediateValueType;
+
+  const InputImageType * const               input = this->GetInput();
+  const typename TSourceImage::RegionType    sourceRegion = source->GetBufferedRegion();
+  const typename OutputImageType::RegionType outputRegion = output->GetBufferedRegion();
+  const bool                                 useShrinker = this->GetUseShrinkImageFilter();
+
+  /** Input, source and output share the direction, so the mapping from source
+   * and output indices to continuous input indices is separable per dimension.
+   */
+  const SpacingType                    inputSpacing = input->GetSpacing();
+  const Vector<double, ImageDimension> sourceOriginInInput =
+    input->GetInverseDirection() * (source->GetOrigin() - input->GetOrigin());
+  const Vector<double, ImageDimension> outputOriginInInput =
+    input->GetInverseDirection() * (output->GetOrigin() - input->GetOrigin());
+
+  /** The current buffer, and its size. The first pass reads from the source directly.
+   * The intermediate values have the precision of the output pixels, not more,
+   * to limit the memory use for large float images.
+   */
+  std::vector<IntermediateValueType> currentBuffer;
+  std::vector<IntermediateValueType> nextBuffer;
+  SizeValueType                      currentSize[ImageDimension];
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    currentSize[dim] = sourceRegion.GetSize()[dim];
+  }
+
+  std::vector<SizeValueType> tapIndices;
+  std::vector<double>        tapWeights;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    const SizeValueType inputLength = currentSize[dim];
+    const SizeValueType outputLength = outputRegion.GetSize()[dim];
+
+    /** The continuous input index of the first source and output voxel, and the steps. */
+    const double sourceStep = source->GetSpacing()[dim] / inputSpacing[dim];
+    const double outputStep = output->GetSpacing()[dim] / inputSpacing[dim];
+    const double sourceFirst =
+      sourceOriginInInput[dim] / inputSpacing[dim] + static_cast<double>(sourceRegion.GetIndex()[dim]) * sourceStep;
+    const double outputFirst =
+      outputOriginInInput[dim] / inputSpacing[dim] + static_cast<double>(outputRegion.GetIndex()[dim]) * outputStep;
+
+    /** The shrinker takes the input voxel nearest to the output voxel. A source that is a
+     * finer level of the shrinker holds the input voxels nearest to its own voxels, so
+     * its voxel m is at input index Round(sourceFirst) + m * sourceStep.
+     */
+    const double sourceFirstContent =
+      useShrinker ? static_cast<double>(Math::Round<OffsetValueType>(sourceFirst)) : sourceFirst;
+
+    /** A Gaussian truncated at 3 sigma. Without smoothing, the weights interpolate
+     * linearly, which reduces to taking the nearest voxel for the shrinker.
+     */
+    const double          sigma = sigmaArray[dim] / source->GetSpacing()[dim];
+    const OffsetValueType radius = sigma > 0.0 ? static_cast<OffsetValueType>(std::ceil(3.0 * sigma)) : 0;
+    const unsigned int    numberOfTaps = static_cast<unsigned int>(2 * radius + 2);
+
+    tapIndices.resize(outputLength * numberOfTaps);
+    tapWeights.resize(outputLength * numberOfTaps);
+    for (SizeValueType j = 0; j < outputLength; ++j)
+    {
+      const double position = outputFirst + static_cast<double>(j) * outputStep;
+      const double contentPosition =
+        useShrinker ? static_cast<double>(Math::Round<OffsetValueType>(position)) : position;
+      const double          center = (contentPosition - sourceFirstContent) / sourceStep;
+      const OffsetValueType first = static_cast<OffsetValueType>(std::floor(center)) - radius;
+
+      double sumOfWeights = 0.0;
+      for (unsigned int t = 0; t < numberOfTaps; ++t)
+      {
+        const OffsetValueType k = first + static_cast<OffsetValueType>(t);
+        const double          distance = static_cast<double>(k) - center;
+        const double          weight = sigma > 0.0 ? std::exp(-0.5 * distance * distance / (sigma * sigma))
+                                                   : std::max(1.0 - std::abs(distance), 0.0);
+
+        // Replicate the border voxels
+        const OffsetValueType clampedK = std::min(std::max(k, OffsetValueType{ 0 }),
+                                                  static_cast<OffsetValueType>(inputLength) - 1);
+        tapIndices[j * numberOfTaps + t] = static_cast<SizeValueType>(clampedK);
+        tapWeights[j * numberOfTaps + t] = weight;
+        sumOfWeights += weight;
+      }
+
+      // Normalize the weights
+      for (unsigned int t = 0; t < numberOfTaps; ++t)
+      {
+        tapWeights[j * numberOfTaps + t] /= sumOfWeights;
+      }
+    } // end for j
+
+    /** The stride of this dimension, and the number of blocks of lines. */
+    SizeValueType innerLength = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+    {
+      innerLength *= currentSize[d];
+    }
+    SizeValueType numberOfBlocks = 1;
+    for (unsigned int d = dim + 1; d < ImageDimension; ++d)
+    {
+      numberOfBlocks *= currentSize[d];
+    }
+
+    /** Filter and decimate along this dimension. */
+    nextBuffer.resize(numberOfBlocks * outputLength * innerLength);
+    if (dim == 0)
+    {
+      ConvolveAndDecimate(source->GetBufferPointer(),
+                          nextBuffer.data(),
+                          tapIndices,
+                          tapWeights,
+                          numberOfTaps,
+                          inputLength,
+                          outputLength,
+                          innerLength,
+                          numberOfBlocks,
+                          this->GetMultiThreader());
+    }
+    else
+    {
+      ConvolveAndDecimate(currentBuffer.data(),
+                          nextBuffer.data(),
+                          tapIndices,
+                          tapWeights,
+                          numberOfTaps,
+                          inputLength,
+                          outputLength,
+                          innerLength,
+                          numberOfBlocks,
+                          this->GetMultiThreader());
+    }
+    currentBuffer.swap(nextBuffer);
+    currentSize[dim] = outputLength;
+  } // end for dim
+
+  /** Copy the result to the output. */
+  OutputPixelType * outputBuffer = output->GetBufferPointer();
+  const std::size_t numberOfPixels = currentBuffer.size();
+  for (std::size_t i = 0; i < numberOfPixels; ++i)
+  {
+    outputBuffer[i] = static_cast<OutputPixelType>(currentBuffer[i]);
+  }
+
+} // end FusedSmoothAndRescale()
+
+
 /**
  * ******************* SetupSmoother ***********************
  */
@@ -910,6 +1204,7 @@ GenericMultiResolutionPyramidImageFilter<TInputImage, TOutputImage, TPrecisionTy
   os << indent << "CurrentLevel: " << this->m_CurrentLevel << std::endl;
   os << indent << "ComputeOnlyForCurrentLevel: " << (this->m_ComputeOnlyForCurrentLevel ? "true" : "false")
      << std::endl;
+  os << indent << "UseCascade: " << (this->m_UseCascade ? "true" : "false") << std::endl;
   os << indent << "SmoothingScheduleDefined: " << (this->m_SmoothingScheduleDefined ? "true" : "false") << std::endl;
   os << indent << "Smoothing Schedule: ";
   if (this->m_SmoothingSchedule.empty())
@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMemoryMappedFile.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <cerrno>
+#  include <cstring>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  include <vector>
+#endif
+
+namespace itk
+{
+
+#ifdef _WIN32
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+MemoryMappedFile::MemoryMappedFile(const std::string & directory, const std::size_t numberOfBytes)
+  : m_NumberOfBytes(numberOfBytes)
+{
+  if (numberOfBytes == 0)
+  {
+    return;
+  }
+
+  char fileName[MAX_PATH];
+  if (GetTempFileNameA(directory.empty() ? "." : directory.c_str(), "elx", 0, fileName) == 0)
+  {
+    itkGenericExceptionMacro(<< "Could not create a temporary file in \"" << directory << "\".");
+  }
+
+  /** The file is deleted as soon as the last handle to it is closed. */
+  const HANDLE file = CreateFileA(fileName,
+                                  GENERIC_READ | GENERIC_WRITE,
+                                  0,
+                                  nullptr,
+                                  CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                                  nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    DeleteFileA(fileName);
+    itkGenericExceptionMacro(<< "Could not open the temporary file \"" << fileName << "\".");
+  }
+  m_FileHandle = file;
+
+  const auto   size = static_cast<unsigned long long>(numberOfBytes);
+  const HANDLE mapping = CreateFileMappingA(
+    file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFULL), nullptr);
+  if (mapping == nullptr)
+  {
+    CloseHandle(file);
+    itkGenericExceptionMacro(<< "Could not map " << numberOfBytes << " bytes of the temporary file \"" << fileName
+                             << "\".");
+  }
+  m_MappingHandle = mapping;
+
+  m_Pointer = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, numberOfBytes);
+  if (m_Pointer == nullptr)
+  {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    itkGenericExceptionMacro(<< "Could not map " << numberOfBytes << " bytes of the temporary file \"" << fileName
+                             << "\".");
+  }
+
+} // end Constructor
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  if (m_Pointer != nullptr)
+  {
+    UnmapViewOfFile(m_Pointer);
+    CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+    CloseHandle(static_cast<HANDLE>(m_FileHandle));
+  }
+
+} // end Destructor
+
+#else
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+MemoryMappedFile::MemoryMappedFile(const std::string & directory, const std::size_t numberOfBytes)
+  : m_NumberOfBytes(numberOfBytes)
+{
+  if (numberOfBytes == 0)
+  {
+    return;
+  }
+
+  const std::string fileNameTemplate =
+    (directory.empty() ? std::string(".") : directory) + "/elastix_memory_mapped_XXXXXX";
+  std::vector<char> fileName(fileNameTemplate.begin(), fileNameTemplate.end());
+  fileName.push_back('\0');
+
+  const int fileDescriptor = mkstemp(fileName.data());
+  if (fileDescriptor < 0)
+  {
+    itkGenericExceptionMacro(<< "Could not create a temporary file in \"" << directory
+                             << "\": " << std::strerror(errno));
+  }
+
+  /** Remove the name right away: the file lives on until it is unmapped. */
+  unlink(fileName.data());
+
+  if (ftruncate(fileDescriptor, static_cast<off_t>(numberOfBytes)) != 0)
+  {
+    const int error = errno;
+    close(fileDescriptor);
+    itkGenericExceptionMacro(<< "Could not resize the temporary file in \"" << directory << "\" to " << numberOfBytes
+                             << " bytes: " << std::strerror(error));
+  }
+
+  void * const pointer = mmap(nullptr, numberOfBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+  const int    error = errno;
+  close(fileDescriptor);
+  if (pointer == MAP_FAILED)
+  {
+    itkGenericExceptionMacro(<< "Could not map " << numberOfBytes << " bytes of a temporary file in \"" << directory
+                             << "\": " << std::strerror(error));
+  }
+  m_Pointer = pointer;
+
+} // end Constructor
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  if (m_Pointer != nullptr)
+  {
+    munmap(m_Pointer, m_NumberOfBytes);
+  }
+
+} // end Destructor
+
+#endif
+
+} // end namespace itk
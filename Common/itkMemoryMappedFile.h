@@ -0,0 +1,82 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+
+#include "itkMacro.h"
+
+#include <cstddef>
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief A block of memory that is backed by a temporary file instead of RAM.
+ *
+ * The constructor creates a temporary file of the requested size in the
+ * given directory and maps it into memory. The file is removed when the
+ * object is destroyed, or when the process ends. Pages of the block are only
+ * loaded when they are accessed, and the operating system may write them back
+ * to the file and drop them under memory pressure. The page cache thereby
+ * acts as a bounded cache of the block.
+ *
+ * An itk::ExceptionObject is thrown when the file cannot be created or mapped.
+ *
+ * \sa MemoryMappedImageContainer
+ * \ingroup Common
+ */
+
+class MemoryMappedFile
+{
+public:
+  /** Creates and maps a temporary file of numberOfBytes bytes in the directory. */
+  MemoryMappedFile(const std::string & directory, std::size_t numberOfBytes);
+
+  /** Unmaps and removes the file. */
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile &) = delete;
+  MemoryMappedFile &
+  operator=(const MemoryMappedFile &) = delete;
+
+  /** The start of the mapped memory, null when the size is zero. */
+  void *
+  GetPointer(void) const
+  {
+    return m_Pointer;
+  }
+
+  std::size_t
+  GetNumberOfBytes(void) const
+  {
+    return m_NumberOfBytes;
+  }
+
+private:
+  void *      m_Pointer{ nullptr };
+  std::size_t m_NumberOfBytes{ 0 };
+
+#ifdef _WIN32
+  void * m_FileHandle{ nullptr };
+  void * m_MappingHandle{ nullptr };
+#endif
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkMemoryMappedFile_h
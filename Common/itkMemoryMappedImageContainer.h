@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_h
+#define itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+#include <memory>
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedImageContainer
+ * \brief A pixel container whose memory is a memory-mapped temporary file.
+ *
+ * Images whose pixel container is a MemoryMappedImageContainer do not need to
+ * fit in RAM: the operating system loads the pages of the image that are
+ * accessed, and drops them again under memory pressure. elastix uses it for
+ * the input images only, see ElastixBase::MultipleImageLoader.
+ *
+ * \sa MemoryMappedFile
+ * \ingroup Common
+ */
+
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedImageContainer                         Self;
+  typedef ImportImageContainer<TElementIdentifier, TElement> Superclass;
+  typedef SmartPointer<Self>                                 Pointer;
+  typedef SmartPointer<const Self>                           ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedImageContainer, ImportImageContainer);
+
+  /** Typedefs from the superclass. */
+  typedef typename Superclass::ElementIdentifier ElementIdentifier;
+  typedef typename Superclass::Element           Element;
+
+  /** Maps a temporary file of size elements, in the given directory, and uses
+   * it as the memory of this container. Any previous memory is released.
+   */
+  void
+  MapTemporaryFile(const std::string & directory, ElementIdentifier size);
+
+  /** Returns whether the container currently uses a memory-mapped file. */
+  bool
+  GetIsMemoryMapped(void) const
+  {
+    return this->m_File != nullptr;
+  }
+
+protected:
+  MemoryMappedImageContainer() = default;
+  ~MemoryMappedImageContainer() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  MemoryMappedImageContainer(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  std::unique_ptr<MemoryMappedFile> m_File;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkMemoryMappedImageContainer.hxx"
+#endif
+
+#endif // end #ifndef itkMemoryMappedImageContainer_h
@@ -0,0 +1,80 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_hxx
+#define itkMemoryMappedImageContainer_hxx
+
+#include "itkMemoryMappedImageContainer.h"
+
+#include <utility>
+
+namespace itk
+{
+
+/**
+ * ******************* Destructor *******************
+ */
+
+template <typename TElementIdentifier, typename TElement>
+MemoryMappedImageContainer<TElementIdentifier, TElement>::~MemoryMappedImageContainer()
+{
+  /** Detach the superclass from the mapped memory before it is unmapped. */
+  if (this->m_File != nullptr)
+  {
+    this->SetImportPointer(nullptr, 0, false);
+  }
+
+} // end Destructor
+
+
+/**
+ * ******************* MapTemporaryFile *******************
+ */
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImageContainer<TElementIdentifier, TElement>::MapTemporaryFile(const std::string &     directory,
+                                                                           const ElementIdentifier size)
+{
+  const std::size_t                 numberOfBytes = static_cast<std::size_t>(size) * sizeof(Element);
+  std::unique_ptr<MemoryMappedFile> file(new MemoryMappedFile(directory, numberOfBytes));
+
+  /** The container does not manage the mapped memory: m_File does. */
+  this->SetImportPointer(static_cast<Element *>(file->GetPointer()), size, false);
+  this->m_File = std::move(file);
+
+} // end MapTemporaryFile()
+
+
+/**
+ * ******************* PrintSelf *******************
+ */
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "IsMemoryMapped: " << (this->GetIsMemoryMapped() ? "true" : "false") << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkMemoryMappedImageContainer_hxx
@@ -66,16 +66,19 @@ namespace itk
  *        February 1993.
  * And code obtained from bigwww.epfl.ch by Philippe Thevenaz
  *
+ * The coefficients are computed multi-threaded, by the ParallelBSplineDecompositionImageFilter.
+ *
  * Limitations:  Spline order must be between 0 and 5.
  *               Spline order must be set before setting the image.
  *               Uses mirror boundary conditions.
  *               Can only process LargestPossibleRegion
  *
  * \sa itkBSplineInterpolateImageFunction
+ * \sa ParallelBSplineDecompositionImageFilter
  *
  *  ***TODO: Is this an ImageFilter?  or does it belong to another group?
  * \ingroup ImageFilters
- * \ingroup SingleThreaded
+ * \ingroup MultiThreaded
  * \ingroup CannotBeStreamed
  */
 template <class TInputImage, class TOutputImage>
@@ -151,53 +154,12 @@ protected:
   void
   EnlargeOutputRequestedRegion(DataObject * output) override;
 
-  /** These are needed by the smoothing spline routine. */
-  std::vector<CoeffType>         m_Scratch;    // temp storage for processing of Coefficients
-  typename TInputImage::SizeType m_DataLength; // Image size
-
   unsigned int m_SplineOrder[ImageDimension]; // User specified spline order per dimension (3rd or cubic is the default)
-  double       m_SplinePoles[3];              // Poles calculated for a given spline order
-  int          m_NumberOfPoles;               // number of poles
-  double       m_Tolerance;                   // Tolerance used for determining initial causal coefficient
-  unsigned int m_IteratorDirection;           // Direction for iterator incrementing
 
 private:
   MultiOrderBSplineDecompositionImageFilter(const Self &) = delete;
   void
   operator=(const Self &) = delete;
-
-  /** Determines the poles for dimension given the Spline Order. */
-  virtual void
-  SetPoles(unsigned int dimension);
-
-  /** Converts a vector of data to a vector of Spline coefficients. */
-  virtual bool
-  DataToCoefficients1D();
-
-  /** Converts an N-dimension image of data to an equivalent sized image
-   *    of spline coefficients. */
-  void
-  DataToCoefficientsND();
-
-  /** Determines the first coefficient for the causal filtering of the data. */
-  virtual void
-  SetInitialCausalCoefficient(double z);
-
-  /** Determines the first coefficient for the anti-causal filtering of the data. */
-  virtual void
-  SetInitialAntiCausalCoefficient(double z);
-
-  /** Used to initialize the Coefficients image before calculation. */
-  void
-  CopyImageToImage();
-
-  /** Copies a vector of data from the Coefficients image to the m_Scratch vector. */
-  void
-  CopyCoefficientsToScratch(OutputLinearIterator &);
-
-  /** Copies a vector of data from m_Scratch to the Coefficients image. */
-  void
-  CopyScratchToCoefficients(OutputLinearIterator &);
 };
 
 } // namespace itk
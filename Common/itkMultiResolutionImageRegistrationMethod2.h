@@ -209,6 +209,13 @@ public:
   /** Get the current resolution level being processed. */
   itkGetConstMacro(CurrentLevel, unsigned long);
 
+  /** Set/Get whether the fixed and moving image pyramids are computed
+   * concurrently by PreparePyramids(). Default: true.
+   */
+  itkSetMacro(ComputePyramidsConcurrently, bool);
+  itkGetConstMacro(ComputePyramidsConcurrently, bool);
+  itkBooleanMacro(ComputePyramidsConcurrently);
+
   /** Set/Get the initial transformation parameters. */
   itkSetMacro(InitialTransformParameters, ParametersType);
   itkGetConstReferenceMacro(InitialTransformParameters, ParametersType);
@@ -303,6 +310,7 @@ private:
 
   unsigned long m_NumberOfLevels;
   unsigned long m_CurrentLevel;
+  bool          m_ComputePyramidsConcurrently;
 };
 
 } // end namespace itk
@@ -44,6 +44,8 @@
 #include "itkContinuousIndex.h"
 #include "vnl/vnl_math.h"
 
+#include <future>
+
 namespace itk
 {
 
@@ -69,6 +71,7 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::MultiResolut
 
   this->m_NumberOfLevels = 1;
   this->m_CurrentLevel = 0;
+  this->m_ComputePyramidsConcurrently = true;
 
   this->m_Stop = false;
 
@@ -191,15 +194,37 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::PreparePyram
     itkExceptionMacro(<< "Moving image pyramid is not present");
   }
 
-  // Setup the fixed image pyramid
+  // Setup the fixed and moving image pyramids
   this->m_FixedImagePyramid->SetNumberOfLevels(this->m_NumberOfLevels);
-  this->m_FixedImagePyramid->SetInput(this->m_FixedImage);
-  this->m_FixedImagePyramid->UpdateLargestPossibleRegion();
-
-  // Setup the moving image pyramid
   this->m_MovingImagePyramid->SetNumberOfLevels(this->m_NumberOfLevels);
-  this->m_MovingImagePyramid->SetInput(this->m_MovingImage);
-  this->m_MovingImagePyramid->UpdateLargestPossibleRegion();
+  if (this->m_ComputePyramidsConcurrently)
+  {
+    // The two pyramids are independent, so they are computed concurrently.
+    // Each pyramid gets a graft of its input image, which shares the pixel
+    // buffer, so that the two pipelines do not share any data object. Bring
+    // the input images up to date first, serially.
+    const_cast<FixedImageType *>(this->m_FixedImage.GetPointer())->UpdateLargestPossibleRegion();
+    const_cast<MovingImageType *>(this->m_MovingImage.GetPointer())->UpdateLargestPossibleRegion();
+
+    const auto fixedImage = FixedImageType::New();
+    fixedImage->Graft(this->m_FixedImage.GetPointer());
+    const auto movingImage = MovingImageType::New();
+    movingImage->Graft(this->m_MovingImage.GetPointer());
+    this->m_FixedImagePyramid->SetInput(fixedImage);
+    this->m_MovingImagePyramid->SetInput(movingImage);
+
+    auto fixedPyramidFuture =
+      std::async(std::launch::async, [this] { this->m_FixedImagePyramid->UpdateLargestPossibleRegion(); });
+    this->m_MovingImagePyramid->UpdateLargestPossibleRegion();
+    fixedPyramidFuture.get();
+  }
+  else
+  {
+    this->m_FixedImagePyramid->SetInput(this->m_FixedImage);
+    this->m_FixedImagePyramid->UpdateLargestPossibleRegion();
+    this->m_MovingImagePyramid->SetInput(this->m_MovingImage);
+    this->m_MovingImagePyramid->UpdateLargestPossibleRegion();
+  }
 
   typedef typename FixedImageRegionType::SizeType      SizeType;
   typedef typename FixedImageRegionType::IndexType     IndexType;
@@ -371,6 +396,7 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::PrintSelf(st
 
   os << indent << "NumberOfLevels: " << this->m_NumberOfLevels << std::endl;
   os << indent << "CurrentLevel: " << this->m_CurrentLevel << std::endl;
+  os << indent << "ComputePyramidsConcurrently: " << this->m_ComputePyramidsConcurrently << std::endl;
 
   os << indent << "InitialTransformParameters: " << this->m_InitialTransformParameters << std::endl;
   os << indent << "InitialTransformParametersOfNextLevel: " << this->m_InitialTransformParametersOfNextLevel
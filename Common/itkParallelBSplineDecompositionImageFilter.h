@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelBSplineDecompositionImageFilter_h
+#define itkParallelBSplineDecompositionImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelBSplineDecompositionImageFilter
+ * \brief Calculates the B-spline coefficients of an image, multi-threaded.
+ *
+ * This filter computes the same coefficients as BSplineDecompositionImageFilter,
+ * with mirror boundary conditions, and like MultiOrderBSplineDecompositionImageFilter
+ * the spline order (0 to 5) may differ per dimension.
+ *
+ * BSplineDecompositionImageFilter filters one line at a time, serially. This
+ * filter filters the lines of each dimension in parallel. Along the first
+ * dimension each line is contiguous in memory. Along the other dimensions,
+ * blocks of BlockSize neighbouring lines are filtered together, so that each
+ * step of the recursion reads and writes contiguous memory.
+ *
+ * The filter works in place in the output buffer, and only needs scratch
+ * memory for one block of lines per work unit.
+ *
+ * \sa BSplineDecompositionImageFilter
+ * \sa MultiOrderBSplineDecompositionImageFilter
+ * \ingroup ImageFilters
+ * \ingroup MultiThreaded
+ * \ingroup CannotBeStreamed
+ */
+
+template <class TInputImage, class TOutputImage>
+class ITK_TEMPLATE_EXPORT ParallelBSplineDecompositionImageFilter
+  : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ParallelBSplineDecompositionImageFilter       Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ParallelBSplineDecompositionImageFilter, ImageToImageFilter);
+
+  /** Inherit input and output image types from Superclass. */
+  using typename Superclass::InputImageType;
+  using typename Superclass::InputImagePointer;
+  using typename Superclass::InputImageConstPointer;
+  using typename Superclass::OutputImageType;
+  using typename Superclass::OutputImagePointer;
+  using typename Superclass::OutputImageRegionType;
+  typedef typename OutputImageType::PixelType OutputPixelType;
+
+  /** Dimension underlying input image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+  /** Set the spline order of all dimensions, from 0 to 5. The default is 3. */
+  void
+  SetSplineOrder(unsigned int order);
+
+  /** Set the spline order of one dimension, from 0 to 5. */
+  void
+  SetSplineOrder(unsigned int dimension, unsigned int order);
+
+  /** Get the spline order of one dimension. */
+  unsigned int
+  GetSplineOrder(unsigned int dimension) const
+  {
+    return this->m_SplineOrder[dimension];
+  }
+
+
+  /** The number of neighbouring lines that are filtered together along the
+   * second and higher dimensions. Default: 32.
+   */
+  itkSetClampMacro(BlockSize, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(BlockSize, unsigned int);
+
+  /** Returns the poles of the B-spline prefilter of the given order. */
+  static std::vector<double>
+  GetSplinePoles(unsigned int order);
+
+protected:
+  ParallelBSplineDecompositionImageFilter();
+  ~ParallelBSplineDecompositionImageFilter() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  GenerateData() override;
+
+  /** This filter requires all of the input image. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** This filter must produce all of its output at once. */
+  void
+  EnlargeOutputRequestedRegion(DataObject * output) override;
+
+private:
+  ParallelBSplineDecompositionImageFilter(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** Filters a block of numberOfLines neighbouring lines of the given length:
+   * sample k of line b is lines[ k * stride + b ]. The scratch buffer must hold
+   * length * numberOfLines values.
+   */
+  static void
+  FilterLines(OutputPixelType *           lines,
+              const SizeValueType         stride,
+              const SizeValueType         length,
+              const SizeValueType         numberOfLines,
+              const std::vector<double> & poles,
+              double *                    scratch);
+
+  unsigned int m_SplineOrder[ImageDimension];
+  unsigned int m_BlockSize;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkParallelBSplineDecompositionImageFilter.hxx"
+#endif
+
+#endif // end #ifndef itkParallelBSplineDecompositionImageFilter_h
@@ -0,0 +1,391 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelBSplineDecompositionImageFilter_hxx
+#define itkParallelBSplineDecompositionImageFilter_hxx
+
+#include "itkParallelBSplineDecompositionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+/**
+ * ******************* Constructor ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::ParallelBSplineDecompositionImageFilter()
+{
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    this->m_SplineOrder[d] = 3;
+  }
+  this->m_BlockSize = 32;
+
+} // end Constructor
+
+
+/**
+ * ******************* SetSplineOrder ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetSplineOrder(unsigned int order)
+{
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    this->SetSplineOrder(d, order);
+  }
+
+} // end SetSplineOrder()
+
+
+/**
+ * ******************* SetSplineOrder ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetSplineOrder(unsigned int dimension,
+                                                                                   unsigned int order)
+{
+  if (order > 5)
+  {
+    itkExceptionMacro(<< "ERROR: SplineOrder must be between 0 and 5. Requested spline order: " << order);
+  }
+  if (this->m_SplineOrder[dimension] != order)
+  {
+    this->m_SplineOrder[dimension] = order;
+    this->Modified();
+  }
+
+} // end SetSplineOrder()
+
+
+/**
+ * ******************* GetSplinePoles ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+std::vector<double>
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::GetSplinePoles(unsigned int order)
+{
+  /** See Unser, 1997. Part II, Table I for the pole values. */
+  std::vector<double> poles;
+  switch (order)
+  {
+    case 2:
+      poles.push_back(std::sqrt(8.0) - 3.0);
+      break;
+    case 3:
+      poles.push_back(std::sqrt(3.0) - 2.0);
+      break;
+    case 4:
+      poles.push_back(std::sqrt(664.0 - std::sqrt(438976.0)) + std::sqrt(304.0) - 19.0);
+      poles.push_back(std::sqrt(664.0 + std::sqrt(438976.0)) - std::sqrt(304.0) - 19.0);
+      break;
+    case 5:
+      poles.push_back(std::sqrt(135.0 / 2.0 - std::sqrt(17745.0 / 4.0)) + std::sqrt(105.0 / 4.0) - 13.0 / 2.0);
+      poles.push_back(std::sqrt(135.0 / 2.0 + std::sqrt(17745.0 / 4.0)) - std::sqrt(105.0 / 4.0) - 13.0 / 2.0);
+      break;
+    default:
+      /** Orders 0 and 1 have no poles: the coefficients equal the data. */
+      break;
+  }
+  return poles;
+
+} // end GetSplinePoles()
+
+
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  const InputImageType * inputPtr = this->GetInput();
+  OutputImageType *      outputPtr = this->GetOutput();
+
+  /** Allocate memory for the output image. */
+  outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+  outputPtr->Allocate();
+
+  const OutputImageRegionType region = outputPtr->GetBufferedRegion();
+  const SizeValueType         numberOfPixels = region.GetNumberOfPixels();
+  MultiThreaderBase *         threader = this->GetMultiThreader();
+  threader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  /** Initialize the coefficients to the input data. */
+  threader->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [inputPtr, outputPtr](const OutputImageRegionType & subRegion) {
+      ImageRegionConstIterator<InputImageType> inIt(inputPtr, subRegion);
+      ImageRegionIterator<OutputImageType>     outIt(outputPtr, subRegion);
+      for (; !outIt.IsAtEnd(); ++inIt, ++outIt)
+      {
+        outIt.Set(static_cast<OutputPixelType>(inIt.Get()));
+      }
+    },
+    nullptr);
+
+  /** Filter the lines along each dimension. The lines of one dimension are
+   * split in blocks of neighbouring lines, and chunks of blocks are filtered in
+   * parallel. Each chunk allocates its scratch memory once.
+   */
+  OutputPixelType * const buffer = outputPtr->GetBufferPointer();
+  SizeValueType           stride = 1;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    const SizeValueType       length = region.GetSize()[d];
+    const std::vector<double> poles = Self::GetSplinePoles(this->m_SplineOrder[d]);
+
+    /** Lines of length 1 are left unchanged, as required by the mirror boundaries. */
+    if ((length > 1) && !poles.empty())
+    {
+      const SizeValueType numberOfOuterLines = numberOfPixels / (stride * length);
+      const SizeValueType blockSize = std::min<SizeValueType>(this->m_BlockSize, stride);
+      const SizeValueType blocksPerOuterLine = (stride + blockSize - 1) / blockSize;
+      const SizeValueType numberOfBlocks = numberOfOuterLines * blocksPerOuterLine;
+      const SizeValueType numberOfChunks =
+        std::min<SizeValueType>(numberOfBlocks, 16 * static_cast<SizeValueType>(threader->GetNumberOfWorkUnits()));
+
+      threader->ParallelizeArray(
+        0,
+        numberOfChunks,
+        [&](const SizeValueType chunk) {
+          std::vector<double> scratch(length * blockSize);
+          const SizeValueType lastBlock = numberOfBlocks * (chunk + 1) / numberOfChunks;
+          for (SizeValueType block = numberOfBlocks * chunk / numberOfChunks; block < lastBlock; ++block)
+          {
+            const SizeValueType outerLine = block / blocksPerOuterLine;
+            const SizeValueType firstLine = (block % blocksPerOuterLine) * blockSize;
+            const SizeValueType numberOfLines = std::min(blockSize, stride - firstLine);
+            Self::FilterLines(buffer + outerLine * stride * length + firstLine,
+                              stride,
+                              length,
+                              numberOfLines,
+                              poles,
+                              scratch.data());
+          }
+        },
+        nullptr);
+    }
+    stride *= length;
+  }
+
+} // end GenerateData()
+
+
+/**
+ * ******************* FilterLines ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::FilterLines(
+  OutputPixelType *           lines,
+  const SizeValueType         stride,
+  const SizeValueType         length,
+  const SizeValueType         numberOfLines,
+  const std::vector<double> & poles,
+  double *                    scratch)
+{
+  /** The tolerance for the initial causal coefficient, as in BSplineDecompositionImageFilter. */
+  const double        tolerance = 1e-10;
+  const SizeValueType n = numberOfLines;
+
+  /** Copy the lines to the scratch buffer, and apply the overall gain.
+   * See Unser, 1993, Part II, Equation 2.5, or Unser, 1999, Box 2.
+   */
+  double gain = 1.0;
+  for (const double z : poles)
+  {
+    gain *= (1.0 - z) * (1.0 - 1.0 / z);
+  }
+  for (SizeValueType k = 0; k < length; ++k)
+  {
+    const OutputPixelType * const line = lines + k * stride;
+    double * const                s = scratch + k * n;
+    for (SizeValueType b = 0; b < n; ++b)
+    {
+      s[b] = gain * static_cast<double>(line[b]);
+    }
+  }
+
+  for (const double z : poles)
+  {
+    /** Causal initialization, for mirror boundaries. */
+    const SizeValueType horizon = static_cast<SizeValueType>(std::ceil(std::log(tolerance) / std::log(std::abs(z))));
+    double              zn = z;
+    if (horizon < length)
+    {
+      /** Accelerated loop. */
+      for (SizeValueType k = 1; k < horizon; ++k)
+      {
+        const double * const s = scratch + k * n;
+        for (SizeValueType b = 0; b < n; ++b)
+        {
+          scratch[b] += zn * s[b];
+        }
+        zn *= z;
+      }
+    }
+    else
+    {
+      /** Full loop. */
+      const double iz = 1.0 / z;
+      double       z2n = std::pow(z, static_cast<double>(length - 1));
+      const double * const last = scratch + (length - 1) * n;
+      for (SizeValueType b = 0; b < n; ++b)
+      {
+        scratch[b] += z2n * last[b];
+      }
+      z2n *= z2n * iz;
+      for (SizeValueType k = 1; k + 1 < length; ++k)
+      {
+        const double * const s = scratch + k * n;
+        const double         weight = zn + z2n;
+        for (SizeValueType b = 0; b < n; ++b)
+        {
+          scratch[b] += weight * s[b];
+        }
+        zn *= z;
+        z2n *= iz;
+      }
+      const double denominator = 1.0 - zn * zn;
+      for (SizeValueType b = 0; b < n; ++b)
+      {
+        scratch[b] /= denominator;
+      }
+    }
+
+    /** Causal recursion. */
+    for (SizeValueType k = 1; k < length; ++k)
+    {
+      double * const       s = scratch + k * n;
+      const double * const previous = s - n;
+      for (SizeValueType b = 0; b < n; ++b)
+      {
+        s[b] += z * previous[b];
+      }
+    }
+
+    /** Anti-causal initialization, for mirror boundaries. */
+    {
+      double * const       s = scratch + (length - 1) * n;
+      const double * const previous = s - n;
+      const double         factor = z / (z * z - 1.0);
+      for (SizeValueType b = 0; b < n; ++b)
+      {
+        s[b] = factor * (z * previous[b] + s[b]);
+      }
+    }
+
+    /** Anti-causal recursion. */
+    for (SizeValueType k = length - 1; k > 0; --k)
+    {
+      double * const       s = scratch + (k - 1) * n;
+      const double * const next = s + n;
+      for (SizeValueType b = 0; b < n; ++b)
+      {
+        s[b] = z * (next[b] - s[b]);
+      }
+    }
+  }
+
+  /** Copy the scratch buffer back to the lines. */
+  for (SizeValueType k = 0; k < length; ++k)
+  {
+    OutputPixelType * const line = lines + k * stride;
+    const double * const    s = scratch + k * n;
+    for (SizeValueType b = 0; b < n; ++b)
+    {
+      line[b] = static_cast<OutputPixelType>(s[b]);
+    }
+  }
+
+} // end FilterLines()
+
+
+/**
+ * ******************* GenerateInputRequestedRegion ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  /** This filter requires all of the input image to be in the buffer. */
+  InputImagePointer inputPtr = const_cast<TInputImage *>(this->GetInput());
+  if (inputPtr)
+  {
+    inputPtr->SetRequestedRegionToLargestPossibleRegion();
+  }
+
+} // end GenerateInputRequestedRegion()
+
+
+/**
+ * ******************* EnlargeOutputRequestedRegion ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::EnlargeOutputRequestedRegion(DataObject * output)
+{
+  /** This filter requires all of the output image to be in the buffer. */
+  TOutputImage * imgData = dynamic_cast<TOutputImage *>(output);
+  if (imgData)
+  {
+    imgData->SetRequestedRegionToLargestPossibleRegion();
+  }
+
+} // end EnlargeOutputRequestedRegion()
+
+
+/**
+ * ******************* PrintSelf ***********************
+ */
+
+template <class TInputImage, class TOutputImage>
+void
+ParallelBSplineDecompositionImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "SplineOrder: ";
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    os << this->m_SplineOrder[d] << (d + 1 < ImageDimension ? ", " : "");
+  }
+  os << std::endl;
+  os << indent << "BlockSize: " << this->m_BlockSize << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkParallelBSplineDecompositionImageFilter_hxx
@@ -0,0 +1,85 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelBSplineInterpolateImageFunction_h
+#define itkParallelBSplineInterpolateImageFunction_h
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkParallelBSplineDecompositionImageFilter.h"
+
+namespace itk
+{
+/** \class ParallelBSplineInterpolateImageFunction
+ * \brief A BSplineInterpolateImageFunction that computes its coefficients multi-threaded.
+ *
+ * This class only differs from BSplineInterpolateImageFunction in SetInputImage:
+ * the B-spline coefficients are computed by the ParallelBSplineDecompositionImageFilter,
+ * instead of by the single-threaded BSplineDecompositionImageFilter. The
+ * coefficients, and therefore the interpolated values, are the same.
+ *
+ * \sa BSplineInterpolateImageFunction
+ * \sa ParallelBSplineDecompositionImageFilter
+ * \ingroup ImageFunctions
+ */
+
+template <class TImageType, class TCoordRep = double, class TCoefficientType = double>
+class ITK_TEMPLATE_EXPORT ParallelBSplineInterpolateImageFunction
+  : public BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ParallelBSplineInterpolateImageFunction                                   Self;
+  typedef BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType> Superclass;
+  typedef SmartPointer<Self>                                                        Pointer;
+  typedef SmartPointer<const Self>                                                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ParallelBSplineInterpolateImageFunction, BSplineInterpolateImageFunction);
+
+  /** Typedefs inherited from the superclass. */
+  using typename Superclass::InputImageType;
+  using typename Superclass::CoefficientImageType;
+
+  /** The filter that computes the coefficients. */
+  typedef ParallelBSplineDecompositionImageFilter<TImageType, CoefficientImageType> ParallelCoefficientFilterType;
+
+  /** Set the input image, and compute its B-spline coefficients multi-threaded.
+   * Like in the superclass, the spline order must be set before the input image.
+   */
+  void
+  SetInputImage(const TImageType * inputData) override;
+
+protected:
+  ParallelBSplineInterpolateImageFunction() = default;
+  ~ParallelBSplineInterpolateImageFunction() override = default;
+
+private:
+  ParallelBSplineInterpolateImageFunction(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkParallelBSplineInterpolateImageFunction.hxx"
+#endif
+
+#endif // end #ifndef itkParallelBSplineInterpolateImageFunction_h
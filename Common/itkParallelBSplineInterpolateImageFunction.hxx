@@ -0,0 +1,61 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelBSplineInterpolateImageFunction_hxx
+#define itkParallelBSplineInterpolateImageFunction_hxx
+
+#include "itkParallelBSplineInterpolateImageFunction.h"
+
+namespace itk
+{
+
+/**
+ * ******************* SetInputImage ***********************
+ */
+
+template <class TImageType, class TCoordRep, class TCoefficientType>
+void
+ParallelBSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::SetInputImage(
+  const TImageType * inputData)
+{
+  if (inputData == nullptr)
+  {
+    Superclass::SetInputImage(inputData);
+    return;
+  }
+
+  /** Compute the coefficients multi-threaded. */
+  const auto coefficientFilter = ParallelCoefficientFilterType::New();
+  coefficientFilter->SetSplineOrder(this->GetSplineOrder());
+  coefficientFilter->SetInput(inputData);
+  coefficientFilter->Update();
+  this->m_Coefficients = coefficientFilter->GetOutput();
+
+  /** Skip the superclass, which would compute the coefficients again, and call
+   * its superclass instead. This is done after the update, in case the filter
+   * pulls in more of the input image.
+   */
+  Superclass::Superclass::SetInputImage(inputData);
+
+  this->m_DataLength = inputData->GetBufferedRegion().GetSize();
+
+} // end SetInputImage()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkParallelBSplineInterpolateImageFunction_hxx
@@ -0,0 +1,318 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParameterUpdateKernel.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+constexpr SizeValueType ParameterUpdateKernel::BlockSize;
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+ParameterUpdateKernel::ParameterUpdateKernel()
+  : m_NumberOfWorkUnits{ std::max<ThreadIdType>(1, MultiThreaderBase::GetGlobalDefaultNumberOfThreads()) }
+{} // end Constructor
+
+
+/**
+ * ****************** Step *********************************
+ */
+
+void
+ParameterUpdateKernel::Step(VectorType & position, const double stepSize, const VectorType & direction)
+{
+  const SizeValueType numberOfParameters = position.GetSize();
+  this->CheckSize(direction, numberOfParameters, "direction");
+
+  this->m_Arguments = ArgumentsType{};
+  this->m_Arguments.Operation = OperationType::Step;
+  this->m_Arguments.NumberOfParameters = numberOfParameters;
+  this->m_Arguments.StepSize = stepSize;
+  this->m_Arguments.Position = position.data_block();
+  this->m_Arguments.Other = direction.data_block();
+  this->Execute();
+
+} // end Step()
+
+
+/**
+ * ****************** PreconditionedStep *********************************
+ */
+
+void
+ParameterUpdateKernel::PreconditionedStep(VectorType &       position,
+                                          const double       stepSize,
+                                          const VectorType & preconditioner,
+                                          const VectorType & gradient,
+                                          VectorType &       searchDirection)
+{
+  const SizeValueType numberOfParameters = position.GetSize();
+  this->CheckSize(preconditioner, numberOfParameters, "preconditioner");
+  this->CheckSize(gradient, numberOfParameters, "gradient");
+  searchDirection.SetSize(numberOfParameters);
+
+  this->m_Arguments = ArgumentsType{};
+  this->m_Arguments.Operation = OperationType::PreconditionedStep;
+  this->m_Arguments.NumberOfParameters = numberOfParameters;
+  this->m_Arguments.StepSize = stepSize;
+  this->m_Arguments.Position = position.data_block();
+  this->m_Arguments.SearchDirection = searchDirection.data_block();
+  this->m_Arguments.Gradient = gradient.data_block();
+  this->m_Arguments.Other = preconditioner.data_block();
+  this->Execute();
+
+} // end PreconditionedStep()
+
+
+/**
+ * ****************** AdaptiveStep *********************************
+ */
+
+void
+ParameterUpdateKernel::AdaptiveStep(VectorType &       position,
+                                    const double       stepSize,
+                                    VectorType &       squaredGradientSum,
+                                    const VectorType & gradient,
+                                    VectorType &       searchDirection,
+                                    const double       epsilon)
+{
+  const SizeValueType numberOfParameters = position.GetSize();
+  this->CheckSize(squaredGradientSum, numberOfParameters, "squaredGradientSum");
+  this->CheckSize(gradient, numberOfParameters, "gradient");
+  searchDirection.SetSize(numberOfParameters);
+
+  this->m_Arguments = ArgumentsType{};
+  this->m_Arguments.Operation = OperationType::AdaptiveStep;
+  this->m_Arguments.NumberOfParameters = numberOfParameters;
+  this->m_Arguments.StepSize = stepSize;
+  this->m_Arguments.Epsilon = epsilon;
+  this->m_Arguments.Position = position.data_block();
+  this->m_Arguments.State = squaredGradientSum.data_block();
+  this->m_Arguments.SearchDirection = searchDirection.data_block();
+  this->m_Arguments.Gradient = gradient.data_block();
+  this->Execute();
+
+} // end AdaptiveStep()
+
+
+/**
+ * ****************** InnerProductAndAssign *********************************
+ */
+
+double
+ParameterUpdateKernel::InnerProductAndAssign(VectorType &       previous,
+                                             const VectorType & current,
+                                             const VectorType & next)
+{
+  const SizeValueType numberOfParameters = current.GetSize();
+  this->CheckSize(previous, numberOfParameters, "previous");
+  this->CheckSize(next, numberOfParameters, "next");
+
+  this->m_Arguments = ArgumentsType{};
+  this->m_Arguments.Operation = OperationType::InnerProductAndAssign;
+  this->m_Arguments.NumberOfParameters = numberOfParameters;
+  this->m_Arguments.State = previous.data_block();
+  this->m_Arguments.Gradient = current.data_block();
+  this->m_Arguments.Other = next.data_block();
+
+  const SizeValueType numberOfBlocks = (numberOfParameters + BlockSize - 1) / BlockSize;
+  this->m_BlockSums.assign(numberOfBlocks, 0.0);
+  this->Execute();
+
+  /** Add the block sums in a fixed order, independent of the number of work units. */
+  double innerProduct = 0.0;
+  for (const double blockSum : this->m_BlockSums)
+  {
+    innerProduct += blockSum;
+  }
+  return innerProduct;
+
+} // end InnerProductAndAssign()
+
+
+/**
+ * ****************** CheckSize *********************************
+ */
+
+void
+ParameterUpdateKernel::CheckSize(const VectorType &  vector,
+                                 const SizeValueType numberOfParameters,
+                                 const char *        name) const
+{
+  if (vector.GetSize() != numberOfParameters)
+  {
+    itkExceptionMacro(<< "The size of " << name << " (" << vector.GetSize()
+                      << ") differs from the number of parameters (" << numberOfParameters << ").");
+  }
+
+} // end CheckSize()
+
+
+/**
+ * ****************** Execute *********************************
+ */
+
+void
+ParameterUpdateKernel::Execute()
+{
+  const SizeValueType numberOfParameters = this->m_Arguments.NumberOfParameters;
+  const SizeValueType numberOfBlocks = (numberOfParameters + BlockSize - 1) / BlockSize;
+
+  /** Only go parallel when each work unit gets a fair amount of work. */
+  const SizeValueType numberOfWorkUnits =
+    std::min<SizeValueType>({ this->m_NumberOfWorkUnits,
+                              numberOfBlocks,
+                              numberOfParameters / this->m_MinimumNumberOfParametersPerWorkUnit });
+
+  if (numberOfWorkUnits <= 1)
+  {
+    this->ExecuteBlocks(0, numberOfBlocks);
+    return;
+  }
+
+  /** The threads are only started at the first large update. */
+  if (this->m_Threader.IsNull())
+  {
+    this->m_Threader = ThreaderType::New();
+  }
+  this->m_Threader->SetNumberOfWorkUnits(static_cast<ThreadIdType>(numberOfWorkUnits));
+  this->m_Threader->SetSingleMethod(ExecuteThreaderCallback, this);
+  this->m_Threader->SingleMethodExecute();
+
+} // end Execute()
+
+
+/**
+ * ****************** ExecuteThreaderCallback *********************************
+ */
+
+ITK_THREAD_RETURN_TYPE
+ParameterUpdateKernel::ExecuteThreaderCallback(void * arg)
+{
+  const auto * const infoStruct = static_cast<ThreadInfoType *>(arg);
+  auto * const       self = static_cast<Self *>(infoStruct->UserData);
+
+  /** Give each work unit a contiguous range of whole blocks. */
+  const SizeValueType numberOfBlocks = (self->m_Arguments.NumberOfParameters + BlockSize - 1) / BlockSize;
+  const SizeValueType workUnitID = infoStruct->WorkUnitID;
+  const SizeValueType numberOfWorkUnits = infoStruct->NumberOfWorkUnits;
+  const SizeValueType beginBlock = (numberOfBlocks * workUnitID) / numberOfWorkUnits;
+  const SizeValueType endBlock = (numberOfBlocks * (workUnitID + 1)) / numberOfWorkUnits;
+
+  self->ExecuteBlocks(beginBlock, endBlock);
+
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end ExecuteThreaderCallback()
+
+
+/**
+ * ****************** ExecuteBlocks *********************************
+ */
+
+void
+ParameterUpdateKernel::ExecuteBlocks(const SizeValueType beginBlock, const SizeValueType endBlock)
+{
+  const ArgumentsType & arguments = this->m_Arguments;
+  const double          stepSize = arguments.StepSize;
+  const double          epsilon = arguments.Epsilon;
+  double * const        position = arguments.Position;
+  double * const        state = arguments.State;
+  double * const        searchDirection = arguments.SearchDirection;
+  const double * const  gradient = arguments.Gradient;
+  const double * const  other = arguments.Other;
+
+  for (SizeValueType block = beginBlock; block < endBlock; ++block)
+  {
+    const SizeValueType jmin = block * BlockSize;
+    const SizeValueType jmax = std::min(jmin + BlockSize, arguments.NumberOfParameters);
+
+    switch (arguments.Operation)
+    {
+      case OperationType::Step:
+      {
+        for (SizeValueType j = jmin; j < jmax; ++j)
+        {
+          position[j] += stepSize * other[j];
+        }
+        break;
+      }
+      case OperationType::PreconditionedStep:
+      {
+        for (SizeValueType j = jmin; j < jmax; ++j)
+        {
+          const double direction = other[j] * gradient[j];
+          searchDirection[j] = direction;
+          position[j] += stepSize * direction;
+        }
+        break;
+      }
+      case OperationType::AdaptiveStep:
+      {
+        for (SizeValueType j = jmin; j < jmax; ++j)
+        {
+          const double squaredGradientSum = state[j] + gradient[j] * gradient[j];
+          const double direction = gradient[j] / std::sqrt(squaredGradientSum + epsilon);
+          state[j] = squaredGradientSum;
+          searchDirection[j] = direction;
+          position[j] += stepSize * direction;
+        }
+        break;
+      }
+      case OperationType::InnerProductAndAssign:
+      {
+        double blockSum = 0.0;
+        for (SizeValueType j = jmin; j < jmax; ++j)
+        {
+          blockSum += state[j] * gradient[j];
+          state[j] = other[j];
+        }
+        this->m_BlockSums[block] = blockSum;
+        break;
+      }
+    }
+  }
+
+} // end ExecuteBlocks()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+ParameterUpdateKernel::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+  os << indent << "MinimumNumberOfParametersPerWorkUnit: " << this->m_MinimumNumberOfParametersPerWorkUnit
+     << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParameterUpdateKernel_h
+#define itkParameterUpdateKernel_h
+
+#include "itkArray.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkPersistentPlatformMultiThreader.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class ParameterUpdateKernel
+ * \brief Applies the element-wise parameter updates of the first-order
+ * optimizers, in parallel over blocks of parameters.
+ *
+ * The gradient descent type optimizers update their parameters, and their
+ * per-parameter state, in a loop over all parameters after each evaluation
+ * of the metric. With a B-spline grid of a few million parameters, that loop
+ * is a serial tail of each iteration. This class offers the loops that the
+ * optimizers need, each fused into a single pass over the vectors:
+ *
+ * - Step: \f$ x = x + a d \f$
+ * - PreconditionedStep: \f$ d = P g, x = x + a d \f$, with diagonal \f$ P \f$
+ * - AdaptiveStep: \f$ v = v + g^2, d = g / \sqrt{v + \epsilon}, x = x + a d \f$
+ * - InnerProductAndAssign: \f$ r = \langle p, g \rangle, p = d \f$, the
+ *   bookkeeping of the adaptive step size strategies.
+ *
+ * The parameters are split in blocks of BlockSize. Consecutive blocks are
+ * processed by a work unit of a persistent thread pool, but only when each
+ * work unit gets at least MinimumNumberOfParametersPerWorkUnit parameters;
+ * smaller problems run on the calling thread, without starting any thread.
+ * Inner products are summed per block, and the block sums are added in
+ * order, so that the result does not depend on the number of work units.
+ *
+ * The loops run over raw pointers, with the scalars in local variables, so
+ * that the compiler can vectorise them.
+ *
+ * \ingroup Optimizers
+ */
+
+class ParameterUpdateKernel : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ParameterUpdateKernel    Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ParameterUpdateKernel, Object);
+
+  /** The type of the parameter and derivative vectors of the optimizers. */
+  typedef Array<double> VectorType;
+
+  /** The number of parameters of a block. */
+  static constexpr SizeValueType BlockSize = 4096;
+
+  /** position += stepSize * direction. */
+  void
+  Step(VectorType & position, double stepSize, const VectorType & direction);
+
+  /** searchDirection = preconditioner * gradient, element-wise, and
+   * position += stepSize * searchDirection.
+   */
+  void
+  PreconditionedStep(VectorType &       position,
+                     double             stepSize,
+                     const VectorType & preconditioner,
+                     const VectorType & gradient,
+                     VectorType &       searchDirection);
+
+  /** squaredGradientSum += gradient^2, searchDirection = gradient /
+   * sqrt(squaredGradientSum + epsilon), and position += stepSize *
+   * searchDirection, all element-wise. This is the AdaGrad update.
+   */
+  void
+  AdaptiveStep(VectorType &       position,
+               double             stepSize,
+               VectorType &       squaredGradientSum,
+               const VectorType & gradient,
+               VectorType &       searchDirection,
+               double             epsilon);
+
+  /** Returns the inner product of previous and current, and assigns next
+   * to previous. next may be the same vector as current.
+   */
+  double
+  InnerProductAndAssign(VectorType & previous, const VectorType & current, const VectorType & next);
+
+  /** Set/Get the maximum number of work units. Default: the global default
+   * number of threads.
+   */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, NumericTraits<ThreadIdType>::max());
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /** Set/Get the minimum number of parameters per work unit. Below twice this
+   * number, the updates run on the calling thread. Default: 32768.
+   */
+  itkSetClampMacro(MinimumNumberOfParametersPerWorkUnit, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(MinimumNumberOfParametersPerWorkUnit, SizeValueType);
+
+protected:
+  ParameterUpdateKernel();
+  ~ParameterUpdateKernel() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ParameterUpdateKernel(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  typedef PersistentPlatformMultiThreader ThreaderType;
+  typedef ThreaderType::WorkUnitInfo      ThreadInfoType;
+
+  enum class OperationType
+  {
+    Step,
+    PreconditionedStep,
+    AdaptiveStep,
+    InnerProductAndAssign
+  };
+
+  /** The operation and its arguments, set before Execute(). */
+  struct ArgumentsType
+  {
+    OperationType  Operation{ OperationType::Step };
+    SizeValueType  NumberOfParameters{ 0 };
+    double         StepSize{ 0.0 };
+    double         Epsilon{ 0.0 };
+    double *       Position{ nullptr };
+    double *       State{ nullptr };
+    double *       SearchDirection{ nullptr };
+    const double * Gradient{ nullptr };
+    const double * Other{ nullptr };
+  };
+
+  /** Throws an exception when the vector does not have the given size. */
+  void
+  CheckSize(const VectorType & vector, SizeValueType numberOfParameters, const char * name) const;
+
+  /** Runs the operation over all blocks, threaded when the vectors are large enough. */
+  void
+  Execute();
+
+  /** Runs the operation over the blocks [beginBlock, endBlock). */
+  void
+  ExecuteBlocks(SizeValueType beginBlock, SizeValueType endBlock);
+
+  /** The threader callback, which runs a range of blocks. */
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  ExecuteThreaderCallback(void * arg);
+
+  ArgumentsType         m_Arguments;
+  std::vector<double>   m_BlockSums;
+  ThreaderType::Pointer m_Threader;
+  ThreadIdType          m_NumberOfWorkUnits;
+  SizeValueType         m_MinimumNumberOfParametersPerWorkUnit{ 32768 };
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkParameterUpdateKernel_h
@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPerformanceTelemetry.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+/**
+ * ****************** AddTime *********************************
+ */
+
+void
+PerformanceTelemetry::AddTime(const std::string & name, double seconds)
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  Channel &                         channel = this->m_Channels[name];
+  channel.m_IsTimer = true;
+  ++channel.m_Count;
+  channel.m_Seconds += seconds;
+
+} // end AddTime()
+
+
+/**
+ * ****************** AddCount *********************************
+ */
+
+void
+PerformanceTelemetry::AddCount(const std::string & name, std::uint64_t count)
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  this->m_Channels[name].m_Count += count;
+
+} // end AddCount()
+
+
+/**
+ * ****************** Collect *********************************
+ */
+
+PerformanceTelemetry::StatisticsType
+PerformanceTelemetry::Collect(void)
+{
+  StatisticsType statistics;
+
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  statistics.reserve(this->m_Channels.size());
+  for (auto & nameAndChannel : this->m_Channels)
+  {
+    Channel & channel = nameAndChannel.second;
+    statistics.push_back({ nameAndChannel.first, channel.m_IsTimer, channel.m_Count, channel.m_Seconds });
+    channel.m_Count = 0;
+    channel.m_Seconds = 0.0;
+  }
+  return statistics;
+
+} // end Collect()
+
+
+/**
+ * ****************** Accumulate *********************************
+ */
+
+void
+PerformanceTelemetry::Accumulate(StatisticsType & total, const StatisticsType & addend)
+{
+  for (const auto & channel : addend)
+  {
+    const auto found = std::find_if(total.begin(), total.end(), [&channel](const ChannelStatistics & existing) {
+      return existing.m_Name == channel.m_Name;
+    });
+    if (found == total.end())
+    {
+      total.push_back(channel);
+    }
+    else
+    {
+      found->m_IsTimer = found->m_IsTimer || channel.m_IsTimer;
+      found->m_Count += channel.m_Count;
+      found->m_Seconds += channel.m_Seconds;
+    }
+  }
+  std::sort(total.begin(), total.end(), [](const ChannelStatistics & lhs, const ChannelStatistics & rhs) {
+    return lhs.m_Name < rhs.m_Name;
+  });
+
+} // end Accumulate()
+
+
+/**
+ * ****************** GetCount *********************************
+ */
+
+std::uint64_t
+PerformanceTelemetry::GetCount(const StatisticsType & statistics, const std::string & name)
+{
+  for (const auto & channel : statistics)
+  {
+    if (channel.m_Name == name)
+    {
+      return channel.m_Count;
+    }
+  }
+  return 0;
+
+} // end GetCount()
+
+
+/**
+ * ****************** WriteJSON *********************************
+ */
+
+void
+PerformanceTelemetry::WriteJSON(std::ostream & os, const StatisticsType & statistics)
+{
+  /** The channel names are chosen by the components, and do not need escaping. */
+  os << '{';
+  bool first = true;
+  for (const auto & channel : statistics)
+  {
+    os << (first ? "" : ",") << '"' << channel.m_Name << "\":";
+    if (channel.m_IsTimer)
+    {
+      os << "{\"count\":" << channel.m_Count << ",\"timeMs\":" << channel.m_Seconds * 1000.0 << '}';
+    }
+    else
+    {
+      os << channel.m_Count;
+    }
+    first = false;
+  }
+  os << '}';
+
+} // end WriteJSON()
+
+
+} // end namespace itk
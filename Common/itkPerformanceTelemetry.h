@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPerformanceTelemetry_h
+#define itkPerformanceTelemetry_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class PerformanceTelemetry
+ * \brief Collects named timers and counters, for profiling a registration.
+ *
+ * Components that are given a PerformanceTelemetry object record how long
+ * their phases take, with a ScopedTimer, and count things like samples or
+ * allocated bytes, with AddCount(). Both are thread-safe. A component that
+ * has no telemetry object passes a null pointer to ScopedTimer, which then
+ * does not even read the clock.
+ *
+ * The owner calls Collect() at the end of each iteration, which returns the
+ * statistics since the previous call, and writes them with WriteJSON().
+ *
+ * \ingroup Common
+ */
+
+class PerformanceTelemetry : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef PerformanceTelemetry     Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PerformanceTelemetry, Object);
+
+  /** The statistics of one timer or counter. A timer counts how often it ran,
+   * and the total time in seconds. A counter only has a count.
+   */
+  struct ChannelStatistics
+  {
+    std::string   m_Name;
+    bool          m_IsTimer;
+    std::uint64_t m_Count;
+    double        m_Seconds;
+  };
+  typedef std::vector<ChannelStatistics> StatisticsType;
+
+  /** Records the duration of the enclosing scope in a timer of the given
+   * telemetry object. Does nothing when the telemetry object is null.
+   */
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer(PerformanceTelemetry * telemetry, const char * name)
+      : m_Telemetry(telemetry)
+      , m_Name(name)
+    {
+      if (m_Telemetry != nullptr)
+      {
+        m_Start = std::chrono::steady_clock::now();
+      }
+    }
+
+    ~ScopedTimer()
+    {
+      if (m_Telemetry != nullptr)
+      {
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - m_Start;
+        m_Telemetry->AddTime(m_Name, duration.count());
+      }
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &
+    operator=(const ScopedTimer &) = delete;
+
+  private:
+    PerformanceTelemetry * const          m_Telemetry;
+    const char * const                    m_Name;
+    std::chrono::steady_clock::time_point m_Start;
+  };
+
+  /** Adds one run of the given duration, in seconds, to a timer. */
+  void
+  AddTime(const std::string & name, double seconds);
+
+  /** Adds to a counter. */
+  void
+  AddCount(const std::string & name, std::uint64_t count);
+
+  /** Returns the statistics since the previous call, sorted by name, and resets them. */
+  StatisticsType
+  Collect(void);
+
+  /** Adds the statistics of addend to total, for example to sum the
+   * iterations of a resolution.
+   */
+  static void
+  Accumulate(StatisticsType & total, const StatisticsType & addend);
+
+  /** Returns the count of the named channel, or zero when there is none. */
+  static std::uint64_t
+  GetCount(const StatisticsType & statistics, const std::string & name);
+
+  /** Writes the statistics as a JSON object: a timer as
+   * "name":{"count":c,"timeMs":t}, and a counter as "name":c.
+   */
+  static void
+  WriteJSON(std::ostream & os, const StatisticsType & statistics);
+
+protected:
+  PerformanceTelemetry() = default;
+  ~PerformanceTelemetry() override = default;
+
+private:
+  PerformanceTelemetry(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  struct Channel
+  {
+    bool          m_IsTimer{ false };
+    std::uint64_t m_Count{ 0 };
+    double        m_Seconds{ 0.0 };
+  };
+
+  std::mutex                     m_Mutex;
+  std::map<std::string, Channel> m_Channels;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkPerformanceTelemetry_h
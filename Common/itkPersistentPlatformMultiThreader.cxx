@@ -0,0 +1,250 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPersistentPlatformMultiThreader.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+namespace itk
+{
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+PersistentPlatformMultiThreader::~PersistentPlatformMultiThreader()
+{
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    this->m_Stop = true;
+  }
+  this->m_ForkCondition.notify_all();
+
+  for (auto & worker : this->m_Workers)
+  {
+    worker.join();
+  }
+
+} // end Destructor
+
+
+/**
+ * ****************** SetSingleMethod *********************************
+ */
+
+void
+PersistentPlatformMultiThreader::SetSingleMethod(ThreadFunctionType f, void * data)
+{
+  this->Superclass::SetSingleMethod(f, data);
+  this->m_Method = f;
+  this->m_UserData = data;
+
+} // end SetSingleMethod()
+
+
+/**
+ * ****************** SingleMethodExecute *********************************
+ */
+
+void
+PersistentPlatformMultiThreader::SingleMethodExecute()
+{
+  if (this->m_Method == nullptr)
+  {
+    itkExceptionMacro(<< "No single method set!");
+  }
+
+  const std::lock_guard<std::mutex> executeLock(this->m_ExecuteMutex);
+
+  const ThreadIdType numberOfWorkUnits = std::max<ThreadIdType>(1, this->GetNumberOfWorkUnits());
+  this->m_CurrentNumberOfWorkUnits = numberOfWorkUnits;
+  this->m_Exception = nullptr;
+
+  if (numberOfWorkUnits > 1)
+  {
+    if (this->m_Workers.size() < numberOfWorkUnits - 1)
+    {
+      this->StartWorkers(numberOfWorkUnits - 1);
+    }
+
+    /** Fork. */
+    this->m_NumberOfBusyWorkers.store(static_cast<ThreadIdType>(this->m_Workers.size()), std::memory_order_relaxed);
+    {
+      const std::lock_guard<std::mutex> lock(this->m_Mutex);
+      this->m_Generation.fetch_add(1, std::memory_order_release);
+    }
+    this->m_ForkCondition.notify_all();
+  }
+
+  this->RunWorkUnit(0);
+
+  if (numberOfWorkUnits > 1)
+  {
+    /** Join. */
+    for (unsigned int spin = 0;
+         spin < this->m_SpinCount && this->m_NumberOfBusyWorkers.load(std::memory_order_acquire) > 0;
+         ++spin)
+    {
+    }
+    if (this->m_NumberOfBusyWorkers.load(std::memory_order_acquire) > 0)
+    {
+      std::unique_lock<std::mutex> lock(this->m_Mutex);
+      this->m_JoinCondition.wait(
+        lock, [this] { return this->m_NumberOfBusyWorkers.load(std::memory_order_acquire) == 0; });
+    }
+  }
+
+  if (this->m_Exception != nullptr)
+  {
+    const std::exception_ptr exception = this->m_Exception;
+    this->m_Exception = nullptr;
+    std::rethrow_exception(exception);
+  }
+
+} // end SingleMethodExecute()
+
+
+/**
+ * ****************** StartWorkers *********************************
+ */
+
+void
+PersistentPlatformMultiThreader::StartWorkers(const ThreadIdType numberOfWorkers)
+{
+  /** Spinning only pays off when each thread has a core of its own. Otherwise
+   * the spinning threads take the time of the threads that have work to do.
+   */
+  const unsigned int numberOfCores = std::max(1u, std::thread::hardware_concurrency());
+  this->m_SpinCount = numberOfWorkers < numberOfCores ? 1024 : 0;
+
+  this->m_Workers.reserve(numberOfWorkers);
+  while (this->m_Workers.size() < numberOfWorkers)
+  {
+    const auto workUnitID = static_cast<ThreadIdType>(this->m_Workers.size() + 1);
+    this->m_Workers.emplace_back(&Self::WorkerLoop, this, workUnitID, this->m_Generation.load());
+
+#ifdef __linux__
+    if (this->m_PinWorkerThreads)
+    {
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(workUnitID % numberOfCores, &cpuSet);
+      pthread_setaffinity_np(this->m_Workers.back().native_handle(), sizeof(cpu_set_t), &cpuSet);
+    }
+#endif
+  }
+
+} // end StartWorkers()
+
+
+/**
+ * ****************** WorkerLoop *********************************
+ */
+
+void
+PersistentPlatformMultiThreader::WorkerLoop(const ThreadIdType workUnitID, unsigned long generation)
+{
+  for (;;)
+  {
+    /** Wait for the next fork: spin for a short while, then block. */
+    const unsigned int spinCount = this->m_SpinCount;
+    for (unsigned int spin = 0; spin < spinCount && this->m_Generation.load(std::memory_order_acquire) == generation &&
+                                !this->m_Stop.load(std::memory_order_acquire);
+         ++spin)
+    {
+    }
+    if (this->m_Generation.load(std::memory_order_acquire) == generation && !this->m_Stop.load())
+    {
+      std::unique_lock<std::mutex> lock(this->m_Mutex);
+      this->m_ForkCondition.wait(lock, [this, generation] {
+        return this->m_Generation.load(std::memory_order_acquire) != generation || this->m_Stop.load();
+      });
+    }
+    if (this->m_Stop.load())
+    {
+      return;
+    }
+    generation = this->m_Generation.load(std::memory_order_acquire);
+
+    /** Workers beyond the current number of work units only take part in the join. */
+    if (workUnitID < this->m_CurrentNumberOfWorkUnits)
+    {
+      this->RunWorkUnit(workUnitID);
+    }
+
+    /** Join: the last worker wakes up the calling thread. */
+    if (this->m_NumberOfBusyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      const std::lock_guard<std::mutex> lock(this->m_Mutex);
+      this->m_JoinCondition.notify_one();
+    }
+  }
+
+} // end WorkerLoop()
+
+
+/**
+ * ****************** RunWorkUnit *********************************
+ */
+
+void
+PersistentPlatformMultiThreader::RunWorkUnit(const ThreadIdType workUnitID)
+{
+  WorkUnitInfo workUnitInfo{};
+  workUnitInfo.WorkUnitID = workUnitID;
+  workUnitInfo.NumberOfWorkUnits = this->m_CurrentNumberOfWorkUnits;
+  workUnitInfo.UserData = this->m_UserData;
+  workUnitInfo.ThreadFunction = this->m_Method;
+
+  try
+  {
+    this->m_Method(&workUnitInfo);
+  }
+  catch (...)
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    if (this->m_Exception == nullptr)
+    {
+      this->m_Exception = std::current_exception();
+    }
+  }
+
+} // end RunWorkUnit()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+PersistentPlatformMultiThreader::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfWorkerThreads: " << this->m_Workers.size() << std::endl;
+  os << indent << "PinWorkerThreads: " << (this->m_PinWorkerThreads ? "true" : "false") << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
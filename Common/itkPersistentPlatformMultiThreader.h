@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPersistentPlatformMultiThreader_h
+#define itkPersistentPlatformMultiThreader_h
+
+#include "itkPlatformMultiThreader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace itk
+{
+/** \class PersistentPlatformMultiThreader
+ * \brief A PlatformMultiThreader that runs SingleMethodExecute() on a
+ * persistent set of worker threads.
+ *
+ * PlatformMultiThreader creates and joins a new set of threads in each call
+ * to SingleMethodExecute(). The metrics call it at least twice per iteration,
+ * for thousands of iterations, so that with a few thousand samples the
+ * creation of the threads takes a noticeable part of each iteration.
+ *
+ * This class starts its worker threads on the first call, and keeps them
+ * for subsequent calls. A call forks by increasing a generation counter, and
+ * joins by counting down the workers. Work unit 0 runs on the calling thread,
+ * as in PlatformMultiThreader. When there are enough cores, idle workers spin
+ * for a short while before they wait on a condition variable, so that the
+ * fork of the next call is cheap when it follows quickly.
+ *
+ * The callback and WorkUnitInfo are the same as for PlatformMultiThreader,
+ * so that it is a drop-in replacement. An exception thrown by a work unit is
+ * rethrown by SingleMethodExecute(), after all work units have finished.
+ *
+ * Optionally, on Linux, the worker threads are pinned to a core each.
+ *
+ * \ingroup Common
+ */
+
+class PersistentPlatformMultiThreader : public PlatformMultiThreader
+{
+public:
+  /** Standard class typedefs. */
+  typedef PersistentPlatformMultiThreader Self;
+  typedef PlatformMultiThreader           Superclass;
+  typedef SmartPointer<Self>              Pointer;
+  typedef SmartPointer<const Self>        ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PersistentPlatformMultiThreader, PlatformMultiThreader);
+
+  /** Set the function that SingleMethodExecute() calls for each work unit. */
+  void
+  SetSingleMethod(ThreadFunctionType f, void * data) override;
+
+  /** Calls the single method once for each work unit, on the persistent
+   * worker threads, and returns when all work units have finished.
+   */
+  void
+  SingleMethodExecute() override;
+
+  /** Pin each worker thread to a core. Only has effect on Linux, and only
+   * for worker threads that are started afterwards. Default: false, because
+   * pinning hurts when several registrations share a machine.
+   */
+  itkSetMacro(PinWorkerThreads, bool);
+  itkGetConstMacro(PinWorkerThreads, bool);
+  itkBooleanMacro(PinWorkerThreads);
+
+protected:
+  PersistentPlatformMultiThreader() = default;
+  ~PersistentPlatformMultiThreader() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  PersistentPlatformMultiThreader(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** Starts worker threads, until there are numberOfWorkers. */
+  void
+  StartWorkers(ThreadIdType numberOfWorkers);
+
+  /** The loop of a worker thread, which runs work unit workUnitID of each fork. */
+  void
+  WorkerLoop(ThreadIdType workUnitID, unsigned long generation);
+
+  /** Calls the single method for one work unit, and stores its exception, if any. */
+  void
+  RunWorkUnit(ThreadIdType workUnitID);
+
+  ThreadFunctionType m_Method{ nullptr };
+  void *             m_UserData{ nullptr };
+  ThreadIdType       m_CurrentNumberOfWorkUnits{ 1 };
+  bool               m_PinWorkerThreads{ false };
+
+  /** The number of times that idle threads check for a fork or join, before they block. */
+  std::atomic<unsigned int> m_SpinCount{ 0 };
+
+  std::vector<std::thread>   m_Workers;
+  std::mutex                 m_ExecuteMutex;
+  std::mutex                 m_Mutex;
+  std::condition_variable    m_ForkCondition;
+  std::condition_variable    m_JoinCondition;
+  std::atomic<unsigned long> m_Generation{ 0 };
+  std::atomic<ThreadIdType>  m_NumberOfBusyWorkers{ 0 };
+  std::atomic<bool>          m_Stop{ false };
+  std::exception_ptr         m_Exception;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkPersistentPlatformMultiThreader_h
@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRasterizedMask_h
+#define itkRasterizedMask_h
+
+#include "itkObject.h"
+#include "itkImageMaskSpatialObject.h"
+#include "itkMath.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class RasterizedMask
+ *
+ * \brief Fast, thread-safe lookup of a mask, at physical points.
+ *
+ * SpatialObject::IsInsideInWorldSpace() is a virtual call that, for an
+ * ImageMaskSpatialObject, transforms the point to the object space and to an
+ * image index, checks the image region and fetches the pixel through the
+ * generic image API. Samplers and metrics do this for every sample, for every
+ * iteration.
+ *
+ * This class rasterizes an ImageMaskSpatialObject once, after SetMask(), into:
+ * \li a bitmask with one bit per voxel of the mask image,
+ * \li one affine map from world coordinates to continuous mask indices,
+ *     combining the object-to-world transform, the direction, the spacing
+ *     and the origin,
+ * \li a coarse occupancy grid of blocks of 8^Dimension voxels, which are either
+ *     empty, full or mixed, so that most lookups do not touch the bitmask.
+ *
+ * The lookup rounds the continuous index like Image::TransformPhysicalPointToIndex().
+ * Masks that are not an ImageMaskSpatialObject are not rasterized; for those
+ * IsInside() simply calls IsInsideInWorldSpace().
+ *
+ * The rasterization is keyed on the modified times of the mask, its
+ * object-to-world transform, its image and the pixel container of the image.
+ * Update() rasterizes the mask again when one of those has changed, for
+ * example when the mask image was modified in place, followed by a call to
+ * Modified(). SetMask() calls Update(), so it may be called at the start of
+ * each resolution, or each time samples are drawn. IsInside() is thread-safe,
+ * SetMask() and Update() are not.
+ */
+
+template <unsigned int VDimension>
+class ITK_TEMPLATE_EXPORT RasterizedMask : public Object
+{
+public:
+  /** Standard ITK stuff. */
+  typedef RasterizedMask           Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RasterizedMask, Object);
+
+  /** The dimension. */
+  itkStaticConstMacro(Dimension, unsigned int, VDimension);
+
+  /** Typedefs. */
+  typedef SpatialObject<VDimension>                      MaskType;
+  typedef typename MaskType::ConstPointer                MaskConstPointer;
+  typedef typename MaskType::PointType                   PointType;
+  typedef ImageMaskSpatialObject<VDimension>             ImageMaskSpatialObjectType;
+  typedef typename ImageMaskSpatialObjectType::ImageType MaskImageType;
+
+  /** Set the mask, and rasterize it when it is an ImageMaskSpatialObject. */
+  void
+  SetMask(const MaskType * mask);
+
+  /** Rasterize the mask again, when it was modified since it was last rasterized. */
+  void
+  Update(void);
+
+  /** Get the mask. */
+  const MaskType *
+  GetMask(void) const
+  {
+    return this->m_Mask.GetPointer();
+  }
+
+
+  /** Returns true when the mask was rasterized, false when IsInside() falls back to the mask itself. */
+  itkGetConstMacro(IsRasterized, bool);
+
+  /** Returns true when the point is inside the mask. Thread-safe. */
+  inline bool
+  IsInside(const PointType & point) const
+  {
+    if (!this->m_IsRasterized)
+    {
+      return this->m_Mask->IsInsideInWorldSpace(point);
+    }
+    return this->IsInsideRasterized(point);
+  }
+
+
+  /** Batched lookup: sets inside[i] to IsInside( points[i] ), for a block of points. */
+  void
+  IsInside(const PointType * points, const SizeValueType numberOfPoints, bool * inside) const;
+
+protected:
+  RasterizedMask();
+  ~RasterizedMask() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  RasterizedMask(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** The coarse occupancy grid: each block of 8^Dimension voxels is empty, full or mixed. */
+  enum BlockStateType : std::uint8_t
+  {
+    EmptyBlock = 0,
+    FullBlock = 1,
+    MixedBlock = 2
+  };
+  itkStaticConstMacro(BlockShift, unsigned int, 3);
+
+  /** Rasterize the image of the mask. */
+  void
+  Rasterize(const ImageMaskSpatialObjectType * imageMask);
+
+  /** Returns the largest modified time of the mask, its object-to-world transform,
+   * its image and the pixel container of its image.
+   */
+  static ModifiedTimeType
+  GetMaskMTime(const MaskType * mask);
+
+  /** The lookup of a rasterized mask. */
+  inline bool
+  IsInsideRasterized(const PointType & point) const
+  {
+    SizeValueType voxelOffset = 0;
+    SizeValueType blockOffset = 0;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      double continuousIndex = this->m_WorldToIndexOffset[i];
+      for (unsigned int j = 0; j < VDimension; ++j)
+      {
+        continuousIndex += this->m_WorldToIndexMatrix[i][j] * point[j];
+      }
+      const OffsetValueType index = Math::RoundHalfIntegerUp<OffsetValueType>(continuousIndex);
+      if (index < 0 || index >= static_cast<OffsetValueType>(this->m_Size[i]))
+      {
+        return false;
+      }
+      voxelOffset += static_cast<SizeValueType>(index) * this->m_VoxelStrides[i];
+      blockOffset += (static_cast<SizeValueType>(index) >> BlockShift) * this->m_BlockStrides[i];
+    }
+
+    const std::uint8_t blockState = this->m_BlockStates[blockOffset];
+    if (blockState != MixedBlock)
+    {
+      return blockState == FullBlock;
+    }
+    return (this->m_Bits[voxelOffset >> 6] >> (voxelOffset & 63)) & 1u;
+  }
+
+
+  /** The mask, and its modified time when it was rasterized. */
+  MaskConstPointer m_Mask;
+  ModifiedTimeType m_RasterizedMaskMTime;
+  bool             m_IsRasterized;
+
+  /** The map from world coordinates to continuous indices of the buffered region. */
+  double m_WorldToIndexMatrix[VDimension][VDimension];
+  double m_WorldToIndexOffset[VDimension];
+
+  /** The bitmask, and the coarse occupancy grid. */
+  SizeValueType              m_Size[VDimension];
+  SizeValueType              m_VoxelStrides[VDimension];
+  SizeValueType              m_BlockStrides[VDimension];
+  std::vector<std::uint64_t> m_Bits;
+  std::vector<std::uint8_t>  m_BlockStates;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkRasterizedMask.hxx"
+#endif
+
+#endif // end #ifndef itkRasterizedMask_h
@@ -0,0 +1,288 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRasterizedMask_hxx
+#define itkRasterizedMask_hxx
+
+#include "itkRasterizedMask.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <algorithm> // For max.
+
+namespace itk
+{
+
+/**
+ * ************* Constructor *******************
+ */
+
+template <unsigned int VDimension>
+RasterizedMask<VDimension>::RasterizedMask()
+{
+  this->m_RasterizedMaskMTime = 0;
+  this->m_IsRasterized = false;
+
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    for (unsigned int j = 0; j < VDimension; ++j)
+    {
+      this->m_WorldToIndexMatrix[i][j] = 0.0;
+    }
+    this->m_WorldToIndexOffset[i] = 0.0;
+    this->m_Size[i] = 0;
+    this->m_VoxelStrides[i] = 0;
+    this->m_BlockStrides[i] = 0;
+  }
+
+} // end Constructor
+
+
+/**
+ * ************* SetMask *******************
+ */
+
+template <unsigned int VDimension>
+void
+RasterizedMask<VDimension>::SetMask(const MaskType * mask)
+{
+  if (mask != this->m_Mask.GetPointer())
+  {
+    this->m_Mask = mask;
+    this->m_RasterizedMaskMTime = 0;
+    this->m_IsRasterized = false;
+  }
+  this->Update();
+
+} // end SetMask()
+
+
+/**
+ * ************* Update *******************
+ */
+
+template <unsigned int VDimension>
+void
+RasterizedMask<VDimension>::Update(void)
+{
+  /** Nothing to do when the mask did not change since it was rasterized. */
+  const ModifiedTimeType maskMTime = Self::GetMaskMTime(this->m_Mask);
+  if (this->m_Mask.IsNotNull() && maskMTime == this->m_RasterizedMaskMTime)
+  {
+    return;
+  }
+
+  const auto *          imageMask = dynamic_cast<const ImageMaskSpatialObjectType *>(this->m_Mask.GetPointer());
+  const MaskImageType * maskImage = imageMask != nullptr ? imageMask->GetImage() : nullptr;
+
+  this->m_RasterizedMaskMTime = maskMTime;
+  this->m_IsRasterized = false;
+  this->m_Bits.clear();
+  this->m_BlockStates.clear();
+
+  if (maskImage != nullptr && maskImage->GetBufferedRegion().GetNumberOfPixels() > 0)
+  {
+    this->Rasterize(imageMask);
+  }
+  this->Modified();
+
+} // end Update()
+
+
+/**
+ * ************* GetMaskMTime *******************
+ */
+
+template <unsigned int VDimension>
+ModifiedTimeType
+RasterizedMask<VDimension>::GetMaskMTime(const MaskType * mask)
+{
+  if (mask == nullptr)
+  {
+    return 0;
+  }
+
+  ModifiedTimeType mtime = mask->GetMTime();
+  if (mask->GetObjectToWorldTransform() != nullptr)
+  {
+    mtime = std::max(mtime, mask->GetObjectToWorldTransform()->GetMTime());
+  }
+
+  const ImageMaskSpatialObjectType * imageMask = dynamic_cast<const ImageMaskSpatialObjectType *>(mask);
+  const MaskImageType *              maskImage = imageMask != nullptr ? imageMask->GetImage() : nullptr;
+  if (maskImage != nullptr)
+  {
+    mtime = std::max(mtime, maskImage->GetMTime());
+    if (maskImage->GetPixelContainer() != nullptr)
+    {
+      mtime = std::max(mtime, maskImage->GetPixelContainer()->GetMTime());
+    }
+  }
+  return mtime;
+
+} // end GetMaskMTime()
+
+
+/**
+ * ************* Rasterize *******************
+ */
+
+template <unsigned int VDimension>
+void
+RasterizedMask<VDimension>::Rasterize(const ImageMaskSpatialObjectType * imageMask)
+{
+  typedef typename MaskImageType::PixelType                MaskPixelType;
+  typedef typename MaskImageType::RegionType               RegionType;
+  typedef ImageRegionConstIterator<MaskImageType>          IteratorType;
+  typedef vnl_matrix_fixed<double, VDimension, VDimension> MatrixType;
+
+  const MaskImageType * maskImage = imageMask->GetImage();
+  const RegionType      region = maskImage->GetBufferedRegion();
+
+  /** The map from world to object space. */
+  const auto *     worldToObject = imageMask->GetObjectToWorldTransformInverse();
+  const MatrixType worldToObjectMatrix = worldToObject->GetMatrix().GetVnlMatrix();
+
+  /** The map from object space to index: spacing^-1 * direction^-1. */
+  MatrixType objectToIndex;
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    for (unsigned int j = 0; j < VDimension; ++j)
+    {
+      objectToIndex(i, j) = maskImage->GetInverseDirection()(i, j) / maskImage->GetSpacing()[i];
+    }
+  }
+
+  /** Combine: index = objectToIndex * ( worldToObject * p + t - origin ) - regionStart. */
+  const MatrixType worldToIndex = objectToIndex * worldToObjectMatrix;
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    double offset = 0.0;
+    for (unsigned int j = 0; j < VDimension; ++j)
+    {
+      this->m_WorldToIndexMatrix[i][j] = worldToIndex(i, j);
+      offset += objectToIndex(i, j) * (worldToObject->GetOffset()[j] - maskImage->GetOrigin()[j]);
+    }
+    this->m_WorldToIndexOffset[i] = offset - static_cast<double>(region.GetIndex()[i]);
+  }
+
+  /** Compute the strides of the voxels and of the blocks. */
+  SizeValueType numberOfVoxels = 1;
+  SizeValueType numberOfBlocks = 1;
+  SizeValueType blockSize[VDimension];
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    this->m_Size[i] = region.GetSize()[i];
+    this->m_VoxelStrides[i] = numberOfVoxels;
+    this->m_BlockStrides[i] = numberOfBlocks;
+    blockSize[i] = ((this->m_Size[i] - 1) >> BlockShift) + 1;
+    numberOfVoxels *= this->m_Size[i];
+    numberOfBlocks *= blockSize[i];
+  }
+
+  /** Fill the bits, and count the voxels inside the mask per block. */
+  std::vector<SizeValueType> insideCount(numberOfBlocks, 0);
+  std::vector<SizeValueType> voxelCount(numberOfBlocks, 0);
+  this->m_Bits.assign((numberOfVoxels + 63) / 64, 0);
+
+  IteratorType  it(maskImage, region);
+  SizeValueType voxelOffset = 0;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it, ++voxelOffset)
+  {
+    const typename MaskImageType::IndexType index = it.GetIndex();
+    SizeValueType                           blockOffset = 0;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      const SizeValueType local = static_cast<SizeValueType>(index[i] - region.GetIndex()[i]);
+      blockOffset += (local >> BlockShift) * this->m_BlockStrides[i];
+    }
+
+    ++voxelCount[blockOffset];
+    if (Math::NotExactlyEquals(it.Get(), NumericTraits<MaskPixelType>::ZeroValue()))
+    {
+      this->m_Bits[voxelOffset >> 6] |= std::uint64_t(1) << (voxelOffset & 63);
+      ++insideCount[blockOffset];
+    }
+  }
+
+  /** Classify the blocks. Blocks at the border of the region may be partial. */
+  this->m_BlockStates.resize(numberOfBlocks);
+  for (SizeValueType b = 0; b < numberOfBlocks; ++b)
+  {
+    if (insideCount[b] == 0)
+    {
+      this->m_BlockStates[b] = EmptyBlock;
+    }
+    else if (insideCount[b] == voxelCount[b])
+    {
+      this->m_BlockStates[b] = FullBlock;
+    }
+    else
+    {
+      this->m_BlockStates[b] = MixedBlock;
+    }
+  }
+
+  this->m_IsRasterized = true;
+
+} // end Rasterize()
+
+
+/**
+ * ************* IsInside *******************
+ */
+
+template <unsigned int VDimension>
+void
+RasterizedMask<VDimension>::IsInside(const PointType * points, const SizeValueType numberOfPoints, bool * inside) const
+{
+  if (!this->m_IsRasterized)
+  {
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      inside[i] = this->m_Mask->IsInsideInWorldSpace(points[i]);
+    }
+    return;
+  }
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    inside[i] = this->IsInsideRasterized(points[i]);
+  }
+
+} // end IsInside()
+
+
+/**
+ * ************* PrintSelf *******************
+ */
+
+template <unsigned int VDimension>
+void
+RasterizedMask<VDimension>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mask: " << this->m_Mask.GetPointer() << std::endl;
+  os << indent << "IsRasterized: " << (this->m_IsRasterized ? "true" : "false") << std::endl;
+  os << indent << "NumberOfBlocks: " << this->m_BlockStates.size() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkRasterizedMask_hxx
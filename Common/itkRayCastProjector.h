@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRayCastProjector_h
+#define itkRayCastProjector_h
+
+#include "itkObject.h"
+#include "itkMultiThreaderBase.h"
+#include "itkPoint.h"
+#include "itkTransform.h"
+#include "itkVector.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+/** \class RayCastProjector
+ * \brief Computes digitally reconstructed radiographs (DRRs) of a 3D volume.
+ *
+ * The projector integrates the intensities of a volume along rays, in the
+ * same way as the AdvancedRayCastInterpolateImageFunction always did: the
+ * volume is centred at the origin, the ray is intersected with the six faces
+ * of the volume, it is stepped one plane of voxels at a time along its
+ * dominant axis, and the intensities are interpolated bilinearly within each
+ * plane. Every ray, also one that passes close to an edge or a corner of the
+ * volume, gives the same integral as before.
+ *
+ * The geometry of the volume, including the planes and corners of its faces,
+ * is computed once per modification of the volume, keyed on its MTime,
+ * instead of once per ray. IntegrateRay() then only clips and traverses the
+ * ray, and is thread safe.
+ *
+ * GenerateProjection() casts the rays of a whole detector at once. The
+ * detector is divided into square tiles, which are distributed over the
+ * threads, so that neighbouring rays, which touch the same voxels, are cast
+ * by the same thread. The positions of the detector pixels and of the focal
+ * point are cached after mapping them by the non-rigid part of the transform,
+ * see GenerateProjection(), so that a change of only the rigid parameters
+ * reuses them. Each pixel of the projection equals IntegrateRay() for the ray
+ * through its mapped position.
+ *
+ * \sa AdvancedRayCastInterpolateImageFunction
+ * \ingroup ImageFunctions
+ * \ingroup MultiThreaded
+ */
+
+template <class TInputImage, class TCoordRep = double>
+class ITK_TEMPLATE_EXPORT RayCastProjector : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef RayCastProjector         Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RayCastProjector, Object);
+
+  /** The volume must be 3-dimensional. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+  /** Typedefs. */
+  typedef TInputImage                                          InputImageType;
+  typedef typename InputImageType::PixelType                   PixelType;
+  typedef Transform<TCoordRep, ImageDimension, ImageDimension> TransformType;
+  typedef Point<TCoordRep, ImageDimension>                     PointType;
+  typedef Vector<TCoordRep, ImageDimension>                    DirectionType;
+
+  /** Set the volume. Its geometry is computed by the first ray that is cast
+   * after the volume, or its geometry, is modified.
+   */
+  void
+  SetVolume(const InputImageType * volume);
+
+  /** Get the volume. */
+  itkGetConstObjectMacro(Volume, InputImageType);
+
+  /** The size of the square tiles of detector pixels that are scheduled to
+   * the threads by GenerateProjection(). Default: 16.
+   */
+  itkSetClampMacro(TileSize, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(TileSize, unsigned int);
+
+  /** Integrates the intensities above the threshold along the line through the
+   * given point, in the given direction. Returns zero if the line misses the
+   * volume, or if no volume is set. This function is thread safe.
+   */
+  double
+  IntegrateRay(const PointType & point, const DirectionType & direction, const double threshold) const;
+
+  /** Computes the DRR on the buffered region of the 3D detector image. The ray
+   * of each detector pixel goes from the pixel, mapped by the transform, to the
+   * focal point, mapped by the transform. Casting is multi-threaded, tile by
+   * tile. The values are clamped to the range of the detector pixel type.
+   *
+   * When the transform is an AdvancedCombinationTransform that composes a
+   * linear current transform with an initial transform, only the initial
+   * transform is the non-rigid part. When the transform is linear as a whole,
+   * there is no non-rigid part. The cached pixel positions are recomputed only
+   * when the detector geometry, the focal point or the non-rigid part changes.
+   */
+  template <class TDetectorImage>
+  void
+  GenerateProjection(const TransformType * transform,
+                     const PointType &     focalPoint,
+                     const double          threshold,
+                     TDetectorImage *      detector);
+
+protected:
+  RayCastProjector();
+  ~RayCastProjector() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  RayCastProjector(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** Computes the geometry of the volume, if the volume is modified since it
+   * was last computed. Thread safe.
+   */
+  void
+  UpdateGeometry(void) const;
+
+  /** Splits the transform in a linear part, which is applied last, and the
+   * non-rigid part, which is applied first. Either part may be null.
+   */
+  static void
+  SplitTransform(const TransformType *  transform,
+                 const TransformType *& linearPart,
+                 const TransformType *& nonRigidPart);
+
+  /** Returns the largest MTime of the transform and, for a combination
+   * transform, of its current and initial transforms, recursively.
+   */
+  static ModifiedTimeType
+  GetTransformChainMTime(const TransformType * transform);
+
+  typename InputImageType::ConstPointer m_Volume;
+  MultiThreaderBase::Pointer            m_Threader;
+  unsigned int                          m_TileSize;
+
+  /** The geometry of the volume: its size in voxels, the distance in pixels
+   * between neighbouring voxels, the voxel spacing, the eight corners and the
+   * planes of the six faces in mm, and the MTime of the volume when it was
+   * computed.
+   */
+  mutable int                           m_Size[3];
+  mutable OffsetValueType               m_Strides[3];
+  mutable double                        m_Spacing[3];
+  mutable double                        m_Corners[8][3];
+  mutable double                        m_Planes[6][4];
+  mutable std::atomic<ModifiedTimeType> m_GeometryMTime;
+  mutable std::mutex                    m_GeometryMutex;
+
+  /** The detector pixel positions and the focal point, mapped by the non-rigid
+   * part of the transform, and what they were computed for.
+   */
+  std::vector<PointType> m_RayPoints;
+  PointType              m_RayFocalPoint;
+  std::vector<double>    m_RayGeometryKey;
+  const TransformType *  m_RayNonRigidTransform;
+  ModifiedTimeType       m_RayNonRigidTransformMTime;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkRayCastProjector.hxx"
+#endif
+
+#endif // end #ifndef itkRayCastProjector_h
@@ -0,0 +1,599 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRayCastProjector_hxx
+#define itkRayCastProjector_hxx
+
+#include "itkRayCastProjector.h"
+#include "itkAdvancedCombinationTransform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+namespace itk
+{
+
+/**
+ * ************* Constructor *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+RayCastProjector<TInputImage, TCoordRep>::RayCastProjector()
+  : m_GeometryMTime(0)
+{
+  this->m_Threader = MultiThreaderBase::New();
+  this->m_TileSize = 16;
+  this->m_RayFocalPoint.Fill(0.0);
+  this->m_RayNonRigidTransform = nullptr;
+  this->m_RayNonRigidTransformMTime = 0;
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    this->m_Size[i] = 0;
+    this->m_Strides[i] = 0;
+    this->m_Spacing[i] = 0.0;
+  }
+  std::fill_n(&this->m_Corners[0][0], 8 * 3, 0.0);
+  std::fill_n(&this->m_Planes[0][0], 6 * 4, 0.0);
+
+} // end Constructor
+
+
+/**
+ * ************* SetVolume *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+void
+RayCastProjector<TInputImage, TCoordRep>::SetVolume(const InputImageType * volume)
+{
+  if (ImageDimension != 3)
+  {
+    itkExceptionMacro(<< "The RayCastProjector only supports 3D volumes.");
+  }
+
+  if (this->m_Volume != volume)
+  {
+    this->m_Volume = volume;
+    this->m_GeometryMTime = 0;
+    this->Modified();
+  }
+
+} // end SetVolume()
+
+
+/**
+ * ************* UpdateGeometry *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+void
+RayCastProjector<TInputImage, TCoordRep>::UpdateGeometry(void) const
+{
+  /** The geometry only changes when the volume is modified. The MTime is compared
+   * once more under the lock, so that only one thread computes the geometry.
+   */
+  const ModifiedTimeType volumeMTime = this->m_Volume->GetMTime();
+  if (this->m_GeometryMTime.load(std::memory_order_acquire) == volumeMTime)
+  {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(this->m_GeometryMutex);
+  if (this->m_GeometryMTime.load(std::memory_order_relaxed) == volumeMTime)
+  {
+    return;
+  }
+
+  const typename InputImageType::SizeType size = this->m_Volume->GetBufferedRegion().GetSize();
+  const OffsetValueType *                 offsetTable = this->m_Volume->GetOffsetTable();
+  double                                  extent[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    this->m_Size[i] = static_cast<int>(size[i]);
+    this->m_Strides[i] = offsetTable[i];
+    this->m_Spacing[i] = this->m_Volume->GetSpacing()[i];
+    extent[i] = this->m_Spacing[i] * static_cast<double>(size[i]);
+  }
+
+  /** The corners of the volume, with the volume at the origin. Corner k is at the
+   * maximum x for k >= 4, at the maximum y for odd k, and at the maximum z for k
+   * in { 0, 1, 4, 5 }.
+   */
+  for (unsigned int k = 0; k < 8; ++k)
+  {
+    this->m_Corners[k][0] = k >= 4 ? extent[0] : 0.0;
+    this->m_Corners[k][1] = k % 2 == 1 ? extent[1] : 0.0;
+    this->m_Corners[k][2] = (k % 4) < 2 ? extent[2] : 0.0;
+  }
+
+  /** The normalized planes of the faces, each through three of its corners. */
+  static const unsigned int planeCorners[6][3] = { { 1, 2, 3 }, { 4, 5, 6 }, { 5, 3, 7 },
+                                                   { 2, 4, 6 }, { 1, 5, 0 }, { 3, 7, 2 } };
+  for (unsigned int face = 0; face < 6; ++face)
+  {
+    const double * corner1 = this->m_Corners[planeCorners[face][0]];
+    const double * corner2 = this->m_Corners[planeCorners[face][1]];
+    const double * corner3 = this->m_Corners[planeCorners[face][2]];
+
+    double line1[3];
+    double line2[3];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      line1[i] = corner1[i] - corner2[i];
+      line2[i] = corner1[i] - corner3[i];
+    }
+
+    const double a = line1[1] * line2[2] - line2[1] * line1[2];
+    const double b = line2[0] * line1[2] - line1[0] * line2[2];
+    const double c = line1[0] * line2[1] - line2[0] * line1[1];
+    const double d = -(a * corner1[0] + b * corner1[1] + c * corner1[2]);
+    const double norm = std::sqrt(a * a + b * b + c * c);
+
+    /** An empty volume has no faces, and no ray intersects it. */
+    double * plane = this->m_Planes[face];
+    plane[0] = norm > 0.0 ? a / norm : 0.0;
+    plane[1] = norm > 0.0 ? b / norm : 0.0;
+    plane[2] = norm > 0.0 ? c / norm : 0.0;
+    plane[3] = norm > 0.0 ? d / norm : 0.0;
+  }
+  this->m_GeometryMTime.store(volumeMTime, std::memory_order_release);
+
+} // end UpdateGeometry()
+
+
+/**
+ * ************* IntegrateRay *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+double
+RayCastProjector<TInputImage, TCoordRep>::IntegrateRay(const PointType &     point,
+                                                       const DirectionType & direction,
+                                                       const double          threshold) const
+{
+  if (this->m_Volume.IsNull())
+  {
+    return 0.0;
+  }
+  this->UpdateGeometry();
+
+  /** The volume is centred at the origin, so its corner is at minus half its extent. */
+  double position[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    position[i] = point[i] + 0.5 * this->m_Spacing[i] * static_cast<double>(this->m_Size[i]);
+  }
+
+  /** Intersect the line with the plane of each face, and keep the intersections that
+   * lie on the face: those for which the cross products of the vectors to consecutive
+   * corners of the face do not change sign. As always, planes almost parallel to the
+   * line are skipped, and the cross products are truncated to multiples of 100, so
+   * that rounding errors around zero do not reject intersections on an edge.
+   */
+  static const unsigned int faceCorners[6][4] = { { 0, 1, 3, 2 }, { 4, 5, 7, 6 }, { 1, 5, 7, 3 },
+                                                  { 0, 2, 6, 4 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 } };
+  double       intersections[6][3];
+  unsigned int numberOfIntersections = 0;
+  for (unsigned int face = 0; face < 6; ++face)
+  {
+    const double * plane = this->m_Planes[face];
+    const double   denominator = plane[0] * direction[0] + plane[1] * direction[1] + plane[2] * direction[2];
+    if (static_cast<long>(denominator * 100) == 0)
+    {
+      continue;
+    }
+
+    const double distance =
+      -(plane[3] + plane[0] * position[0] + plane[1] * position[1] + plane[2] * position[2]) / denominator;
+    double cornerVectors[4][3];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const double intersection = position[i] + distance * direction[i];
+      intersections[numberOfIntersections][i] = intersection;
+      for (unsigned int k = 0; k < 4; ++k)
+      {
+        cornerVectors[k][i] = this->m_Corners[faceCorners[face][k]][i] - intersection;
+      }
+    }
+
+    int cross[4][3];
+    for (unsigned int k = 0; k < 4; ++k)
+    {
+      const double * u = cornerVectors[k];
+      const double * v = cornerVectors[(k + 1) % 4];
+      cross[k][0] = static_cast<int>((u[1] * v[2] - u[2] * v[1]) / 100);
+      cross[k][1] = static_cast<int>((u[2] * v[0] - u[0] * v[2]) / 100);
+      cross[k][2] = static_cast<int>((u[0] * v[1] - u[1] * v[0]) / 100);
+    }
+
+    bool isOnFace = true;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const bool allNonPositive = cross[0][i] <= 0 && cross[1][i] <= 0 && cross[2][i] <= 0 && cross[3][i] <= 0;
+      const bool allNonNegative = cross[0][i] >= 0 && cross[1][i] >= 0 && cross[2][i] >= 0 && cross[3][i] >= 0;
+      isOnFace = isOnFace && (allNonPositive || allNonNegative);
+    }
+    if (isOnFace)
+    {
+      ++numberOfIntersections;
+    }
+  }
+  if (numberOfIntersections < 2)
+  {
+    return 0.0;
+  }
+
+  /** A ray through an edge or a corner may be found on more than two faces. The two
+   * intersections that are farthest apart are then its end points.
+   */
+  unsigned int first = 0;
+  unsigned int second = 1;
+  double       maximumSquaredDistance = 0.0;
+  for (unsigned int j = 0; numberOfIntersections > 2 && j + 1 < numberOfIntersections; ++j)
+  {
+    for (unsigned int k = j + 1; k < numberOfIntersections; ++k)
+    {
+      double squaredDistance = 0.0;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        squaredDistance += (intersections[j][i] - intersections[k][i]) * (intersections[j][i] - intersections[k][i]);
+      }
+      if (squaredDistance > maximumSquaredDistance)
+      {
+        maximumSquaredDistance = squaredDistance;
+        first = j;
+        second = k;
+      }
+    }
+  }
+
+  /** The end points, in voxels. */
+  double start[3];
+  double end[3];
+  double numberOfVoxels[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    start[i] = intersections[first][i] / this->m_Spacing[i];
+    end[i] = intersections[second][i] / this->m_Spacing[i];
+    numberOfVoxels[i] = std::fabs(start[i] - end[i]);
+  }
+
+  /** Step along the axis a that crosses the most voxel planes, from the centre of
+   * one plane to the next. The other two axes, b and c, are shifted by half a voxel,
+   * so that casting their coordinates to int gives the first of the two voxels that
+   * are interpolated.
+   */
+  const unsigned int a = (numberOfVoxels[0] >= numberOfVoxels[1] && numberOfVoxels[0] >= numberOfVoxels[2])
+                           ? 0
+                           : ((numberOfVoxels[1] >= numberOfVoxels[2]) ? 1 : 2);
+  const unsigned int b = a == 0 ? 1 : 0;
+  const unsigned int c = a == 2 ? 1 : 2;
+  if (!(numberOfVoxels[a] > 0.0))
+  {
+    return 0.0;
+  }
+
+  double increment[3];
+  increment[a] = start[a] < end[a] ? 1.0 : -1.0;
+  for (const unsigned int i : { b, c })
+  {
+    increment[i] = increment[a] * (start[i] - end[i]) / (start[a] - end[a]);
+    start[i] += (static_cast<int>(start[a]) - start[a]) * increment[i] * increment[a] + 0.5 * increment[i] - 0.5;
+  }
+  start[a] = static_cast<int>(start[a]) + 0.5 * increment[a];
+  int numberOfPlanes = static_cast<int>(numberOfVoxels[a]);
+
+  /** Shorten the ray until the interpolated voxels of its first and last point
+   * lie inside the volume.
+   */
+  const auto isInside = [this, a](const double * voxel) {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const int index = static_cast<int>(std::floor(voxel[i]));
+      if (index < 0 || index + (i == a ? 0 : 1) >= this->m_Size[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  bool startIsInside = false;
+  bool endIsInside = false;
+  do
+  {
+    startIsInside = isInside(start);
+    if (!startIsInside)
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        start[i] += increment[i];
+      }
+      --numberOfPlanes;
+    }
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      end[i] = start[i] + numberOfPlanes * increment[i];
+    }
+    endIsInside = isInside(end);
+    if (!endIsInside)
+    {
+      --numberOfPlanes;
+    }
+  } while (!(startIsInside && endIsInside) && numberOfPlanes > 1);
+
+  if (!(startIsInside && endIsInside))
+  {
+    return 0.0;
+  }
+
+  /** Traverse the ray, and interpolate bilinearly in each plane of voxels. */
+  const PixelType *     buffer = this->m_Volume->GetBufferPointer();
+  const OffsetValueType strideB = this->m_Strides[b];
+  const OffsetValueType strideC = this->m_Strides[c];
+  double                integral = 0.0;
+  for (int plane = 0; plane < numberOfPlanes; ++plane)
+  {
+    const int indexA = static_cast<int>(start[a]);
+    const int indexB = static_cast<int>(start[b]);
+    const int indexC = static_cast<int>(start[c]);
+
+    const PixelType * voxel = buffer + indexA * this->m_Strides[a] + indexB * strideB + indexC * strideC;
+    const double      value = static_cast<double>(voxel[0]);
+    const double      differenceB = static_cast<double>(voxel[strideB]) - value;
+    const double      differenceC = static_cast<double>(voxel[strideC]) - value;
+    const double      differenceBC =
+      static_cast<double>(voxel[strideB + strideC]) - value - differenceB - differenceC;
+
+    const double fractionB = start[b] - indexB;
+    const double fractionC = start[c] - indexC;
+    const double intensity =
+      value + differenceB * fractionB + differenceC * fractionC + differenceBC * fractionB * fractionC;
+    if (intensity > threshold)
+    {
+      integral += intensity - threshold;
+    }
+
+    start[0] += increment[0];
+    start[1] += increment[1];
+    start[2] += increment[2];
+  }
+
+  /** Scale by the distance in mm between consecutive points on the ray. */
+  double squaredStepLength = 0.0;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    squaredStepLength += increment[i] * this->m_Spacing[i] * increment[i] * this->m_Spacing[i];
+  }
+  return integral * std::sqrt(squaredStepLength);
+
+} // end IntegrateRay()
+
+
+/**
+ * ************* GenerateProjection *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+template <class TDetectorImage>
+void
+RayCastProjector<TInputImage, TCoordRep>::GenerateProjection(const TransformType * transform,
+                                                             const PointType &     focalPoint,
+                                                             const double          threshold,
+                                                             TDetectorImage *      detector)
+{
+  typedef typename TDetectorImage::PixelType DetectorPixelType;
+
+  if (this->m_Volume.IsNull() || transform == nullptr || detector == nullptr)
+  {
+    itkExceptionMacro(<< "A volume, a transform and a detector image are required.");
+  }
+  if (TDetectorImage::ImageDimension != 3)
+  {
+    itkExceptionMacro(<< "The RayCastProjector only supports 3D detector images.");
+  }
+  this->UpdateGeometry();
+
+  const typename TDetectorImage::RegionType region = detector->GetBufferedRegion();
+  const SizeValueType                       sizeX = region.GetSize(0);
+  const SizeValueType                       sizeY = region.GetSize(1);
+  const SizeValueType                       sizeZ = region.GetSize(2);
+
+  /** The rays only depend on the detector geometry, the focal point and the transform. */
+  std::vector<double> geometryKey;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    geometryKey.push_back(static_cast<double>(region.GetIndex(i)));
+    geometryKey.push_back(static_cast<double>(region.GetSize(i)));
+    geometryKey.push_back(detector->GetOrigin()[i]);
+    geometryKey.push_back(detector->GetSpacing()[i]);
+    geometryKey.push_back(focalPoint[i]);
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      geometryKey.push_back(detector->GetDirection()[i][j]);
+    }
+  }
+
+  /** Map the detector pixels and the focal point by the non-rigid part of the
+   * transform, only when that part, or the detector geometry, has changed.
+   */
+  const TransformType * linearPart = nullptr;
+  const TransformType * nonRigidPart = nullptr;
+  Self::SplitTransform(transform, linearPart, nonRigidPart);
+  const ModifiedTimeType nonRigidMTime = Self::GetTransformChainMTime(nonRigidPart);
+
+  if (geometryKey != this->m_RayGeometryKey || nonRigidPart != this->m_RayNonRigidTransform ||
+      nonRigidMTime != this->m_RayNonRigidTransformMTime)
+  {
+    this->m_RayPoints.resize(region.GetNumberOfPixels());
+
+    const auto mapPointsOfLine = [&, this](const SizeValueType line) {
+      typename TDetectorImage::IndexType index = region.GetIndex();
+      index[1] += static_cast<IndexValueType>(line % sizeY);
+      index[2] += static_cast<IndexValueType>(line / sizeY);
+
+      SizeValueType pixel = line * sizeX;
+      for (SizeValueType x = 0; x < sizeX; ++x, ++pixel)
+      {
+        typename TDetectorImage::PointType detectorPoint;
+        detector->TransformIndexToPhysicalPoint(index, detectorPoint);
+        ++index[0];
+
+        PointType rayPoint;
+        rayPoint.CastFrom(detectorPoint);
+        this->m_RayPoints[pixel] = nonRigidPart != nullptr ? nonRigidPart->TransformPoint(rayPoint) : rayPoint;
+      }
+    };
+    this->m_Threader->ParallelizeArray(0, sizeY * sizeZ, mapPointsOfLine, nullptr);
+
+    this->m_RayFocalPoint = nonRigidPart != nullptr ? nonRigidPart->TransformPoint(focalPoint) : focalPoint;
+    this->m_RayGeometryKey = geometryKey;
+    this->m_RayNonRigidTransform = nonRigidPart;
+    this->m_RayNonRigidTransformMTime = nonRigidMTime;
+  }
+
+  /** Only the linear, for example rigid, part of the transform is applied per projection. */
+  const PointType mappedFocalPoint =
+    linearPart != nullptr ? linearPart->TransformPoint(this->m_RayFocalPoint) : this->m_RayFocalPoint;
+  const double        minimumValue = NumericTraits<DetectorPixelType>::NonpositiveMin();
+  const double        maximumValue = NumericTraits<DetectorPixelType>::max();
+  DetectorPixelType * output = detector->GetBufferPointer();
+
+  /** Divide the detector into tiles, and cast the rays of each tile on one thread. */
+  const SizeValueType tileSize = this->m_TileSize;
+  const SizeValueType tilesX = (sizeX + tileSize - 1) / tileSize;
+  const SizeValueType tilesY = (sizeY + tileSize - 1) / tileSize;
+
+  const auto castRaysOfTile = [&, this](const SizeValueType tile) {
+    const SizeValueType z = tile / (tilesX * tilesY);
+    const SizeValueType y0 = ((tile / tilesX) % tilesY) * tileSize;
+    const SizeValueType x0 = (tile % tilesX) * tileSize;
+    const SizeValueType y1 = std::min(y0 + tileSize, sizeY);
+    const SizeValueType x1 = std::min(x0 + tileSize, sizeX);
+
+    for (SizeValueType y = y0; y < y1; ++y)
+    {
+      SizeValueType pixel = (z * sizeY + y) * sizeX + x0;
+      for (SizeValueType x = x0; x < x1; ++x, ++pixel)
+      {
+        const PointType rayPoint =
+          linearPart != nullptr ? linearPart->TransformPoint(this->m_RayPoints[pixel]) : this->m_RayPoints[pixel];
+        const double value = this->IntegrateRay(rayPoint, mappedFocalPoint - rayPoint, threshold);
+        output[pixel] = static_cast<DetectorPixelType>(std::max(minimumValue, std::min(value, maximumValue)));
+      }
+    }
+  };
+  this->m_Threader->ParallelizeArray(0, tilesX * tilesY * sizeZ, castRaysOfTile, nullptr);
+
+} // end GenerateProjection()
+
+
+/**
+ * ************* SplitTransform *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+void
+RayCastProjector<TInputImage, TCoordRep>::SplitTransform(const TransformType *  transform,
+                                                         const TransformType *& linearPart,
+                                                         const TransformType *& nonRigidPart)
+{
+  typedef AdvancedCombinationTransform<TCoordRep, ImageDimension> CombinationTransformType;
+
+  linearPart = nullptr;
+  nonRigidPart = transform;
+  if (transform == nullptr)
+  {
+    return;
+  }
+
+  if (transform->IsLinear())
+  {
+    linearPart = transform;
+    nonRigidPart = nullptr;
+    return;
+  }
+
+  /** A composition T(x) = T1(T0(x)) with a linear T1, as in 2D/3D registration. */
+  const auto * combinationTransform = dynamic_cast<const CombinationTransformType *>(transform);
+  if (combinationTransform != nullptr && combinationTransform->GetUseComposition() &&
+      combinationTransform->GetInitialTransform() != nullptr &&
+      combinationTransform->GetCurrentTransform() != nullptr &&
+      combinationTransform->GetCurrentTransform()->IsLinear())
+  {
+    linearPart = combinationTransform->GetCurrentTransform();
+    nonRigidPart = combinationTransform->GetInitialTransform();
+  }
+
+} // end SplitTransform()
+
+
+/**
+ * ************* GetTransformChainMTime *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+ModifiedTimeType
+RayCastProjector<TInputImage, TCoordRep>::GetTransformChainMTime(const TransformType * transform)
+{
+  typedef AdvancedCombinationTransform<TCoordRep, ImageDimension> CombinationTransformType;
+
+  if (transform == nullptr)
+  {
+    return 0;
+  }
+
+  /** SetParameters() of the current transform of a combination transform does
+   * not modify the combination itself, and neither does modifying its initial
+   * transform. So walk the whole chain.
+   */
+  ModifiedTimeType mtime = transform->GetMTime();
+  const auto *     combinationTransform = dynamic_cast<const CombinationTransformType *>(transform);
+  if (combinationTransform != nullptr)
+  {
+    mtime = std::max(mtime, Self::GetTransformChainMTime(combinationTransform->GetCurrentTransform()));
+    mtime = std::max(mtime, Self::GetTransformChainMTime(combinationTransform->GetInitialTransform()));
+  }
+  return mtime;
+
+} // end GetTransformChainMTime()
+
+
+/**
+ * ************* PrintSelf *******************
+ */
+
+template <class TInputImage, class TCoordRep>
+void
+RayCastProjector<TInputImage, TCoordRep>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Volume: " << this->m_Volume.GetPointer() << std::endl;
+  os << indent << "GeometryMTime: " << this->m_GeometryMTime.load() << std::endl;
+  os << indent << "TileSize: " << this->m_TileSize << std::endl;
+  os << indent << "NumberOfCachedRayPoints: " << this->m_RayPoints.size() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkRayCastProjector_hxx
@@ -0,0 +1,90 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRayCastResampleImageFilter_h
+#define itkRayCastResampleImageFilter_h
+
+#include "itkResampleImageFilter.h"
+#include "itkAdvancedRayCastInterpolateImageFunction.h"
+
+namespace itk
+{
+/**
+ * \class RayCastResampleImageFilter
+ *
+ * \brief A ResampleImageFilter that computes digitally reconstructed
+ * radiographs (DRRs) a whole projection at a time.
+ *
+ * When the interpolator is an AdvancedRayCastInterpolateImageFunction that
+ * uses the same transform as this filter, GenerateData() does not evaluate the
+ * interpolator for every output pixel, but lets its RayCastProjector cast the
+ * rays of the whole output image, tile by tile, multi-threaded. The output is
+ * the same. With any other interpolator, this filter is a ResampleImageFilter.
+ *
+ * \sa RayCastProjector
+ * \ingroup GeometricTransform
+ * \ingroup MultiThreaded
+ */
+
+template <class TInputImage, class TOutputImage, class TInterpolatorPrecisionType = double>
+class ITK_TEMPLATE_EXPORT RayCastResampleImageFilter
+  : public ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType>
+{
+public:
+  /** Standard ITK stuff. */
+  typedef RayCastResampleImageFilter                                                 Self;
+  typedef ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType> Superclass;
+  typedef SmartPointer<Self>                                                         Pointer;
+  typedef SmartPointer<const Self>                                                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RayCastResampleImageFilter, ResampleImageFilter);
+
+  /** Typedefs. */
+  using typename Superclass::InputImageType;
+  using typename Superclass::OutputImageType;
+  typedef AdvancedRayCastInterpolateImageFunction<InputImageType, TInterpolatorPrecisionType> RayCastInterpolatorType;
+
+protected:
+  /** Constructor. */
+  RayCastResampleImageFilter() = default;
+
+  /** Destructor. */
+  ~RayCastResampleImageFilter() override = default;
+
+  /** Computes the whole projection through the ray cast interpolator, if
+   * possible. Otherwise calls the superclass implementation.
+   */
+  void
+  GenerateData(void) override;
+
+private:
+  RayCastResampleImageFilter(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkRayCastResampleImageFilter.hxx"
+#endif
+
+#endif // end #ifndef itkRayCastResampleImageFilter_h
@@ -0,0 +1,59 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRayCastResampleImageFilter_hxx
+#define itkRayCastResampleImageFilter_hxx
+
+#include "itkRayCastResampleImageFilter.h"
+
+namespace itk
+{
+
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template <class TInputImage, class TOutputImage, class TInterpolatorPrecisionType>
+void
+RayCastResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType>::GenerateData(void)
+{
+  /** The projection maps the output pixels by the transform of the interpolator,
+   * so that transform must be the one of this filter.
+   */
+  auto * rayCaster = dynamic_cast<RayCastInterpolatorType *>(this->GetModifiableInterpolator());
+  if (OutputImageType::ImageDimension != 3 || rayCaster == nullptr || rayCaster->GetTransform() == nullptr ||
+      static_cast<const Object *>(rayCaster->GetTransform()) != static_cast<const Object *>(this->GetTransform()))
+  {
+    this->Superclass::GenerateData();
+    return;
+  }
+
+  /** The same steps as ImageSource::GenerateData(). BeforeThreadedGenerateData()
+   * connects the input image to the interpolator, and AfterThreadedGenerateData()
+   * disconnects it.
+   */
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+  rayCaster->GenerateProjection(this->GetOutput());
+  this->AfterThreadedGenerateData();
+
+} // end GenerateData()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkRayCastResampleImageFilter_hxx
@@ -94,6 +94,7 @@ ScaledSingleValuedNonLinearOptimizer::GetUseScales(void) const
 ScaledSingleValuedNonLinearOptimizer::MeasureType
 ScaledSingleValuedNonLinearOptimizer::GetScaledValue(const ParametersType & parameters) const
 {
+  const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.CostFunctionEvaluation");
   return this->m_ScaledCostFunction->GetValue(parameters);
 
 } // end GetScaledValue()
@@ -107,6 +108,7 @@ void
 ScaledSingleValuedNonLinearOptimizer::GetScaledDerivative(const ParametersType & parameters,
                                                           DerivativeType &       derivative) const
 {
+  const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.CostFunctionEvaluation");
   this->m_ScaledCostFunction->GetDerivative(parameters, derivative);
 
 } // end GetScaledDerivative()
@@ -121,6 +123,7 @@ ScaledSingleValuedNonLinearOptimizer::GetScaledValueAndDerivative(const Paramete
                                                                   MeasureType &          value,
                                                                   DerivativeType &       derivative) const
 {
+  const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.CostFunctionEvaluation");
   this->m_ScaledCostFunction->GetValueAndDerivative(parameters, value, derivative);
 
 } // end GetScaledValueAndDerivative()
@@ -20,6 +20,7 @@
 
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itkScaledSingleValuedCostFunction.h"
+#include "itkPerformanceTelemetry.h"
 
 namespace itk
 {
@@ -129,6 +130,12 @@ public:
 
   itkGetConstMacro(Maximize, bool);
 
+  /** Set/Get the telemetry object in which the optimizer records the time
+   * spent in evaluations of the cost function. Default: null, no recording.
+   */
+  itkSetObjectMacro(PerformanceTelemetry, PerformanceTelemetry);
+  itkGetModifiableObjectMacro(PerformanceTelemetry, PerformanceTelemetry);
+
 protected:
   /** The constructor. */
   ScaledSingleValuedNonLinearOptimizer();
@@ -143,6 +150,9 @@ protected:
   ParametersType            m_ScaledCurrentPosition;
   ScaledCostFunctionPointer m_ScaledCostFunction;
 
+  /** The telemetry object, may be null. */
+  PerformanceTelemetry::Pointer m_PerformanceTelemetry;
+
   /** Set m_ScaledCurrentPosition. */
   virtual void
   SetScaledCurrentPosition(const ParametersType & parameters);
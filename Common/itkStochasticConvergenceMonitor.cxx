@@ -0,0 +1,124 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkStochasticConvergenceMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+/**
+ * ****************** Initialize *********************************
+ */
+
+void
+StochasticConvergenceMonitor::Initialize(const unsigned int windowSize, const double significance)
+{
+  this->m_WindowSize = (windowSize == 0) ? 0 : std::max(windowSize, 3u);
+  this->m_Significance = significance;
+  this->m_Values.assign(this->m_WindowSize, 0.0);
+  this->m_NumberOfValues = 0;
+  this->m_HasConverged = false;
+  this->m_DecreasePerIteration = 0.0;
+  this->m_StandardError = 0.0;
+
+} // end Initialize()
+
+
+/**
+ * ****************** AddValue *********************************
+ */
+
+bool
+StochasticConvergenceMonitor::AddValue(const double value)
+{
+  const SizeValueType windowSize = this->m_WindowSize;
+  if (windowSize == 0)
+  {
+    return false;
+  }
+
+  this->m_Values[this->m_NumberOfValues % windowSize] = value;
+  ++this->m_NumberOfValues;
+  if (this->m_NumberOfValues < windowSize)
+  {
+    return false;
+  }
+
+  /** The values in chronological order are at oldest, oldest + 1, ... in the ring buffer.
+   * The iteration numbers x = 0, ..., n - 1 have mean (n - 1) / 2, and their sum of squared
+   * deviations from the mean is n (n^2 - 1) / 12.
+   */
+  const SizeValueType oldest = this->m_NumberOfValues % windowSize;
+  const double        n = static_cast<double>(windowSize);
+  const double        meanX = 0.5 * (n - 1.0);
+  const double        sxx = n * (n * n - 1.0) / 12.0;
+
+  double sumY = 0.0;
+  for (const double y : this->m_Values)
+  {
+    sumY += y;
+  }
+  const double meanY = sumY / n;
+
+  double sxy = 0.0;
+  for (SizeValueType i = 0; i < windowSize; ++i)
+  {
+    sxy += (static_cast<double>(i) - meanX) * (this->m_Values[(oldest + i) % windowSize] - meanY);
+  }
+  const double slope = sxy / sxx;
+
+  /** The residual variance has n - 2 degrees of freedom: the line has two parameters. */
+  double sumOfSquaredResiduals = 0.0;
+  for (SizeValueType i = 0; i < windowSize; ++i)
+  {
+    const double residual =
+      (this->m_Values[(oldest + i) % windowSize] - meanY) - slope * (static_cast<double>(i) - meanX);
+    sumOfSquaredResiduals += residual * residual;
+  }
+  const double residualVariance = sumOfSquaredResiduals / (n - 2.0);
+
+  this->m_DecreasePerIteration = -slope;
+  this->m_StandardError = std::sqrt(residualVariance / sxx);
+  this->m_HasConverged = this->m_DecreasePerIteration <= this->m_Significance * this->m_StandardError;
+  return this->m_HasConverged;
+
+} // end AddValue()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+StochasticConvergenceMonitor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "WindowSize: " << this->m_WindowSize << std::endl;
+  os << indent << "Significance: " << this->m_Significance << std::endl;
+  os << indent << "NumberOfValues: " << this->m_NumberOfValues << std::endl;
+  os << indent << "HasConverged: " << this->m_HasConverged << std::endl;
+  os << indent << "DecreasePerIteration: " << this->m_DecreasePerIteration << std::endl;
+  os << indent << "StandardError: " << this->m_StandardError << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
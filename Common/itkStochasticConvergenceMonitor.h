@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkStochasticConvergenceMonitor_h
+#define itkStochasticConvergenceMonitor_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class StochasticConvergenceMonitor
+ * \brief Detects when a noisy sequence of metric values stops decreasing.
+ *
+ * A stochastic optimizer evaluates the metric on a new random subset of
+ * samples in each iteration, so consecutive metric values differ by noise,
+ * and a tolerance on the change of the value would either never be met, or be
+ * met by chance. This class instead fits a straight line, by least squares,
+ * through the last WindowSize values that are passed to AddValue(). The slope
+ * of that line estimates the decrease per iteration, and the scatter of the
+ * values around the line gives its standard error. Progress is considered
+ * insignificant, and the sequence converged, when the estimated decrease is
+ * less than Significance times its standard error. That includes the case of
+ * an increasing trend.
+ *
+ * The check is only done once the window is full, so that it never stops a
+ * resolution within its first WindowSize iterations. A window size of zero
+ * disables the check; other window sizes are at least three, because two
+ * values leave no degree of freedom to estimate the noise.
+ *
+ * \ingroup Common
+ */
+
+class StochasticConvergenceMonitor : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef StochasticConvergenceMonitor Self;
+  typedef Object                       Superclass;
+  typedef SmartPointer<Self>           Pointer;
+  typedef SmartPointer<const Self>     ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(StochasticConvergenceMonitor, Object);
+
+  /** Sets the window size and the significance, and forgets all values that
+   * were added before. Call this at the start of each resolution.
+   */
+  void
+  Initialize(unsigned int windowSize, double significance);
+
+  /** Adds the metric value of the current iteration, and returns whether the
+   * sequence has converged.
+   */
+  bool
+  AddValue(double value);
+
+  /** The number of values that the regression is fitted to, or zero when the check is disabled. */
+  itkGetConstMacro(WindowSize, unsigned int);
+
+  /** The number of standard errors by which the value has to decrease. */
+  itkGetConstMacro(Significance, double);
+
+  /** Whether the last call to AddValue() detected convergence. */
+  itkGetConstMacro(HasConverged, bool);
+
+  /** The decrease per iteration and its standard error, estimated from the
+   * last full window. Both are zero until the window is full.
+   */
+  itkGetConstMacro(DecreasePerIteration, double);
+  itkGetConstMacro(StandardError, double);
+
+protected:
+  StochasticConvergenceMonitor() = default;
+  ~StochasticConvergenceMonitor() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  StochasticConvergenceMonitor(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** The last WindowSize values, as a ring buffer. */
+  std::vector<double> m_Values;
+  SizeValueType       m_NumberOfValues{ 0 };
+
+  unsigned int m_WindowSize{ 0 };
+  double       m_Significance{ 2.0 };
+  bool         m_HasConverged{ false };
+  double       m_DecreasePerIteration{ 0.0 };
+  double       m_StandardError{ 0.0 };
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkStochasticConvergenceMonitor_h
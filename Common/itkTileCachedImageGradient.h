@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTileCachedImageGradient_h
+#define itkTileCachedImageGradient_h
+
+#include "itkObject.h"
+#include "itkCovariantVector.h"
+#include "itkImage.h"
+
+#include <atomic>
+#include <memory>
+
+namespace itk
+{
+/**
+ * \class TileCachedImageGradient
+ *
+ * \brief Lazy, thread-safe central difference gradients of an image.
+ *
+ * This class computes the same gradient as a GradientImageFilter with
+ * UseImageSpacing and UseImageDirection on, and a zero flux Neumann boundary,
+ * but without producing the full gradient image. The buffered region of the
+ * image is divided in tiles of 8^ImageDimension voxels. The gradients of a
+ * tile are computed the first time one of its voxels is asked for, and are
+ * stored as float. Tiles that are never touched by a sample never cost any
+ * memory.
+ *
+ * SetImage() releases the tiles when the image or its modified time changed.
+ * Evaluate() is thread-safe: when two threads compute the same tile at once,
+ * one of the two results is kept.
+ */
+
+template <class TImage, class TCoordRep = double>
+class ITK_TEMPLATE_EXPORT TileCachedImageGradient : public Object
+{
+public:
+  /** Standard ITK stuff. */
+  typedef TileCachedImageGradient  Self;
+  typedef Object                   Superclass;
+  typedef SmartPointer<Self>       Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TileCachedImageGradient, Object);
+
+  /** The dimension of the image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  /** Typedefs. */
+  typedef TImage                                     ImageType;
+  typedef typename ImageType::IndexType              IndexType;
+  typedef CovariantVector<TCoordRep, ImageDimension> CovariantVectorType;
+
+  /** Set the image. The cached tiles are released when the image changed. */
+  void
+  SetImage(const ImageType * image);
+
+  /** Get the image. */
+  itkGetConstObjectMacro(Image, ImageType);
+
+  /** Returns the gradient at the given index. Indices outside the buffered
+   * region are clamped to it. Thread-safe.
+   */
+  inline void
+  Evaluate(const IndexType & index, CovariantVectorType & gradient) const
+  {
+    SizeValueType voxelInTile = 0;
+    SizeValueType tile = 0;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      OffsetValueType position = index[i] - this->m_Start[i];
+      position = position < 0 ? 0 : position;
+      position = position >= this->m_Size[i] ? this->m_Size[i] - 1 : position;
+      voxelInTile += static_cast<SizeValueType>(position & TileMask) << (TileShift * i);
+      tile += static_cast<SizeValueType>(position >> TileShift) * this->m_TileStrides[i];
+    }
+
+    const float * tileGradients = this->m_Tiles[tile].load(std::memory_order_acquire);
+    if (tileGradients == nullptr)
+    {
+      tileGradients = this->ComputeTile(tile);
+    }
+
+    const float * voxelGradient = tileGradients + voxelInTile * ImageDimension;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      gradient[i] = voxelGradient[i];
+    }
+  }
+
+
+  /** Release the memory of all tiles. */
+  void
+  ReleaseTiles(void);
+
+  /** The number of tiles that are currently computed. */
+  SizeValueType
+  GetNumberOfComputedTiles(void) const;
+
+protected:
+  TileCachedImageGradient();
+  ~TileCachedImageGradient() override;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  TileCachedImageGradient(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** A tile has 2^TileShift voxels in each dimension. */
+  itkStaticConstMacro(TileShift, unsigned int, 3);
+  itkStaticConstMacro(TileMask, OffsetValueType, 7);
+
+  /** Compute the gradients of a tile, publish them, and return them. */
+  const float *
+  ComputeTile(const SizeValueType tile) const;
+
+  /** The image, and its modified time. */
+  typename ImageType::ConstPointer m_Image;
+  ModifiedTimeType                 m_ImageMTime;
+
+  /** The geometry of the buffered region, and of the grid of tiles. */
+  OffsetValueType m_Start[ImageDimension];
+  OffsetValueType m_Size[ImageDimension];
+  OffsetValueType m_VoxelStrides[ImageDimension];
+  SizeValueType   m_TileStrides[ImageDimension];
+  SizeValueType   m_NumberOfTiles;
+
+  /** The map from index differences to physical gradients: direction / ( 2 * spacing ). */
+  double m_IndexToPhysical[ImageDimension][ImageDimension];
+
+  /** The gradients of each tile, or nullptr when not computed yet. */
+  std::unique_ptr<std::atomic<float *>[]> m_Tiles;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTileCachedImageGradient.hxx"
+#endif
+
+#endif // end #ifndef itkTileCachedImageGradient_h
@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTileCachedImageGradient_hxx
+#define itkTileCachedImageGradient_hxx
+
+#include "itkTileCachedImageGradient.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+/**
+ * ************* Constructor *******************
+ */
+
+template <class TImage, class TCoordRep>
+TileCachedImageGradient<TImage, TCoordRep>::TileCachedImageGradient()
+{
+  this->m_ImageMTime = 0;
+  this->m_NumberOfTiles = 0;
+
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      this->m_IndexToPhysical[i][j] = 0.0;
+    }
+    this->m_Start[i] = 0;
+    this->m_Size[i] = 0;
+    this->m_VoxelStrides[i] = 0;
+    this->m_TileStrides[i] = 0;
+  }
+
+} // end Constructor
+
+
+/**
+ * ************* Destructor *******************
+ */
+
+template <class TImage, class TCoordRep>
+TileCachedImageGradient<TImage, TCoordRep>::~TileCachedImageGradient()
+{
+  this->ReleaseTiles();
+
+} // end Destructor
+
+
+/**
+ * ************* SetImage *******************
+ */
+
+template <class TImage, class TCoordRep>
+void
+TileCachedImageGradient<TImage, TCoordRep>::SetImage(const ImageType * image)
+{
+  /** Nothing to do when the image did not change. */
+  if (image == this->m_Image.GetPointer() && image != nullptr && image->GetMTime() == this->m_ImageMTime)
+  {
+    return;
+  }
+
+  this->ReleaseTiles();
+  this->m_Tiles.reset();
+  this->m_NumberOfTiles = 0;
+  this->m_Image = image;
+  this->m_ImageMTime = image != nullptr ? image->GetMTime() : 0;
+  this->Modified();
+
+  if (image == nullptr || image->GetBufferedRegion().GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  /** Store the geometry of the buffered region and of the tiles. */
+  const typename ImageType::RegionType region = image->GetBufferedRegion();
+  const OffsetValueType *              offsetTable = image->GetOffsetTable();
+  SizeValueType                        numberOfTiles = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    this->m_Start[i] = region.GetIndex()[i];
+    this->m_Size[i] = static_cast<OffsetValueType>(region.GetSize()[i]);
+    this->m_VoxelStrides[i] = offsetTable[i];
+    this->m_TileStrides[i] = numberOfTiles;
+    numberOfTiles *= static_cast<SizeValueType>((this->m_Size[i] + TileMask) >> TileShift);
+  }
+
+  /** The central difference along index direction j is divided by twice the
+   * spacing, and then rotated to physical space by the direction cosines.
+   */
+  const typename ImageType::SpacingType   spacing = image->GetSpacing();
+  const typename ImageType::DirectionType direction = image->GetDirection();
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      this->m_IndexToPhysical[i][j] = direction[i][j] / (2.0 * spacing[j]);
+    }
+  }
+
+  this->m_NumberOfTiles = numberOfTiles;
+  this->m_Tiles.reset(new std::atomic<float *>[numberOfTiles]);
+  for (SizeValueType tile = 0; tile < numberOfTiles; ++tile)
+  {
+    this->m_Tiles[tile].store(nullptr, std::memory_order_relaxed);
+  }
+
+} // end SetImage()
+
+
+/**
+ * ************* ReleaseTiles *******************
+ */
+
+template <class TImage, class TCoordRep>
+void
+TileCachedImageGradient<TImage, TCoordRep>::ReleaseTiles(void)
+{
+  for (SizeValueType tile = 0; tile < this->m_NumberOfTiles; ++tile)
+  {
+    delete[] this->m_Tiles[tile].exchange(nullptr, std::memory_order_acq_rel);
+  }
+
+} // end ReleaseTiles()
+
+
+/**
+ * ************* GetNumberOfComputedTiles *******************
+ */
+
+template <class TImage, class TCoordRep>
+SizeValueType
+TileCachedImageGradient<TImage, TCoordRep>::GetNumberOfComputedTiles(void) const
+{
+  SizeValueType numberOfComputedTiles = 0;
+  for (SizeValueType tile = 0; tile < this->m_NumberOfTiles; ++tile)
+  {
+    if (this->m_Tiles[tile].load(std::memory_order_acquire) != nullptr)
+    {
+      ++numberOfComputedTiles;
+    }
+  }
+  return numberOfComputedTiles;
+
+} // end GetNumberOfComputedTiles()
+
+
+/**
+ * ************* ComputeTile *******************
+ */
+
+template <class TImage, class TCoordRep>
+const float *
+TileCachedImageGradient<TImage, TCoordRep>::ComputeTile(const SizeValueType tile) const
+{
+  const SizeValueType tileWidth = SizeValueType{ 1 } << TileShift;
+  SizeValueType       voxelsPerTile = 1;
+  OffsetValueType     tileStart[ImageDimension];
+  OffsetValueType     tileSize[ImageDimension];
+  SizeValueType       remainder = tile;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    const SizeValueType tilesAlongDimension = static_cast<SizeValueType>((this->m_Size[i] + TileMask) >> TileShift);
+    tileStart[i] = static_cast<OffsetValueType>((remainder % tilesAlongDimension) << TileShift);
+    tileSize[i] = std::min(static_cast<OffsetValueType>(tileWidth), this->m_Size[i] - tileStart[i]);
+    remainder /= tilesAlongDimension;
+    voxelsPerTile *= tileWidth;
+  }
+
+  /** Voxels of the tile that fall outside the image (at the upper borders) are left zero. */
+  std::unique_ptr<float[]> gradients(new float[voxelsPerTile * ImageDimension]());
+
+  const typename ImageType::PixelType * buffer = this->m_Image->GetBufferPointer();
+  for (SizeValueType voxelInTile = 0; voxelInTile < voxelsPerTile; ++voxelInTile)
+  {
+    /** The position of the voxel in the buffered region, and its offset in the buffer. */
+    OffsetValueType position[ImageDimension];
+    OffsetValueType offset = 0;
+    bool            isInside = true;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      const OffsetValueType positionInTile = static_cast<OffsetValueType>(voxelInTile >> (TileShift * i)) & TileMask;
+      isInside = isInside && positionInTile < tileSize[i];
+      position[i] = tileStart[i] + positionInTile;
+      offset += position[i] * this->m_VoxelStrides[i];
+    }
+    if (!isInside)
+    {
+      continue;
+    }
+
+    /** Central differences, with the neighbours clamped to the buffered region. */
+    double difference[ImageDimension];
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      const OffsetValueType previous = position[j] > 0 ? this->m_VoxelStrides[j] : 0;
+      const OffsetValueType next = position[j] + 1 < this->m_Size[j] ? this->m_VoxelStrides[j] : 0;
+      difference[j] = static_cast<double>(buffer[offset + next]) - static_cast<double>(buffer[offset - previous]);
+    }
+
+    float * gradient = gradients.get() + voxelInTile * ImageDimension;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      double value = 0.0;
+      for (unsigned int j = 0; j < ImageDimension; ++j)
+      {
+        value += this->m_IndexToPhysical[i][j] * difference[j];
+      }
+      gradient[i] = static_cast<float>(value);
+    }
+  }
+
+  /** Publish the tile. When another thread was first, use its tile instead. */
+  float * expected = nullptr;
+  if (this->m_Tiles[tile].compare_exchange_strong(
+        expected, gradients.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+  {
+    return gradients.release();
+  }
+  return expected;
+
+} // end ComputeTile()
+
+
+/**
+ * ************* PrintSelf *******************
+ */
+
+template <class TImage, class TCoordRep>
+void
+TileCachedImageGradient<TImage, TCoordRep>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Image: " << this->m_Image.GetPointer() << std::endl;
+  os << indent << "NumberOfTiles: " << this->m_NumberOfTiles << std::endl;
+  os << indent << "NumberOfComputedTiles: " << this->GetNumberOfComputedTiles() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkTileCachedImageGradient_hxx
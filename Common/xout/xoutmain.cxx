@@ -20,9 +20,21 @@
 
 namespace xoutlibrary
 {
+namespace
+{
+/** The xout of the calling thread, when it does not use the global xout. */
+thread_local xoutmain * threadXout{ nullptr };
+} // namespace
+
+
 xoutmain &
 get_xout(void)
 {
+  if (threadXout != nullptr)
+  {
+    return *threadXout;
+  }
+
   // Note: C++11 "magic statics" ensures that the construction of a local
   // static variable like this is thread-safe.
   static xoutmain local_xout;
@@ -30,4 +42,13 @@ get_xout(void)
   return local_xout;
 }
 
+
+xoutmain *
+set_thread_xout(xoutmain * const newThreadXout)
+{
+  xoutmain * const previousXout = threadXout;
+  threadXout = newThreadXout;
+  return previousXout;
+}
+
 } // namespace xoutlibrary
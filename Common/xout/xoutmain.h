@@ -40,6 +40,13 @@ class xoutmain : public xoutbase
 xoutmain &
 get_xout(void);
 
+/** Makes get_xout() return the specified xout in the calling thread, or the global
+ * xout again when the specified xout is null. Returns the xout that the calling
+ * thread used before, or null when it used the global xout.
+ */
+xoutmain *
+set_thread_xout(xoutmain * newThreadXout);
+
 } // end namespace xoutlibrary
 
 #endif // end #ifndef xoutmain_h
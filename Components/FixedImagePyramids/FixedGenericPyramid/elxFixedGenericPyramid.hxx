@@ -20,6 +20,8 @@
 
 #include "elxFixedGenericPyramid.h"
 
+#include <sstream>
+
 namespace elastix
 {
 
@@ -151,6 +153,13 @@ FixedGenericPyramid<TElastix>::SetFixedSchedule(void)
   this->m_Configuration->ReadParameter(computeThisResolution, "ComputePyramidImagesPerResolution", 0, false);
   this->SetComputeOnlyForCurrentLevel(computeThisResolution);
 
+  /** Decide whether or not to compute the pyramid images as a cascade, where
+   * each level is derived from the next finer level.
+   */
+  bool useCascade = false;
+  this->m_Configuration->ReadParameter(useCascade, "ImagePyramidUseCascade", 0, false);
+  this->SetUseCascade(useCascade);
+
 } // end SetFixedSchedule()
 
 
@@ -174,6 +183,28 @@ FixedGenericPyramid<TElastix>::BeforeEachResolution(void)
 } // end BeforeEachResolution()
 
 
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template <class TElastix>
+void
+FixedGenericPyramid<TElastix>::GenerateData(void)
+{
+  /** Besides the rescale schedule, the output depends on these settings. */
+  std::ostringstream settingsKey;
+  settingsKey << this->GetPyramidSettingsKey() << " smoothing " << this->GetSmoothingSchedule() << " cascade "
+              << this->GetUseCascade() << " currentLevelOnly " << this->GetComputeOnlyForCurrentLevel();
+  if (this->GetComputeOnlyForCurrentLevel())
+  {
+    settingsKey << " level " << this->GetCurrentLevel();
+  }
+
+  this->GenerateSharedData([this] { this->Superclass1::GenerateData(); }, settingsKey.str());
+
+} // end GenerateData()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxFixedGenericPyramid_hxx
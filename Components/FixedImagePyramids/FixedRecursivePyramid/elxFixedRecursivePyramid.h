@@ -89,6 +89,13 @@ protected:
   /** The destructor. */
   ~FixedRecursivePyramid() override = default;
 
+  /** Generates the pyramid, or shares it with the other registrations of a batch. */
+  void
+  GenerateData(void) override
+  {
+    this->GenerateSharedData([this] { this->Superclass1::GenerateData(); }, this->GetPyramidSettingsKey());
+  }
+
 private:
   elxOverrideGetSelfMacro;
 
@@ -91,6 +91,13 @@ protected:
   /** The destructor. */
   ~FixedSmoothingPyramid() override = default;
 
+  /** Generates the pyramid, or shares it with the other registrations of a batch. */
+  void
+  GenerateData(void) override
+  {
+    this->GenerateSharedData([this] { this->Superclass1::GenerateData(); }, this->GetPyramidSettingsKey());
+  }
+
 private:
   elxOverrideGetSelfMacro;
 
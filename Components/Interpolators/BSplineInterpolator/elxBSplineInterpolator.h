@@ -19,7 +19,7 @@
 #define elxBSplineInterpolator_h
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
-#include "itkBSplineInterpolateImageFunction.h"
+#include "itkParallelBSplineInterpolateImageFunction.h"
 
 namespace elastix
 {
@@ -48,18 +48,18 @@ namespace elastix
 
 template <class TElastix>
 class ITK_TEMPLATE_EXPORT BSplineInterpolator
-  : public itk::BSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
-                                                typename InterpolatorBase<TElastix>::CoordRepType,
-                                                double>
+  : public itk::ParallelBSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
+                                                        typename InterpolatorBase<TElastix>::CoordRepType,
+                                                        double>
   , // CoefficientType
     public InterpolatorBase<TElastix>
 {
 public:
   /** Standard ITK-stuff. */
   typedef BSplineInterpolator Self;
-  typedef itk::BSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
-                                               typename InterpolatorBase<TElastix>::CoordRepType,
-                                               double>
+  typedef itk::ParallelBSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
+                                                       typename InterpolatorBase<TElastix>::CoordRepType,
+                                                       double>
                                         Superclass1;
   typedef InterpolatorBase<TElastix>    Superclass2;
   typedef itk::SmartPointer<Self>       Pointer;
@@ -153,7 +153,7 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
 
   /** Initialize some variables. */
   value = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<double>::ZeroValue());
 
   /** Construct the JointPDF, JointPDFDerivatives, Alpha and its derivatives. */
@@ -772,47 +772,58 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Upda
   const int movingParzenWindowIndex =
     static_cast<int>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
 
-  /** Compute the fixed Parzen values. */
-  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
-  this->EvaluateParzenValues(
-    fixedImageParzenWindowTerm, fixedParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
+  /** Compute the fixed Parzen values. The stack allocated containers
+   * avoid a heap allocation per sample.
+   */
+  ParzenWindowValuesType fixedParzenValues;
+  this->EvaluateFixedParzenValues(
+    fixedImageParzenWindowTerm, fixedParzenWindowIndex, fixedParzenValues.GetDataPointer());
 
   /** Compute the derivatives of the moving Parzen window. */
-  ParzenValueContainerType derivativeMovingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
-  this->EvaluateParzenValues(
-    movingImageParzenWindowTerm, movingParzenWindowIndex, this->m_DerivativeMovingKernel, derivativeMovingParzenValues);
+  ParzenWindowValuesType derivativeMovingParzenValues;
+  this->EvaluateDerivativeMovingParzenValues(
+    movingImageParzenWindowTerm, movingParzenWindowIndex, derivativeMovingParzenValues.GetDataPointer());
 
   /** Get the moving image bin size. */
   const double et = static_cast<double>(this->m_MovingImageBinSize);
 
+  /** The size of the Parzen window. */
+  const unsigned int fixedWindowSize = this->m_JointPDFWindow.GetSize()[1];
+  const unsigned int movingWindowSize = this->m_JointPDFWindow.GetSize()[0];
+
   /** Loop over the Parzen window region and increment sum. */
   PDFValueType sum = 0.0;
-  for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+  for (unsigned int f = 0; f < fixedWindowSize; ++f)
   {
-    const double fv_et = fixedParzenValues[f] / et;
-    for (unsigned int m = 0; m < derivativeMovingParzenValues.GetSize(); ++m)
+    const double         fv_et = fixedParzenValues[f] / et;
+    const PRatioType *   pRatioPtr = this->m_PRatioArray[f + fixedParzenWindowIndex] + movingParzenWindowIndex;
+    for (unsigned int m = 0; m < movingWindowSize; ++m)
     {
-      sum += this->m_PRatioArray[f + fixedParzenWindowIndex][m + movingParzenWindowIndex] * fv_et *
-             derivativeMovingParzenValues[m];
+      sum += pRatioPtr[m] * fv_et * derivativeMovingParzenValues[m];
     }
   }
 
-  /** Now compute derivative -= sum * imageJacobian. */
+  /** Now compute derivative -= sum * imageJacobian, using raw pointers,
+   * so that the compiler can vectorise the loops.
+   */
+  const DerivativeValueType * imjac = imageJacobian.data_block();
+  DerivativeValueType *       derivPtr = derivative.data_block();
+  const unsigned int          numberOfJacobianValues = imageJacobian.GetSize();
   if (nzji.size() == this->GetNumberOfParameters())
   {
     /** Loop over all Jacobians. */
-    for (unsigned int mu = 0; mu < this->GetNumberOfParameters(); ++mu)
+    for (unsigned int mu = 0; mu < numberOfJacobianValues; ++mu)
     {
-      derivative[mu] += static_cast<DerivativeValueType>(imageJacobian[mu] * sum);
+      derivPtr[mu] += static_cast<DerivativeValueType>(imjac[mu] * sum);
     }
   }
   else
   {
     /** Loop only over the non-zero Jacobians. */
-    for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
+    const typename NonZeroJacobianIndicesType::value_type * nzjiPtr = nzji.data();
+    for (unsigned int i = 0; i < numberOfJacobianValues; ++i)
     {
-      const unsigned int mu = nzji[i];
-      derivative[mu] += static_cast<DerivativeValueType>(imageJacobian[i] * sum);
+      derivPtr[nzjiPtr[i]] += static_cast<DerivativeValueType>(imjac[i] * sum);
     }
   }
 
@@ -832,7 +843,7 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetV
 {
   /** Initialize some variables. */
   value = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<double>::ZeroValue());
 
   /** Construct the JointPDF, JointPDFDerivatives, Alpha and its derivatives. */
@@ -24,6 +24,8 @@
 #include "itkImageGridSampler.h"                        // needed for SelfHessian
 #include "itkNearestNeighborInterpolateImageFunction.h" // needed for SelfHessian
 
+#include <vector>
+
 namespace itk
 {
 
@@ -147,7 +149,9 @@ public:
                         MeasureType &                   value,
                         DerivativeType &                derivative) const override;
 
-  /** Experimental feature: compute SelfHessian */
+  /** Experimental feature: compute SelfHessian.
+   * The samples are processed in parallel when UseMultiThread is on.
+   */
   void
   GetSelfHessian(const TransformParametersType & parameters, HessianType & H) const override;
 
@@ -215,6 +219,23 @@ protected:
                                            DummyFixedImageInterpolatorType;
   typedef ImageGridSampler<FixedImageType> SelfHessianSamplerType;
 
+  /** A nonzero contribution to the SelfHessian, in coordinate (COO) format.
+   * GetSelfHessian() collects these per chunk of samples, and merges them into H.
+   */
+  struct SelfHessianEntryType
+  {
+    unsigned int m_Row;
+    unsigned int m_Column;
+    double       m_Value;
+  };
+  typedef std::vector<SelfHessianEntryType> SelfHessianEntryContainerType;
+
+  /** The number of samples per chunk of GetSelfHessian(). It is fixed, so that neither the
+   * chunks, nor their noise, nor the order in which they are summed depend on the number of
+   * work units.
+   */
+  static constexpr SizeValueType NumberOfSelfHessianSamplesPerChunk = 4096;
+
   double m_NormalizationFactor;
 
   /** Compute a pixel's contribution to the measure and derivatives;
@@ -227,12 +248,17 @@ protected:
                                 MeasureType &                      measure,
                                 DerivativeType &                   deriv) const;
 
-  /** Compute a pixel's contribution to the SelfHessian;
+  /** Compute a pixel's contribution to the SelfHessian, and append it to a coordinate list;
    * Called by GetSelfHessian(). */
   void
   UpdateSelfHessianTerms(const DerivativeType &             imageJacobian,
                          const NonZeroJacobianIndicesType & nzji,
-                         HessianType &                      H) const;
+                         SelfHessianEntryContainerType &    entries) const;
+
+  /** Sort a coordinate list by row and column, and sum the entries with equal row and column,
+   * in list order. */
+  static void
+  CompactSelfHessianEntries(SelfHessianEntryContainerType & entries);
 
   /** Get value for each thread. */
   inline void
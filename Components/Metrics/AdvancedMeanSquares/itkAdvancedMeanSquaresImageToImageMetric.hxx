@@ -23,6 +23,8 @@
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "itkComputeImageExtremaFilter.h"
 
+#include <algorithm>
+
 #ifdef ELASTIX_USE_OPENMP
 #  include <omp.h>
 #endif
@@ -466,7 +468,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDer
   /** Initialize some variables. */
   this->m_NumberOfPixelsCounted = 0;
   MeasureType measure = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
 
   /** Array that stores dM(x)/dmu, and the sparse jacobian+indices. */
@@ -854,22 +856,20 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::GetSelfHessian
 {
   itkDebugMacro("GetSelfHessian()");
   typedef Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+  typedef typename HessianType::row                         RowType;
+  typedef typename HessianType::pair_t                      ElementType;
 
   /** Initialize some variables. */
   this->m_NumberOfPixelsCounted = 0;
   RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::GetInstance();
   randomGenerator->Initialize();
 
-  /** Array that stores dM(x)/dmu, and the sparse jacobian+indices. */
-  NonZeroJacobianIndicesType nzji(this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices());
-  DerivativeType             imageJacobian(nzji.size());
-  TransformJacobianType      jacobian;
-
   /** Make sure the transform parameters are up to date. */
   this->SetTransformParameters(parameters);
 
   /** Prepare Hessian */
-  H.set_size(this->GetNumberOfParameters(), this->GetNumberOfParameters());
+  const NumberOfParametersType numberOfParameters = this->GetNumberOfParameters();
+  H.set_size(numberOfParameters, numberOfParameters);
   // H.Fill(0.0); // done by set_size if sparse matrix
 
   /** Smooth fixed image */
@@ -905,87 +905,219 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::GetSelfHessian
   /** Update the imageSampler and get a handle to the sample container. */
   sampler->Update();
   ImageSampleContainerPointer sampleContainer = sampler->GetOutput();
+  const SizeValueType         sampleContainerSize = sampleContainer->Size();
 
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator fiter;
-  typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator fend = sampleContainer->End();
-
-  /** Loop over the fixed image to calculate the mean squares. */
-  for (fiter = fbegin; fiter != fend; ++fiter)
+  /** The samples are split in contiguous chunks of a fixed size. Each chunk
+   * collects its contributions in its own coordinate list, and draws its noise
+   * from its own random generator, so the result depends neither on the
+   * scheduling of the chunks nor on the number of work units.
+   */
+  const SizeValueType numberOfChunks = std::max<SizeValueType>(
+    (sampleContainerSize + NumberOfSelfHessianSamplesPerChunk - 1) / NumberOfSelfHessianSamplesPerChunk, 1);
+  const bool useMultiThread = this->m_UseMultiThread && this->m_Threader->GetNumberOfWorkUnits() > 1;
+  std::vector<SelfHessianEntryContainerType>    chunkEntries(numberOfChunks);
+  std::vector<SizeValueType>                    chunkNumberOfPixelsCounted(numberOfChunks, 0);
+  std::vector<RandomGeneratorType::IntegerType> chunkSeeds(numberOfChunks);
+  for (auto & seed : chunkSeeds)
   {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
-    MovingImagePointType        mappedPoint;
-    MovingImageDerivativeType   movingImageDerivative;
+    seed = randomGenerator->GetIntegerVariate();
+  }
 
-    /** Transform point and check if it is inside the B-spline support region. */
-    bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
+  const auto computeChunk = [&](const SizeValueType chunk) {
+    RandomGeneratorType::Pointer chunkRandomGenerator = RandomGeneratorType::New();
+    chunkRandomGenerator->Initialize(chunkSeeds[chunk]);
 
-    /** Check if point is inside mask. NB: we assume here that the
-     * initial transformation is approximately ok.
-     */
-    if (sampleOk)
-    {
-      sampleOk = this->IsInsideMovingMask(mappedPoint);
-    }
+    /** Array that stores dM(x)/dmu, and the sparse jacobian+indices. */
+    NonZeroJacobianIndicesType nzji(this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices());
+    DerivativeType             imageJacobian(nzji.size());
+    TransformJacobianType      jacobian;
 
-    /** Check if point is inside moving image. NB: we assume here that the
-     * initial transformation is approximately ok.
+    /** The coordinate list is compacted whenever it has grown well beyond
+     * its previously compacted size, which bounds the memory use by the
+     * number of nonzero entries of H.
      */
-    if (sampleOk)
+    SelfHessianEntryContainerType & entries = chunkEntries[chunk];
+    const SizeValueType             minimumNumberOfEntries = SizeValueType(1) << 20;
+    SizeValueType                   compactedNumberOfEntries = 0;
+    SizeValueType                   numberOfPixelsCounted = 0;
+
+    /** Create iterator over the samples of this chunk. */
+    typename ImageSampleContainerType::ConstIterator fiter;
+    typename ImageSampleContainerType::ConstIterator fbegin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator fend = sampleContainer->Begin();
+    typedef typename ImageSampleContainerType::ConstIterator::difference_type SampleDifferenceType;
+    const SizeValueType first = std::min(chunk * NumberOfSelfHessianSamplesPerChunk, sampleContainerSize);
+    const SizeValueType last = std::min((chunk + 1) * NumberOfSelfHessianSamplesPerChunk, sampleContainerSize);
+    fbegin += static_cast<SampleDifferenceType>(first);
+    fend += static_cast<SampleDifferenceType>(last);
+
+    for (fiter = fbegin; fiter != fend; ++fiter)
     {
-      sampleOk = this->m_Interpolator->IsInsideBuffer(mappedPoint);
-    }
+      /** Read fixed coordinates and initialize some variables. */
+      const FixedImagePointType & fixedPoint = (*fiter).Value().m_ImageCoordinates;
+      MovingImagePointType        mappedPoint;
+      MovingImageDerivativeType   movingImageDerivative;
 
-    if (sampleOk)
-    {
-      this->m_NumberOfPixelsCounted++;
+      /** Transform point and check if it is inside the B-spline support region. */
+      bool sampleOk = this->TransformPoint(fixedPoint, mappedPoint);
 
-      /** Use the derivative of the fixed image for the self Hessian!
-       * \todo: we can do this more efficient without the interpolation,
-       * without the sampler, and with a precomputed gradient image,
-       * but is this the bottleneck?
+      /** Check if point is inside mask. NB: we assume here that the
+       * initial transformation is approximately ok.
        */
-      movingImageDerivative = fixedInterpolator->EvaluateDerivative(fixedPoint);
-      for (unsigned int d = 0; d < FixedImageDimension; ++d)
+      if (sampleOk)
       {
-        movingImageDerivative[d] += randomGenerator->GetVariateWithClosedRange(this->m_SelfHessianNoiseRange) -
-                                    this->m_SelfHessianNoiseRange / 2.0;
+        sampleOk = this->IsInsideMovingMask(mappedPoint);
       }
 
-      /** Get the TransformJacobian dT/dmu. */
-      this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
-
-      /** Compute the innerproducts (dM/dx)^T (dT/dmu) */
-      this->EvaluateTransformJacobianInnerProduct(jacobian, movingImageDerivative, imageJacobian);
-
-      /** Compute this pixel's contribution to the SelfHessian. */
-      this->UpdateSelfHessianTerms(imageJacobian, nzji, H);
+      /** Check if point is inside moving image. NB: we assume here that the
+       * initial transformation is approximately ok.
+       */
+      if (sampleOk)
+      {
+        sampleOk = this->m_Interpolator->IsInsideBuffer(mappedPoint);
+      }
 
-    } // end if sampleOk
+      if (sampleOk)
+      {
+        ++numberOfPixelsCounted;
+
+        /** Use the derivative of the fixed image for the self Hessian!
+         * \todo: we can do this more efficient without the interpolation,
+         * without the sampler, and with a precomputed gradient image,
+         * but is this the bottleneck?
+         */
+        movingImageDerivative = fixedInterpolator->EvaluateDerivative(fixedPoint);
+        for (unsigned int d = 0; d < FixedImageDimension; ++d)
+        {
+          movingImageDerivative[d] += chunkRandomGenerator->GetVariateWithClosedRange(this->m_SelfHessianNoiseRange) -
+                                      this->m_SelfHessianNoiseRange / 2.0;
+        }
+
+        /** Get the TransformJacobian dT/dmu. */
+        this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
+
+        /** Compute the innerproducts (dM/dx)^T (dT/dmu) */
+        this->EvaluateTransformJacobianInnerProduct(jacobian, movingImageDerivative, imageJacobian);
+
+        /** Compute this pixel's contribution to the SelfHessian. */
+        this->UpdateSelfHessianTerms(imageJacobian, nzji, entries);
+        if (entries.size() > std::max(2 * compactedNumberOfEntries, minimumNumberOfEntries))
+        {
+          Self::CompactSelfHessianEntries(entries);
+          compactedNumberOfEntries = entries.size();
+        }
+
+      } // end if sampleOk
+
+    } // end for loop over the samples of this chunk
+
+    Self::CompactSelfHessianEntries(entries);
+    chunkNumberOfPixelsCounted[chunk] = numberOfPixelsCounted;
+  };
+
+  if (useMultiThread && numberOfChunks > 1)
+  {
+    this->m_Threader->ParallelizeArray(0, numberOfChunks, computeChunk, nullptr);
+  }
+  else
+  {
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      computeChunk(chunk);
+    }
+  }
 
-  } // end for loop over the image sample container
+  for (const SizeValueType numberOfPixelsCounted : chunkNumberOfPixelsCounted)
+  {
+    this->m_NumberOfPixelsCounted += numberOfPixelsCounted;
+  }
 
   /** Check if enough samples were valid. */
-  this->CheckNumberOfSamples(sampleContainer->Size(), this->m_NumberOfPixelsCounted);
+  this->CheckNumberOfSamples(sampleContainerSize, this->m_NumberOfPixelsCounted);
 
-  /** Compute the measure value and derivative. */
-  if (this->m_NumberOfPixelsCounted > 0)
+  if (this->m_NumberOfPixelsCounted == 0)
   {
-    const double normal_sum = 2.0 * this->m_NormalizationFactor / static_cast<double>(this->m_NumberOfPixelsCounted);
-    for (unsigned int i = 0; i < this->GetNumberOfParameters(); ++i)
+    // H.fill_diagonal(1.0);
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
     {
-      H.scale_row(i, normal_sum);
+      H(i, i) = 1.0;
     }
+    return;
   }
-  else
-  {
-    // H.fill_diagonal(1.0);
-    for (unsigned int i = 0; i < this->GetNumberOfParameters(); ++i)
+
+  /** Merge the sorted coordinate lists of all chunks into the rows of H, in
+   * chunk order, and normalize. Blocks of rows are merged in parallel; each
+   * block only writes its own rows, so no locking is needed.
+   */
+  const double normal_sum = 2.0 * this->m_NormalizationFactor / static_cast<double>(this->m_NumberOfPixelsCounted);
+  const SizeValueType numberOfRowBlocks = useMultiThread ? 4 * this->m_Threader->GetNumberOfWorkUnits() : 1;
+
+  const auto mergeRowBlock = [&](const SizeValueType block) {
+    typedef typename SelfHessianEntryContainerType::const_iterator EntryIteratorType;
+
+    const SizeValueType rowBegin = numberOfParameters * block / numberOfRowBlocks;
+    const SizeValueType rowEnd = numberOfParameters * (block + 1) / numberOfRowBlocks;
+
+    /** Find the first entry of this block of rows, in each chunk. */
+    std::vector<EntryIteratorType> cursors(numberOfChunks);
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
     {
-      H(i, i) = 1.0;
+      cursors[chunk] = std::lower_bound(chunkEntries[chunk].begin(),
+                                        chunkEntries[chunk].end(),
+                                        rowBegin,
+                                        [](const SelfHessianEntryType & entry, const SizeValueType row) {
+                                          return entry.m_Row < row;
+                                        });
+    }
+
+    for (SizeValueType row = rowBegin; row < rowEnd; ++row)
+    {
+      RowType & rowVector = H.get_row(static_cast<unsigned int>(row));
+      for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+      {
+        EntryIteratorType & cursor = cursors[chunk];
+        for (; (cursor != chunkEntries[chunk].end()) && (cursor->m_Row == row); ++cursor)
+        {
+          rowVector.push_back(ElementType(cursor->m_Column, cursor->m_Value));
+        }
+      }
+
+      /** Entries of different chunks may share a column: sort and sum those, in chunk order. */
+      if (numberOfChunks > 1)
+      {
+        std::stable_sort(rowVector.begin(), rowVector.end(), [](const ElementType & a, const ElementType & b) {
+          return a.first < b.first;
+        });
+        auto last = rowVector.begin();
+        for (auto rowIt = rowVector.begin(); rowIt != rowVector.end(); ++rowIt)
+        {
+          if ((last != rowVector.begin()) && ((last - 1)->first == rowIt->first))
+          {
+            (last - 1)->second += rowIt->second;
+          }
+          else
+          {
+            *last = *rowIt;
+            ++last;
+          }
+        }
+        rowVector.erase(last, rowVector.end());
+      }
+
+      for (ElementType & element : rowVector)
+      {
+        element.second *= normal_sum;
+      }
     }
+  };
+
+  if (numberOfRowBlocks > 1)
+  {
+    this->m_Threader->ParallelizeArray(0, numberOfRowBlocks, mergeRowBlock, nullptr);
+  }
+  else
+  {
+    mergeRowBlock(0);
   }
 
 } // end GetSelfHessian()
@@ -1000,67 +1132,65 @@ void
 AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::UpdateSelfHessianTerms(
   const DerivativeType &             imageJacobian,
   const NonZeroJacobianIndicesType & nzji,
-  HessianType &                      H) const
+  SelfHessianEntryContainerType &    entries) const
 {
-  typedef typename HessianType::row    RowType;
-  typedef typename RowType::iterator   RowIteratorType;
-  typedef typename HessianType::pair_t ElementType;
-
-  // does not work for sparse matrix. \todo: distinguish between sparse and nonsparse
-  ///** Do rank-1 update of H */
-  // if ( nzji.size() == this->GetNumberOfParameters() )
-  //{
-  //  /** Loop over all Jacobians. */
-  //  vnl_matrix_update( H, imageJacobian, imageJacobian );
-  //}
-  // else
-  //{
   /** Only pick the nonzero Jacobians.
-   * Save only upper triangular part of the matrix */
+   * Save only upper triangular part of the matrix.
+   * The entries are simply appended; CompactSelfHessianEntries() sums them.
+   */
   const unsigned int imjacsize = imageJacobian.GetSize();
   for (unsigned int i = 0; i < imjacsize; ++i)
   {
     const unsigned int row = nzji[i];
     const double       imjacrow = imageJacobian[i];
 
-    RowType &       rowVector = H.get_row(row);
-    RowIteratorType rowIt = rowVector.begin();
-
     for (unsigned int j = i; j < imjacsize; ++j)
     {
-      const unsigned int col = nzji[j];
-      const double       val = imjacrow * imageJacobian[j];
+      const double val = imjacrow * imageJacobian[j];
       if ((val < 1e-14) && (val > -1e-14))
       {
         continue;
       }
 
-      /** The following implements:
-       * H(row,col) += imjacrow * imageJacobian[ j ];
-       * But more efficient.
-       */
+      const SelfHessianEntryType entry = { row, static_cast<unsigned int>(nzji[j]), val };
+      entries.push_back(entry);
+    }
+  }
 
-      /** Go to next element */
-      for (; (rowIt != rowVector.end()) && ((*rowIt).first < col); ++rowIt)
-      {
-      }
+} // end UpdateSelfHessianTerms()
 
-      if ((rowIt == rowVector.end()) || ((*rowIt).first != col))
-      {
-        /** Add new column to the row and set iterator to that column. */
-        rowIt = rowVector.insert(rowIt, ElementType(col, val));
-      }
-      else
-      {
-        /** Add to existing value */
-        (*rowIt).second += val;
-      }
+
+/**
+ * *************** CompactSelfHessianEntries ***************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::CompactSelfHessianEntries(
+  SelfHessianEntryContainerType & entries)
+{
+  /** Sort by row and column. The sort is stable, so that equal entries are summed in list order. */
+  std::stable_sort(entries.begin(), entries.end(), [](const SelfHessianEntryType & a, const SelfHessianEntryType & b) {
+    return (a.m_Row < b.m_Row) || ((a.m_Row == b.m_Row) && (a.m_Column < b.m_Column));
+  });
+
+  /** Sum the entries with the same row and column. */
+  auto last = entries.begin();
+  for (auto it = entries.begin(); it != entries.end(); ++it)
+  {
+    if ((last != entries.begin()) && ((last - 1)->m_Row == it->m_Row) && ((last - 1)->m_Column == it->m_Column))
+    {
+      (last - 1)->m_Value += it->m_Value;
+    }
+    else
+    {
+      *last = *it;
+      ++last;
     }
   }
+  entries.erase(last, entries.end());
 
-  //} // end else
-
-} // end UpdateSelfHessianTerms()
+} // end CompactSelfHessianEntries()
 
 
 } // end namespace itk
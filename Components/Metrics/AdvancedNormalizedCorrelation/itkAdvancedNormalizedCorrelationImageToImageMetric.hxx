@@ -335,7 +335,7 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::GetV
 
   /** Initialize some variables. */
   this->m_NumberOfPixelsCounted = 0;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
   DerivativeType derivativeF = DerivativeType(this->GetNumberOfParameters());
   derivativeF.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
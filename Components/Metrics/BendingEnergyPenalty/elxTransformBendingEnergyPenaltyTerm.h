@@ -39,6 +39,13 @@ namespace elastix
  * The parameters used in this class are:
  * \parameter Metric: Select this metric as follows:\n
  *    <tt>(Metric "TransformBendingEnergyPenalty")</tt>
+ * \parameter UseExactBendingEnergy: Integrate the bending energy of a B-spline transform
+ *    exactly over the fixed image domain, instead of averaging it over the samples. The
+ *    result is deterministic and does not depend on the number of samples, but the
+ *    masks are ignored. Only third order B-splines are supported; for other transforms
+ *    the samples are used. Can be given for each resolution.\n
+ *    example: <tt>(UseExactBendingEnergy "true")</tt>\n
+ *    The default is "false".
  *
  * \ingroup Metrics
  *
@@ -133,6 +140,7 @@ public:
   /**
    * Do some things before each resolution:
    * \li Set options for SelfHessian
+   * \li Set UseExactBendingEnergy
    */
   void
   BeforeEachResolution(void) override;
@@ -59,6 +59,12 @@ TransformBendingEnergyPenalty<TElastix>::BeforeEachResolution(void)
     numberOfSamplesForSelfHessian, "NumberOfSamplesForSelfHessian", this->GetComponentLabel(), level, 0);
   this->SetNumberOfSamplesForSelfHessian(numberOfSamplesForSelfHessian);
 
+  /** Integrate the bending energy exactly, instead of sampling it? */
+  bool useExactBendingEnergy = false;
+  this->GetConfiguration()->ReadParameter(
+    useExactBendingEnergy, "UseExactBendingEnergy", this->GetComponentLabel(), level, 0);
+  this->SetUseExactBendingEnergy(useExactBendingEnergy);
+
 } // end BeforeEachResolution()
 
 
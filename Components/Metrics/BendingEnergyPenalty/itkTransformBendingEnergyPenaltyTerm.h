@@ -21,6 +21,8 @@
 #include "itkTransformPenaltyTerm.h"
 #include "itkImageGridSampler.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -35,6 +37,18 @@ namespace itk
  * zero.
  *
  *
+ * By default the energy is averaged over the samples of the image sampler.
+ * With UseExactBendingEnergy, and a third order B-spline transform, the
+ * energy is instead integrated exactly over the fixed image domain. The
+ * energy is then a quadratic form in the B-spline coefficients, of which
+ * the matrix is a sum of tensor products of banded 1D matrices, the inner
+ * products of the (derivatives of the) B-spline basis functions. These 1D
+ * matrices are computed once per grid. The value and derivative are then
+ * computed by applying them along each grid dimension, multi-threaded, so
+ * that they are deterministic and independent of the number of samples.
+ * The fixed and moving masks are ignored in this mode, and the grid direction
+ * is assumed to be orthonormal. Other transforms fall back on sampling.
+ *
  * [1]: D. Rueckert, L. I. Sonoda, C. Hayes, D. L. G. Hill,
  *      M. O. Leach, and D. J. Hawkes, "Nonrigid registration
  *      using free-form deformations: Application to breast MR
@@ -158,6 +172,13 @@ public:
   itkSetMacro(NumberOfSamplesForSelfHessian, unsigned int);
   itkGetConstMacro(NumberOfSamplesForSelfHessian, unsigned int);
 
+  /** Integrate the bending energy of a B-spline transform exactly, instead of
+   * sampling it. Default: false.
+   */
+  itkSetMacro(UseExactBendingEnergy, bool);
+  itkGetConstMacro(UseExactBendingEnergy, bool);
+  itkBooleanMacro(UseExactBendingEnergy);
+
 protected:
   /** Typedefs for indices and points. */
   using typename Superclass::FixedImageIndexType;
@@ -171,6 +192,12 @@ protected:
   /** Typedefs for SelfHessian */
   typedef ImageGridSampler<FixedImageType> SelfHessianSamplerType;
 
+  /** Typedefs for the grid of the B-spline transform. */
+  typedef typename BSplineOrder3TransformType::RegionType    GridRegionType;
+  typedef typename BSplineOrder3TransformType::SpacingType   GridSpacingType;
+  typedef typename BSplineOrder3TransformType::OriginType    GridOriginType;
+  typedef typename BSplineOrder3TransformType::DirectionType GridDirectionType;
+
   /** The constructor. */
   TransformBendingEnergyPenaltyTerm();
 
@@ -184,7 +211,51 @@ private:
   void
   operator=(const Self &) = delete;
 
+  /** Computes the exact bending energy, and its derivative if derivative is
+   * not null. Returns false if the exact computation is not switched on, or
+   * not possible for the current transform.
+   */
+  bool
+  GetExactValueAndDerivative(const ParametersType & parameters,
+                             MeasureType &          value,
+                             DerivativeType *       derivative) const;
+
+  /** (Re)computes the banded 1D matrices when the grid or fixed image region changed. */
+  void
+  UpdateExactBendingEnergyStencil(const BSplineOrder3TransformType & bspline) const;
+
+  /** Applies the banded 1D matrix along one grid dimension, to all lines of
+   * all coefficient images. If accumulate is true, weight times the result
+   * is added to the output, otherwise the result is written to the output.
+   */
+  void
+  ApplyExactBendingEnergyStencil(const double * input,
+                                 double *       output,
+                                 const double * stencil,
+                                 unsigned int   dimension,
+                                 bool           accumulate,
+                                 double         weight) const;
+
   unsigned int m_NumberOfSamplesForSelfHessian;
+  bool         m_UseExactBendingEnergy;
+
+  /** The half bandwidth of the 1D matrices of third order B-splines. */
+  static constexpr unsigned int ExactStencilRadius = 3;
+  static constexpr unsigned int ExactStencilWidth = 2 * ExactStencilRadius + 1;
+
+  /** The cached 1D matrices, per dimension and order of derivative, stored by
+   * row: element ( i, i + o - ExactStencilRadius ) is at i * ExactStencilWidth + o.
+   */
+  mutable std::vector<double>  m_ExactStencils[FixedImageDimension][3];
+  mutable double               m_ExactDomainVolume;
+  mutable GridRegionType       m_ExactGridRegion;
+  mutable GridSpacingType      m_ExactGridSpacing;
+  mutable GridOriginType       m_ExactGridOrigin;
+  mutable GridDirectionType    m_ExactGridDirection;
+  mutable FixedImageRegionType m_ExactFixedImageRegion;
+  mutable ModifiedTimeType     m_ExactFixedImageMTime;
+  mutable std::vector<double>  m_ExactBuffers[2];
+  mutable DerivativeType       m_ExactDerivative;
 };
 
 } // end namespace itk
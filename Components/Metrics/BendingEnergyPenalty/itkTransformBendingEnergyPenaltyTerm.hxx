@@ -19,6 +19,13 @@
 #define itkTransformBendingEnergyPenaltyTerm_hxx
 
 #include "itkTransformBendingEnergyPenaltyTerm.h"
+#include "itkBSplineKernelFunction2.h"
+#include "itkBSplineDerivativeKernelFunction2.h"
+#include "itkBSplineSecondOrderDerivativeKernelFunction2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #ifdef ELASTIX_USE_OPENMP
 #  include <omp.h>
@@ -40,6 +47,9 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::TransformBendingEne
   this->SetUseImageSampler(true);
 
   this->m_NumberOfSamplesForSelfHessian = 100000;
+  this->m_UseExactBendingEnergy = false;
+  this->m_ExactDomainVolume = 0.0;
+  this->m_ExactFixedImageMTime = 0;
 
 } // end Constructor
 
@@ -63,6 +73,13 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValue(const Para
     return static_cast<MeasureType>(measure);
   }
 
+  /** Integrate the bending energy exactly, if requested and possible. */
+  MeasureType exactValue = NumericTraits<MeasureType>::Zero;
+  if (this->GetExactValueAndDerivative(parameters, exactValue, nullptr))
+  {
+    return exactValue;
+  }
+
   /** Call non-thread-safe stuff, such as:
    *   this->SetTransformParameters( parameters );
    *   this->GetImageSampler()->Update();
@@ -163,7 +180,7 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivati
   /** Create and initialize some variables. */
   this->m_NumberOfPixelsCounted = 0;
   RealType measure = NumericTraits<RealType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
 
   SpatialHessianType           spatialHessian;
@@ -181,6 +198,12 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivati
     value = static_cast<MeasureType>(measure);
     return;
   }
+
+  /** Integrate the bending energy exactly, if requested and possible. */
+  if (this->GetExactValueAndDerivative(parameters, value, &derivative))
+  {
+    return;
+  }
   // TODO: This is only required once! and not every iteration.
 
   /** Check if this transform is a B-spline transform. */
@@ -354,6 +377,12 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivati
                                                                                    MeasureType &          value,
                                                                                    DerivativeType & derivative) const
 {
+  /** Integrate the bending energy exactly, if requested and possible. */
+  if (this->GetExactValueAndDerivative(parameters, value, &derivative))
+  {
+    return;
+  }
+
   /** Option for now to still use the single threaded code. */
   if (!this->m_UseMultiThread)
   {
@@ -645,6 +674,340 @@ TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::AfterThreadedGetVal
 } // end AfterThreadedGetValueAndDerivative()
 
 
+/**
+ * ******************* GetExactValueAndDerivative *******************
+ */
+
+template <class TFixedImage, class TScalarType>
+bool
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::GetExactValueAndDerivative(
+  const ParametersType & parameters,
+  MeasureType &          value,
+  DerivativeType *       derivative) const
+{
+  if (!this->m_UseExactBendingEnergy)
+  {
+    return false;
+  }
+
+  /** A third order B-spline transform is required, or a combination with such a
+   * current transform. An initial transform is only allowed when it is added,
+   * and does not contribute to the spatial Hessian.
+   */
+  BSplineOrder3TransformPointer bspline;
+  if (!this->CheckForBSplineTransform2(bspline) || bspline.IsNull())
+  {
+    return false;
+  }
+  const CombinationTransformType * combination =
+    dynamic_cast<const CombinationTransformType *>(this->m_AdvancedTransform.GetPointer());
+  if (combination != nullptr && combination->GetInitialTransform() != nullptr &&
+      (!combination->GetUseAddition() || combination->GetInitialTransform()->GetHasNonZeroSpatialHessian()))
+  {
+    return false;
+  }
+
+  /** Make sure the transform parameters are up to date. The image sampler is
+   * not needed, see BeforeThreadedGetValueAndDerivative().
+   */
+  if (this->m_UseMetricSingleThreaded)
+  {
+    this->SetTransformParameters(parameters);
+  }
+
+  /** Get the banded 1D matrices of the current grid. */
+  this->UpdateExactBendingEnergyStencil(*bspline);
+
+  const SizeValueType numberOfParameters = FixedImageDimension * this->m_ExactGridRegion.GetNumberOfPixels();
+  if (bspline->GetNumberOfParameters() != numberOfParameters)
+  {
+    itkExceptionMacro(<< "The number of B-spline parameters does not match the grid region.");
+  }
+  const double * coefficients = bspline->GetParameters().data_block();
+
+  /** The gradient is written to the derivative, if requested. */
+  DerivativeType & gradient = derivative != nullptr ? *derivative : this->m_ExactDerivative;
+  if (gradient.GetSize() != numberOfParameters)
+  {
+    gradient.SetSize(numberOfParameters);
+  }
+  gradient.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+  for (std::vector<double> & buffer : this->m_ExactBuffers)
+  {
+    buffer.resize(numberOfParameters);
+  }
+
+  /** The bending energy density is the sum over p <= q of the squared second order
+   * derivatives d^2 T / dx_p dx_q, with weight 2 when p < q. Each of these terms is
+   * a quadratic form with a tensor product of 1D matrices: of the second derivatives
+   * along p if p == q, of the first derivatives along p and q otherwise, and of the
+   * basis functions along the other dimensions. The gradient of the energy is twice
+   * the sum of these matrices times the coefficients.
+   */
+  const GridSpacingType & gridSpacing = this->m_ExactGridSpacing;
+  for (unsigned int p = 0; p < FixedImageDimension; ++p)
+  {
+    for (unsigned int q = p; q < FixedImageDimension; ++q)
+    {
+      unsigned int order[FixedImageDimension] = {};
+      ++order[p];
+      ++order[q];
+      const double weight =
+        (p == q ? 2.0 : 4.0) / (vnl_math::sqr(gridSpacing[p] * gridSpacing[q]) * this->m_ExactDomainVolume);
+
+      /** Apply the 1D matrices one dimension at a time, and add the last pass to the gradient. */
+      const double * input = coefficients;
+      for (unsigned int d = 0; d < FixedImageDimension; ++d)
+      {
+        const bool lastPass = d + 1 == FixedImageDimension;
+        double *   output = lastPass ? gradient.data_block() : this->m_ExactBuffers[d % 2].data();
+        this->ApplyExactBendingEnergyStencil(
+          input, output, this->m_ExactStencils[d][order[d]].data(), d, lastPass, weight);
+        input = output;
+      }
+    }
+  }
+
+  /** The energy is a quadratic form, so its value is half the inner product
+   * of the coefficients and the gradient.
+   */
+  double energy = 0.0;
+  for (SizeValueType i = 0; i < numberOfParameters; ++i)
+  {
+    energy += coefficients[i] * gradient[i];
+  }
+  value = static_cast<MeasureType>(0.5 * energy);
+
+  return true;
+
+} // end GetExactValueAndDerivative()
+
+
+/**
+ * ******************* UpdateExactBendingEnergyStencil *******************
+ */
+
+template <class TFixedImage, class TScalarType>
+void
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::UpdateExactBendingEnergyStencil(
+  const BSplineOrder3TransformType & bspline) const
+{
+  const GridRegionType         gridRegion = bspline.GetGridRegion();
+  const GridSpacingType        gridSpacing = bspline.GetGridSpacing();
+  const GridOriginType         gridOrigin = bspline.GetGridOrigin();
+  const GridDirectionType      gridDirection = bspline.GetGridDirection();
+  const FixedImageType *       fixedImage = this->GetFixedImage();
+  const FixedImageRegionType & fixedImageRegion = this->GetFixedImageRegion();
+
+  /** Nothing to do when neither the grid nor the fixed image domain changed. */
+  if (!this->m_ExactStencils[0][0].empty() && gridRegion == this->m_ExactGridRegion &&
+      gridSpacing == this->m_ExactGridSpacing && gridOrigin == this->m_ExactGridOrigin &&
+      gridDirection == this->m_ExactGridDirection && fixedImageRegion == this->m_ExactFixedImageRegion &&
+      fixedImage->GetMTime() == this->m_ExactFixedImageMTime)
+  {
+    return;
+  }
+
+  this->m_ExactGridRegion = gridRegion;
+  this->m_ExactGridSpacing = gridSpacing;
+  this->m_ExactGridOrigin = gridOrigin;
+  this->m_ExactGridDirection = gridDirection;
+  this->m_ExactFixedImageRegion = fixedImageRegion;
+  this->m_ExactFixedImageMTime = fixedImage->GetMTime();
+
+  /** The domain of integration, in continuous grid indices: the bounding box of the
+   * corner voxels of the fixed image region, within the valid region of the grid.
+   */
+  const auto inverseGridDirection = gridDirection.GetInverse();
+  double     lower[FixedImageDimension];
+  double     upper[FixedImageDimension];
+  std::fill_n(lower, FixedImageDimension, std::numeric_limits<double>::max());
+  std::fill_n(upper, FixedImageDimension, std::numeric_limits<double>::lowest());
+  for (unsigned int corner = 0; corner < (1u << FixedImageDimension); ++corner)
+  {
+    FixedImageIndexType index = fixedImageRegion.GetIndex();
+    for (unsigned int d = 0; d < FixedImageDimension; ++d)
+    {
+      if ((corner >> d) & 1)
+      {
+        index[d] += static_cast<FixedImageIndexValueType>(fixedImageRegion.GetSize()[d]) - 1;
+      }
+    }
+    FixedImagePointType point;
+    fixedImage->TransformIndexToPhysicalPoint(index, point);
+
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      double gridIndex = 0.0;
+      for (unsigned int j = 0; j < FixedImageDimension; ++j)
+      {
+        gridIndex += inverseGridDirection(i, j) * (point[j] - gridOrigin[j]);
+      }
+      gridIndex /= gridSpacing[i];
+      lower[i] = std::min(lower[i], gridIndex);
+      upper[i] = std::max(upper[i], gridIndex);
+    }
+  }
+
+  /** The kernels of the basis functions and their first and second derivatives. */
+  const typename KernelFunctionBase<double>::Pointer kernels[3] = {
+    BSplineKernelFunction2<3>::New().GetPointer(),
+    BSplineDerivativeKernelFunction2<3>::New().GetPointer(),
+    BSplineSecondOrderDerivativeKernelFunction2<3>::New().GetPointer()
+  };
+
+  /** Nodes and weights of the 4 point Gauss-Legendre quadrature, which is exact
+   * for the products of two cubic polynomials between the knots.
+   */
+  const double nodes[4] = {
+    -0.861136311594052575, -0.339981043584856265, 0.339981043584856265, 0.861136311594052575
+  };
+  const double weights[4] = {
+    0.347854845137453857, 0.652145154862546143, 0.652145154862546143, 0.347854845137453857
+  };
+
+  this->m_ExactDomainVolume = 1.0;
+  for (unsigned int d = 0; d < FixedImageDimension; ++d)
+  {
+    const IndexValueType firstIndex = gridRegion.GetIndex()[d];
+    const SizeValueType  length = gridRegion.GetSize()[d];
+    const IndexValueType endIndex = firstIndex + static_cast<IndexValueType>(length);
+    const double         validBegin = static_cast<double>(firstIndex) + 1.0;
+    const double         validEnd = static_cast<double>(endIndex) - 2.0;
+    const double         begin = std::max(lower[d], validBegin);
+    const double         end = std::min(upper[d], validEnd);
+    if (begin > end)
+    {
+      itkExceptionMacro(<< "The fixed image domain lies outside the valid region of the B-spline grid.");
+    }
+
+    std::vector<double> * stencils = this->m_ExactStencils[d];
+    for (unsigned int m = 0; m < 3; ++m)
+    {
+      stencils[m].assign(length * ExactStencilWidth, 0.0);
+    }
+
+    /** Adds weight times the products of the basis functions that are nonzero at x. */
+    const auto addProducts = [&](const double x, const double weight) {
+      const IndexValueType first = static_cast<IndexValueType>(std::floor(x)) - 1;
+      const IndexValueType supportBegin = std::max(first, firstIndex);
+      const IndexValueType supportEnd = std::min(first + 4, endIndex);
+      for (IndexValueType i = supportBegin; i < supportEnd; ++i)
+      {
+        for (IndexValueType j = supportBegin; j < supportEnd; ++j)
+        {
+          const SizeValueType element =
+            static_cast<SizeValueType>(i - firstIndex) * ExactStencilWidth + (j - i + ExactStencilRadius);
+          for (unsigned int m = 0; m < 3; ++m)
+          {
+            stencils[m][element] += weight * kernels[m]->Evaluate(x - i) * kernels[m]->Evaluate(x - j);
+          }
+        }
+      }
+    };
+
+    if (end > begin)
+    {
+      /** Integrate between consecutive knots. */
+      for (double knot = std::floor(begin); knot < end; knot += 1.0)
+      {
+        const double from = std::max(knot, begin);
+        const double to = std::min(knot + 1.0, end);
+        const double halfWidth = 0.5 * (to - from);
+        for (unsigned int k = 0; k < 4; ++k)
+        {
+          addProducts(from + halfWidth * (1.0 + nodes[k]), halfWidth * weights[k]);
+        }
+      }
+      this->m_ExactDomainVolume *= end - begin;
+    }
+    else
+    {
+      /** A fixed image of a single voxel wide: evaluate instead of integrate. */
+      addProducts(begin, 1.0);
+    }
+  }
+
+} // end UpdateExactBendingEnergyStencil()
+
+
+/**
+ * ******************* ApplyExactBendingEnergyStencil *******************
+ */
+
+template <class TFixedImage, class TScalarType>
+void
+TransformBendingEnergyPenaltyTerm<TFixedImage, TScalarType>::ApplyExactBendingEnergyStencil(
+  const double *     input,
+  double *           output,
+  const double *     stencil,
+  const unsigned int dimension,
+  const bool         accumulate,
+  const double       weight) const
+{
+  /** A line along the given dimension has length elements, stride apart. */
+  const SizeValueType numberOfCoefficients = this->m_ExactGridRegion.GetNumberOfPixels();
+  const SizeValueType length = this->m_ExactGridRegion.GetSize()[dimension];
+  SizeValueType       stride = 1;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    stride *= this->m_ExactGridRegion.GetSize()[d];
+  }
+  const SizeValueType linesPerImage = numberOfCoefficients / length;
+  const SizeValueType numberOfLines = FixedImageDimension * linesPerImage;
+  const SizeValueType radius = ExactStencilRadius;
+  const SizeValueType width = ExactStencilWidth;
+
+  /** Neighbouring lines go to the same chunk, so that they share cache lines. */
+  const SizeValueType numberOfChunks =
+    std::min<SizeValueType>(numberOfLines, 4 * static_cast<SizeValueType>(this->m_Threader->GetNumberOfWorkUnits()));
+
+  const auto applyToChunk = [=](const SizeValueType chunk) {
+    const SizeValueType lineBegin = chunk * numberOfLines / numberOfChunks;
+    const SizeValueType lineEnd = (chunk + 1) * numberOfLines / numberOfChunks;
+    for (SizeValueType line = lineBegin; line < lineEnd; ++line)
+    {
+      const SizeValueType lineInImage = line % linesPerImage;
+      const SizeValueType offset = (line / linesPerImage) * numberOfCoefficients +
+                                   (lineInImage / stride) * stride * length + lineInImage % stride;
+      const double * in = input + offset;
+      double *       out = output + offset;
+
+      for (SizeValueType i = 0; i < length; ++i)
+      {
+        const double *      row = stencil + i * width;
+        const SizeValueType jBegin = i > radius ? i - radius : 0;
+        const SizeValueType jEnd = std::min(i + radius + 1, length);
+        double              sum = 0.0;
+        for (SizeValueType j = jBegin; j < jEnd; ++j)
+        {
+          sum += row[j + radius - i] * in[j * stride];
+        }
+
+        if (accumulate)
+        {
+          out[i * stride] += weight * sum;
+        }
+        else
+        {
+          out[i * stride] = sum;
+        }
+      }
+    }
+  };
+
+  if (numberOfChunks > 1)
+  {
+    this->m_Threader->ParallelizeArray(0, numberOfChunks, applyToChunk, nullptr);
+  }
+  else
+  {
+    applyToChunk(0);
+  }
+
+} // end ApplyExactBendingEnergyStencil()
+
+
 /**
  * ******************* GetSelfHessian *******************
  */
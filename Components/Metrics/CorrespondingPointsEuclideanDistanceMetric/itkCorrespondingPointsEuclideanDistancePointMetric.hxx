@@ -83,11 +83,7 @@ CorrespondingPointsEuclideanDistancePointMetric<TFixedPointSet, TMovingPointSet>
     bool sampleOk = true;
     if (sampleOk)
     {
-      // sampleOk = this->IsInsideMovingMask( mappedPoint );
-      if (this->m_MovingImageMask.IsNotNull())
-      {
-        sampleOk = this->m_MovingImageMask->IsInsideInWorldSpace(mappedPoint);
-      }
+      sampleOk = this->IsInsideMovingMask(mappedPoint);
     }
 
     if (sampleOk)
@@ -157,7 +153,7 @@ CorrespondingPointsEuclideanDistancePointMetric<TFixedPointSet, TMovingPointSet>
   /** Initialize some variables */
   this->m_NumberOfPointsCounted = 0;
   MeasureType measure = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
   NonZeroJacobianIndicesType nzji(this->m_Transform->GetNumberOfNonZeroJacobianIndices());
   TransformJacobianType      jacobian;
@@ -200,11 +196,7 @@ CorrespondingPointsEuclideanDistancePointMetric<TFixedPointSet, TMovingPointSet>
     bool sampleOk = true;
     if (sampleOk)
     {
-      // sampleOk = this->IsInsideMovingMask( mappedPoint );
-      if (this->m_MovingImageMask.IsNotNull())
-      {
-        sampleOk = this->m_MovingImageMask->IsInsideInWorldSpace(mappedPoint);
-      }
+      sampleOk = this->IsInsideMovingMask(mappedPoint);
     }
 
     if (sampleOk)
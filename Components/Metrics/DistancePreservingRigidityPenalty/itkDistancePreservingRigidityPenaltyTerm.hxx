@@ -305,7 +305,7 @@ DistancePreservingRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDeri
   this->m_RigidityPenaltyTermValue = NumericTraits<MeasureType>::Zero;
 
   /** Set output values to zero. */
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<MeasureType>::ZeroValue());
 
   this->m_BSplineTransform->SetParameters(parameters);
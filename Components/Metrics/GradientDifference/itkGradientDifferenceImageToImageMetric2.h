@@ -40,7 +40,7 @@
 #include "itkNeighborhoodOperatorImageFilter.h"
 #include "itkPoint.h"
 #include "itkCastImageFilter.h"
-#include "itkResampleImageFilter.h"
+#include "itkRayCastResampleImageFilter.h"
 #include "itkOptimizer.h"
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
@@ -119,10 +119,10 @@ public:
   itkStaticConstMacro(FixedImageDimension, unsigned int, FixedImageType::ImageDimension);
   itkStaticConstMacro(MovedImageDimension, unsigned int, MovingImageType::ImageDimension);
 
-  typedef typename itk::AdvancedCombinationTransform<ScalarType, FixedImageDimension> CombinationTransformType;
-  typedef typename CombinationTransformType::Pointer                                  CombinationTransformPointer;
-  typedef itk::Image<FixedImagePixelType, Self::FixedImageDimension>                  TransformedMovingImageType;
-  typedef itk::ResampleImageFilter<MovingImageType, TransformedMovingImageType>       TransformMovingImageFilterType;
+  typedef typename itk::AdvancedCombinationTransform<ScalarType, FixedImageDimension>  CombinationTransformType;
+  typedef typename CombinationTransformType::Pointer                                   CombinationTransformPointer;
+  typedef itk::Image<FixedImagePixelType, Self::FixedImageDimension>                   TransformedMovingImageType;
+  typedef itk::RayCastResampleImageFilter<MovingImageType, TransformedMovingImageType> TransformMovingImageFilterType;
   typedef typename itk::AdvancedRayCastInterpolateImageFunction<MovingImageType, ScalarType> RayCastInterpolatorType;
   typedef typename RayCastInterpolatorType::Pointer                                          RayCastInterpolatorPointer;
   typedef itk::Image<RealType, Self::FixedImageDimension>                                    FixedGradientImageType;
@@ -255,7 +255,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeVariance
       /** if fixedMask is given */
       if (!this->m_FixedImageMask.IsNull())
       {
-        if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+        if (this->IsInsideFixedMask(point))
         {
           sampleOK = true;
         }
@@ -304,7 +304,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeVariance
       /** if fixedMask is given */
       if (!this->m_FixedImageMask.IsNull())
       {
-        if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+        if (this->IsInsideFixedMask(point))
         {
           sampleOK = true;
         }
@@ -409,7 +409,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::ComputeMeasure(
       if (!this->m_FixedImageMask.IsNull())
       {
 
-        if (this->m_FixedImageMask->IsInsideInWorldSpace(point)) // sample is good
+        if (this->IsInsideFixedMask(point)) // sample is good
         {
           sampleOK = true;
         }
@@ -491,7 +491,7 @@ GradientDifferenceImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(
   TransformParametersType testPoint;
   testPoint = parameters;
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
-  derivative = DerivativeType(numberOfParameters);
+  derivative.SetSize(numberOfParameters);
 
   for (unsigned int i = 0; i < numberOfParameters; ++i)
   {
@@ -18,11 +18,19 @@
 
 #include "itkANNBinaryTreeCreator.h"
 
+#include <mutex>
+
 namespace itk
 {
 
 unsigned int ANNBinaryTreeCreator::m_NumberOfANNBinaryTrees = 0;
 
+namespace
+{
+/** Guards the reference count, so that trees can be created concurrently. */
+std::mutex ANNBinaryTreeCreatorMutex;
+} // namespace
+
 /**
  * ************************ CreateANNkDTree *************************
  */
@@ -103,6 +111,7 @@ ANNBinaryTreeCreator::DeleteANNBruteForceTree(ANNBruteForceTreeType *& tree)
 void
 ANNBinaryTreeCreator::IncreaseReferenceCount(void)
 {
+  const std::lock_guard<std::mutex> lock(ANNBinaryTreeCreatorMutex);
   m_NumberOfANNBinaryTrees++;
 } // end IncreaseReferenceCount
 
@@ -114,6 +123,10 @@ ANNBinaryTreeCreator::IncreaseReferenceCount(void)
 void
 ANNBinaryTreeCreator::DecreaseReferenceCount(void)
 {
+  /** The lock is held while closing ANN, so that no tree can be created
+   * in between the count dropping to zero and annClose() being called.
+   */
+  const std::lock_guard<std::mutex> lock(ANNBinaryTreeCreatorMutex);
   m_NumberOfANNBinaryTrees--;
   if (m_NumberOfANNBinaryTrees == 0)
   {
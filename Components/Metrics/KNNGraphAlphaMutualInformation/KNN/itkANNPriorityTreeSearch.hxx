@@ -98,40 +98,21 @@ ANNPriorityTreeSearch<TBinaryTree>::Search(const MeasurementVectorType & qp,
                                            IndexArrayType &              ind,
                                            DistanceArrayType &           dists)
 {
-  /** Get k , dim and eps. */
+  /** Get k and eps. */
   int    k = static_cast<int>(this->m_KNearestNeighbors);
-  int    dim = static_cast<int>(this->m_DataDimension);
   double eps = this->m_ErrorBound;
 
-  /** Allocate memory for ANN indices and distances arrays. */
-  ANNIndexArrayType ANNIndices;
-  ANNIndices = new ANNIndexType[k];
-
-  ANNDistanceArrayType ANNDistances;
-  ANNDistances = new ANNDistanceType[k];
-
-  /** Alocate memory for ANN query point and copy qp to it. */
-  ANNPointType ANNQueryPoint = annAllocPt(dim);
-  for (int i = 0; i < dim; ++i)
-  {
-    ANNQueryPoint[i] = qp[i];
-  }
-
-  /** The actual ANN search. */
-  this->m_BinaryTreeAskDTree->annkPriSearch(ANNQueryPoint, k, ANNIndices, ANNDistances, eps);
-  // this->m_BinaryTree->GetANNTree()->annkPriSearch(
-  // ANNQueryPoint, k, ANNIndices, ANNDistances, eps );
-
-  /** Set the ANNIndices and ANNDistances in the corresponding itk::Array's.
-   * Memory management is transfered to these itk::Array's, which have SmartPointers
-   * and therefore don't have to be regarded anymore. No deallocation of
-   * ANNIndices and ANNDistances is needed now.
+  /** Resize the output arrays. This is a no-op when the caller reuses the
+   * arrays for subsequent queries, so that no memory is allocated per search.
    */
-  ind.SetData(ANNIndices, k, true);
-  dists.SetData(ANNDistances, k, true);
+  ind.SetSize(k);
+  dists.SetSize(k);
 
-  /** Deallocate the temporary ANNQueryPoint. */
-  annDeallocPt(ANNQueryPoint);
+  /** The actual ANN search. ANN does not modify the query point, and keeps its
+   * search state in thread-local storage, so concurrent searches are safe.
+   */
+  ANNPointType ANNQueryPoint = const_cast<ANNPointType>(qp.data_block());
+  this->m_BinaryTreeAskDTree->annkPriSearch(ANNQueryPoint, k, ind.data_block(), dists.data_block(), eps);
 
 } // end Search
 
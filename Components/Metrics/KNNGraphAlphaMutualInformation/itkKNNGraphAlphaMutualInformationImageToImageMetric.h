@@ -127,6 +127,8 @@ public:
   using typename Superclass::FixedImageLimiterOutputType;
   using typename Superclass::MovingImageLimiterOutputType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::ThreaderType;
+  using typename Superclass::ThreadInfoType;
 
   /** Typedef's for storing multiple inputs. */
   using typename Superclass::FixedImageVectorType;
@@ -263,6 +265,14 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Get the graph lengths for each thread. */
+  inline void
+  ThreadedGetValue(ThreadIdType threadID) override;
+
+  /** Get the graph lengths and their derivatives for each thread. */
+  inline void
+  ThreadedGetValueAndDerivative(ThreadIdType threadID) override;
+
   /** Member variables. */
   BinaryKNNTreePointer m_BinaryKNNTreeFixed;
   BinaryKNNTreePointer m_BinaryKNNTreeMoving;
@@ -291,6 +301,61 @@ private:
   typedef Array2D<double>                         SpatialDerivativeType;
   typedef std::vector<SpatialDerivativeType>      SpatialDerivativeContainerType;
 
+  /** Typedef for accumulating the graph lengths. */
+  typedef typename NumericTraits<MeasureType>::AccumulateType AccumulateType;
+
+  /** Typedef for the multi-threading parameters of the superclass. */
+  using typename Superclass::MultiThreaderParameterType;
+
+  /** The list samples and derivative information that are shared, read-only,
+   * by all threads during a call to GetValue() or GetValueAndDerivative().
+   */
+  struct KNNGraphAlphaMutualInformationThreaderDataStruct
+  {
+    const ListSampleType *                        st_ListSampleFixed;
+    const ListSampleType *                        st_ListSampleMoving;
+    const ListSampleType *                        st_ListSampleJoint;
+    const TransformJacobianContainerType *        st_Jacobians;
+    const TransformJacobianIndicesContainerType * st_JacobiansIndices;
+    const SpatialDerivativeContainerType *        st_SpatialDerivatives;
+  };
+  mutable KNNGraphAlphaMutualInformationThreaderDataStruct m_KNNGraphAlphaMutualInformationThreaderData;
+
+  /** Generate the fixed, moving and joint kNN trees from the list samples,
+   * and connect them to the tree searchers. When multi-threading is switched on,
+   * the three trees are generated concurrently.
+   */
+  void
+  GenerateTreesAndConnectSearchers(const ListSamplePointer & listSampleFixed,
+                                   const ListSamplePointer & listSampleMoving,
+                                   const ListSamplePointer & listSampleJoint) const;
+
+  /** Helper function to generate the trees multi-threadedly. */
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  GenerateTreesThreaderCallback(void * arg);
+
+  /** Compute the range of query points [begin, end) of a thread. */
+  void
+  GetQueryPointRangeOfThread(ThreadIdType threadID, unsigned long & begin, unsigned long & end) const;
+
+  /** Search the nearest neighbours of the query points [begin, end), and add
+   * their graph lengths to sumG. The search is re-entrant, so this function
+   * may be called concurrently for disjoint ranges.
+   */
+  void
+  ComputeGraphLengths(const unsigned long begin, const unsigned long end, AccumulateType & sumG) const;
+
+  /** Search the nearest neighbours of the query points [begin, end), and add
+   * their graph lengths to sumG and the derivatives to contribution.
+   * This function may be called concurrently for disjoint ranges, as long as
+   * each thread uses its own contribution.
+   */
+  void
+  ComputeGraphLengthsAndDerivatives(const unsigned long begin,
+                                    const unsigned long end,
+                                    AccumulateType &    sumG,
+                                    DerivativeType &    contribution) const;
+
   /** This function takes the fixed image samples from the ImageSampler
    * and puts them in the listSampleFixed, together with the fixed feature
    * image samples. Also the corresponding moving image values and moving
@@ -325,22 +325,7 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * and connect them to the searchers.
    */
 
-  /** Generate the tree for the fixed image samples. */
-  this->m_BinaryKNNTreeFixed->SetSample(listSampleFixed);
-  this->m_BinaryKNNTreeFixed->GenerateTree();
-
-  /** Generate the tree for the moving image samples. */
-  this->m_BinaryKNNTreeMoving->SetSample(listSampleMoving);
-  this->m_BinaryKNNTreeMoving->GenerateTree();
-
-  /** Generate the tree for the joint image samples. */
-  this->m_BinaryKNNTreeJoint->SetSample(listSampleJoint);
-  this->m_BinaryKNNTreeJoint->GenerateTree();
-
-  /** Initialize tree searchers. */
-  this->m_BinaryKNNTreeSearcherFixed->SetBinaryTree(this->m_BinaryKNNTreeFixed);
-  this->m_BinaryKNNTreeSearcherMoving->SetBinaryTree(this->m_BinaryKNNTreeMoving);
-  this->m_BinaryKNNTreeSearcherJoint->SetBinaryTree(this->m_BinaryKNNTreeJoint);
+  this->GenerateTreesAndConnectSearchers(listSampleFixed, listSampleMoving, listSampleJoint);
 
   /**
    * *************** Estimate the \alpha MI ******************
@@ -375,77 +360,35 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * where d1 and d2 are the possibly different dimensions of the two feature sets.
    */
 
-  /** Temporary variables. */
-  typedef typename NumericTraits<MeasureType>::AccumulateType AccumulateType;
-  MeasurementVectorType                                       z_F, z_M, z_J;
-  IndexArrayType                                              indices_F, indices_M, indices_J;
-  DistanceArrayType                                           distances_F, distances_M, distances_J;
+  /** Share the list samples with the threads. */
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleFixed = listSampleFixed.GetPointer();
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleMoving = listSampleMoving.GetPointer();
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleJoint = listSampleJoint.GetPointer();
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_Jacobians = nullptr;
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_JacobiansIndices = nullptr;
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_SpatialDerivatives = nullptr;
 
-  MeasureType    H, G;
+  /** Loop over all query points, i.e. all samples, and sum the graph lengths. */
   AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
-
-  /** Get the size of the feature vectors. */
-  unsigned int fixedSize = this->GetNumberOfFixedImages();
-  unsigned int movingSize = this->GetNumberOfMovingImages();
-  unsigned int jointSize = fixedSize + movingSize;
-
-  /** Get the number of neighbours and \gamma. */
-  unsigned int k = this->m_BinaryKNNTreeSearcherFixed->GetKNearestNeighbors();
-  double       twoGamma = jointSize * (1.0 - this->m_Alpha);
-
-  /** Loop over all query points, i.e. all samples. */
-  for (unsigned long i = 0; i < this->m_NumberOfPixelsCounted; ++i)
+  if (!this->m_UseMultiThread)
   {
-    /** Get the i-th query point. */
-    listSampleFixed->GetMeasurementVector(i, z_F);
-    listSampleMoving->GetMeasurementVector(i, z_M);
-    listSampleJoint->GetMeasurementVector(i, z_J);
-
-    /** Search for the K nearest neighbours of the current query point. */
-    this->m_BinaryKNNTreeSearcherFixed->Search(z_F, indices_F, distances_F);
-    this->m_BinaryKNNTreeSearcherMoving->Search(z_M, indices_M, distances_M);
-    this->m_BinaryKNNTreeSearcherJoint->Search(z_J, indices_J, distances_J);
-
-    /** Add the distances between the points to get the total graph length.
-     * The outcommented implementation calculates: sum J/sqrt(F*M)
-     *
-    for ( unsigned int j = 0; j < K; j++ )
-    {
-    enumerator = std::sqrt( distsJ[ j ] );
-    denominator = std::sqrt( std::sqrt( distsF[ j ] ) * std::sqrt( distsM[ j ] ) );
-    if ( denominator > 1e-14 )
-    {
-    contribution += std::pow( enumerator / denominator, twoGamma );
-    }
-    }*/
-
-    /** Add the distances of all neighbours of the query point,
-     * for the three graphs:
-     * sum M / sqrt( sum F * sum M)
-     */
-
-    /** Variables to compute the measure. */
-    AccumulateType Gamma_F = NumericTraits<AccumulateType>::Zero;
-    AccumulateType Gamma_M = NumericTraits<AccumulateType>::Zero;
-    AccumulateType Gamma_J = NumericTraits<AccumulateType>::Zero;
+    this->ComputeGraphLengths(0, this->m_NumberOfPixelsCounted, sumG);
+  }
+  else
+  {
+    /** Launch the multi-threaded search. */
+    this->LaunchGetValueThreaderCallback();
 
-    /** Loop over the neighbours. */
-    for (unsigned int p = 0; p < k; ++p)
+    /** Gather the graph lengths from all threads. */
+    const ThreadIdType numberOfThreads = Self::GetNumberOfWorkUnits();
+    for (ThreadIdType i = 0; i < numberOfThreads; ++i)
     {
-      Gamma_F += std::sqrt(distances_F[p]);
-      Gamma_M += std::sqrt(distances_M[p]);
-      Gamma_J += std::sqrt(distances_J[p]);
-    } // end loop over the k neighbours
+      sumG += this->m_GetValuePerThreadVariables[i].st_Value;
 
-    /** Calculate the contribution of this query point. */
-    H = std::sqrt(Gamma_F * Gamma_M);
-    if (H > this->m_AvoidDivisionBy)
-    {
-      /** Compute some sums. */
-      G = Gamma_J / H;
-      sumG += std::pow(G, twoGamma);
+      /** Reset this variable for the next iteration. */
+      this->m_GetValuePerThreadVariables[i].st_Value = NumericTraits<MeasureType>::Zero;
     }
-  } // end looping over all query points
+  }
 
   /**
    * *************** Finally, calculate the metric value \alpha MI ******************
@@ -500,7 +443,7 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
 {
   /** Initialize some variables. */
   MeasureType measure = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
 
   /** Call non-thread-safe stuff, such as:
@@ -549,22 +492,7 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * and connect them to the searchers.
    */
 
-  /** Generate the tree for the fixed image samples. */
-  this->m_BinaryKNNTreeFixed->SetSample(listSampleFixed);
-  this->m_BinaryKNNTreeFixed->GenerateTree();
-
-  /** Generate the tree for the moving image samples. */
-  this->m_BinaryKNNTreeMoving->SetSample(listSampleMoving);
-  this->m_BinaryKNNTreeMoving->GenerateTree();
-
-  /** Generate the tree for the joint image samples. */
-  this->m_BinaryKNNTreeJoint->SetSample(listSampleJoint);
-  this->m_BinaryKNNTreeJoint->GenerateTree();
-
-  /** Initialize tree searchers. */
-  this->m_BinaryKNNTreeSearcherFixed->SetBinaryTree(this->m_BinaryKNNTreeFixed);
-  this->m_BinaryKNNTreeSearcherMoving->SetBinaryTree(this->m_BinaryKNNTreeMoving);
-  this->m_BinaryKNNTreeSearcherJoint->SetBinaryTree(this->m_BinaryKNNTreeJoint);
+  this->GenerateTreesAndConnectSearchers(listSampleFixed, listSampleMoving, listSampleJoint);
 
   /**
    * *************** Estimate the \alpha MI and its derivatives ******************
@@ -599,21 +527,355 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
    * where d1 and d2 are the possibly different dimensions of the two feature sets.
    */
 
-  /** Temporary variables. */
-  typedef typename NumericTraits<MeasureType>::AccumulateType AccumulateType;
-  MeasurementVectorType                                       z_F, z_M, z_J, z_M_ip, z_J_ip, diff_M, diff_J;
-  IndexArrayType                                              indices_F, indices_M, indices_J;
-  DistanceArrayType                                           distances_F, distances_M, distances_J;
-  MeasureType                                                 distance_F, distance_M, distance_J;
+  /** Share the list samples and the derivative information with the threads. */
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleFixed = listSampleFixed.GetPointer();
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleMoving = listSampleMoving.GetPointer();
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleJoint = listSampleJoint.GetPointer();
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_Jacobians = &jacobianContainer;
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_JacobiansIndices = &jacobianIndicesContainer;
+  this->m_KNNGraphAlphaMutualInformationThreaderData.st_SpatialDerivatives = &spatialDerivativesContainer;
+
+  /** Get the size of the joint feature vectors. */
+  const unsigned int jointSize = this->GetNumberOfFixedImages() + this->GetNumberOfMovingImages();
 
-  MeasureType    H, G, Gpow;
+  /** Loop over all query points, i.e. all samples, and sum the graph lengths
+   * and their derivatives.
+   */
   AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+  if (!this->m_UseMultiThread)
+  {
+    DerivativeType contribution(this->GetNumberOfParameters());
+    contribution.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+    this->ComputeGraphLengthsAndDerivatives(0, this->m_NumberOfPixelsCounted, sumG, contribution);
+
+    if (sumG > this->m_AvoidDivisionBy)
+    {
+      /** Compute the derivative (-2.0 * d = -jointSize). */
+      derivative = (static_cast<AccumulateType>(jointSize) / sumG) * contribution;
+    }
+  }
+  else
+  {
+    /** Launch the multi-threaded search. */
+    this->LaunchGetValueAndDerivativeThreaderCallback();
+
+    /** Gather the graph lengths from all threads. */
+    const ThreadIdType numberOfThreads = Self::GetNumberOfWorkUnits();
+    for (ThreadIdType i = 0; i < numberOfThreads; ++i)
+    {
+      sumG += this->m_GetValueAndDerivativePerThreadVariables[i].st_Value;
+
+      /** Reset this variable for the next iteration. */
+      this->m_GetValueAndDerivativePerThreadVariables[i].st_Value = NumericTraits<MeasureType>::Zero;
+    }
+
+    /** Accumulate the derivatives from all threads. This also resets the
+     * per-thread derivatives, so it is needed even when sumG is too small.
+     * The derivative is (-2.0 * d = -jointSize) / sumG * contribution.
+     */
+    const bool sumGIsValid = sumG > this->m_AvoidDivisionBy;
+    this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
+    this->m_ThreaderMetricParameters.st_NormalizationFactor =
+      sumGIsValid ? sumG / static_cast<AccumulateType>(jointSize) : NumericTraits<DerivativeValueType>::OneValue();
+    this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
+                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+    this->m_Threader->SingleMethodExecute();
+
+    if (!sumGIsValid)
+    {
+      derivative.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
+    }
+  }
+
+  /**
+   * *************** Finally, calculate the metric value and derivative ******************
+   */
+
+  /** Compute the value. */
+  double n, number;
+  if (sumG > this->m_AvoidDivisionBy)
+  {
+    /** Compute the measure. */
+    n = static_cast<double>(this->m_NumberOfPixelsCounted);
+    number = std::pow(n, this->m_Alpha);
+    measure = std::log(sumG / number) / (this->m_Alpha - 1.0);
+  }
+  value = -measure;
+
+} // end GetValueAndDerivative()
+
+
+/**
+ * ******************* GenerateTreesAndConnectSearchers *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GenerateTreesAndConnectSearchers(
+  const ListSamplePointer & listSampleFixed,
+  const ListSamplePointer & listSampleMoving,
+  const ListSamplePointer & listSampleJoint) const
+{
+  /** Set the fixed, moving and joint image samples. */
+  this->m_BinaryKNNTreeFixed->SetSample(listSampleFixed);
+  this->m_BinaryKNNTreeMoving->SetSample(listSampleMoving);
+  this->m_BinaryKNNTreeJoint->SetSample(listSampleJoint);
+
+  /** Generate the trees. These are independent, so they can be generated concurrently. */
+  if (!this->m_UseMultiThread)
+  {
+    this->m_BinaryKNNTreeFixed->GenerateTree();
+    this->m_BinaryKNNTreeMoving->GenerateTree();
+    this->m_BinaryKNNTreeJoint->GenerateTree();
+  }
+  else
+  {
+    this->m_Threader->SetSingleMethod(this->GenerateTreesThreaderCallback,
+                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+    this->m_Threader->SingleMethodExecute();
+  }
+
+  /** Initialize tree searchers. */
+  this->m_BinaryKNNTreeSearcherFixed->SetBinaryTree(this->m_BinaryKNNTreeFixed);
+  this->m_BinaryKNNTreeSearcherMoving->SetBinaryTree(this->m_BinaryKNNTreeMoving);
+  this->m_BinaryKNNTreeSearcherJoint->SetBinaryTree(this->m_BinaryKNNTreeJoint);
+
+} // end GenerateTreesAndConnectSearchers()
+
+
+/**
+ * **************** GenerateTreesThreaderCallback *******
+ */
+
+template <class TFixedImage, class TMovingImage>
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GenerateTreesThreaderCallback(void * arg)
+{
+  ThreadInfoType * infoStruct = static_cast<ThreadInfoType *>(arg);
+  ThreadIdType     threadId = infoStruct->WorkUnitID;
+  ThreadIdType     nrOfThreads = infoStruct->NumberOfWorkUnits;
+
+  MultiThreaderParameterType * temp = static_cast<MultiThreaderParameterType *>(infoStruct->UserData);
+  const Self *                 metric = static_cast<const Self *>(temp->st_Metric);
+
+  /** Distribute the three trees over the threads. */
+  const BinaryKNNTreePointer trees[3] = { metric->m_BinaryKNNTreeFixed,
+                                          metric->m_BinaryKNNTreeMoving,
+                                          metric->m_BinaryKNNTreeJoint };
+  for (ThreadIdType i = threadId; i < 3; i += nrOfThreads)
+  {
+    trees[i]->GenerateTree();
+  }
+
+  return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end GenerateTreesThreaderCallback()
+
+
+/**
+ * ******************* GetQueryPointRangeOfThread *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::GetQueryPointRangeOfThread(
+  ThreadIdType    threadId,
+  unsigned long & begin,
+  unsigned long & end) const
+{
+  const unsigned long numberOfQueryPoints = this->m_NumberOfPixelsCounted;
+  const unsigned long nrOfQueryPointsPerThread = static_cast<unsigned long>(
+    std::ceil(static_cast<double>(numberOfQueryPoints) / static_cast<double>(Self::GetNumberOfWorkUnits())));
+
+  begin = nrOfQueryPointsPerThread * threadId;
+  end = nrOfQueryPointsPerThread * (threadId + 1);
+  begin = (begin > numberOfQueryPoints) ? numberOfQueryPoints : begin;
+  end = (end > numberOfQueryPoints) ? numberOfQueryPoints : end;
+
+} // end GetQueryPointRangeOfThread()
+
+
+/**
+ * ******************* ThreadedGetValue *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValue(ThreadIdType threadId)
+{
+  /** Get the query points for this thread. */
+  unsigned long pos_begin, pos_end;
+  this->GetQueryPointRangeOfThread(threadId, pos_begin, pos_end);
+
+  /** Search the neighbours and sum the graph lengths. */
+  AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+  this->ComputeGraphLengths(pos_begin, pos_end, sumG);
+
+  /** Store the result for this thread. */
+  this->m_GetValuePerThreadVariables[threadId].st_Value = sumG;
+
+} // end ThreadedGetValue()
+
+
+/**
+ * ******************* ThreadedGetValueAndDerivative *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValueAndDerivative(
+  ThreadIdType threadId)
+{
+  /** Get the query points for this thread. */
+  unsigned long pos_begin, pos_end;
+  this->GetQueryPointRangeOfThread(threadId, pos_begin, pos_end);
+
+  /** Get a handle to the pre-allocated derivative for the current thread.
+   * The initialization is performed at the beginning of each resolution in
+   * InitializeThreadingParameters(), and at the end of each iteration in
+   * the accumulate function.
+   */
+  DerivativeType & contribution = this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
+
+  /** Search the neighbours and sum the graph lengths and their derivatives. */
+  AccumulateType sumG = NumericTraits<AccumulateType>::Zero;
+  this->ComputeGraphLengthsAndDerivatives(pos_begin, pos_end, sumG, contribution);
+
+  /** Store the result for this thread. */
+  this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Value = sumG;
+
+} // end ThreadedGetValueAndDerivative()
+
+
+/**
+ * ******************* ComputeGraphLengths *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::ComputeGraphLengths(
+  const unsigned long begin,
+  const unsigned long end,
+  AccumulateType &    sumG) const
+{
+  /** Get handles to the list samples. */
+  const ListSampleType * listSampleFixed = this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleFixed;
+  const ListSampleType * listSampleMoving = this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleMoving;
+  const ListSampleType * listSampleJoint = this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleJoint;
+
+  /** Temporary variables. These are local to the calling thread, and are reused
+   * for all its query points, so that the searches do not allocate memory.
+   */
+  MeasurementVectorType z_F, z_M, z_J;
+  IndexArrayType        indices_F, indices_M, indices_J;
+  DistanceArrayType     distances_F, distances_M, distances_J;
+
+  MeasureType H, G;
+
+  /** Get the size of the feature vectors. */
+  unsigned int fixedSize = this->GetNumberOfFixedImages();
+  unsigned int movingSize = this->GetNumberOfMovingImages();
+  unsigned int jointSize = fixedSize + movingSize;
+
+  /** Get the number of neighbours and \gamma. */
+  unsigned int k = this->m_BinaryKNNTreeSearcherFixed->GetKNearestNeighbors();
+  double       twoGamma = jointSize * (1.0 - this->m_Alpha);
+
+  /** Loop over the query points of this range. */
+  for (unsigned long i = begin; i < end; ++i)
+  {
+    /** Get the i-th query point. */
+    listSampleFixed->GetMeasurementVector(i, z_F);
+    listSampleMoving->GetMeasurementVector(i, z_M);
+    listSampleJoint->GetMeasurementVector(i, z_J);
+
+    /** Search for the K nearest neighbours of the current query point. */
+    this->m_BinaryKNNTreeSearcherFixed->Search(z_F, indices_F, distances_F);
+    this->m_BinaryKNNTreeSearcherMoving->Search(z_M, indices_M, distances_M);
+    this->m_BinaryKNNTreeSearcherJoint->Search(z_J, indices_J, distances_J);
+
+    /** Add the distances between the points to get the total graph length.
+     * The outcommented implementation calculates: sum J/sqrt(F*M)
+     *
+    for ( unsigned int j = 0; j < K; j++ )
+    {
+    enumerator = std::sqrt( distsJ[ j ] );
+    denominator = std::sqrt( std::sqrt( distsF[ j ] ) * std::sqrt( distsM[ j ] ) );
+    if ( denominator > 1e-14 )
+    {
+    contribution += std::pow( enumerator / denominator, twoGamma );
+    }
+    }*/
+
+    /** Add the distances of all neighbours of the query point,
+     * for the three graphs:
+     * sum M / sqrt( sum F * sum M)
+     */
+
+    /** Variables to compute the measure. */
+    AccumulateType Gamma_F = NumericTraits<AccumulateType>::Zero;
+    AccumulateType Gamma_M = NumericTraits<AccumulateType>::Zero;
+    AccumulateType Gamma_J = NumericTraits<AccumulateType>::Zero;
+
+    /** Loop over the neighbours. */
+    for (unsigned int p = 0; p < k; ++p)
+    {
+      Gamma_F += std::sqrt(distances_F[p]);
+      Gamma_M += std::sqrt(distances_M[p]);
+      Gamma_J += std::sqrt(distances_J[p]);
+    } // end loop over the k neighbours
+
+    /** Calculate the contribution of this query point. */
+    H = std::sqrt(Gamma_F * Gamma_M);
+    if (H > this->m_AvoidDivisionBy)
+    {
+      /** Compute some sums. */
+      G = Gamma_J / H;
+      sumG += std::pow(G, twoGamma);
+    }
+  } // end looping over all query points
+
+} // end ComputeGraphLengths()
+
+
+/**
+ * ******************* ComputeGraphLengthsAndDerivatives *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::ComputeGraphLengthsAndDerivatives(
+  const unsigned long begin,
+  const unsigned long end,
+  AccumulateType &    sumG,
+  DerivativeType &    contribution) const
+{
+  /** Get handles to the list samples. */
+  const ListSampleType * listSampleFixed = this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleFixed;
+  const ListSampleType * listSampleMoving = this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleMoving;
+  const ListSampleType * listSampleJoint = this->m_KNNGraphAlphaMutualInformationThreaderData.st_ListSampleJoint;
+
+  /** Temporary variables. These are local to the calling thread, and are reused
+   * for all its query points, so that the searches do not allocate memory.
+   */
+  MeasurementVectorType z_F, z_M, z_J, z_M_ip, z_J_ip, diff_M, diff_J;
+  IndexArrayType        indices_F, indices_M, indices_J;
+  DistanceArrayType     distances_F, distances_M, distances_J;
+  MeasureType           distance_F, distance_M, distance_J;
+
+  MeasureType H, G, Gpow;
 
-  DerivativeType contribution(this->GetNumberOfParameters());
-  contribution.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
   DerivativeType dGamma_M(this->GetNumberOfParameters());
   DerivativeType dGamma_J(this->GetNumberOfParameters());
 
+  /** Get handles to the derivative information. */
+  const TransformJacobianContainerType & jacobianContainer =
+    *this->m_KNNGraphAlphaMutualInformationThreaderData.st_Jacobians;
+  const TransformJacobianIndicesContainerType & jacobianIndicesContainer =
+    *this->m_KNNGraphAlphaMutualInformationThreaderData.st_JacobiansIndices;
+  const SpatialDerivativeContainerType & spatialDerivativesContainer =
+    *this->m_KNNGraphAlphaMutualInformationThreaderData.st_SpatialDerivatives;
+
   /** Get the size of the feature vectors. */
   unsigned int fixedSize = this->GetNumberOfFixedImages();
   unsigned int movingSize = this->GetNumberOfMovingImages();
@@ -623,8 +885,8 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
   unsigned int k = this->m_BinaryKNNTreeSearcherFixed->GetKNearestNeighbors();
   double       twoGamma = jointSize * (1.0 - this->m_Alpha);
 
-  /** Loop over all query points, i.e. all samples. */
-  for (unsigned long i = 0; i < this->m_NumberOfPixelsCounted; ++i)
+  /** Loop over the query points of this range. */
+  for (unsigned long i = begin; i < end; ++i)
   {
     /** Get the i-th query point. */
     listSampleFixed->GetMeasurementVector(i, z_F);
@@ -703,25 +965,7 @@ KNNGraphAlphaMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Get
 
   } // end looping over all query points
 
-  /**
-   * *************** Finally, calculate the metric value and derivative ******************
-   */
-
-  /** Compute the value. */
-  double n, number;
-  if (sumG > this->m_AvoidDivisionBy)
-  {
-    /** Compute the measure. */
-    n = static_cast<double>(this->m_NumberOfPixelsCounted);
-    number = std::pow(n, this->m_Alpha);
-    measure = std::log(sumG / number) / (this->m_Alpha - 1.0);
-
-    /** Compute the derivative (-2.0 * d = -jointSize). */
-    derivative = (static_cast<AccumulateType>(jointSize) / sumG) * contribution;
-  }
-  value = -measure;
-
-} // end GetValueAndDerivative()
+} // end ComputeGraphLengthsAndDerivatives()
 
 
 /**
@@ -23,7 +23,7 @@
 #include "itkNeighborhoodOperatorImageFilter.h"
 #include "itkPoint.h"
 #include "itkCastImageFilter.h"
-#include "itkResampleImageFilter.h"
+#include "itkRayCastResampleImageFilter.h"
 #include "itkOptimizer.h"
 #include "itkAdvancedCombinationTransform.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
@@ -95,8 +95,9 @@ public:
   typedef itk::Image<FixedImagePixelType, Self::FixedImageDimension>                  TransformedMovingImageType;
   typedef itk::Image<unsigned char, Self::FixedImageDimension>                        MaskImageType;
   typedef typename MaskImageType::Pointer                                             MaskImageTypePointer;
-  typedef itk::ResampleImageFilter<MovingImageType, TransformedMovingImageType>       TransformMovingImageFilterType;
-  typedef typename TransformMovingImageFilterType::Pointer                            TransformMovingImageFilterPointer;
+  typedef itk::RayCastResampleImageFilter<MovingImageType, TransformedMovingImageType>
+                                                           TransformMovingImageFilterType;
+  typedef typename TransformMovingImageFilterType::Pointer TransformMovingImageFilterPointer;
   typedef typename itk::AdvancedRayCastInterpolateImageFunction<MovingImageType, ScalarType> RayCastInterpolatorType;
   typedef typename RayCastInterpolatorType::Pointer                                          RayCastInterpolatorPointer;
 
@@ -180,7 +180,7 @@ NormalizedGradientCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Comp
     /** if fixedMask is given */
     if (!this->m_FixedImageMask.IsNull())
     {
-      if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+      if (this->IsInsideFixedMask(point))
       {
         sampleOK = true;
       }
@@ -256,7 +256,7 @@ NormalizedGradientCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Comp
     /** if fixedMask is given */
     if (!this->m_FixedImageMask.IsNull())
     {
-      if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+      if (this->IsInsideFixedMask(point))
       {
         sampleOK = true;
       }
@@ -347,7 +347,7 @@ NormalizedGradientCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Comp
     /** if fixedMask is given */
     if (!this->m_FixedImageMask.IsNull())
     {
-      if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+      if (this->IsInsideFixedMask(point))
       {
         sampleOK = true;
       }
@@ -455,7 +455,7 @@ NormalizedGradientCorrelationImageToImageMetric<TFixedImage, TMovingImage>::GetD
   TransformParametersType testPoint;
   testPoint = parameters;
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
-  derivative = DerivativeType(numberOfParameters);
+  derivative.SetSize(numberOfParameters);
 
   for (unsigned int i = 0; i < numberOfParameters; ++i)
   {
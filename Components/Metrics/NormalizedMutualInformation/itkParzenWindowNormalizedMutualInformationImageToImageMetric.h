@@ -177,6 +177,7 @@ protected:
   using typename Superclass::JointPDFDerivativesRegionType;
   using typename Superclass::JointPDFDerivativesSizeType;
   using typename Superclass::ParzenValueContainerType;
+  using typename Superclass::ParzenWindowValuesType;
   using typename Superclass::KernelFunctionType;
   using typename Superclass::NonZeroJacobianIndicesType;
 
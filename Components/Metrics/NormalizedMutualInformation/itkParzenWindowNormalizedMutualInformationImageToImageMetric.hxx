@@ -179,7 +179,7 @@ ParzenWindowNormalizedMutualInformationImageToImageMetric<TFixedImage, TMovingIm
 {
   /** Initialize some variables */
   value = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<double>::ZeroValue());
 
   /** Construct the JointPDF, JointPDFDerivatives, and Alpha. */
@@ -426,7 +426,7 @@ PCAMetric<TFixedImage, TMovingImage>::GetValueAndDerivative(const TransformParam
   const unsigned int P = this->GetNumberOfParameters();
   this->m_NumberOfPixelsCounted = 0;
   MeasureType measure = NumericTraits<MeasureType>::Zero;
-  derivative = DerivativeType(P);
+  derivative.SetSize(P);
   derivative.Fill(NumericTraits<DerivativeValueType>::Zero);
 
   /** Make sure the transform parameters are up to date. */
@@ -22,7 +22,7 @@
 
 #include "itkPoint.h"
 #include "itkCastImageFilter.h"
-#include "itkResampleImageFilter.h"
+#include "itkRayCastResampleImageFilter.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkSubtractImageFilter.h"
 #include "itkOptimizer.h"
@@ -111,8 +111,9 @@ public:
   typedef typename CombinationTransformType::Pointer                                  CombinationTransformPointer;
   typedef typename itk::AdvancedRayCastInterpolateImageFunction<MovingImageType, ScalarType> RayCastInterpolatorType;
   typedef typename RayCastInterpolatorType::Pointer                                          RayCastInterpolatorPointer;
-  typedef itk::ResampleImageFilter<MovingImageType, TransformedMovingImageType> TransformMovingImageFilterType;
-  typedef typename TransformMovingImageFilterType::Pointer                      TransformMovingImageFilterPointer;
+  typedef itk::RayCastResampleImageFilter<MovingImageType, TransformedMovingImageType>
+                                                           TransformMovingImageFilterType;
+  typedef typename TransformMovingImageFilterType::Pointer TransformMovingImageFilterPointer;
   typedef itk::RescaleIntensityImageFilter<TransformedMovingImageType, TransformedMovingImageType>
                                                             RescaleIntensityImageFilterType;
   typedef typename RescaleIntensityImageFilterType::Pointer RescaleIntensityImageFilterPointer;
@@ -174,7 +174,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIFixed()
     /** if fixedMask is given */
     if (!this->m_FixedImageMask.IsNull())
     {
-      if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+      if (this->IsInsideFixedMask(point))
       {
         sampleOK = true;
       }
@@ -285,7 +285,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::ComputePIDiff(con
     /** if fixedMask is given */
     if (!this->m_FixedImageMask.IsNull())
     {
-      if (this->m_FixedImageMask->IsInsideInWorldSpace(point))
+      if (this->IsInsideFixedMask(point))
       {
         sampleOK = true;
       }
@@ -399,7 +399,7 @@ PatternIntensityImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(con
   TransformParametersType testPoint;
   testPoint = parameters;
   const unsigned int numberOfParameters = this->GetNumberOfParameters();
-  derivative = DerivativeType(numberOfParameters);
+  derivative.SetSize(numberOfParameters);
 
   for (unsigned int i = 0; i < numberOfParameters; ++i)
   {
@@ -902,7 +902,7 @@ TransformRigidityPenaltyTerm<TFixedImage, TScalarType>::GetValueAndDerivative(co
   this->m_PropernessConditionValue = NumericTraits<MeasureType>::Zero;
 
   /** Set output values to zero. */
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<MeasureType>::ZeroValue());
 
   /** Call non-thread-safe stuff, such as:
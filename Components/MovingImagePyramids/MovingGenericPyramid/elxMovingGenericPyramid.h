@@ -60,6 +60,13 @@ namespace elastix
  * ImagePyramidUseShrinkImageFilter: Flag to specify if the ShrinkingImageFilter is used for rescaling the image, or the
  * ResampleImageFilter. Shrinker is faster.\n example: <tt>(ImagePyramidUseShrinkImageFilter "true")</tt>\n Default
  * false, so by default the resampler is used.
+ * \parameter ImagePyramidUseCascade: Flag to specify if the resolution levels are computed as
+ *    a cascade, from fine to coarse, where each level is derived from the next finer level.
+ *    Smoothing and rescaling are then fused in one separable Gaussian kernel, which is only
+ *    evaluated at the voxels that remain after rescaling. Faster for large images and many
+ *    resolutions. Has no effect on the levels when ComputePyramidImagesPerResolution is true.\n
+ *    example: <tt>(ImagePyramidUseCascade "true")</tt>\n
+ *    Default false.
  *
  * \ingroup ImagePyramids
  */
@@ -151,6 +151,13 @@ MovingGenericPyramid<TElastix>::SetMovingSchedule(void)
   this->m_Configuration->ReadParameter(computeThisResolution, "ComputePyramidImagesPerResolution", 0, false);
   this->SetComputeOnlyForCurrentLevel(computeThisResolution);
 
+  /** Decide whether or not to compute the pyramid images as a cascade, where
+   * each level is derived from the next finer level.
+   */
+  bool useCascade = false;
+  this->m_Configuration->ReadParameter(useCascade, "ImagePyramidUseCascade", 0, false);
+  this->SetUseCascade(useCascade);
+
 } // end SetMovingSchedule()
 
 
@@ -118,6 +118,9 @@ AdaGrad<TElastix>::BeforeEachResolution(void)
     maximumNumberOfIterations, "MaximumNumberOfIterations", this->GetComponentLabel(), level, 0);
   this->SetNumberOfIterations(maximumNumberOfIterations);
 
+  /** Set the convergence check of this resolution, see ConvergenceWindowSize. */
+  this->InitializeConvergenceCheck();
+
   /** Set the gain parameter A. */
   double A = 20.0;
   this->GetConfiguration()->ReadParameter(A, "SP_A", this->GetComponentLabel(), level, 0);
@@ -309,6 +312,13 @@ AdaGrad<TElastix>::AfterEachIteration(void)
     this->SelectNewSamples();
   }
 
+  /** Stop the resolution when the metric value no longer decreases significantly. */
+  if (this->HasConverged(this->GetValue()))
+  {
+    this->m_StopCondition = NoSignificantProgress;
+    this->StopOptimization();
+  }
+
 } // end AfterEachIteration()
 
 
@@ -327,7 +337,8 @@ AdaGrad<TElastix>::AfterEachResolution(void)
    * typedef enum {
    *   MaximumNumberOfIterations,
    *   MetricError,
-   *   MinimumStepSize } StopConditionType;
+   *   MinimumStepSize,
+   *   NoSignificantProgress } StopConditionType;
    */
   std::string stopcondition;
 
@@ -345,6 +356,10 @@ AdaGrad<TElastix>::AfterEachResolution(void)
       stopcondition = "The minimum step length has been reached";
       break;
 
+    case NoSignificantProgress:
+      stopcondition = this->GetConvergenceStopCondition();
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
@@ -415,31 +430,21 @@ template <class TElastix>
 void
 AdaGrad<TElastix>::AdvanceOneStep(void)
 {
-  /** Get space dimension. */
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
   /** Compute and set the learning rate. */
   double lamda = this->GetParam_a() / (1.0 + this->Superclass1::GetCurrentTime() / this->GetParam_A());
   this->SetLearningRate(lamda);
 
-  DerivativeType & searchDirection = this->m_SearchDirection;
-
-  /** Get a reference to the previously allocated newPosition. */
-  ParametersType & newPosition = this->m_ScaledCurrentPosition;
-
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
+  /** Accumulate the squared gradient, and update the search direction and
+   * the position, in place and in a single pass.
+   */
   const double eta = 1e-14;
   const double lamda2 = lamda * this->m_NoiseFactor;
-  //  const double lamda2 = 0.01;
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    this->m_PreconditionVector[j] += this->m_Gradient[j] * this->m_Gradient[j];
-    searchDirection[j] = this->m_Gradient[j] / (std::sqrt(this->m_PreconditionVector[j] + eta));
-    newPosition[j] = currentPosition[j] - lamda2 * searchDirection[j];
-  }
+  this->m_ParameterUpdateKernel->AdaptiveStep(this->m_ScaledCurrentPosition,
+                                              -lamda2,
+                                              this->m_PreconditionVector,
+                                              this->m_Gradient,
+                                              this->m_SearchDirection,
+                                              eta);
 
   this->Superclass1::UpdateCurrentTime();
   this->InvokeEvent(itk::IterationEvent());
@@ -23,6 +23,7 @@
 
 #include "itkComputeJacobianTerms.h"            // For  ASGD step size
 #include "itkComputeDisplacementDistribution.h" // For FASGD step size
+#include "itkAdaptiveSampleSizeSchedule.h"
 #include "elxProgressCommand.h"
 #include "itkAdvancedTransform.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
@@ -73,6 +74,7 @@ namespace elastix
  *    Default/recommended value: 500. When you are in a hurry, you may go down to 250 for example.
  *    When you have plenty of time, and want to be absolutely sure of the best results, a setting
  *    of 2000 is reasonable. In general, 500 gives satisfactory results.
+ * \parameter ConvergenceWindowSize and ConvergenceSignificance: see OptimizerBase.
  * \parameter MaximumNumberOfSamplingAttempts: The maximum number of sampling attempts. Sometimes
  *   not enough corresponding samples can be drawn, upon which an exception is thrown. With this
  *   parameter it is possible to try to draw another set of samples. \n
@@ -182,6 +184,31 @@ namespace elastix
  *   The parameter can be specified for each resolution, or for all resolutions at once.\n
  *   example: <tt>(NoiseCompensation "true")</tt>\n
  *   Default/recommended: true.
+ * \parameter AdaptiveNumberOfSpatialSamples: Whether to adapt the number of spatial samples during
+ *   the optimization. A resolution then starts with few samples, and takes more when the noise of the
+ *   gradient grows relative to the gradient itself, as it does towards convergence. The noise is
+ *   estimated from the inner products of subsequent gradients, which also drive the adaptive step
+ *   sizes, and calibrated by the gradient measurements of the AutomaticParameterEstimation.
+ *   Requires (NewSamplesEveryIteration "true") and (UseAdaptiveStepSizes "true").
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(AdaptiveNumberOfSpatialSamples "true")</tt>\n
+ *   Default: "false".
+ * \parameter MinimumSpatialSamplesFactor: The number of samples of the first iteration, as a factor
+ *   of the NumberOfSpatialSamples of the sampler. Only used with AdaptiveNumberOfSpatialSamples.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(MinimumSpatialSamplesFactor 0.25)</tt>\n
+ *   Default: 0.25.
+ * \parameter MaximumSpatialSamplesFactor: The largest number of samples of an iteration, as a factor
+ *   of the NumberOfSpatialSamples of the sampler. Only used with AdaptiveNumberOfSpatialSamples.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(MaximumSpatialSamplesFactor 4.0)</tt>\n
+ *   Default: 4.0.
+ * \parameter SpatialSamplesBudgetFactor: Caps the total number of samples of a resolution at this
+ *   factor times MaximumNumberOfIterations times NumberOfSpatialSamples. Only used with
+ *   AdaptiveNumberOfSpatialSamples.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(SpatialSamplesBudgetFactor 0.5)</tt>\n
+ *   Default: 1.0, so that a resolution never evaluates more samples than with a fixed number.
  *
  * \todo: this class contains a lot of functional code, which actually does not belong here.
  *
@@ -403,6 +430,13 @@ protected:
   virtual void
   AddRandomPerturbation(ParametersType & parameters, double sigma);
 
+  /** Calls the superclass' implementation, and then chooses the number of
+   * samples of the next iteration, when AdaptiveNumberOfSpatialSamples is used.
+   * It only resizes the samplers: AfterEachIteration() selects the new samples.
+   */
+  void
+  UpdateCurrentTime(void) override;
+
 private:
   elxOverrideGetSelfMacro;
 
@@ -427,6 +461,10 @@ private:
   /** The flag of using noise compensation. */
   bool m_UseNoiseCompensation;
   bool m_OriginalButSigmoidToDefault;
+
+  /** The number of samples of each iteration, see AdaptiveNumberOfSpatialSamples. */
+  bool                                     m_UseAdaptiveNumberOfSpatialSamples{ false };
+  itk::AdaptiveSampleSizeSchedule::Pointer m_SampleSizeSchedule{ itk::AdaptiveSampleSizeSchedule::New() };
 };
 
 } // end namespace elastix
@@ -106,6 +106,41 @@ AdaptiveStochasticGradientDescent<TElastix>::BeforeEachResolution(void)
     maximumNumberOfIterations, "MaximumNumberOfIterations", this->GetComponentLabel(), level, 0);
   this->SetNumberOfIterations(maximumNumberOfIterations);
 
+  /** Set the convergence check of this resolution, see ConvergenceWindowSize. */
+  this->InitializeConvergenceCheck();
+
+  /** Set whether the number of samples adapts to the noise of the gradient; default: false. */
+  this->m_UseAdaptiveNumberOfSpatialSamples = false;
+  this->GetConfiguration()->ReadParameter(this->m_UseAdaptiveNumberOfSpatialSamples,
+                                          "AdaptiveNumberOfSpatialSamples",
+                                          this->GetComponentLabel(),
+                                          level,
+                                          0);
+  if (this->m_UseAdaptiveNumberOfSpatialSamples && !this->GetNewSamplesEveryIteration())
+  {
+    xl::xout["warning"] << "WARNING: AdaptiveNumberOfSpatialSamples is turned off, "
+                        << "because NewSamplesEveryIteration is not set to \"true\"." << std::endl;
+    this->m_UseAdaptiveNumberOfSpatialSamples = false;
+  }
+  if (this->m_UseAdaptiveNumberOfSpatialSamples)
+  {
+    double minimumSpatialSamplesFactor = 0.25;
+    double maximumSpatialSamplesFactor = 4.0;
+    double spatialSamplesBudgetFactor = 1.0;
+    this->GetConfiguration()->ReadParameter(
+      minimumSpatialSamplesFactor, "MinimumSpatialSamplesFactor", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(
+      maximumSpatialSamplesFactor, "MaximumSpatialSamplesFactor", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(
+      spatialSamplesBudgetFactor, "SpatialSamplesBudgetFactor", this->GetComponentLabel(), level, 0);
+    this->m_SampleSizeSchedule->SetMinimumRelativeNumberOfSamples(minimumSpatialSamplesFactor);
+    this->m_SampleSizeSchedule->SetMaximumRelativeNumberOfSamples(maximumSpatialSamplesFactor);
+    this->m_SampleSizeSchedule->SetRelativeSampleBudget(spatialSamplesBudgetFactor);
+
+    /** Unknown until the automatic parameter estimation measures it. */
+    this->m_SampleSizeSchedule->SetReferenceNoiseToSignalRatio(0.0);
+  }
+
   /** Set the gain parameter A. */
   double A = 20.0;
   this->GetConfiguration()->ReadParameter(A, "SP_A", this->GetComponentLabel(), level, 0);
@@ -285,6 +320,13 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachIteration(void)
     this->SelectNewSamples();
   }
 
+  /** Stop the resolution when the metric value no longer decreases significantly. */
+  if (this->HasConverged(this->GetValue()))
+  {
+    this->m_StopCondition = NoSignificantProgress;
+    this->StopOptimization();
+  }
+
 } // end AfterEachIteration()
 
 
@@ -303,7 +345,8 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachResolution(void)
    * typedef enum {
    *   MaximumNumberOfIterations,
    *   MetricError,
-   *   MinimumStepSize } StopConditionType;
+   *   MinimumStepSize,
+   *   NoSignificantProgress } StopConditionType;
    */
   std::string stopcondition;
 
@@ -321,6 +364,10 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachResolution(void)
       stopcondition = "The minimum step length has been reached";
       break;
 
+    case NoSignificantProgress:
+      stopcondition = this->GetConvergenceStopCondition();
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
@@ -329,6 +376,16 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachResolution(void)
   /** Print the stopping condition. */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
 
+  /** Print the number of samples, relative to the NumberOfSpatialSamples. */
+  if (this->m_UseAdaptiveNumberOfSpatialSamples && this->m_SampleSizeSchedule->GetNumberOfCompletedIterations() > 0)
+  {
+    elxout << "Adaptive number of spatial samples: on average "
+           << this->m_SampleSizeSchedule->GetTotalRelativeNumberOfSamples() /
+                this->m_SampleSizeSchedule->GetNumberOfCompletedIterations()
+           << ", finally " << this->m_SampleSizeSchedule->GetRelativeNumberOfSamples()
+           << " times NumberOfSpatialSamples." << std::endl;
+  }
+
   /** Store the used parameters, for later printing to screen. */
   SettingsType settings;
   settings.a = this->GetParam_a();
@@ -415,6 +472,26 @@ AdaptiveStochasticGradientDescent<TElastix>::ResumeOptimization(void)
     this->m_AutomaticParameterEstimationDone = true;
   }
 
+  /** Start the adaptive number of samples only now, because the automatic parameter
+   * estimation measures the noise with the NumberOfSpatialSamples of the samplers,
+   * and may turn off the adaptive step sizes, whose inner products it relies on.
+   */
+  if (this->m_UseAdaptiveNumberOfSpatialSamples && this->GetCurrentIteration() == 0)
+  {
+    if (this->GetUseAdaptiveStepSizes())
+    {
+      this->m_SampleSizeSchedule->Initialize(this->GetNumberOfIterations());
+      this->SetRelativeNumberOfSamples(this->m_SampleSizeSchedule->GetRelativeNumberOfSamples());
+      this->SelectNewSamples();
+    }
+    else
+    {
+      xl::xout["warning"] << "WARNING: AdaptiveNumberOfSpatialSamples is turned off, "
+                          << "because UseAdaptiveStepSizes is not \"true\"." << std::endl;
+      this->m_UseAdaptiveNumberOfSpatialSamples = false;
+    }
+  }
+
   this->Superclass1::ResumeOptimization();
 
 } // end ResumeOptimization()
@@ -594,6 +671,10 @@ AdaptiveStochasticGradientDescent<TElastix>::AutomaticParameterEstimationOrigina
   }
   this->SampleGradients(this->GetScaledCurrentPosition(), sigma4, gg, ee);
   timer3.Stop();
+  if (gg > 1e-14)
+  {
+    this->m_SampleSizeSchedule->SetReferenceNoiseToSignalRatio(ee / gg);
+  }
   elxout << "  Sampling the gradients took " << Conversion::SecondsToDHMS(timer3.GetMean(), 6) << std::endl;
 
   /** Determine parameter settings. */
@@ -734,6 +815,10 @@ AdaptiveStochasticGradientDescent<TElastix>::AutomaticParameterEstimationUsingDi
       sigma4 = sigma4factor * delta / std::sqrt(maxJJ);
     }
     this->SampleGradients(this->GetScaledCurrentPosition(), sigma4, gg, ee);
+    if (gg > 1e-14)
+    {
+      this->m_SampleSizeSchedule->SetReferenceNoiseToSignalRatio(ee / gg);
+    }
 
     const double noisefactor = gg / (gg + ee + 1e-14);
     a = delta * std::pow(A + 1.0, alpha) / (jacg + 1e-14) * noisefactor;
@@ -1044,6 +1129,32 @@ AdaptiveStochasticGradientDescent<TElastix>::AddRandomPerturbation(ParametersTyp
 } // end AddRandomPerturbation()
 
 
+/**
+ * ***************** UpdateCurrentTime ***********************
+ */
+
+template <class TElastix>
+void
+AdaptiveStochasticGradientDescent<TElastix>::UpdateCurrentTime(void)
+{
+  this->Superclass1::UpdateCurrentTime();
+
+  /** Choose the number of samples of the next iteration, from the inner product of
+   * the last two gradients that the superclass just computed. The samples themselves
+   * are drawn once, by AfterEachIteration(), as NewSamplesEveryIteration is "true".
+   */
+  if (this->m_UseAdaptiveNumberOfSpatialSamples)
+  {
+    if (this->GetCurrentIteration() > 0)
+    {
+      this->m_SampleSizeSchedule->AddGradient(this->GetGradientInnerProduct(), this->GetGradient().squared_magnitude());
+    }
+    this->SetRelativeNumberOfSamples(this->m_SampleSizeSchedule->AdvanceIteration());
+  }
+
+} // end UpdateCurrentTime()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxAdaptiveStochasticGradientDescent_hxx
@@ -54,14 +54,17 @@ AdaptiveStochasticGradientDescentOptimizer::UpdateCurrentTime(void)
       const double beta = this->GetSigmoidScale() * std::log(-this->GetSigmoidMax() / this->GetSigmoidMin());
       sigmoid.SetBeta(beta);
 
-      /** Formula (2) in Cruz */
-      const double inprod = inner_product(this->m_PreviousGradient, this->GetGradient());
-      this->m_CurrentTime += sigmoid(-inprod);
+      /** Formula (2) in Cruz, fused with saving for the next iteration */
+      this->m_GradientInnerProduct = this->m_ParameterUpdateKernel->InnerProductAndAssign(
+        this->m_PreviousGradient, this->GetGradient(), this->GetGradient());
+      this->m_CurrentTime += sigmoid(-this->m_GradientInnerProduct);
       this->m_CurrentTime = std::max(0.0, this->m_CurrentTime);
     }
-
-    /** Save for next iteration */
-    this->m_PreviousGradient = this->GetGradient();
+    else
+    {
+      /** Save for next iteration */
+      this->m_PreviousGradient = this->GetGradient();
+    }
   }
   else
   {
@@ -114,6 +114,11 @@ public:
   itkSetMacro(SigmoidScale, double);
   itkGetConstMacro(SigmoidScale, double);
 
+  /** Get the inner product of the gradient and the previous gradient, as computed
+   * by the last UpdateCurrentTime(). Only computed when UseAdaptiveStepSizes is true,
+   * and from the second iteration on. */
+  itkGetConstMacro(GradientInnerProduct, double);
+
 protected:
   AdaptiveStochasticGradientDescentOptimizer();
   ~AdaptiveStochasticGradientDescentOptimizer() override = default;
@@ -141,6 +146,9 @@ private:
   double m_SigmoidMax{ 1.0 };
   double m_SigmoidMin{ -0.8 };
   double m_SigmoidScale{ 1e-8 };
+
+  /** The inner product of the last two gradients. */
+  double m_GradientInnerProduct{ 0.0 };
 };
 
 } // end namespace itk
@@ -146,6 +146,9 @@ AdaptiveStochasticLBFGS<TElastix>::BeforeEachResolution(void)
   this->m_OutsideIterations = maximumNumberOfIterations;
   this->SetNumberOfIterations(this->m_OutsideIterations);
 
+  /** Set the convergence check of this resolution, see ConvergenceWindowSize. */
+  this->InitializeConvergenceCheck();
+
   /** Set the numberOfInnerLoopSamples. */
   SizeValueType numberOfInnerLoopSamples = 10;
   this->GetConfiguration()->ReadParameter(
@@ -362,6 +365,13 @@ AdaptiveStochasticLBFGS<TElastix>::AfterEachIteration(void)
     this->SelectNewSamples();
   }
 
+  /** Stop the resolution when the metric value no longer decreases significantly. */
+  if (this->HasConverged(this->GetValue()))
+  {
+    this->m_StopCondition = NoSignificantProgress;
+    this->StopOptimization();
+  }
+
 } // end AfterEachIteration()
 
 
@@ -380,7 +390,8 @@ AdaptiveStochasticLBFGS<TElastix>::AfterEachResolution(void)
    * typedef enum {
    *   MaximumNumberOfIterations,
    *   MetricError,
-   *   MinimumStepSize } StopConditionType;
+   *   MinimumStepSize,
+   *   NoSignificantProgress } StopConditionType;
    */
   std::string stopcondition;
 
@@ -406,6 +417,10 @@ AdaptiveStochasticLBFGS<TElastix>::AfterEachResolution(void)
       stopcondition = "The last step size was (nearly) zero";
       break;
 
+    case NoSignificantProgress:
+      stopcondition = this->GetConvergenceStopCondition();
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
@@ -522,21 +537,8 @@ AdaptiveStochasticLBFGS<TElastix>::LBFGSUpdate(void)
 {
   itkDebugMacro("LBFGSUpdate");
 
-  /** Get space dimension. */
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
-  /** Get a reference to the previously allocated newPosition. */
-  ParametersType & newPosition = this->m_ScaledCurrentPosition;
-
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
-  const double learningRate = this->GetLearningRate();
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    newPosition[j] = currentPosition[j] + learningRate * this->m_SearchDir[j];
-  }
+  /** Update the position in place, along the search direction. */
+  this->m_ParameterUpdateKernel->Step(this->m_ScaledCurrentPosition, this->GetLearningRate(), this->m_SearchDir);
 
   this->InvokeEvent(itk::IterationEvent());
 } // end LBFGSUpdate()
@@ -552,21 +554,8 @@ AdaptiveStochasticLBFGS<TElastix>::AdvanceOneStep(void)
 {
   itkDebugMacro("AdvanceOneStep");
 
-  /** Get space dimension. */
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
-  /** Get a reference to the previously allocated newPosition. */
-  ParametersType & newPosition = this->m_ScaledCurrentPosition;
-
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
-  const double learningRate = this->GetLearningRate();
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    newPosition[j] = currentPosition[j] - learningRate * this->m_Gradient[j];
-  }
+  /** Update the position in place, along the negative gradient. */
+  this->m_ParameterUpdateKernel->Step(this->m_ScaledCurrentPosition, -this->GetLearningRate(), this->m_Gradient);
 
   this->InvokeEvent(itk::IterationEvent());
 
@@ -629,9 +618,6 @@ AdaptiveStochasticLBFGS<TElastix>::ResumeOptimization(void)
   ParametersType previousCurvaturePosition = this->GetScaledCurrentPosition();
   ParametersType meanCurrentCurvaturePosition;
 
-  ParametersType s;
-  DerivativeType y;
-
   /** Getting pointers to the samplers. */
   const unsigned int                   M = this->GetElastix()->GetNumberOfMetrics();
   std::vector<ImageSamplerBasePointer> originalSampler(M);
@@ -694,7 +680,10 @@ AdaptiveStochasticLBFGS<TElastix>::ResumeOptimization(void)
       this->SetLearningRate(this->Superclass1::Compute_a(this->Superclass1::GetCurrentTime()));
 
       /** Perform gradient descent. */
-      this->AdvanceOneStep();
+      {
+        const itk::PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+        this->AdvanceOneStep();
+      }
 
       /** Update the time. */
       this->Superclass1::UpdateCurrentTime();
@@ -753,7 +742,10 @@ AdaptiveStochasticLBFGS<TElastix>::ResumeOptimization(void)
       //       }
 
       /** Update the position using the quasi-Newton method. */
-      this->LBFGSUpdate();
+      {
+        const itk::PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+        this->LBFGSUpdate();
+      }
 
     } // end if update rule
 
@@ -789,9 +781,16 @@ AdaptiveStochasticLBFGS<TElastix>::ResumeOptimization(void)
         this->GetElastix()->GetElxMetricBase(m)->SetAdvancedMetricImageSampler(originalSampler[m]);
       }
 
-      /** Compute s and y and store them. */
-      s = meanCurrentCurvaturePosition - previousCurvaturePosition;
-      y = meanCurrentCurvatureGradient - previousCurvatureGradient;
+      /** Compute s and y in place, in the memory of m_S and m_Y, and store them. */
+      ParametersType & s = this->m_S[this->m_CurrentT];
+      DerivativeType & y = this->m_Y[this->m_CurrentT];
+      s.SetSize(spaceDimension);
+      y.SetSize(spaceDimension);
+      for (SizeValueType j = 0; j < spaceDimension; ++j)
+      {
+        s[j] = meanCurrentCurvaturePosition[j] - previousCurvaturePosition[j];
+        y[j] = meanCurrentCurvatureGradient[j] - previousCurvatureGradient[j];
+      }
       this->StoreCurrentPoint(s, y);
 
       /** Update previous. */
@@ -1544,8 +1543,15 @@ AdaptiveStochasticLBFGS<TElastix>::StoreCurrentPoint(const ParametersType & step
     this->StopOptimization();
   }
 
-  this->m_S[this->m_CurrentT] = step;     // expensive copy
-  this->m_Y[this->m_CurrentT] = grad_dif; // expensive copy
+  /** The step and gradient difference may already be computed in place, see ResumeOptimization(). */
+  if (&step != &this->m_S[this->m_CurrentT])
+  {
+    this->m_S[this->m_CurrentT] = step; // expensive copy
+  }
+  if (&grad_dif != &this->m_Y[this->m_CurrentT])
+  {
+    this->m_Y[this->m_CurrentT] = grad_dif; // expensive copy
+  }
   this->m_Rho[this->m_CurrentT] = rho;
   this->m_HessianFillValue[this->m_CurrentT] = fill_value;
 
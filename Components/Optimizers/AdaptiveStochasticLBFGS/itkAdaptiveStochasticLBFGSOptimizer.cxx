@@ -54,14 +54,17 @@ AdaptiveStochasticLBFGSOptimizer::UpdateCurrentTime(void)
   {
     if (this->GetCurrentIteration() > 0)
     {
-      /** Formula (2) in Cruz: <g_k, g_{k-1}>. */
-      const double inprod = inner_product(this->m_PreviousGradient, this->GetGradient());
+      /** Formula (2) in Cruz: <g_k, g_{k-1}>, fused with saving for the next iteration */
+      const double inprod = this->m_ParameterUpdateKernel->InnerProductAndAssign(
+        this->m_PreviousGradient, this->GetGradient(), this->GetGradient());
       this->m_CurrentTime += sigmoid(-inprod);
       this->m_CurrentTime = std::max(0.0, this->m_CurrentTime);
     }
-
-    /** Save for next iteration */
-    this->m_PreviousGradient = this->GetGradient();
+    else
+    {
+      /** Save for next iteration */
+      this->m_PreviousGradient = this->GetGradient();
+    }
   }
   else if (this->m_UseAdaptiveStepSizes && this->m_UseSearchDirForAdaptiveStepSize)
   {
@@ -73,6 +73,7 @@ namespace elastix
  *    Default/recommended value: 500. When you are in a hurry, you may go down to 250 for example.
  *    When you have plenty of time, and want to be absolutely sure of the best results, a setting
  *    of 2000 is reasonable. In general, 500 gives satisfactory results.
+ * \parameter ConvergenceWindowSize and ConvergenceSignificance: see OptimizerBase.
  * \parameter MaximumNumberOfSamplingAttempts: The maximum number of sampling attempts. Sometimes
  *   not enough corresponding samples can be drawn, upon which an exception is thrown. With this
  *   parameter it is possible to try to draw another set of samples. \n
@@ -304,7 +305,7 @@ public:
   void
   SetNumberOfWorkUnits(ThreadIdType numberOfThreads)
   {
-    this->m_Threader->SetNumberOfWorkUnits(numberOfThreads);
+    this->m_ParameterUpdateKernel->SetNumberOfWorkUnits(numberOfThreads);
   }
 
 protected:
@@ -440,21 +441,6 @@ private:
   void
   operator=(const Self &) = delete;
 
-  // multi-threaded AdvanceOneStep:
-  struct MultiThreaderParameterType
-  {
-    ParametersType * t_NewPosition;
-    Self *           t_Optimizer;
-  };
-
-  /** The callback function. */
-  static itk::ITK_THREAD_RETURN_TYPE
-  AdvanceOneStepThreaderCallback(void * arg);
-
-  /** The threaded implementation of AdvanceOneStep(). */
-  inline void
-  ThreadedAdvanceOneStep(ThreadIdType threadId, ParametersType & newPosition);
-
   bool   m_AutomaticParameterEstimation;
   double m_MaximumStepLength;
 
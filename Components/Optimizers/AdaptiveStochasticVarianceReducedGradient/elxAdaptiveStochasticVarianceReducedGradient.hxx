@@ -134,6 +134,9 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::BeforeEachResolution(void)
   this->m_OutsideIterations = maximumNumberOfIterations;
   this->SetNumberOfIterations(this->m_OutsideIterations);
 
+  /** Set the convergence check of this resolution, see ConvergenceWindowSize. */
+  this->InitializeConvergenceCheck();
+
   /** Set the numberOfInnerLoopSamples. */
   SizeValueType numberOfInnerLoopSamples = 10;
   this->GetConfiguration()->ReadParameter(
@@ -314,6 +317,13 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AfterEachIteration(void)
     this->SelectNewSamples();
   }
 
+  /** Stop the resolution when the metric value no longer decreases significantly. */
+  if (this->HasConverged(this->GetValue()))
+  {
+    this->m_StopCondition = NoSignificantProgress;
+    this->StopOptimization();
+  }
+
 } // end AfterEachIteration()
 
 
@@ -332,7 +342,8 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AfterEachResolution(void)
    * typedef enum {
    *   MaximumNumberOfIterations,
    *   MetricError,
-   *   MinimumStepSize } StopConditionType;
+   *   MinimumStepSize,
+   *   NoSignificantProgress } StopConditionType;
    */
   std::string stopcondition;
 
@@ -346,6 +357,10 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AfterEachResolution(void)
       stopcondition = "The minimum step length has been reached";
       break;
 
+    case NoSignificantProgress:
+      stopcondition = this->GetConvergenceStopCondition();
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
@@ -445,21 +460,8 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AdvanceOneStep(void)
 {
   itkDebugMacro("AdvancedOneStep");
 
-  /** Get space dimension. */
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
-  /** Get a reference to the previously allocated newPosition. */
-  ParametersType & newPosition = this->m_ScaledCurrentPosition;
-
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
-  const double learningRate = this->GetLearningRate();
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    newPosition[j] = currentPosition[j] - learningRate * this->m_Gradient[j];
-  }
+  /** Update the position in place, along the negative gradient. */
+  this->m_ParameterUpdateKernel->Step(this->m_ScaledCurrentPosition, -this->GetLearningRate(), this->m_Gradient);
 
   this->InvokeEvent(itk::IterationEvent());
 }
@@ -506,6 +508,7 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::ResumeOptimization(void)
   this->m_MeanGradient = DerivativeType(spaceDimension);
   DerivativeType localCurrentGradient(spaceDimension);
   DerivativeType localPreviousGradient(spaceDimension);
+  ParametersType previousPosition(spaceDimension);
 
   const unsigned int M = this->GetElastix()->GetNumberOfMetrics();
 
@@ -561,7 +564,7 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::ResumeOptimization(void)
 
     // this->SelectNewSamples();
     timeCollector.Start("copy");
-    ParametersType previousPosition = this->GetScaledCurrentPosition();
+    previousPosition = this->GetScaledCurrentPosition();
     timeCollector.Stop("copy");
 
     timeCollector.Start("g1");
@@ -652,12 +655,21 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::ResumeOptimization(void)
 
       timeCollector.Start("step");
       this->SetLearningRate(this->Superclass1::Compute_a(this->Superclass1::GetCurrentTime()));
-      this->AdvanceOneStep();
+      {
+        const itk::PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+        this->AdvanceOneStep();
+      }
       timeCollector.Stop("step");
 
       this->Superclass1::UpdateCurrentTime();
 
       this->m_CurrentInnerIteration++;
+
+      /** StopOptimization may have been called. */
+      if (this->m_Stop)
+      {
+        break;
+      }
       /** Preserve the previous position. */
     } // end inner forloop
 
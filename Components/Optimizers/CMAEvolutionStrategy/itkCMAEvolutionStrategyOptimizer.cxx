@@ -181,7 +181,10 @@ CMAEvolutionStrategyOptimizer::ResumeOptimization()
       break;
     }
 
-    this->AdvanceOneStep();
+    {
+      const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+      this->AdvanceOneStep();
+    }
 
     /** Something may have gone wrong during evalution of the current value */
     if (this->m_Stop)
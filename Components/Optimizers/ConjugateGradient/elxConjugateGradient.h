@@ -185,7 +185,7 @@ protected:
    * is printed, but ignored further. The optimizer stops, but elastix
    * just goes on to the next resolution. */
   void
-  LineSearch(const ParametersType searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g)
+  LineSearch(const ParametersType & searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g)
     override;
 
 private:
@@ -112,11 +112,11 @@ ConjugateGradient<TElastix>::StartOptimization(void)
 
 template <class TElastix>
 void
-ConjugateGradient<TElastix>::LineSearch(const ParametersType searchDir,
-                                        double &             step,
-                                        ParametersType &     x,
-                                        MeasureType &        f,
-                                        DerivativeType &     g)
+ConjugateGradient<TElastix>::LineSearch(const ParametersType & searchDir,
+                                        double &               step,
+                                        ParametersType &       x,
+                                        MeasureType &          f,
+                                        DerivativeType &       g)
 {
   /** Call the superclass's implementation and ignore a
    * LineSearchError. Just report the error and assume convergence. */
@@ -266,11 +266,11 @@ GenericConjugateGradientOptimizer::ComputeSearchDirection(const DerivativeType &
  */
 
 void
-GenericConjugateGradientOptimizer::LineSearch(const ParametersType searchDir,
-                                              double &             step,
-                                              ParametersType &     x,
-                                              MeasureType &        f,
-                                              DerivativeType &     g)
+GenericConjugateGradientOptimizer::LineSearch(const ParametersType & searchDir,
+                                              double &               step,
+                                              ParametersType &       x,
+                                              MeasureType &          f,
+                                              DerivativeType &       g)
 {
 
   itkDebugMacro("LineSearch");
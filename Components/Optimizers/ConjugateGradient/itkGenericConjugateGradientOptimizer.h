@@ -198,7 +198,7 @@ protected:
    * the derivative. On return the step, \f$x\f$ (new position), \f$f\f$ (value at \f$x\f$), and \f$g\f$
    * (derivative at \f$x\f$) are updated. */
   virtual void
-  LineSearch(const ParametersType searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g);
+  LineSearch(const ParametersType & searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g);
 
   /** Check if convergence has occured;
    * The firstLineSearchDone bool allows the implementation of TestConvergence to
@@ -185,7 +185,10 @@ FiniteDifferenceGradientDescentOptimizer::ResumeOptimization(void)
      * only for interested users... */
     this->m_GradientMagnitude = std::sqrt(sumOfSquaredGradients);
 
-    this->AdvanceOneStep();
+    {
+      const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+      this->AdvanceOneStep();
+    }
 
     this->m_CurrentIteration++;
 
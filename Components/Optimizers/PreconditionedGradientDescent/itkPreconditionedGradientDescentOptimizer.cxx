@@ -182,7 +182,10 @@ PreconditionedGradientDescentOptimizer::ResumeOptimization(void)
       break;
     }
 
-    this->AdvanceOneStep();
+    {
+      const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+      this->AdvanceOneStep();
+    }
 
     /** StopOptimization may have been called. */
     if (this->m_Stop)
@@ -238,22 +241,14 @@ PreconditionedGradientDescentOptimizer::AdvanceOneStep(void)
   typedef DerivativeType::ValueType      DerivativeValueType;
   typedef DerivativeType::const_iterator DerivativeIteratorType;
 
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-  DerivativeType &       searchDirection = this->m_SearchDirection;
+  DerivativeType & searchDirection = this->m_SearchDirection;
 
   /** Compute the search direction */
   this->CholmodSolve(this->m_Gradient, searchDirection);
 
-  /** Compute the new position */
-  ParametersType newPosition(spaceDimension);
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    newPosition[j] = currentPosition[j] - this->m_LearningRate * searchDirection[j];
-  }
-
-  this->SetScaledCurrentPosition(newPosition);
+  /** Compute the new position, in place. */
+  this->m_ParameterUpdateKernel->Step(this->m_ScaledCurrentPosition, -this->m_LearningRate, searchDirection);
+  this->Modified();
 
   this->InvokeEvent(IterationEvent());
 
@@ -19,6 +19,7 @@
 #define itkPreconditionedGradientDescentOptimizer_h
 
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
+#include "itkParameterUpdateKernel.h"
 #include "itkArray2D.h"
 #include "vnl/vnl_sparse_matrix.h"
 #include "cholmod.h"
@@ -212,6 +213,9 @@ protected:
   cholmod_factor * m_CholmodFactor{ nullptr };
   cholmod_sparse * m_CholmodGradient{ nullptr };
 
+  /** Applies the parameter updates, in parallel for large numbers of parameters. */
+  ParameterUpdateKernel::Pointer m_ParameterUpdateKernel{ ParameterUpdateKernel::New() };
+
   /** Solve Hx = g, using the Cholesky decomposition of the preconditioner.
    * Matlab notation: x = L'\(L\g) = Pg = searchDirection
    * The last argument can be used to also solve different systems, like L x = g.
@@ -419,28 +419,14 @@ template <class TElastix>
 void
 PreconditionedStochasticGradientDescent<TElastix>::AdvanceOneStep(void)
 {
-  /** Get space dimension. */
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
   /** Compute and set the learning rate. */
   const double lamda = this->GetParam_a() / (1.0 + this->Superclass1::GetCurrentTime() / this->GetParam_A());
   this->SetLearningRate(lamda);
 
-  DerivativeType & searchDirection = this->m_SearchDirection;
-
-  /** Get a reference to the previously allocated newPosition. */
-  ParametersType & newPosition = this->m_ScaledCurrentPosition;
-
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
+  /** Update the search direction and the position, in place and in a single pass. */
   const double lamda2 = lamda * this->m_NoiseFactor;
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    searchDirection[j] = this->m_PreconditionVector[j] * this->m_Gradient[j];
-    newPosition[j] = currentPosition[j] - lamda2 * searchDirection[j];
-  }
+  this->m_ParameterUpdateKernel->PreconditionedStep(
+    this->m_ScaledCurrentPosition, -lamda2, this->m_PreconditionVector, this->m_Gradient, this->m_SearchDirection);
 
   this->Superclass1::UpdateCurrentTime();
   this->InvokeEvent(itk::IterationEvent());
@@ -54,14 +54,17 @@ PreconditionedASGDOptimizer::UpdateCurrentTime(void)
       const double beta = this->GetSigmoidScale() * std::log(-this->GetSigmoidMax() / this->GetSigmoidMin());
       sigmoid.SetBeta(beta);
 
-      /** Formula (2) in Cruz */
-      const double inprod = inner_product(this->m_PreviousSearchDirection, this->GetGradient());
+      /** Formula (2) in Cruz, fused with saving for the next iteration */
+      const double inprod = this->m_ParameterUpdateKernel->InnerProductAndAssign(
+        this->m_PreviousSearchDirection, this->GetGradient(), this->GetSearchDirection());
       this->m_CurrentTime += sigmoid(-inprod);
       this->m_CurrentTime = std::max(0.0, this->m_CurrentTime);
     }
-
-    /** Save for next iteration */
-    this->m_PreviousSearchDirection = this->GetSearchDirection();
+    else
+    {
+      /** Save for next iteration */
+      this->m_PreviousSearchDirection = this->GetSearchDirection();
+    }
   }
   /** Decaying or constant step size. */
   else if (this->m_StepSizeStrategy == "Decaying")
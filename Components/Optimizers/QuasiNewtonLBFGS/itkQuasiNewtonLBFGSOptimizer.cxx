@@ -63,6 +63,7 @@ QuasiNewtonLBFGSOptimizer::StartOptimization()
 
   /** Resize Rho, Alpha, S and Y. */
   this->m_Rho.SetSize(this->GetMemory());
+  this->m_Alpha.SetSize(this->GetMemory());
   this->m_S.resize(this->GetMemory());
   this->m_Y.resize(this->GetMemory());
 
@@ -149,13 +150,20 @@ QuasiNewtonLBFGSOptimizer::ResumeOptimization()
      * compute the search direction in the next iterations */
     if (this->GetMemory() > 0)
     {
-      ParametersType s;
-      DerivativeType y;
-      s = this->GetCurrentStepLength() * searchDir;
-      y = this->GetCurrentGradient() - previousGradient;
+      /** Compute s and y in place, in the memory of m_S and m_Y. */
+      ParametersType &       s = this->m_S[this->m_Point];
+      DerivativeType &       y = this->m_Y[this->m_Point];
+      const DerivativeType & currentGradient = this->GetCurrentGradient();
+      const double           stepLength = this->GetCurrentStepLength();
+      const unsigned int     numberOfParameters = currentGradient.GetSize();
+      s.SetSize(numberOfParameters);
+      y.SetSize(numberOfParameters);
+      for (unsigned int j = 0; j < numberOfParameters; ++j)
+      {
+        s[j] = stepLength * searchDir[j];
+        y[j] = currentGradient[j] - previousGradient[j];
+      }
       this->StoreCurrentPoint(s, y);
-      s.clear();
-      y.clear();
     }
 
     /** Number of valid entries in m_S and m_Y */
@@ -247,14 +255,18 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(const DerivativeType & gradien
 
   /** Assumes m_Rho, m_S, and m_Y are up-to-date at m_PreviousPoint */
 
-  typedef Array<double> AlphaType;
-  AlphaType             alpha(this->GetMemory());
+  RhoType & alpha = this->m_Alpha;
 
-  const unsigned int numberOfParameters = gradient.GetSize();
-  DiagonalMatrixType H0;
+  const unsigned int   numberOfParameters = gradient.GetSize();
+  DiagonalMatrixType & H0 = this->m_DiagonalMatrix;
   this->ComputeDiagonalMatrix(H0);
 
-  searchDir = -gradient;
+  /** searchDir = -gradient, without a temporary vector. */
+  searchDir.SetSize(numberOfParameters);
+  for (unsigned int j = 0; j < numberOfParameters; ++j)
+  {
+    searchDir[j] = -gradient[j];
+  }
 
   int cp = static_cast<int>(this->m_Point);
 
@@ -315,11 +327,11 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(const DerivativeType & gradien
  */
 
 void
-QuasiNewtonLBFGSOptimizer::LineSearch(const ParametersType searchDir,
-                                      double &             step,
-                                      ParametersType &     x,
-                                      MeasureType &        f,
-                                      DerivativeType &     g)
+QuasiNewtonLBFGSOptimizer::LineSearch(const ParametersType & searchDir,
+                                      double &               step,
+                                      ParametersType &       x,
+                                      MeasureType &          f,
+                                      DerivativeType &       g)
 {
 
   itkDebugMacro("LineSearch");
@@ -378,8 +390,15 @@ QuasiNewtonLBFGSOptimizer::StoreCurrentPoint(const ParametersType & step, const
 {
   itkDebugMacro("StoreCurrentPoint");
 
-  this->m_S[this->m_Point] = step;                                  // s
-  this->m_Y[this->m_Point] = grad_dif;                              // y
+  /** The step and gradient difference may already be computed in place, see ResumeOptimization(). */
+  if (&step != &this->m_S[this->m_Point])
+  {
+    this->m_S[this->m_Point] = step; // s
+  }
+  if (&grad_dif != &this->m_Y[this->m_Point])
+  {
+    this->m_Y[this->m_Point] = grad_dif; // y
+  }
   this->m_Rho[this->m_Point] = 1.0 / inner_product(step, grad_dif); // 1/ys
 
 } // end StoreCurrentPoint
@@ -154,6 +154,10 @@ protected:
   SType   m_S;
   YType   m_Y;
 
+  /** Workspace of ComputeSearchDirection(), which is reused between iterations. */
+  RhoType            m_Alpha;
+  DiagonalMatrixType m_DiagonalMatrix;
+
   unsigned int m_Point{ 0 };
   unsigned int m_PreviousPoint{ 0 };
   unsigned int m_Bound{ 0 };
@@ -181,7 +185,7 @@ protected:
    * the derivative. On return the step, x (new position), f (value at x), and g
    * (derivative at x) are updated. */
   virtual void
-  LineSearch(const ParametersType searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g);
+  LineSearch(const ParametersType & searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g);
 
   /** Store s = x_k - x_k-1 and y = g_k - g_k-1 in m_S and m_Y,
    * and store 1/(ys) in m_Rho. */
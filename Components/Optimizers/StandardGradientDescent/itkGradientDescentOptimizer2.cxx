@@ -22,10 +22,6 @@
 #include "itkEventObject.h"
 #include "itkMacro.h"
 
-#ifdef ELASTIX_USE_OPENMP
-#  include <omp.h>
-#endif
-
 
 namespace itk
 {
@@ -35,11 +31,6 @@ namespace itk
  */
 
 GradientDescentOptimizer2 ::GradientDescentOptimizer2()
-  : m_UseOpenMP{
-#ifdef ELASTIX_USE_OPENMP
-    true
-#endif
-  }
 {
   itkDebugMacro("Constructor");
 
@@ -132,7 +123,10 @@ GradientDescentOptimizer2 ::ResumeOptimization(void)
       break;
     }
 
-    this->AdvanceOneStep();
+    {
+      const PerformanceTelemetry::ScopedTimer timer(this->m_PerformanceTelemetry, "Optimizer.Update");
+      this->AdvanceOneStep();
+    }
 
     /** StopOptimization may have been called. */
     if (this->m_Stop)
@@ -187,36 +181,10 @@ GradientDescentOptimizer2 ::AdvanceOneStep(void)
 {
   itkDebugMacro("AdvanceOneStep");
 
-  /** Get space dimension. */
-  const unsigned int spaceDimension = this->GetScaledCostFunction()->GetNumberOfParameters();
-
-  /** Get a reference to the previously allocated newPosition. */
-  ParametersType & newPosition = this->m_ScaledCurrentPosition;
-
-  /** Advance one step. */
-#if 1 // force single-threaded since it is fastest most of the times
-      //#ifndef ELASTIX_USE_OPENMP // If no OpenMP detected then use single-threaded code
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
-  for (unsigned int j = 0; j < spaceDimension; ++j)
-  {
-    newPosition[j] = currentPosition[j] - this->m_LearningRate * this->m_Gradient[j];
-  }
-#else // Otherwise use OpenMP
-  /** Get a reference to the current position. */
-  const ParametersType & currentPosition = this->GetScaledCurrentPosition();
-
-  /** Update the new position. */
-  const int nthreads = static_cast<int>(this->m_Threader->GetNumberOfWorkUnits());
-  omp_set_num_threads(nthreads);
-#  pragma omp parallel for
-  for (int j = 0; j < static_cast<int>(spaceDimension); ++j)
-  {
-    newPosition[j] = currentPosition[j] - this->m_LearningRate * this->m_Gradient[j];
-  }
-#endif
+  /** Advance one step: mu_{k+1} = mu_k - a_k * gradient_k, in place. The kernel
+   * only goes parallel when there are enough parameters to pay off.
+   */
+  this->m_ParameterUpdateKernel->Step(this->m_ScaledCurrentPosition, -this->m_LearningRate, this->m_Gradient);
 
   this->InvokeEvent(IterationEvent());
 
@@ -19,6 +19,7 @@
 #define itkGradientDescentOptimizer2_h
 
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
+#include "itkParameterUpdateKernel.h"
 
 
 namespace itk
@@ -76,13 +77,14 @@ public:
   using Superclass::ScaledCostFunctionPointer;
 
   /** Codes of stopping conditions
-   * The MinimumStepSize stopcondition never occurs, but may
-   * be implemented in inheriting classes */
+   * The MinimumStepSize and NoSignificantProgress stopconditions never occur,
+   * but may be implemented in inheriting classes */
   typedef enum
   {
     MaximumNumberOfIterations,
     MetricError,
-    MinimumStepSize
+    MinimumStepSize,
+    NoSignificantProgress
   } StopConditionType;
 
   /** Advance one step following the gradient direction. */
@@ -134,8 +136,12 @@ public:
   /** Get current search direction */
   itkGetConstReferenceMacro(SearchDirection, DerivativeType);
 
-  /** Set use OpenMP or not. */
-  itkSetMacro(UseOpenMP, bool);
+  /** Set the maximum number of threads of the parameter update. */
+  void
+  SetNumberOfWorkUnits(ThreadIdType numberOfThreads)
+  {
+    this->m_ParameterUpdateKernel->SetNumberOfWorkUnits(numberOfThreads);
+  }
 
 protected:
   GradientDescentOptimizer2();
@@ -148,6 +154,9 @@ protected:
   DerivativeType    m_SearchDirection;
   StopConditionType m_StopCondition{ MaximumNumberOfIterations };
 
+  /** Applies the parameter updates, in parallel for large numbers of parameters. */
+  ParameterUpdateKernel::Pointer m_ParameterUpdateKernel{ ParameterUpdateKernel::New() };
+
 private:
   GradientDescentOptimizer2(const Self &) = delete;
   void
@@ -158,8 +167,6 @@ private:
   bool          m_Stop{ false };
   unsigned long m_NumberOfIterations{ 100 };
   unsigned long m_CurrentIteration{ 0 };
-
-  bool m_UseOpenMP;
 };
 
 } // end namespace itk
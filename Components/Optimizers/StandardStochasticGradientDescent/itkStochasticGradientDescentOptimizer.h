@@ -19,7 +19,7 @@
 #define itkStochasticGradientDescentOptimizer_h
 
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
-#include "itkPlatformMultiThreader.h"
+#include "itkParameterUpdateKernel.h"
 
 namespace itk
 {
@@ -75,8 +75,8 @@ public:
   using Superclass::ScaledCostFunctionPointer;
 
   /** Codes of stopping conditions
-   * The MinimumStepSize stopcondition never occurs, but may
-   * be implemented in inheriting classes */
+   * The MinimumStepSize and NoSignificantProgress stopconditions never occur,
+   * but may be implemented in inheriting classes */
   typedef enum
   {
     MaximumNumberOfIterations,
@@ -85,6 +85,7 @@ public:
     InvalidDiagonalMatrix,
     GradientMagnitudeTolerance,
     LineSearchError,
+    NoSignificantProgress,
   } StopConditionType;
 
   /** Advance one step following the gradient direction. */
@@ -161,13 +162,8 @@ public:
   void
   SetNumberOfWorkUnits(ThreadIdType numberOfThreads)
   {
-    this->m_Threader->SetNumberOfWorkUnits(numberOfThreads);
+    this->m_ParameterUpdateKernel->SetNumberOfWorkUnits(numberOfThreads);
   }
-  // itkGetConstReferenceMacro( NumberOfThreads, ThreadIdType );
-  itkSetMacro(UseMultiThread, bool);
-
-  itkSetMacro(UseOpenMP, bool);
-  itkSetMacro(UseEigen, bool);
 
 protected:
   StochasticGradientDescentOptimizer();
@@ -175,23 +171,21 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
-  /** Typedefs for multi-threading. */
-  typedef itk::PlatformMultiThreader ThreaderType;
-  typedef ThreaderType::WorkUnitInfo ThreadInfoType;
-
   // made protected so subclass can access
-  double                m_Value{ 0.0 };
-  DerivativeType        m_Gradient;
-  ParametersType        m_SearchDir;
-  ParametersType        m_PreviousSearchDir;
-  ParametersType        m_PrePreviousSearchDir;
-  ParametersType        m_MeanSearchDir;
-  double                m_LearningRate{ 1.0 };
-  StopConditionType     m_StopCondition{ MaximumNumberOfIterations };
-  DerivativeType        m_PreviousGradient;
-  DerivativeType        m_PrePreviousGradient;
-  ParametersType        m_PreviousPosition;
-  ThreaderType::Pointer m_Threader{ ThreaderType::New() };
+  double            m_Value{ 0.0 };
+  DerivativeType    m_Gradient;
+  ParametersType    m_SearchDir;
+  ParametersType    m_PreviousSearchDir;
+  ParametersType    m_PrePreviousSearchDir;
+  ParametersType    m_MeanSearchDir;
+  double            m_LearningRate{ 1.0 };
+  StopConditionType m_StopCondition{ MaximumNumberOfIterations };
+  DerivativeType    m_PreviousGradient;
+  DerivativeType    m_PrePreviousGradient;
+  ParametersType    m_PreviousPosition;
+
+  /** Applies the parameter updates, in parallel for large numbers of parameters. */
+  ParameterUpdateKernel::Pointer m_ParameterUpdateKernel{ ParameterUpdateKernel::New() };
 
   bool          m_Stop{ false };
   unsigned long m_NumberOfIterations{ 100 };
@@ -204,25 +198,6 @@ private:
   StochasticGradientDescentOptimizer(const Self &) = delete;
   void
   operator=(const Self &) = delete;
-
-  // multi-threaded AdvanceOneStep:
-  bool m_UseMultiThread{ false };
-  struct MultiThreaderParameterType
-  {
-    ParametersType * t_NewPosition;
-    Self *           t_Optimizer;
-  };
-
-  bool m_UseOpenMP{ false };
-  bool m_UseEigen{ false };
-
-  /** The callback function. */
-  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
-  AdvanceOneStepThreaderCallback(void * arg);
-
-  /** The threaded implementation of AdvanceOneStep(). */
-  inline void
-  ThreadedAdvanceOneStep(ThreadIdType threadId, ParametersType & newPosition);
 };
 
 } // end namespace itk
@@ -478,6 +478,10 @@ private:
    */
   double
   GetFinalMetricWeight(unsigned int pos) const;
+
+  /** Adds weight * metricDerivative to the derivative, in place. */
+  static void
+  AddWeightedDerivative(const double weight, const DerivativeType & metricDerivative, DerivativeType & derivative);
 };
 
 } // end namespace itk
@@ -653,6 +653,24 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetFinalMetricWeight(u
 } // end GetFinalMetricWeight()
 
 
+/**
+ * ******************* AddWeightedDerivative *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+CombinationImageToImageMetric<TFixedImage, TMovingImage>::AddWeightedDerivative(const double           weight,
+                                                                                const DerivativeType & metricDerivative,
+                                                                                DerivativeType &       derivative)
+{
+  const std::size_t numberOfParameters = derivative.GetSize();
+  for (std::size_t j = 0; j < numberOfParameters; ++j)
+  {
+    derivative[j] += weight * metricDerivative[j];
+  }
+} // end AddWeightedDerivative()
+
+
 /**
  * ********************* GetValue ****************************
  */
@@ -719,9 +737,10 @@ void
 CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(const ParametersType & parameters,
                                                                         DerivativeType &       derivative) const
 {
-  /** Initialise. */
-  DerivativeType tmpDerivative = DerivativeType(this->GetNumberOfParameters());
-  derivative = DerivativeType(this->GetNumberOfParameters());
+  /** Initialise. The derivatives are stored and combined in place, so that
+   * no temporary vectors are allocated.
+   */
+  derivative.SetSize(this->GetNumberOfParameters());
   derivative.Fill(NumericTraits<MeasureType>::ZeroValue());
 
   /** Compute, store and combine all metric derivatives. */
@@ -731,14 +750,14 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(const Pa
     itk::TimeProbe timer;
     timer.Start();
 
-    /** Compute ... */
-    tmpDerivative.Fill(NumericTraits<MeasureType>::ZeroValue());
-    this->m_Metrics[i]->GetDerivative(parameters, tmpDerivative);
+    /** Compute and store ... */
+    DerivativeType & metricDerivative = this->m_MetricDerivatives[i];
+    metricDerivative.SetSize(this->GetNumberOfParameters());
+    metricDerivative.Fill(NumericTraits<MeasureType>::ZeroValue());
+    this->m_Metrics[i]->GetDerivative(parameters, metricDerivative);
     timer.Stop();
 
-    /** store ... */
-    this->m_MetricDerivatives[i] = tmpDerivative;
-    this->m_MetricDerivativesMagnitude[i] = tmpDerivative.magnitude();
+    this->m_MetricDerivativesMagnitude[i] = metricDerivative.magnitude();
     this->m_MetricComputationTime[i] = timer.GetMean() * 1000.0;
 
     /** and combine. */
@@ -746,7 +765,7 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(const Pa
     {
       if (!this->m_UseRelativeWeights)
       {
-        derivative += this->m_MetricWeights[i] * this->m_MetricDerivatives[i];
+        this->AddWeightedDerivative(this->m_MetricWeights[i], metricDerivative, derivative);
       }
       else
       {
@@ -761,7 +780,7 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetDerivative(const Pa
         {
           weight = this->m_MetricRelativeWeights[i] * this->m_MetricDerivativesMagnitude[0] /
                    this->m_MetricDerivativesMagnitude[i];
-          derivative += weight * this->m_MetricDerivatives[i];
+          this->AddWeightedDerivative(weight, metricDerivative, derivative);
         }
       }
     }
@@ -837,24 +856,14 @@ CombinationImageToImageMetric<TFixedImage, TMovingImage>::GetValueAndDerivative(
     }
   }
 
-  /** Combine the metric derivatives. First, the first derivative. */
-  if (this->m_UseMetric[0])
-  {
-    const double weight = this->GetFinalMetricWeight(0);
-    derivative = weight * this->m_MetricDerivatives[0];
-  }
-  else
-  {
-    derivative.Fill(0);
-  }
-
-  /** Then the remaining derivatives. */
-  for (unsigned int i = 1; i < this->m_NumberOfMetrics; ++i)
+  /** Combine the metric derivatives, in place. */
+  derivative.SetSize(this->GetNumberOfParameters());
+  derivative.Fill(0);
+  for (unsigned int i = 0; i < this->m_NumberOfMetrics; ++i)
   {
     if (this->m_UseMetric[i])
     {
-      const double weight = this->GetFinalMetricWeight(i);
-      derivative += weight * this->m_MetricDerivatives[i];
+      this->AddWeightedDerivative(this->GetFinalMetricWeight(i), this->m_MetricDerivatives[i], derivative);
     }
   }
 
@@ -19,7 +19,7 @@
 #define elxBSplineResampleInterpolator_h
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
-#include "itkBSplineInterpolateImageFunction.h"
+#include "itkParallelBSplineInterpolateImageFunction.h"
 
 namespace elastix
 {
@@ -52,18 +52,18 @@ namespace elastix
 
 template <class TElastix>
 class ITK_TEMPLATE_EXPORT BSplineResampleInterpolator
-  : public itk::BSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
-                                                typename ResampleInterpolatorBase<TElastix>::CoordRepType,
-                                                double>
+  : public itk::ParallelBSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
+                                                        typename ResampleInterpolatorBase<TElastix>::CoordRepType,
+                                                        double>
   , // CoefficientType
     public ResampleInterpolatorBase<TElastix>
 {
 public:
   /** Standard ITK-stuff. */
   typedef BSplineResampleInterpolator Self;
-  typedef itk::BSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
-                                               typename ResampleInterpolatorBase<TElastix>::CoordRepType,
-                                               double>
+  typedef itk::ParallelBSplineInterpolateImageFunction<typename ResampleInterpolatorBase<TElastix>::InputImageType,
+                                                       typename ResampleInterpolatorBase<TElastix>::CoordRepType,
+                                                       double>
                                              Superclass1;
   typedef ResampleInterpolatorBase<TElastix> Superclass2;
   typedef itk::SmartPointer<Self>            Pointer;
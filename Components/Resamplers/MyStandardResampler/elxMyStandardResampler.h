@@ -19,7 +19,7 @@
 #define elxMyStandardResampler_h
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
-#include "itkResampleImageFilter.h"
+#include "itkRayCastResampleImageFilter.h"
 
 namespace elastix
 {
@@ -28,25 +28,42 @@ namespace elastix
  * \class MyStandardResampler
  * \brief A resampler based on the itk::ResampleImageFilter.
  *
+ * With the RayCastResampleInterpolator, the whole projection is computed at once,
+ * see itk::RayCastResampleImageFilter.
+ *
  * The parameters used in this class are:
  * \parameter Resampler: Select this resampler as follows:\n
  *    <tt>(Resampler "DefaultResampler")</tt>
+ * \parameter ResampleUsingDeformationField: Whether to first compute the deformation
+ *    field of the transform on the output grid, and to resample through this field,
+ *    instead of evaluating the transform for every output voxel. The field is computed
+ *    once, and reused as long as the transform and the output grid do not change, so
+ *    that resampling multiple images with the same transform (for example by transformix)
+ *    only costs the interpolation. The field is stored as float, which takes
+ *    ImageDimension floats per output voxel. \n
+ *    example: <tt>(ResampleUsingDeformationField "true")</tt> \n
+ *    The default is "false".
  *
  * \ingroup Resamplers
  */
 
 template <class TElastix>
 class ITK_TEMPLATE_EXPORT MyStandardResampler
-  : public ResamplerBase<TElastix>::ITKBaseType
+  : public itk::RayCastResampleImageFilter<typename ResamplerBase<TElastix>::InputImageType,
+                                           typename ResamplerBase<TElastix>::OutputImageType,
+                                           typename ResamplerBase<TElastix>::CoordRepType>
   , public ResamplerBase<TElastix>
 {
 public:
   /** Standard ITK-stuff. */
-  typedef MyStandardResampler                           Self;
-  typedef typename ResamplerBase<TElastix>::ITKBaseType Superclass1;
-  typedef ResamplerBase<TElastix>                       Superclass2;
-  typedef itk::SmartPointer<Self>                       Pointer;
-  typedef itk::SmartPointer<const Self>                 ConstPointer;
+  typedef MyStandardResampler Self;
+  typedef itk::RayCastResampleImageFilter<typename ResamplerBase<TElastix>::InputImageType,
+                                          typename ResamplerBase<TElastix>::OutputImageType,
+                                          typename ResamplerBase<TElastix>::CoordRepType>
+                                        Superclass1;
+  typedef ResamplerBase<TElastix>       Superclass2;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -86,7 +103,9 @@ public:
   using typename Superclass2::RegistrationPointer;
   typedef typename Superclass2::ITKBaseType ITKBaseType;
 
-  /* Nothing to add. In the baseclass already everything is done what should be done. */
+  /** Typedef's for the deformation field. */
+  typedef typename ElastixType::TransformBaseType::DeformationFieldImageType DeformationFieldImageType;
+  typedef typename DeformationFieldImageType::Pointer                       DeformationFieldImagePointer;
 
 protected:
   /** The constructor. */
@@ -94,6 +113,18 @@ protected:
   /** The destructor. */
   ~MyStandardResampler() override = default;
 
+  /** Reads the ResampleUsingDeformationField parameter, and (re)computes the
+   * deformation field when necessary.
+   */
+  void
+  BeforeThreadedGenerateData(void) override;
+
+  /** Resamples through the deformation field, if used. Otherwise the
+   * superclass implementation is called.
+   */
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
 private:
   elxOverrideGetSelfMacro;
 
@@ -102,6 +133,20 @@ private:
   /** The deleted assignment operator. */
   void
   operator=(const Self &) = delete;
+
+  /** Returns true when m_DeformationField was computed for the current transform and output grid. */
+  bool
+  IsDeformationFieldUpToDate(void) const;
+
+  /** Returns the largest MTime of the transform and, for a combination transform,
+   * of its current and initial transforms, recursively.
+   */
+  static itk::ModifiedTimeType
+  GetTransformChainMTime(const itk::Object * transform);
+
+  DeformationFieldImagePointer m_DeformationField{ nullptr };
+  itk::ModifiedTimeType        m_DeformationFieldTransformMTime{ 0 };
+  bool                         m_UseDeformationField{ false };
 };
 
 } // end namespace elastix
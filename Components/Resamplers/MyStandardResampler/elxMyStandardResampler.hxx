@@ -21,6 +21,198 @@
 
 #include "elxMyStandardResampler.h"
 
-// nothing
+#include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
 
-#endif
+#include <algorithm> // For max and min.
+
+namespace elastix
+{
+
+/**
+ * ******************* BeforeThreadedGenerateData ***********************
+ */
+
+template <class TElastix>
+void
+MyStandardResampler<TElastix>::BeforeThreadedGenerateData(void)
+{
+  /** Connect the interpolator (and extrapolator) to the input image. */
+  this->Superclass1::BeforeThreadedGenerateData();
+
+  /** Check if the user wants to resample through a deformation field. */
+  this->m_UseDeformationField = false;
+  this->m_Configuration->ReadParameter(this->m_UseDeformationField, "ResampleUsingDeformationField", 0, false);
+
+  /** The ray cast interpolator uses a transform of its own. */
+  typedef itk::AdvancedRayCastInterpolateImageFunction<InputImageType, CoordRepType> RayCastInterpolatorType;
+  if (dynamic_cast<const RayCastInterpolatorType *>(this->GetInterpolator()) != nullptr)
+  {
+    this->m_UseDeformationField = false;
+  }
+
+  if (!this->m_UseDeformationField)
+  {
+    /** Release the memory of a previously computed field. */
+    this->m_DeformationField = nullptr;
+    return;
+  }
+
+  /** Compute the deformation field only if the transform or output grid has changed. */
+  if (!this->IsDeformationFieldUpToDate())
+  {
+    elxout << "  Computing the deformation field for resampling ..." << std::endl;
+    this->m_DeformationField = this->m_Elastix->GetElxTransformBase()->GenerateDeformationFieldImage();
+    this->m_DeformationFieldTransformMTime = Self::GetTransformChainMTime(this->GetTransform());
+  }
+  else
+  {
+    elxout << "  Reusing the deformation field for resampling ..." << std::endl;
+  }
+
+} // end BeforeThreadedGenerateData()
+
+
+/**
+ * ******************* DynamicThreadedGenerateData ***********************
+ */
+
+template <class TElastix>
+void
+MyStandardResampler<TElastix>::DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  if (!this->m_UseDeformationField)
+  {
+    this->Superclass1::DynamicThreadedGenerateData(outputRegionForThread);
+    return;
+  }
+
+  /** Typedef's. */
+  typedef typename InterpolatorType::ContinuousIndexType             ContinuousIndexType;
+  typedef typename InterpolatorType::OutputType                      InterpolatorOutputType;
+  typedef typename DeformationFieldImageType::PixelType              DisplacementType;
+  typedef typename OutputImageType::PointType                        PointType;
+  typedef typename PointType::VectorType                             PointVectorType;
+  typedef itk::ImageScanlineIterator<OutputImageType>                OutputIteratorType;
+  typedef itk::ImageScanlineConstIterator<DeformationFieldImageType> FieldIteratorType;
+
+  OutputImageType *        outputImage = this->GetOutput();
+  const InputImageType *   inputImage = this->GetInput();
+  const InterpolatorType * interpolator = this->GetInterpolator();
+  const auto *             extrapolator = this->GetExtrapolator();
+  const PixelType          defaultValue = this->GetDefaultPixelValue();
+
+  /** The output pixel values are clamped to the range of the pixel type. */
+  const InterpolatorOutputType minValue = itk::NumericTraits<PixelType>::NonpositiveMin();
+  const InterpolatorOutputType maxValue = itk::NumericTraits<PixelType>::max();
+
+  /** The physical step between two consecutive voxels on a scanline. */
+  PointVectorType scanlineStep;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    scanlineStep[i] = outputImage->GetDirection()[i][0] * outputImage->GetSpacing()[0];
+  }
+
+  OutputIteratorType outIt(outputImage, outputRegionForThread);
+  FieldIteratorType  fieldIt(this->m_DeformationField, outputRegionForThread);
+
+  while (!outIt.IsAtEnd())
+  {
+    /** Compute the physical point of the first voxel of this scanline only. */
+    PointType fixedPoint;
+    outputImage->TransformIndexToPhysicalPoint(outIt.GetIndex(), fixedPoint);
+
+    while (!outIt.IsAtEndOfLine())
+    {
+      /** Displace the point, and find it in the input image. */
+      const DisplacementType & displacement = fieldIt.Value();
+      PointType                movingPoint;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        movingPoint[i] = fixedPoint[i] + static_cast<CoordRepType>(displacement[i]);
+      }
+      const ContinuousIndexType cindex =
+        inputImage->template TransformPhysicalPointToContinuousIndex<CoordRepType>(movingPoint);
+
+      /** Interpolate. */
+      PixelType outputValue = defaultValue;
+      if (interpolator->IsInsideBuffer(cindex) || extrapolator != nullptr)
+      {
+        const InterpolatorOutputType value = interpolator->IsInsideBuffer(cindex)
+                                               ? interpolator->EvaluateAtContinuousIndex(cindex)
+                                               : extrapolator->EvaluateAtContinuousIndex(cindex);
+        outputValue = static_cast<PixelType>(std::max(minValue, std::min(value, maxValue)));
+      }
+      outIt.Set(outputValue);
+
+      fixedPoint += scanlineStep;
+      ++outIt;
+      ++fieldIt;
+    }
+    outIt.NextLine();
+    fieldIt.NextLine();
+  }
+
+} // end DynamicThreadedGenerateData()
+
+
+/**
+ * ******************* IsDeformationFieldUpToDate ***********************
+ */
+
+template <class TElastix>
+bool
+MyStandardResampler<TElastix>::IsDeformationFieldUpToDate(void) const
+{
+  if (this->m_DeformationField.IsNull() || this->GetTransform() == nullptr ||
+      Self::GetTransformChainMTime(this->GetTransform()) != this->m_DeformationFieldTransformMTime)
+  {
+    return false;
+  }
+
+  /** The field must cover the output grid. Only the direction may differ,
+   * see TransformBase::GenerateDeformationFieldImage().
+   */
+  const OutputImageType * outputImage = this->GetOutput();
+  return (this->m_DeformationField->GetLargestPossibleRegion() == outputImage->GetLargestPossibleRegion()) &&
+         (this->m_DeformationField->GetSpacing() == outputImage->GetSpacing()) &&
+         (this->m_DeformationField->GetOrigin() == outputImage->GetOrigin());
+
+} // end IsDeformationFieldUpToDate()
+
+
+/**
+ * ******************* GetTransformChainMTime ***********************
+ */
+
+template <class TElastix>
+itk::ModifiedTimeType
+MyStandardResampler<TElastix>::GetTransformChainMTime(const itk::Object * transform)
+{
+  typedef typename ElastixType::TransformBaseType::CombinationTransformType CombinationTransformType;
+
+  if (transform == nullptr)
+  {
+    return 0;
+  }
+
+  /** SetParameters() of the current transform of a combination transform does
+   * not modify the combination itself, and neither does modifying its initial
+   * transform. So walk the whole chain.
+   */
+  itk::ModifiedTimeType mtime = transform->GetMTime();
+  const auto *          combinationTransform = dynamic_cast<const CombinationTransformType *>(transform);
+  if (combinationTransform != nullptr)
+  {
+    mtime = std::max(mtime, Self::GetTransformChainMTime(combinationTransform->GetCurrentTransform()));
+    mtime = std::max(mtime, Self::GetTransformChainMTime(combinationTransform->GetInitialTransform()));
+  }
+  return mtime;
+
+} // end GetTransformChainMTime()
+
+
+} // end namespace elastix
+
+#endif // end #ifndef elxMyStandardResampler_hxx
@@ -23,6 +23,7 @@
 #include "itkMacro.h"
 #include "itkImage.h"
 #include "itkVectorInterpolateImageFunction.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
 #include "itkVectorNearestNeighborInterpolateImageFunction.h"
 
 namespace itk
@@ -36,6 +37,13 @@ namespace itk
  * is not implemented. DO NOT USE IT FOR REGISTRATION.
  * You may set your own interpolator!
  *
+ * When the interpolator is a VectorNearestNeighborInterpolateImageFunction or
+ * a VectorLinearInterpolateImageFunction, TransformPoint does not call the
+ * interpolator, but interpolates the deformation field inline, directly on
+ * its buffer. The result is the same. The geometry of the deformation field
+ * is cached by SetDeformationField() and SetDeformationFieldInterpolator(),
+ * so call SetDeformationField() again after changing it.
+ *
  * \ingroup Transforms
  */
 
@@ -93,6 +101,8 @@ public:
   typedef typename DeformationFieldInterpolatorType::Pointer               DeformationFieldInterpolatorPointer;
   typedef VectorNearestNeighborInterpolateImageFunction<DeformationFieldType, ScalarType>
     DefaultDeformationFieldInterpolatorType;
+  typedef VectorLinearInterpolateImageFunction<DeformationFieldType, ScalarType>
+    LinearDeformationFieldInterpolatorType;
 
   /** Set the transformation parameters is not supported.
    * Use SetDeformationField() instead
@@ -173,6 +183,11 @@ public:
 
   itkGetModifiableObjectMacro(DeformationFieldInterpolator, DeformationFieldInterpolatorType);
 
+  /** Whether TransformPoint interpolates the deformation field inline,
+   * instead of calling the interpolator.
+   */
+  itkGetConstMacro(UseInlinedInterpolation, bool);
+
   bool
   IsLinear(void) const override
   {
@@ -261,6 +276,28 @@ private:
   DeformationFieldInterpolatingTransform(const Self &) = delete;
   void
   operator=(const Self &) = delete;
+
+  typedef typename DeformationFieldType::PointType     DeformationFieldPointType;
+  typedef typename DeformationFieldType::DirectionType DeformationFieldMatrixType;
+
+  /** Decides whether the inlined interpolation can be used, and caches the
+   * geometry of the deformation field that it needs.
+   */
+  void
+  UpdateInlinedInterpolation(void);
+
+  /** Transforms a point by the inlined nearest neighbor or linear interpolation. */
+  OutputPointType
+  TransformPointInlined(const InputPointType & point) const;
+
+  /** The cached state of the inlined interpolation. */
+  bool                       m_UseInlinedInterpolation{ false };
+  unsigned int               m_InlinedInterpolationOrder{ 0 };
+  DeformationFieldPointType  m_FieldOrigin;
+  DeformationFieldMatrixType m_FieldPointToIndex;
+  IndexValueType             m_FieldStartIndex[NDimensions]{};
+  IndexValueType             m_FieldEndIndex[NDimensions]{};
+  OffsetValueType            m_FieldOffsetTable[NDimensions]{};
 };
 
 } // namespace itk
@@ -20,6 +20,9 @@
 
 #include "itkDeformationFieldInterpolatingTransform.h"
 
+#include <algorithm>
+#include <typeinfo>
+
 namespace itk
 {
 
@@ -50,6 +53,11 @@ typename DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TCompo
 DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>::TransformPoint(
   const InputPointType & point) const
 {
+  if (this->m_UseInlinedInterpolation)
+  {
+    return this->TransformPointInlined(point);
+  }
+
   InputContinuousIndexType cindex;
   this->m_DeformationFieldInterpolator->ConvertPointToContinuousIndex(point, cindex);
 
@@ -70,6 +78,103 @@ DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>
 }
 
 
+// Transform a point, interpolating the deformation field inline
+template <class TScalarType, unsigned int NDimensions, class TComponentType>
+typename DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>::OutputPointType
+DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>::TransformPointInlined(
+  const InputPointType & point) const
+{
+  /** Compute the continuous index, as in Image::TransformPhysicalPointToContinuousIndex(),
+   * and return the point unchanged when it is outside the buffer, as in TransformPoint().
+   */
+  ScalarType cindex[NDimensions];
+  for (unsigned int i = 0; i < NDimensions; ++i)
+  {
+    double sum = 0.0;
+    for (unsigned int j = 0; j < NDimensions; ++j)
+    {
+      sum += this->m_FieldPointToIndex(i, j) * (point[j] - this->m_FieldOrigin[j]);
+    }
+    cindex[i] = static_cast<ScalarType>(sum);
+
+    if (!(cindex[i] >= static_cast<ScalarType>(this->m_FieldStartIndex[i] - 0.5)) ||
+        !(cindex[i] < static_cast<ScalarType>(this->m_FieldEndIndex[i] + 0.5)))
+    {
+      return point;
+    }
+  }
+
+  const DeformationFieldVectorType * const buffer = this->m_DeformationField->GetBufferPointer();
+  OutputPointType                          outpoint = point;
+
+  if (this->m_InlinedInterpolationOrder == 0)
+  {
+    /** Nearest neighbor, as in VectorNearestNeighborInterpolateImageFunction. */
+    OffsetValueType offset = 0;
+    for (unsigned int i = 0; i < NDimensions; ++i)
+    {
+      const IndexValueType index = Math::RoundHalfIntegerUp<IndexValueType>(cindex[i]);
+      offset += (index - this->m_FieldStartIndex[i]) * this->m_FieldOffsetTable[i];
+    }
+    const DeformationFieldVectorType & vec = buffer[offset];
+    for (unsigned int i = 0; i < NDimensions; ++i)
+    {
+      outpoint[i] += static_cast<ScalarType>(static_cast<double>(vec[i]));
+    }
+    return outpoint;
+  }
+
+  /** Linear, as in VectorLinearInterpolateImageFunction: the neighbors are clamped
+   * to the buffer, and visited in the same order.
+   */
+  double          distance[NDimensions];
+  OffsetValueType lowerOffset[NDimensions];
+  OffsetValueType upperOffset[NDimensions];
+  for (unsigned int i = 0; i < NDimensions; ++i)
+  {
+    const IndexValueType baseIndex = Math::Floor<IndexValueType>(cindex[i]);
+    const IndexValueType lower = std::max(baseIndex, this->m_FieldStartIndex[i]);
+    const IndexValueType upper = std::min(baseIndex + 1, this->m_FieldEndIndex[i]);
+    distance[i] = cindex[i] - static_cast<double>(baseIndex);
+    lowerOffset[i] = (lower - this->m_FieldStartIndex[i]) * this->m_FieldOffsetTable[i];
+    upperOffset[i] = (upper - this->m_FieldStartIndex[i]) * this->m_FieldOffsetTable[i];
+  }
+
+  double displacement[NDimensions]{};
+  for (unsigned int neighbor = 0; neighbor < (1u << NDimensions); ++neighbor)
+  {
+    double          overlap = 1.0;
+    OffsetValueType offset = 0;
+    for (unsigned int i = 0; i < NDimensions; ++i)
+    {
+      if (neighbor & (1u << i))
+      {
+        overlap *= distance[i];
+        offset += upperOffset[i];
+      }
+      else
+      {
+        overlap *= 1.0 - distance[i];
+        offset += lowerOffset[i];
+      }
+    }
+
+    const DeformationFieldVectorType & vec = buffer[offset];
+    for (unsigned int i = 0; i < NDimensions; ++i)
+    {
+      displacement[i] += overlap * static_cast<double>(vec[i]);
+    }
+  }
+
+  for (unsigned int i = 0; i < NDimensions; ++i)
+  {
+    outpoint[i] += static_cast<ScalarType>(displacement[i]);
+  }
+  return outpoint;
+
+} // end TransformPointInlined()
+
+
 // Set the deformation field
 template <class TScalarType, unsigned int NDimensions, class TComponentType>
 void
@@ -86,6 +191,7 @@ DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>
   {
     this->m_DeformationFieldInterpolator->SetInputImage(this->m_DeformationField);
   }
+  this->UpdateInlinedInterpolation();
 }
 
 
@@ -105,9 +211,50 @@ DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>
   {
     this->m_DeformationFieldInterpolator->SetInputImage(this->m_DeformationField);
   }
+  this->UpdateInlinedInterpolation();
 }
 
 
+// Decide whether the inlined interpolation can be used
+template <class TScalarType, unsigned int NDimensions, class TComponentType>
+void
+DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>::UpdateInlinedInterpolation(void)
+{
+  this->m_UseInlinedInterpolation = false;
+  if (this->m_DeformationField.IsNull() || this->m_DeformationFieldInterpolator.IsNull())
+  {
+    return;
+  }
+
+  /** Only the exact interpolator types are inlined; subclasses may evaluate differently. */
+  const auto & interpolatorType = typeid(*this->m_DeformationFieldInterpolator);
+  if (interpolatorType == typeid(DefaultDeformationFieldInterpolatorType))
+  {
+    this->m_InlinedInterpolationOrder = 0;
+  }
+  else if (interpolatorType == typeid(LinearDeformationFieldInterpolatorType))
+  {
+    this->m_InlinedInterpolationOrder = 1;
+  }
+  else
+  {
+    return;
+  }
+
+  const auto & region = this->m_DeformationField->GetBufferedRegion();
+  this->m_FieldOrigin = this->m_DeformationField->GetOrigin();
+  this->m_FieldPointToIndex = this->m_DeformationField->GetPhysicalPointToIndex();
+  for (unsigned int i = 0; i < NDimensions; ++i)
+  {
+    this->m_FieldStartIndex[i] = region.GetIndex()[i];
+    this->m_FieldEndIndex[i] = region.GetIndex()[i] + static_cast<IndexValueType>(region.GetSize()[i]) - 1;
+    this->m_FieldOffsetTable[i] = this->m_DeformationField->GetOffsetTable()[i];
+  }
+  this->m_UseInlinedInterpolation = true;
+
+} // end UpdateInlinedInterpolation()
+
+
 // Print self
 template <class TScalarType, unsigned int NDimensions, class TComponentType>
 void
@@ -119,6 +266,7 @@ DeformationFieldInterpolatingTransform<TScalarType, NDimensions, TComponentType>
   os << indent << "DeformationField: " << this->m_DeformationField << std::endl;
   os << indent << "ZeroDeformationField: " << this->m_ZeroDeformationField << std::endl;
   os << indent << "DeformationFieldInterpolator: " << this->m_DeformationFieldInterpolator << std::endl;
+  os << indent << "UseInlinedInterpolation: " << this->m_UseInlinedInterpolation << std::endl;
 }
 
 
@@ -76,6 +76,17 @@ namespace elastix
  *   <em>Nonrigid registration of dynamic medical imaging data using nD+t B-splines and a
  *   groupwise optimization approach</em>, C.T. Metz, S. Klein, M. Schaap, T. van Walsum and
  *   W.J. Niessen, Medical Image Analysis, in press.
+ * \parameter UseInterleavedControlPoints: let the transform keep an internal copy of the
+ *   coefficients in which the coefficients of each control point are stored contiguously.
+ *   This speeds up the evaluation of the transform, at the cost of memory for one copy of
+ *   the parameters. Not used for the cyclic transform. \n
+ *   example: <tt>(UseInterleavedControlPoints "true")</tt> \n
+ *   The default is "false".
+ * \parameter UseSinglePrecisionControlPoints: like UseInterleavedControlPoints, but the internal
+ *   copy is stored in single precision, which halves its memory traffic. The transform parameters,
+ *   the weights and the sums remain in double precision. Not used for the cyclic transform. \n
+ *   example: <tt>(UseSinglePrecisionControlPoints "true")</tt> \n
+ *   The default is "false".
  *
  *
  * The transform parameters necessary for transformix, additionally defined by this class, are:
@@ -296,6 +307,8 @@ private:
   /** Variables to remember order and periodicity of B-spline transform. */
   unsigned int m_SplineOrder;
   bool         m_Cyclic;
+  bool         m_UseInterleavedControlPoints;
+  bool         m_UseSinglePrecisionControlPoints;
 
   /** Initialize the right B-spline transform based on the spline order and periodicity. */
   unsigned int
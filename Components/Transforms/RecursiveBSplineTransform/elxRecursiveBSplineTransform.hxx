@@ -73,15 +73,24 @@ RecursiveBSplineTransform<TElastix>::InitializeBSplineTransform(void)
 
     if (this->m_SplineOrder == 1)
     {
-      this->m_BSplineTransform = BSplineTransformLinearType::New();
+      const auto bsplineTransform = BSplineTransformLinearType::New();
+      bsplineTransform->SetUseInterleavedCoefficients(this->m_UseInterleavedControlPoints);
+      bsplineTransform->SetUseSinglePrecisionCoefficients(this->m_UseSinglePrecisionControlPoints);
+      this->m_BSplineTransform = bsplineTransform;
     }
     else if (this->m_SplineOrder == 2)
     {
-      this->m_BSplineTransform = BSplineTransformQuadraticType::New();
+      const auto bsplineTransform = BSplineTransformQuadraticType::New();
+      bsplineTransform->SetUseInterleavedCoefficients(this->m_UseInterleavedControlPoints);
+      bsplineTransform->SetUseSinglePrecisionCoefficients(this->m_UseSinglePrecisionControlPoints);
+      this->m_BSplineTransform = bsplineTransform;
     }
     else if (this->m_SplineOrder == 3)
     {
-      this->m_BSplineTransform = BSplineTransformCubicType::New();
+      const auto bsplineTransform = BSplineTransformCubicType::New();
+      bsplineTransform->SetUseInterleavedCoefficients(this->m_UseInterleavedControlPoints);
+      bsplineTransform->SetUseSinglePrecisionCoefficients(this->m_UseSinglePrecisionControlPoints);
+      this->m_BSplineTransform = bsplineTransform;
     }
     else
     {
@@ -112,6 +121,12 @@ RecursiveBSplineTransform<TElastix>::BeforeAll(void)
     this->m_SplineOrder, "BSplineTransformSplineOrder", this->GetComponentLabel(), 0, 0, true);
   this->m_Cyclic = false;
   this->GetConfiguration()->ReadParameter(this->m_Cyclic, "UseCyclicTransform", this->GetComponentLabel(), 0, 0, true);
+  this->m_UseInterleavedControlPoints = false;
+  this->GetConfiguration()->ReadParameter(
+    this->m_UseInterleavedControlPoints, "UseInterleavedControlPoints", this->GetComponentLabel(), 0, 0, false);
+  this->m_UseSinglePrecisionControlPoints = false;
+  this->GetConfiguration()->ReadParameter(
+    this->m_UseSinglePrecisionControlPoints, "UseSinglePrecisionControlPoints", this->GetComponentLabel(), 0, 0, false);
 
   return this->InitializeBSplineTransform();
 } // end BeforeAll()
@@ -460,6 +475,12 @@ RecursiveBSplineTransform<TElastix>::ReadFromFile(void)
     m_SplineOrder, "BSplineTransformSplineOrder", this->GetComponentLabel(), 0, 0);
   m_Cyclic = false;
   this->GetConfiguration()->ReadParameter(m_Cyclic, "UseCyclicTransform", this->GetComponentLabel(), 0, 0);
+  m_UseInterleavedControlPoints = false;
+  this->GetConfiguration()->ReadParameter(
+    m_UseInterleavedControlPoints, "UseInterleavedControlPoints", this->GetComponentLabel(), 0, 0, false);
+  m_UseSinglePrecisionControlPoints = false;
+  this->GetConfiguration()->ReadParameter(
+    m_UseSinglePrecisionControlPoints, "UseSinglePrecisionControlPoints", this->GetComponentLabel(), 0, 0, false);
   InitializeBSplineTransform();
 
   /** Read and Set the Grid: this is a BSplineTransform specific task. */
@@ -25,6 +25,9 @@
 #include "itkObject.h"
 #include "itkMultiResolutionPyramidImageFilter.h"
 
+#include <functional>
+#include <string>
+
 namespace elastix
 {
 
@@ -126,6 +129,21 @@ protected:
   /** The destructor. */
   ~FixedImagePyramidBase() override = default;
 
+  /** Calls generateData, which should be the GenerateData() of the ITK pyramid.
+   * During a batch registration (see itk::BatchDataCache) the pyramid of the
+   * same input, schedule and settings is computed only once. The other
+   * registrations graft its outputs. The settingsKey identifies the settings
+   * of the pyramid other than its schedule.
+   */
+  void
+  GenerateSharedData(const std::function<void()> & generateData, const std::string & settingsKey = "");
+
+  /** Returns the settings of the ITK pyramid, other than its schedule, that
+   * determine its outputs, to be passed as (part of) the settingsKey.
+   */
+  std::string
+  GetPyramidSettingsKey(void) const;
+
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
 
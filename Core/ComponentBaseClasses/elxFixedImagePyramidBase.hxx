@@ -20,6 +20,11 @@
 
 #include "elxFixedImagePyramidBase.h"
 #include "itkImageFileCastWriter.h"
+#include "itkBatchDataCache.h"
+#include "itkSimpleDataObjectDecorator.h"
+
+#include <sstream>
+#include <vector>
 
 namespace elastix
 {
@@ -83,6 +88,79 @@ FixedImagePyramidBase<TElastix>::BeforeEachResolutionBase(void)
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ********************** GenerateSharedData **********************
+ */
+
+template <class TElastix>
+void
+FixedImagePyramidBase<TElastix>::GenerateSharedData(const std::function<void()> & generateData,
+                                                    const std::string &           settingsKey)
+{
+  if (!itk::BatchDataCache::IsEnabled())
+  {
+    generateData();
+    return;
+  }
+
+  ITKBaseType *      pyramid = this->GetAsITKBaseType();
+  const unsigned int numberOfLevels = pyramid->GetNumberOfLevels();
+
+  std::ostringstream key;
+  key << "FixedImagePyramid " << this->elxGetClassName() << ' '
+      << itk::BatchDataCache::MakeImageKey(pyramid->GetInput()) << " levels " << numberOfLevels << " schedule "
+      << pyramid->GetSchedule() << ' ' << settingsKey;
+
+  /** The outputs are shared as grafts; levels that were not computed are null. */
+  typedef std::vector<typename OutputImageType::Pointer>   OutputImagesType;
+  typedef itk::SimpleDataObjectDecorator<OutputImagesType> SharedOutputImagesType;
+  const itk::DataObject::Pointer sharedData = itk::BatchDataCache::GetOrCreate(key.str(), [&] {
+    generateData();
+
+    OutputImagesType outputImages(numberOfLevels);
+    for (unsigned int level = 0; level < numberOfLevels; ++level)
+    {
+      const OutputImageType * output = pyramid->GetOutput(level);
+      if (output->GetBufferedRegion().GetNumberOfPixels() > 0)
+      {
+        outputImages[level] = OutputImageType::New();
+        outputImages[level]->Graft(output);
+      }
+    }
+    const auto sharedOutputImages = SharedOutputImagesType::New();
+    sharedOutputImages->Set(outputImages);
+    return itk::DataObject::Pointer(sharedOutputImages);
+  });
+
+  const OutputImagesType & outputImages = static_cast<const SharedOutputImagesType &>(*sharedData).Get();
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    if (outputImages[level].IsNotNull())
+    {
+      pyramid->GetOutput(level)->Graft(outputImages[level]);
+    }
+  }
+
+} // end GenerateSharedData()
+
+
+/**
+ * ********************** GetPyramidSettingsKey **********************
+ */
+
+template <class TElastix>
+std::string
+FixedImagePyramidBase<TElastix>::GetPyramidSettingsKey(void) const
+{
+  const ITKBaseType * pyramid = this->GetAsITKBaseType();
+
+  std::ostringstream settingsKey;
+  settingsKey << "maximumError " << pyramid->GetMaximumError() << " shrink " << pyramid->GetUseShrinkImageFilter();
+  return settingsKey.str();
+
+} // end GetPyramidSettingsKey()
+
+
 /**
  * ********************** SetFixedSchedule **********************
  */
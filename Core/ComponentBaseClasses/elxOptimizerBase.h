@@ -24,6 +24,11 @@
 
 #include "elxBaseComponentSE.h"
 #include "itkOptimizer.h"
+#include "itkImageSamplerBase.h"
+#include "itkStochasticConvergenceMonitor.h"
+
+#include <map>
+#include <string>
 
 namespace elastix
 {
@@ -45,6 +50,23 @@ namespace elastix
  *    example: <tt>(NewSamplesEveryIteration "true" "true" "true")</tt> \n
  *    Default is "false" for every resolution.\n
  *
+ * The following parameters are used by the optimizers that support the convergence check:
+ * AdaptiveStochasticGradientDescent, AdaGrad, AdaptiveStochasticLBFGS and
+ * AdaptiveStochasticVarianceReducedGradient.
+ * \parameter ConvergenceWindowSize: Stops a resolution before MaximumNumberOfIterations when the
+ *   metric value has not decreased significantly over this number of iterations. A straight line
+ *   is fitted through the last ConvergenceWindowSize metric values, and the resolution stops when
+ *   its slope is not a decrease of at least ConvergenceSignificance standard errors.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(ConvergenceWindowSize 100)</tt>\n
+ *   Default value: 0, which disables the check. Because the metric values of a stochastic optimizer
+ *   are noisy, the window should span many iterations, for example 50 or more.
+ * \parameter ConvergenceSignificance: The number of standard errors by which the metric value has
+ *   to decrease over the last ConvergenceWindowSize iterations for a resolution to go on.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(ConvergenceSignificance 3.0)</tt>\n
+ *   Default value: 2.0. Larger values stop a resolution earlier.
+ *
  * \ingroup Optimizers
  * \ingroup ComponentBaseClasses
  */
@@ -124,10 +146,37 @@ protected:
   virtual void
   SelectNewSamples(void);
 
+  /** Resizes each sampler that supports new samples to relativeNumberOfSamples times
+   * the number of samples it had at the first call in this resolution. The new number
+   * of samples is used from the next call of SelectNewSamples() on.
+   */
+  void
+  SetRelativeNumberOfSamples(double relativeNumberOfSamples);
+
   /** Check whether the user asked to select new samples every iteration. */
   virtual bool
   GetNewSamplesEveryIteration(void) const;
 
+  /** Reads ConvergenceWindowSize and ConvergenceSignificance of the current resolution,
+   * and starts the convergence check anew. Called in BeforeEachResolution() by the
+   * optimizers that support the convergence check.
+   */
+  void
+  InitializeConvergenceCheck(void);
+
+  /** Adds the metric value of the current iteration to the convergence check. Returns
+   * true when the metric value has not decreased significantly over the last
+   * ConvergenceWindowSize iterations. Called in AfterEachIteration() by the optimizers
+   * that support the convergence check, which then stop with their NoSignificantProgress
+   * stop condition.
+   */
+  bool
+  HasConverged(const double value);
+
+  /** The description of the NoSignificantProgress stop condition. */
+  std::string
+  GetConvergenceStopCondition(void) const;
+
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
 
@@ -141,6 +190,14 @@ private:
    * samples each iteration.
    */
   bool m_NewSamplesEveryIteration;
+
+  /** The number of samples of each sampler at the start of the adaptive
+   * number of samples in this resolution, see SetRelativeNumberOfSamples().
+   */
+  std::map<itk::ImageSamplerBase<typename ElastixType::FixedImageType> *, unsigned long> m_NumberOfSamplesOfResolution;
+
+  /** The convergence check of the metric value, see ConvergenceWindowSize. */
+  itk::StochasticConvergenceMonitor::Pointer m_ConvergenceMonitor{ itk::StochasticConvergenceMonitor::New() };
 };
 
 } // end namespace elastix
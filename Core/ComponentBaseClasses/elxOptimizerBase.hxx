@@ -23,6 +23,9 @@
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itk_zlib.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace elastix
 {
 
@@ -75,6 +78,9 @@ OptimizerBase<TElastix>::BeforeEachResolutionBase(void)
   this->GetConfiguration()->ReadParameter(
     this->m_NewSamplesEveryIteration, "NewSamplesEveryIteration", this->GetComponentLabel(), level, 0);
 
+  /** The samplers get their number of samples of this resolution anew. */
+  this->m_NumberOfSamplesOfResolution.clear();
+
 } // end BeforeEachResolutionBase()
 
 
@@ -126,6 +132,37 @@ OptimizerBase<TElastix>::SelectNewSamples(void)
 } // end SelectNewSamples()
 
 
+/**
+ * ****************** SetRelativeNumberOfSamples ****************************
+ */
+
+template <class TElastix>
+void
+OptimizerBase<TElastix>::SetRelativeNumberOfSamples(const double relativeNumberOfSamples)
+{
+  /** Remember the number of samples of each sampler before resizing any of them,
+   * because several metrics may share a sampler. Samplers that do not select new
+   * samples, like the grid and full samplers, keep their number of samples.
+   */
+  const unsigned int numberOfMetrics = this->GetElastix()->GetNumberOfMetrics();
+  for (unsigned int i = 0; i < numberOfMetrics; ++i)
+  {
+    const auto sampler = this->GetElastix()->GetElxMetricBase(i)->GetAdvancedMetricImageSampler();
+    if (sampler != nullptr && sampler->SelectingNewSamplesOnUpdateSupported())
+    {
+      this->m_NumberOfSamplesOfResolution.emplace(sampler, sampler->GetNumberOfSamples());
+    }
+  }
+
+  for (const auto & samplerAndNumberOfSamples : this->m_NumberOfSamplesOfResolution)
+  {
+    const double numberOfSamples = std::round(relativeNumberOfSamples * samplerAndNumberOfSamples.second);
+    samplerAndNumberOfSamples.first->SetNumberOfSamples(static_cast<unsigned long>(std::max(1.0, numberOfSamples)));
+  }
+
+} // end SetRelativeNumberOfSamples()
+
+
 /**
  * ****************** GetNewSamplesEveryIteration ********************
  */
@@ -140,6 +177,59 @@ OptimizerBase<TElastix>::GetNewSamplesEveryIteration(void) const
 } // end GetNewSamplesEveryIteration()
 
 
+/**
+ * ****************** InitializeConvergenceCheck ********************
+ */
+
+template <class TElastix>
+void
+OptimizerBase<TElastix>::InitializeConvergenceCheck(void)
+{
+  /** Get the current resolution level. */
+  unsigned int level = this->GetRegistration()->GetAsITKBaseType()->GetCurrentLevel();
+
+  /** The resolution stops when the metric value has not decreased significantly over
+   * the last ConvergenceWindowSize iterations. Default: 0, i.e. no check, so that
+   * MaximumNumberOfIterations are always done.
+   */
+  unsigned int convergenceWindowSize = 0;
+  double       convergenceSignificance = 2.0;
+  this->GetConfiguration()->ReadParameter(
+    convergenceWindowSize, "ConvergenceWindowSize", this->GetComponentLabel(), level, 0);
+  this->GetConfiguration()->ReadParameter(
+    convergenceSignificance, "ConvergenceSignificance", this->GetComponentLabel(), level, 0);
+  this->m_ConvergenceMonitor->Initialize(convergenceWindowSize, convergenceSignificance);
+
+} // end InitializeConvergenceCheck()
+
+
+/**
+ * ****************** HasConverged ********************
+ */
+
+template <class TElastix>
+bool
+OptimizerBase<TElastix>::HasConverged(const double value)
+{
+  return this->m_ConvergenceMonitor->AddValue(value);
+
+} // end HasConverged()
+
+
+/**
+ * ****************** GetConvergenceStopCondition ********************
+ */
+
+template <class TElastix>
+std::string
+OptimizerBase<TElastix>::GetConvergenceStopCondition(void) const
+{
+  return "The metric value has not decreased significantly over the last " +
+         std::to_string(this->m_ConvergenceMonitor->GetWindowSize()) + " iterations";
+
+} // end GetConvergenceStopCondition()
+
+
 /**
  * ****************** SetSinusScales ********************
  */
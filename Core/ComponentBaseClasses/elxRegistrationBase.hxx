@@ -19,6 +19,9 @@
 #define elxRegistrationBase_hxx
 
 #include "elxRegistrationBase.h"
+#include "itkBatchDataCache.h"
+
+#include <sstream>
 
 namespace elastix
 {
@@ -116,36 +119,44 @@ RegistrationBase<TElastix>::GenerateFixedMaskSpatialObject(const FixedMaskImageT
     return fixedMaskSpatialObject;
   }
 
-  /** Erode, and convert to spatial object. */
-  FixedMaskErodeFilterPointer erosion = FixedMaskErodeFilterType::New();
-  erosion->SetInput(maskImage);
-  erosion->SetSchedule(pyramid->GetSchedule());
-  erosion->SetIsMovingMask(false);
-  erosion->SetResolutionLevel(level);
-
-  /** Set output of the erosion to fixedImageMaskAsImage. */
-  FixedMaskImagePointer erodedFixedMaskAsImage = erosion->GetOutput();
-
-  /** Do the erosion. */
-  try
-  {
-    erodedFixedMaskAsImage->Update();
-  }
-  catch (itk::ExceptionObject & excp)
-  {
-    /** Add information to the exception. */
-    excp.SetLocation("RegistrationBase - UpdateMasks()");
-    std::string err_str = excp.GetDescription();
-    err_str += "\nError while eroding the fixed mask.\n";
-    excp.SetDescription(err_str);
-    /** Pass the exception to an higher level. */
-    throw excp;
-  }
+  /** Erode, and convert to spatial object. During a batch registration the
+   * eroded mask is shared by all registrations, see itk::BatchDataCache.
+   */
+  std::ostringstream key;
+  key << "ErodedFixedMask " << itk::BatchDataCache::MakeImageKey(maskImage) << " schedule " << pyramid->GetSchedule()
+      << " level " << level;
+  const itk::DataObject::Pointer erodedFixedMask = itk::BatchDataCache::GetOrCreate(key.str(), [&] {
+    FixedMaskErodeFilterPointer erosion = FixedMaskErodeFilterType::New();
+    erosion->SetInput(maskImage);
+    erosion->SetSchedule(pyramid->GetSchedule());
+    erosion->SetIsMovingMask(false);
+    erosion->SetResolutionLevel(level);
+
+    /** Set output of the erosion to fixedImageMaskAsImage. */
+    FixedMaskImagePointer erodedFixedMaskAsImage = erosion->GetOutput();
+
+    /** Do the erosion. */
+    try
+    {
+      erodedFixedMaskAsImage->Update();
+    }
+    catch (itk::ExceptionObject & excp)
+    {
+      /** Add information to the exception. */
+      excp.SetLocation("RegistrationBase - UpdateMasks()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError while eroding the fixed mask.\n";
+      excp.SetDescription(err_str);
+      /** Pass the exception to an higher level. */
+      throw excp;
+    }
 
-  /** Release some memory. */
-  erodedFixedMaskAsImage->DisconnectPipeline();
+    /** Release some memory. */
+    erodedFixedMaskAsImage->DisconnectPipeline();
+    return itk::DataObject::Pointer(erodedFixedMaskAsImage);
+  });
 
-  fixedMaskSpatialObject->SetImage(erodedFixedMaskAsImage);
+  fixedMaskSpatialObject->SetImage(static_cast<const FixedMaskImageType *>(erodedFixedMask.GetPointer()));
   fixedMaskSpatialObject->Update();
   return fixedMaskSpatialObject;
 
@@ -107,6 +107,34 @@ namespace elastix
  * The location is relative to the path from where elastix/transformix is started!\n
  * Default: "NoInitialTransform", which (obviously) means that there is no initial transform
  * to be loaded.
+ * \transformparameter JacobianNumberOfStreamDivisions: The number of chunks in which the
+ * (determinant of the) spatial Jacobian is generated and written, when transformix is run
+ * with "-jac all" or "-jacmat all". Streaming limits the memory use for large images, but
+ * only works for file formats that support streamed writing, like mhd and nrrd.\n
+ * example <tt>(JacobianNumberOfStreamDivisions 8)</tt>\n
+ * Default: 1.
+ * \transformparameter InverseMaximumNumberOfIterations: The maximum number of fixed-point
+ * iterations per voxel, when transformix is run with "-inv all".\n
+ * example <tt>(InverseMaximumNumberOfIterations 30)</tt>\n
+ * Default: 20.
+ * \transformparameter InverseTolerance: The residual |y - T(x)|, in physical units, below
+ * which the inverse x of a voxel y has converged, when transformix is run with "-inv all".\n
+ * example <tt>(InverseTolerance 0.001)</tt>\n
+ * Default: 0.01 times the smallest voxel spacing of the domain of the inverse.
+ * \transformparameter InverseCoarseGridShrinkFactor: The factor by which the grid of the
+ * coarse inverse, which gives the starting points of the iteration, is coarser than the
+ * domain of the inverse. A factor of 1 turns the coarse inverse off.\n
+ * example <tt>(InverseCoarseGridShrinkFactor 2)</tt>\n
+ * Default: 4.
+ * \transformparameter InverseGridSpacingInVoxels: The control point spacing, in voxels of
+ * the domain, of the B-spline transform that is fitted to the inverse.\n
+ * example <tt>(InverseGridSpacingInVoxels 8.0)</tt>\n
+ * Default: 4.0.
+ * \transformparameter InverseNumberOfFittingLevels: The number of levels of the multi-level
+ * B-spline fit of the inverse. Each level doubles the number of mesh elements of the previous
+ * one, and the last level has the grid of InverseGridSpacingInVoxels.\n
+ * example <tt>(InverseNumberOfFittingLevels 2)</tt>\n
+ * Default: as many levels as the grid allows, with at least one mesh element in the first level.
  *
  * The command line arguments used by this class are:
  * \commandlinearg -t0: optional argument for elastix for specifying an initial transform
@@ -122,6 +150,12 @@ namespace elastix
  *    It is also possible to deform all points, thereby generating a deformation field
  *    image. This is done by:\n
  *    example: <tt>-def all</tt> \n
+ * \commandlinearg -inv: optional argument for transformix to compute the inverse of the
+ *    transform. The displacement of the inverse is computed for every voxel of the input
+ *    image (or, without input image, of the output grid) by a fixed-point iteration, and
+ *    written as inverseDeformationField. A B-spline transform fitted to it is written as
+ *    InverseTransformParameters.txt, which can be used by transformix.\n
+ *    example: <tt>-inv all</tt> \n
  *
  * \ingroup Transforms
  * \ingroup ComponentBaseClasses
@@ -252,6 +286,10 @@ public:
   void
   ComputeSpatialJacobian(void) const;
 
+  /** Function to compute the inverse transform, as a displacement field and as a B-spline transform. */
+  void
+  ComputeInverseTransform(void) const;
+
   /** Makes sure that the final parameters from the registration components
    * are copied, set, and stored.
    */
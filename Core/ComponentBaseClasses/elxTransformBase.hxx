@@ -32,6 +32,10 @@
 #include "itkTransformToDisplacementFieldFilter.h"
 #include "itkTransformToDeterminantOfSpatialJacobianSource.h"
 #include "itkTransformToSpatialJacobianSource.h"
+#include "itkTransformToInverseDisplacementFieldSource.h"
+#include "itkDisplacementFieldToBSplineImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageFileWriter.h"
 #include "itkImageGridSampler.h"
 #include "itkContinuousIndex.h"
@@ -42,7 +46,9 @@
 #include "itkTransformMeshFilter.h"
 #include "itkCommonEnums.h"
 
+#include <algorithm> // For max and min_element.
 #include <cassert>
+#include <cmath> // For round.
 #include <fstream>
 #include <iomanip> // For setprecision.
 
@@ -197,6 +203,17 @@ TransformBase<TElastix>::BeforeAllTransformix(void)
     elxout << "-jacmat   " << check << std::endl;
   }
 
+  /** Check for appearance of "-inv". */
+  check = this->m_Configuration->GetCommandLineArgument("-inv");
+  if (check.empty())
+  {
+    elxout << "-inv      unspecified, so no inverse transform computed" << std::endl;
+  }
+  else
+  {
+    elxout << "-inv      " << check << std::endl;
+  }
+
   /** Return a value. */
   return returndummy;
 
@@ -1238,6 +1255,11 @@ TransformBase<TElastix>::ComputeDeterminantOfSpatialJacobian(void) const
   jacWriter->SetInput(infoChanger->GetOutput());
   jacWriter->SetFileName(makeFileName.str().c_str());
 
+  /** Generate and write the output in chunks, if desired, to limit the memory use. */
+  unsigned int numberOfStreamDivisions = 1;
+  this->m_Configuration->ReadParameter(numberOfStreamDivisions, "JacobianNumberOfStreamDivisions", 0, false);
+  jacWriter->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+
   /** Do the writing. */
   elxout << "  Computing and writing the spatial Jacobian determinant..." << std::endl;
   try
@@ -1256,6 +1278,12 @@ TransformBase<TElastix>::ComputeDeterminantOfSpatialJacobian(void) const
     throw excp;
   }
 
+  /** Report the statistics, which were gathered while generating the image. */
+  elxout << "  Minimum determinant of spatial Jacobian: " << jacGenerator->GetMinimumDeterminant() << "\n"
+         << "  Maximum determinant of spatial Jacobian: " << jacGenerator->GetMaximumDeterminant() << "\n"
+         << "  Fraction of folding voxels (determinant <= 0): " << jacGenerator->GetFractionOfFoldingVoxels() << " ("
+         << jacGenerator->GetNumberOfFoldingVoxels() << " voxels)" << std::endl;
+
 } // end ComputeDeterminantOfSpatialJacobian()
 
 
@@ -1324,6 +1352,11 @@ TransformBase<TElastix>::ComputeSpatialJacobian(void) const
   const auto jacWriter = JacobianWriterType::New();
   jacWriter->SetInput(infoChanger->GetOutput());
   jacWriter->SetFileName(makeFileName.str().c_str());
+
+  /** Generate and write the output in chunks, if desired, to limit the memory use. */
+  unsigned int numberOfStreamDivisions = 1;
+  this->m_Configuration->ReadParameter(numberOfStreamDivisions, "JacobianNumberOfStreamDivisions", 0, false);
+  jacWriter->SetNumberOfStreamDivisions(numberOfStreamDivisions);
   /** Hack to change the pixel type to vector. Not necessary for mhd. */
   const auto jacStartWriteCommand = PixelTypeChangeCommandType::New();
   if (resultImageFormat != "mhd")
@@ -1352,6 +1385,281 @@ TransformBase<TElastix>::ComputeSpatialJacobian(void) const
 } // end ComputeSpatialJacobian()
 
 
+/**
+ * ************** ComputeInverseTransform **********************
+ *
+ * This function computes the inverse displacement of every voxel by a
+ * fixed-point iteration, and fits a B-spline transform to the result.
+ */
+
+template <class TElastix>
+void
+TransformBase<TElastix>::ComputeInverseTransform(void) const
+{
+  /** If the optional command "-inv" is given in the command line arguments,
+   * then and only then we continue.
+   */
+  const std::string inv = this->GetConfiguration()->GetCommandLineArgument("-inv");
+  if (inv != "all")
+  {
+    elxout << "  The command-line option \"-inv\" is not used, "
+           << "so no inverse transform computed." << std::endl;
+    return;
+  }
+
+  /** Typedef's. */
+  typedef itk::TransformToInverseDisplacementFieldSource<DeformationFieldImageType, CoordRepType> InverseGeneratorType;
+  typedef itk::DisplacementFieldToBSplineImageFilter<DeformationFieldImageType>                  BSplineFitterType;
+  typedef typename BSplineFitterType::ArrayType                                                  ArrayType;
+  typedef typename BSplineFitterType::DisplacementFieldControlPointLatticeType                   LatticeType;
+  typedef itk::ImageFileWriter<DeformationFieldImageType>                                        InverseWriterType;
+  const unsigned int                                                                             splineOrder = 3;
+
+  /** The domain of the inverse is the grid of the input image, if it is given,
+   * or else the output grid of the resampler.
+   */
+  const auto inverseGenerator = InverseGeneratorType::New();
+  inverseGenerator->SetTransform(const_cast<const ITKBaseType *>(this->GetAsITKBaseType()));
+  if (this->m_Elastix->GetMovingImage() != nullptr)
+  {
+    inverseGenerator->SetOutputParametersFromImage(this->m_Elastix->GetMovingImage());
+  }
+  else
+  {
+    xl::xout["warning"] << "WARNING: There is no input image, so the inverse transform is computed "
+                        << "on the output grid of the resampler (Size, Spacing, Origin, Index and Direction)."
+                        << std::endl;
+    const auto & resampler = *(this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType());
+    inverseGenerator->SetOutputSize(resampler.GetSize());
+    inverseGenerator->SetOutputSpacing(resampler.GetOutputSpacing());
+    inverseGenerator->SetOutputOrigin(resampler.GetOutputOrigin());
+    inverseGenerator->SetOutputIndex(resampler.GetOutputStartIndex());
+    inverseGenerator->SetOutputDirection(resampler.GetOutputDirection());
+  }
+  const auto & domainSize = inverseGenerator->GetOutputRegion().GetSize();
+  const auto & domainSpacing = inverseGenerator->GetOutputSpacing();
+  const auto & domainDirection = inverseGenerator->GetOutputDirection();
+
+  /** Read the settings of the inversion. The default tolerance is a hundredth voxel. */
+  unsigned int maximumNumberOfIterations = 20;
+  double       tolerance = 0.01 * *std::min_element(domainSpacing.Begin(), domainSpacing.End());
+  unsigned int coarseGridShrinkFactor = 4;
+  double       gridSpacingInVoxels = 4.0;
+  unsigned int numberOfFittingLevels = 0;
+  this->m_Configuration->ReadParameter(maximumNumberOfIterations, "InverseMaximumNumberOfIterations", 0, false);
+  this->m_Configuration->ReadParameter(tolerance, "InverseTolerance", 0, false);
+  this->m_Configuration->ReadParameter(coarseGridShrinkFactor, "InverseCoarseGridShrinkFactor", 0, false);
+  this->m_Configuration->ReadParameter(gridSpacingInVoxels, "InverseGridSpacingInVoxels", 0, false);
+  this->m_Configuration->ReadParameter(numberOfFittingLevels, "InverseNumberOfFittingLevels", 0, false);
+  inverseGenerator->SetMaximumNumberOfIterations(maximumNumberOfIterations);
+  inverseGenerator->SetTolerance(tolerance);
+  inverseGenerator->SetCoarseGridShrinkFactor(coarseGridShrinkFactor);
+
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    if (domainSize[i] < 2)
+    {
+      itkExceptionMacro(<< "The domain of the inverse transform should have at least 2 voxels in each dimension.");
+    }
+  }
+
+  /** Track the progress of the generation of the inverse displacement field. */
+  const auto progressObserver =
+    BaseComponent::IsElastixLibrary() ? nullptr : ProgressCommandType::CreateAndConnect(*inverseGenerator);
+
+  /** Fit a B-spline to the inverse displacement field, with a grid that covers
+   * the domain like the grid of an AdvancedBSplineTransform does. The fit is
+   * multi-level: each level fits the residual of the previous ones on a grid with
+   * twice the number of mesh elements, up to the target grid of the last level.
+   */
+  const auto fitter = BSplineFitterType::New();
+  fitter->SetDisplacementField(inverseGenerator->GetOutput());
+  fitter->SetUseInputFieldToDefineTheBSplineDomain(true);
+  fitter->SetEnforceStationaryBoundary(false);
+  fitter->SetEstimateInverse(false);
+  fitter->SetSplineOrder(splineOrder);
+  ArrayType numberOfControlPoints;
+  ArrayType numberOfFittingLevelsArray;
+
+  typename DeformationFieldImageType::SizeType    gridSize;
+  typename DeformationFieldImageType::IndexType   gridIndex;
+  typename DeformationFieldImageType::SpacingType gridSpacing;
+  typename DeformationFieldImageType::PointType   gridOrigin = inverseGenerator->GetOutputOrigin();
+  gridIndex.Fill(0);
+  unsigned int targetNumberOfMeshElements[FixedImageDimension];
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    targetNumberOfMeshElements[i] = std::max<unsigned int>(
+      1, static_cast<unsigned int>(std::round((domainSize[i] - 1) / std::max(gridSpacingInVoxels, 1e-3))));
+  }
+
+  /** By default, use as many levels as the coarsest grid of at least one mesh element allows. */
+  const auto maximumNumberOfFittingLevels =
+    1 + static_cast<unsigned int>(std::floor(std::log2(*std::min_element(
+          targetNumberOfMeshElements, targetNumberOfMeshElements + FixedImageDimension))));
+  if (numberOfFittingLevels == 0 || numberOfFittingLevels > maximumNumberOfFittingLevels)
+  {
+    numberOfFittingLevels = maximumNumberOfFittingLevels;
+  }
+  numberOfFittingLevelsArray.Fill(numberOfFittingLevels);
+
+  const unsigned int refinementFactor = 1U << (numberOfFittingLevels - 1);
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    const double domainExtent = domainSpacing[i] * (domainSize[i] - 1);
+    const auto   numberOfInitialMeshElements = std::max<unsigned int>(
+      1, static_cast<unsigned int>(std::round(static_cast<double>(targetNumberOfMeshElements[i]) / refinementFactor)));
+    const unsigned int numberOfMeshElements = numberOfInitialMeshElements * refinementFactor;
+    numberOfControlPoints[i] = numberOfInitialMeshElements + splineOrder;
+    gridSize[i] = numberOfMeshElements + splineOrder;
+    gridSpacing[i] = domainExtent / numberOfMeshElements;
+  }
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    for (unsigned int j = 0; j < FixedImageDimension; ++j)
+    {
+      gridOrigin[i] -= domainDirection[i][j] * gridSpacing[j] * 0.5 * (splineOrder - 1);
+    }
+  }
+  fitter->SetNumberOfControlPoints(numberOfControlPoints);
+  fitter->SetNumberOfFittingLevels(numberOfFittingLevelsArray);
+
+  elxout << "  Computing the inverse displacement field and fitting a B-spline transform ..." << std::endl;
+  try
+  {
+    fitter->Update();
+  }
+  catch (itk::ExceptionObject & excp)
+  {
+    /** Add information to the exception. */
+    excp.SetLocation("TransformBase - ComputeInverseTransform()");
+    std::string err_str = excp.GetDescription();
+    err_str += "\nError occurred while computing the inverse transform.\n";
+    excp.SetDescription(err_str);
+
+    /** Pass the exception to an higher level. */
+    throw excp;
+  }
+
+  elxout << "  Maximum residual of the inverse displacement field: " << inverseGenerator->GetMaximumResidual() << "\n"
+         << "  Number of voxels for which the inversion did not converge: "
+         << inverseGenerator->GetNumberOfNonConvergedVoxels() << "\n"
+         << "  Mean number of iterations per voxel: " << inverseGenerator->GetMeanNumberOfIterations() << std::endl;
+
+  /** The residual T(T^-1(y)) - y of the fitted inverse T^-1, at every voxel y of the
+   * domain. The output of the fitter is the fitted B-spline, sampled on the domain.
+   */
+  const DeformationFieldImageType * const fittedField = fitter->GetOutput();
+  double                                  maximumFittedResidual = 0.0;
+  double                                  sumOfFittedResiduals = 0.0;
+  for (itk::ImageRegionConstIteratorWithIndex<DeformationFieldImageType> it(fittedField,
+                                                                             fittedField->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    InputPointType y;
+    fittedField->TransformIndexToPhysicalPoint(it.GetIndex(), y);
+    InputPointType x = y;
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      x[i] += it.Get()[i];
+    }
+    const double residual = y.EuclideanDistanceTo(this->GetAsITKBaseType()->TransformPoint(x));
+    maximumFittedResidual = std::max(maximumFittedResidual, residual);
+    sumOfFittedResiduals += residual;
+  }
+  elxout << "  Number of B-spline fitting levels: " << numberOfFittingLevels << "\n"
+         << "  Maximum residual of the fitted inverse: " << maximumFittedResidual << "\n"
+         << "  Mean residual of the fitted inverse: "
+         << sumOfFittedResiduals / fittedField->GetBufferedRegion().GetNumberOfPixels() << std::endl;
+
+  /** Store the control points of the lattice as B-spline transform parameters. */
+  const LatticeType * const  lattice = fitter->GetDisplacementFieldControlPointLattice();
+  const itk::SizeValueType   numberOfControlPointsTotal = lattice->GetLargestPossibleRegion().GetNumberOfPixels();
+  ParametersType             inverseParameters(FixedImageDimension * numberOfControlPointsTotal);
+  itk::SizeValueType         controlPointIndex = 0;
+  for (itk::ImageRegionConstIterator<LatticeType> it(lattice, lattice->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it, ++controlPointIndex)
+  {
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      inverseParameters[i * numberOfControlPointsTotal + controlPointIndex] = it.Get()[i];
+    }
+  }
+
+  /** Create the parameter map of the inverse transform. The fixed and moving
+   * image of the inverse are the moving and fixed image of this transform.
+   */
+  std::string fixpix = "float";
+  std::string movpix = "float";
+  this->m_Configuration->ReadParameter(fixpix, "FixedInternalImagePixelType", 0, false);
+  this->m_Configuration->ReadParameter(movpix, "MovingInternalImagePixelType", 0, false);
+
+  ParameterMapType parameterMap = {
+    { "Transform", { "BSplineTransform" } },
+    { "NumberOfParameters", { Conversion::ToString(inverseParameters.GetSize()) } },
+    { "TransformParameters", Conversion::ToVectorOfStrings(inverseParameters) },
+    { "InitialTransformParametersFileName", { "NoInitialTransform" } },
+    { "HowToCombineTransforms", { "Compose" } },
+    { "FixedImageDimension", { Conversion::ToString(MovingImageDimension) } },
+    { "MovingImageDimension", { Conversion::ToString(FixedImageDimension) } },
+    { "FixedInternalImagePixelType", { movpix } },
+    { "MovingInternalImagePixelType", { fixpix } },
+    { "Size", Conversion::ToVectorOfStrings(domainSize) },
+    { "Index", Conversion::ToVectorOfStrings(inverseGenerator->GetOutputRegion().GetIndex()) },
+    { "Spacing", Conversion::ToVectorOfStrings(domainSpacing) },
+    { "Origin", Conversion::ToVectorOfStrings(inverseGenerator->GetOutputOrigin()) },
+    { "Direction", Conversion::ToVectorOfStrings(domainDirection) },
+    { "UseDirectionCosines", { Conversion::ToString(this->GetElastix()->GetUseDirectionCosines()) } },
+    { "GridSize", Conversion::ToVectorOfStrings(gridSize) },
+    { "GridIndex", Conversion::ToVectorOfStrings(gridIndex) },
+    { "GridSpacing", Conversion::ToVectorOfStrings(gridSpacing) },
+    { "GridOrigin", Conversion::ToVectorOfStrings(gridOrigin) },
+    { "GridDirection", Conversion::ToVectorOfStrings(domainDirection) },
+    { "BSplineTransformSplineOrder", { Conversion::ToString(splineOrder) } },
+    { "UseCyclicTransform", { Conversion::ToString(false) } }
+  };
+  this->m_Elastix->GetElxResampleInterpolatorBase()->CreateTransformParametersMap(parameterMap);
+  this->m_Elastix->GetElxResamplerBase()->CreateTransformParametersMap(parameterMap);
+
+  /** Put the inverse in the elastix object, for the library. */
+  this->m_Elastix->SetInverseTransformParametersMap(parameterMap);
+
+  if (!BaseComponent::IsElastixLibrary())
+  {
+    /** Write the dense inverse displacement field and the fitted inverse transform. */
+    std::string resultImageFormat = "mhd";
+    this->m_Configuration->ReadParameter(resultImageFormat, "ResultImageFormat", 0, false);
+    const std::string outputDirectory = this->m_Configuration->GetCommandLineArgument("-out");
+
+    const auto inverseWriter = InverseWriterType::New();
+    inverseWriter->SetInput(inverseGenerator->GetOutput());
+    inverseWriter->SetFileName(outputDirectory + "inverseDeformationField." + resultImageFormat);
+    try
+    {
+      inverseWriter->Update();
+    }
+    catch (itk::ExceptionObject & excp)
+    {
+      /** Add information to the exception. */
+      excp.SetLocation("TransformBase - ComputeInverseTransform()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError occurred while writing the inverse deformation field image.\n";
+      excp.SetDescription(err_str);
+
+      /** Pass the exception to an higher level. */
+      throw excp;
+    }
+
+    const std::string inverseFileName = outputDirectory + "InverseTransformParameters.txt";
+    std::ofstream     inverseFile(inverseFileName);
+    inverseFile << Conversion::ParameterMapToString(parameterMap);
+    elxout << "  The inverse transform is written to " << inverseFileName << std::endl;
+  }
+
+} // end ComputeInverseTransform()
+
+
 /**
  * ************** SetTransformParametersFileName ****************
  */
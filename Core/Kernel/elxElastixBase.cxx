@@ -434,6 +434,52 @@ ElastixBase::BeforeAllTransformixBase(void)
 } // end BeforeAllTransformixBase()
 
 
+/**
+ * ************************ BeforeEachTransformixBase ***************************
+ */
+
+int
+ElastixBase::BeforeEachTransformixBase(void)
+{
+  /** Declare the return value and initialize it. */
+  int returndummy = 0;
+
+  /** Check Command line options and print them to the logfile. */
+  elxout << "Command line options from ElastixBase:" << std::endl;
+  if (!BaseComponent::IsElastixLibrary())
+  {
+    /** Read the input image filenames again, since they may differ from the previous call. */
+    int inreturndummy = 0;
+    this->m_MovingImageFileNameContainer =
+      GenerateFileNameContainer(*(this->m_Configuration), "-in", inreturndummy, false, true);
+    if (inreturndummy != 0)
+    {
+      elxout << "-in       unspecified, so no input image specified" << std::endl;
+    }
+  }
+
+  /** Check for appearance of "-out". */
+  const std::string check = this->GetConfiguration()->GetCommandLineArgument("-out");
+  if (check.empty())
+  {
+    xl::xout["error"] << "ERROR: No CommandLine option \"-out\" given!" << std::endl;
+    returndummy |= 1;
+  }
+  else
+  {
+    /** Make sure that last character of -out equals a '/'. */
+    if (check.back() != '/')
+    {
+      this->GetConfiguration()->SetCommandLineArgument("-out", check + '/');
+    }
+    elxout << "-out      " << check << std::endl;
+  }
+
+  return returndummy;
+
+} // end BeforeEachTransformixBase()
+
+
 /**
  * ************************ BeforeRegistrationBase ******************
  */
@@ -546,6 +592,28 @@ ElastixBase::GetTransformParametersMap(void) const
 } // end GetTransformParametersMap()
 
 
+/**
+ * ************** SetInverseTransformParametersMap *****************
+ */
+
+void
+ElastixBase::SetInverseTransformParametersMap(const ParameterMapType & parameterMap)
+{
+  this->m_InverseTransformParametersMap = parameterMap;
+} // end SetInverseTransformParametersMap()
+
+
+/**
+ * ************** GetInverseTransformParametersMap *****************
+ */
+
+itk::ParameterMapInterface::ParameterMapType
+ElastixBase::GetInverseTransformParametersMap(void) const
+{
+  return this->m_InverseTransformParametersMap;
+} // end GetInverseTransformParametersMap()
+
+
 /**
  * ************** SetConfigurations *********************
  */
@@ -37,11 +37,14 @@
 // ITK header files:
 #include <itkChangeInformationImageFilter.h>
 #include <itkDataObject.h>
+#include <itkImageAlgorithm.h>
 #include <itkImageFileReader.h>
+#include <itkMemoryMappedImageContainer.h>
 #include <itkObject.h>
 #include <itkTimeProbe.h>
 #include <itkVectorContainer.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 
@@ -306,9 +309,13 @@ public:
   virtual int
   Run(void) = 0;
 
-  /** Empty ApplyTransform()-function to be overridden. */
+  /** Empty ApplyTransform()-function to be overridden.
+   * When doReadTransform is false, the components are assumed to be configured
+   * already, and to have read the transform parameters in a previous call.
+   * This allows a prepared transform to be applied to many inputs.
+   */
   virtual int
-  ApplyTransform(void) = 0;
+  ApplyTransform(const bool doReadTransform = true) = 0;
 
   /** Function that is called at the very beginning of ElastixTemplate::Run().
    * It checks the command line input arguments.
@@ -322,6 +329,13 @@ public:
   int
   BeforeAllTransformixBase(void);
 
+  /** Function that is called at the beginning of ElastixTemplate::ApplyTransform(),
+   * when the transform was already read by a previous call. It only updates the
+   * command line input arguments that may differ per call, like "-in" and "-out".
+   */
+  int
+  BeforeEachTransformixBase(void);
+
   /** Function called before registration.
    * It installs the IterationInfo field.
    */
@@ -374,6 +388,13 @@ public:
   ParameterMapType
   GetTransformParametersMap(void) const;
 
+  /** Set/Get the parameter map of the inverse transform, computed by transformix with "-inv all". */
+  void
+  SetInverseTransformParametersMap(const ParameterMapType & parameterMap);
+
+  ParameterMapType
+  GetInverseTransformParametersMap(void) const;
+
   /** Set configuration vector. Library only. */
   void
   SetConfigurations(const std::vector<ConfigurationPointer> & configurations);
@@ -426,6 +447,9 @@ protected:
   /** Stores transformation parameters map. */
   ParameterMapType m_TransformParametersMap;
 
+  /** Stores the parameter map of the inverse transform. */
+  ParameterMapType m_InverseTransformParametersMap;
+
   std::ofstream m_IterationInfoFile;
 
   /** Convenient mini class to load the files specified by a filename container
@@ -439,6 +463,13 @@ protected:
    * The useDirection option is built in as a means to ignore the direction
    * cosines. Set it to false to force the direction cosines to identity.
    * The original direction cosines are returned separately.
+   *
+   * When a memoryMapDirectory is given, the images are read out-of-core: their
+   * pixels are stored in a memory-mapped temporary file in that directory, and
+   * they are read in chunks, see StreamIntoMemoryMappedImage(). A warning is
+   * printed when the ImageIO of a file cannot read in chunks. Only the loaded
+   * images themselves are out-of-core; images derived from them, like the
+   * pyramid images, are allocated in RAM as usual.
    */
   template <class TImage>
   class ITK_TEMPLATE_EXPORT MultipleImageLoader
@@ -450,7 +481,8 @@ protected:
     GenerateImageContainer(const FileNameContainerType * const fileNameContainer,
                            const std::string &                 imageDescription,
                            bool                                useDirectionCosines,
-                           DirectionType *                     originalDirectionCosines = nullptr)
+                           DirectionType *                     originalDirectionCosines = nullptr,
+                           const std::string &                 memoryMapDirectory = "")
     {
       const auto imageContainer = DataObjectContainerType::New();
 
@@ -468,9 +500,26 @@ protected:
         infoChanger->SetInput(imageReader->GetOutput());
 
         /** Do the reading. */
+        typename TImage::Pointer image;
         try
         {
-          infoChanger->Update();
+          if (memoryMapDirectory.empty())
+          {
+            infoChanger->Update();
+            image = infoChanger->GetOutput();
+          }
+          else
+          {
+            imageReader->UpdateOutputInformation();
+            if (!imageReader->GetImageIO()->CanStreamRead())
+            {
+              xl::xout["warning"] << "WARNING: The ImageIO of " << fileName
+                                  << " does not support streaming. The " << imageDescription
+                                  << " is therefore read into memory entirely, before it is copied out-of-core."
+                                  << std::endl;
+            }
+            image = StreamIntoMemoryMappedImage(infoChanger->GetOutput(), memoryMapDirectory);
+          }
         }
         catch (itk::ExceptionObject & excp)
         {
@@ -484,8 +533,7 @@ protected:
         }
 
         /** Store loaded image in the image container, as a DataObjectPointer. */
-        const auto image = infoChanger->GetOutput();
-        imageContainer->push_back(image);
+        imageContainer->push_back(image.GetPointer());
 
         /** Store the original direction cosines */
         if (originalDirectionCosines != nullptr)
@@ -500,6 +548,58 @@ protected:
     } // end static method GenerateImageContainer
 
 
+    /** Updates the source image in slabs along its last dimension, of at most
+     * 64 MB each, and copies each slab into a new image whose pixel container
+     * is a memory-mapped temporary file in the given directory. When the
+     * ImageIO of the file supports streaming, only one slab is in RAM at a time.
+     */
+    static typename TImage::Pointer
+    StreamIntoMemoryMappedImage(TImage * const source, const std::string & directory)
+    {
+      typedef typename TImage::PixelType                                      PixelType;
+      typedef typename TImage::RegionType                                     RegionType;
+      typedef itk::MemoryMappedImageContainer<itk::SizeValueType, PixelType> PixelContainerType;
+
+      const unsigned int       lastDimension = TImage::ImageDimension - 1;
+      const itk::SizeValueType chunkSizeInBytes = 64 * 1024 * 1024;
+
+      source->UpdateOutputInformation();
+      const RegionType largestRegion = source->GetLargestPossibleRegion();
+
+      const auto pixelContainer = PixelContainerType::New();
+      pixelContainer->MapTemporaryFile(directory, largestRegion.GetNumberOfPixels());
+
+      const auto image = TImage::New();
+      image->CopyInformation(source);
+      image->SetRegions(largestRegion);
+      image->SetPixelContainer(pixelContainer);
+
+      const itk::SizeValueType numberOfSlices = largestRegion.GetSize(lastDimension);
+      if (numberOfSlices == 0)
+      {
+        return image;
+      }
+      const itk::SizeValueType sliceSizeInBytes =
+        largestRegion.GetNumberOfPixels() / numberOfSlices * sizeof(PixelType);
+      const itk::SizeValueType slicesPerSlab =
+        std::max<itk::SizeValueType>(1, chunkSizeInBytes / std::max<itk::SizeValueType>(1, sliceSizeInBytes));
+
+      RegionType slab = largestRegion;
+      for (itk::SizeValueType firstSlice = 0; firstSlice < numberOfSlices; firstSlice += slicesPerSlab)
+      {
+        slab.SetIndex(lastDimension,
+                      largestRegion.GetIndex(lastDimension) + static_cast<itk::IndexValueType>(firstSlice));
+        slab.SetSize(lastDimension, std::min(slicesPerSlab, numberOfSlices - firstSlice));
+        source->SetRequestedRegion(slab);
+        source->Update();
+        itk::ImageAlgorithm::Copy(source, image.GetPointer(), slab, slab);
+      }
+
+      return image;
+
+    } // end static method StreamIntoMemoryMappedImage
+
+
     MultipleImageLoader() = default;
     ~MultipleImageLoader() = default;
   };
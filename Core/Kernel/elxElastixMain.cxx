@@ -30,6 +30,8 @@
 #include "elxMacro.h"
 #include "itkPlatformMultiThreader.h"
 
+#include <sstream>
+
 #ifdef ELASTIX_USE_OPENCL
 #  include "itkOpenCLContext.h"
 #  include "itkOpenCLSetup.h"
@@ -57,6 +59,15 @@ struct Data
 
 Data g_data;
 
+/** The xout TargetCells of the calling thread, when it does not use the global ones. */
+thread_local Data * t_data{ nullptr };
+
+Data &
+GetData()
+{
+  return (t_data == nullptr) ? g_data : *t_data;
+}
+
 } // end unnamed namespace
 
 /**
@@ -69,13 +80,14 @@ Data g_data;
 int
 elastix::xoutSetup(const char * logfilename, bool setupLogging, bool setupCout)
 {
-  int returndummy = 0;
+  int    returndummy = 0;
+  Data & data = GetData();
 
   if (setupLogging)
   {
     /** Open the logfile for writing. */
-    g_data.LogFileStream.open(logfilename);
-    if (!g_data.LogFileStream.is_open())
+    data.LogFileStream.open(logfilename);
+    if (!data.LogFileStream.is_open())
     {
       std::cerr << "ERROR: LogFile cannot be opened!" << std::endl;
       return 1;
@@ -85,7 +97,7 @@ elastix::xoutSetup(const char * logfilename, bool setupLogging, bool setupCout)
   /** Set std::cout and the logfile as outputs of xout. */
   if (setupLogging)
   {
-    returndummy |= xl::xout.AddOutput("log", &g_data.LogFileStream);
+    returndummy |= xl::xout.AddOutput("log", &data.LogFileStream);
   }
   if (setupCout)
   {
@@ -93,24 +105,24 @@ elastix::xoutSetup(const char * logfilename, bool setupLogging, bool setupCout)
   }
 
   /** Set outputs of LogOnly and CoutOnly. */
-  returndummy |= g_data.LogOnlyXout.AddOutput("log", &g_data.LogFileStream);
-  returndummy |= g_data.CoutOnlyXout.AddOutput("cout", &std::cout);
+  returndummy |= data.LogOnlyXout.AddOutput("log", &data.LogFileStream);
+  returndummy |= data.CoutOnlyXout.AddOutput("cout", &std::cout);
 
   /** Copy the outputs to the warning-, error- and standard-xouts. */
-  g_data.WarningXout.SetOutputs(xl::xout.GetCOutputs());
-  g_data.ErrorXout.SetOutputs(xl::xout.GetCOutputs());
-  g_data.StandardXout.SetOutputs(xl::xout.GetCOutputs());
+  data.WarningXout.SetOutputs(xl::xout.GetCOutputs());
+  data.ErrorXout.SetOutputs(xl::xout.GetCOutputs());
+  data.StandardXout.SetOutputs(xl::xout.GetCOutputs());
 
-  g_data.WarningXout.SetOutputs(xl::xout.GetXOutputs());
-  g_data.ErrorXout.SetOutputs(xl::xout.GetXOutputs());
-  g_data.StandardXout.SetOutputs(xl::xout.GetXOutputs());
+  data.WarningXout.SetOutputs(xl::xout.GetXOutputs());
+  data.ErrorXout.SetOutputs(xl::xout.GetXOutputs());
+  data.StandardXout.SetOutputs(xl::xout.GetXOutputs());
 
   /** Link the warning-, error- and standard-xouts to xout. */
-  returndummy |= xl::xout.AddTargetCell("warning", &g_data.WarningXout);
-  returndummy |= xl::xout.AddTargetCell("error", &g_data.ErrorXout);
-  returndummy |= xl::xout.AddTargetCell("standard", &g_data.StandardXout);
-  returndummy |= xl::xout.AddTargetCell("logonly", &g_data.LogOnlyXout);
-  returndummy |= xl::xout.AddTargetCell("coutonly", &g_data.CoutOnlyXout);
+  returndummy |= xl::xout.AddTargetCell("warning", &data.WarningXout);
+  returndummy |= xl::xout.AddTargetCell("error", &data.ErrorXout);
+  returndummy |= xl::xout.AddTargetCell("standard", &data.StandardXout);
+  returndummy |= xl::xout.AddTargetCell("logonly", &data.LogOnlyXout);
+  returndummy |= xl::xout.AddTargetCell("coutonly", &data.CoutOnlyXout);
 
   /** Format the output. */
   xl::xout["standard"] << std::fixed;
@@ -144,6 +156,51 @@ xoutManager::Guard::~Guard()
 }
 
 
+/**
+ * ********************* xoutThreadManager ******************************
+ */
+
+struct xoutThreadManager::ThreadData
+{
+  xl::xoutmain       Xout;
+  Data               XoutData;
+  std::ostringstream ErrorStream;
+  xl::xoutmain *     PreviousXout;
+  Data *             PreviousData;
+};
+
+
+xoutThreadManager::xoutThreadManager(const std::string & logFileName, const bool setupLogging, const bool setupCout)
+  : m_ThreadData(new ThreadData)
+{
+  m_ThreadData->PreviousXout = xl::set_thread_xout(&m_ThreadData->Xout);
+  m_ThreadData->PreviousData = t_data;
+  t_data = &m_ThreadData->XoutData;
+
+  if (xoutSetup(logFileName.c_str(), setupLogging, setupCout) ||
+      m_ThreadData->XoutData.ErrorXout.AddOutput("errorstream", &m_ThreadData->ErrorStream))
+  {
+    xl::set_thread_xout(m_ThreadData->PreviousXout);
+    t_data = m_ThreadData->PreviousData;
+    itkGenericExceptionMacro("Error while setting up xout");
+  }
+}
+
+
+xoutThreadManager::~xoutThreadManager()
+{
+  xl::set_thread_xout(m_ThreadData->PreviousXout);
+  t_data = m_ThreadData->PreviousData;
+}
+
+
+std::string
+xoutThreadManager::GetErrorMessages() const
+{
+  return m_ThreadData->ErrorStream.str();
+}
+
+
 /**
  * ********************* Constructor ****************************
  */
@@ -175,6 +232,8 @@ ElastixMain::ElastixMain()
   this->m_InitialTransform = nullptr;
   this->m_TransformParametersMap.clear();
 
+  this->m_LimitGlobalMaximumNumberOfThreads = true;
+
 } // end Constructor
 
 
@@ -905,8 +964,8 @@ ElastixMain::SetMaximumNumberOfThreads(void) const
   /** Get the number of threads from the command line. */
   std::string maximumNumberOfThreadsString = this->m_Configuration->GetCommandLineArgument("-threads");
 
-  /** If supplied, set the maximum number of threads. */
-  if (!maximumNumberOfThreadsString.empty())
+  /** If supplied, set the maximum number of threads. The metric reads "-threads" itself. */
+  if (!maximumNumberOfThreadsString.empty() && this->m_LimitGlobalMaximumNumberOfThreads)
   {
     const int maximumNumberOfThreads = atoi(maximumNumberOfThreadsString.c_str());
     itk::MultiThreaderBase::SetGlobalMaximumNumberOfThreads(maximumNumberOfThreads);
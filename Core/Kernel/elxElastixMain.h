@@ -28,6 +28,7 @@
 // Standard C++ header files:
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
 
@@ -82,6 +83,34 @@ private:
 };
 
 
+/** Sets up "xout" output streams for the calling thread only, and closes them again
+ * on destruction. Meanwhile, "xout" refers to these streams in the calling thread,
+ * so that registrations that run concurrently, each in its own thread, each have
+ * their own log. Other threads, including the ITK worker threads of a registration,
+ * keep using the global "xout" output streams.
+ */
+class xoutThreadManager
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(xoutThreadManager);
+
+  /** Sets up the "xout" output streams of the calling thread. */
+  explicit xoutThreadManager(const std::string & logfilename, const bool setupLogging, const bool setupCout);
+
+  /** Makes the calling thread use the "xout" output streams it used before. */
+  ~xoutThreadManager();
+
+  /** Returns everything that was written to xout["error"] by the calling thread. */
+  std::string
+  GetErrorMessages() const;
+
+private:
+  struct ThreadData;
+
+  const std::unique_ptr<ThreadData> m_ThreadData;
+};
+
+
 /**
  * \class ElastixMain
  * \brief A class with all functionality to configure elastix.
@@ -306,10 +335,19 @@ public:
   /** Set maximum number of threads, which is read from the command line arguments.
    * Syntax:
    * -threads \<int\>
+   * It only sets the global maximum number of ITK threads when
+   * LimitGlobalMaximumNumberOfThreads is true.
    */
   virtual void
   SetMaximumNumberOfThreads(void) const;
 
+  /** Set/Get whether "-threads" limits the global maximum number of ITK threads, or
+   * only the threads of the metric, for a registration that runs concurrently with
+   * others in the same process. Default true.
+   */
+  itkSetMacro(LimitGlobalMaximumNumberOfThreads, bool);
+  itkGetConstMacro(LimitGlobalMaximumNumberOfThreads, bool);
+
   /** Function to get the ComponentDatabase. */
   static const ComponentDatabase &
   GetComponentDatabase(void);
@@ -361,6 +399,8 @@ protected:
 
   FlatDirectionCosinesType m_OriginalFixedImageDirection;
 
+  bool m_LimitGlobalMaximumNumberOfThreads;
+
   /** InitDBIndex sets m_DBIndex by asking the ImageTypes
    * from the Configuration object and obtaining the corresponding
    * DB index from the ComponentDatabase.
@@ -38,7 +38,13 @@
 #include "elxResampleInterpolatorBase.h"
 #include "elxTransformBase.h"
 
+#include "itkPerformanceTelemetry.h"
+#include "itkScaledSingleValuedNonLinearOptimizer.h"
+
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 /**
  * Macro that defines to functions. In the case of
@@ -86,6 +92,34 @@ namespace elastix
  *    example: <tt>(WriteTransformParametersEachResolution "true")</tt>\n
  *    This parameter can not be specified for each resolution separately.
  *    Default value: "false".
+ * \parameter WritePerformanceTelemetry: Controls whether to write timers and
+ *    counters of the metrics, image samplers and optimizers to the file
+ *    PerformanceTelemetry.<elastixlevel>.jsonl in the output directory. The
+ *    file has a JSON line per iteration, and a summary line per resolution,
+ *    with the time, the number of samples, the ratio of valid samples and
+ *    the bytes allocated.\n
+ *    example: <tt>(WritePerformanceTelemetry "true")</tt>\n
+ *    This parameter can not be specified for each resolution separately.
+ *    Default value: "false".
+ * \parameter OutOfCoreInputImages: Controls whether the fixed and moving images
+ *    and masks that are read from file are stored out-of-core, in memory-mapped
+ *    temporary files, instead of in RAM. Only these input images are
+ *    out-of-core. The images are read in chunks, and the operating system only
+ *    keeps the parts that are accessed in memory. The pyramid images and the
+ *    result image are still allocated in RAM, and the image samplers and
+ *    interpolators have no chunked access of their own: they read the pixels
+ *    of the pyramid images. So this option lowers the memory use of the input
+ *    images, but it does not allow the registration of images that are larger
+ *    than the memory. Streamed reading requires a file format whose ImageIO
+ *    supports it, like .mha or .nrrd; otherwise a warning is printed. Images
+ *    that are passed in memory, through the elastix library, are not affected,
+ *    and a warning is printed as well.\n
+ *    example: <tt>(OutOfCoreInputImages "true")</tt>\n
+ *    Default value: "false".
+ * \parameter OutOfCoreDirectory: The directory of the temporary files of
+ *    OutOfCoreInputImages. Preferably on a fast local disk.\n
+ *    example: <tt>(OutOfCoreDirectory "/scratch")</tt>\n
+ *    Default value: the output directory.
  * \parameter UseDirectionCosines: Controls whether to use or ignore the
  * direction cosines (world matrix, transform matrix) set in the images.
  * Voxel spacing and image origin are always taken into account, regardless
@@ -218,7 +252,7 @@ public:
   Run(void) override;
 
   int
-  ApplyTransform(void) override;
+  ApplyTransform(const bool doReadTransform = true) override;
 
   /** The Callback functions. */
   int
@@ -264,6 +298,13 @@ private:
   AfterEachIterationCommandPointer   m_AfterEachIterationCommand{};
   AfterEachResolutionCommandPointer  m_AfterEachResolutionCommand{};
 
+  /** The telemetry object, null when WritePerformanceTelemetry is false,
+   * the statistics of the current resolution, and the output file.
+   */
+  itk::PerformanceTelemetry::Pointer        m_PerformanceTelemetry{};
+  itk::PerformanceTelemetry::StatisticsType m_ResolutionTelemetry{};
+  std::ofstream                             m_PerformanceTelemetryFile{};
+
   /** CreateTransformParameterFile. */
   void
   CreateTransformParameterFile(const std::string & FileName, const bool ToLog);
@@ -276,6 +317,20 @@ private:
   void
   OpenIterationInfoFile(void);
 
+  /** Open the PerformanceTelemetry file, and pass the telemetry object to
+   * the metrics, image samplers and optimizers.
+   */
+  void
+  InitializePerformanceTelemetry(void);
+
+  /** Write a line to the PerformanceTelemetry file: the statistics of one
+   * iteration, or the summed statistics of a resolution.
+   */
+  void
+  WritePerformanceTelemetry(const bool                                        isResolution,
+                            const double                                      timeInSeconds,
+                            const itk::PerformanceTelemetry::StatisticsType & statistics);
+
   /** Used by the callback functions, BeforeEachResolution() etc.).
    * This method calls a function in each component, in the following order:
    * \li Registration
@@ -295,6 +350,13 @@ private:
   int
   CallInEachComponentInt(PtrToMemberFunction2 func);
 
+  /** Calls first func1 and then func2 in each component, in the same order as
+   * CallInEachComponent(), and returns for each component its label and the
+   * time in seconds spent in both calls.
+   */
+  std::vector<std::pair<std::string, double>>
+  CallInEachComponentTimed(PtrToMemberFunction func1, PtrToMemberFunction func2);
+
   /** Call in each component SetElastix(This) and set its ComponentLabel
    * (for example "Metric1"). This makes sure that the component knows its
    * own function in the registration process.
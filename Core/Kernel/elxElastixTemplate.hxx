@@ -152,13 +152,35 @@ ElastixTemplate<TFixedImage, TMovingImage>::Run(void)
   this->m_Timer0.Start();
   elxout << "\nReading images..." << std::endl;
 
+  /** Read the input images out-of-core, in memory-mapped temporary files, if requested.
+   * The pyramid images are still allocated in RAM.
+   */
+  bool outOfCoreInputImages = false;
+  this->GetConfiguration()->ReadParameter(outOfCoreInputImages, "OutOfCoreInputImages", 0, false);
+  std::string outOfCoreDirectory = "";
+  if (outOfCoreInputImages)
+  {
+    outOfCoreDirectory = this->GetConfiguration()->GetCommandLineArgument("-out");
+    this->GetConfiguration()->ReadParameter(outOfCoreDirectory, "OutOfCoreDirectory", 0, false);
+    elxout << "The input images are stored out-of-core, in temporary files in: " << outOfCoreDirectory << "\n"
+           << "  The pyramid images are still stored in RAM." << std::endl;
+
+    if ((this->GetFixedImage() != nullptr) || (this->GetMovingImage() != nullptr))
+    {
+      xl::xout["warning"] << "WARNING: OutOfCoreInputImages only applies to images that are read from file.\n"
+                          << "  The images that are passed in memory, like through the elastix library, are not "
+                             "stored out-of-core."
+                          << std::endl;
+    }
+  }
+
   /** Read images and masks, if not set already. */
   const bool              useDirCos = this->GetUseDirectionCosines();
   FixedImageDirectionType fixDirCos;
   if (this->GetFixedImage() == nullptr)
   {
     this->SetFixedImageContainer(MultipleImageLoader<FixedImageType>::GenerateImageContainer(
-      this->GetFixedImageFileNameContainer(), "Fixed Image", useDirCos, &fixDirCos));
+      this->GetFixedImageFileNameContainer(), "Fixed Image", useDirCos, &fixDirCos, outOfCoreDirectory));
     this->SetOriginalFixedImageDirection(fixDirCos);
   }
   else
@@ -177,17 +199,17 @@ ElastixTemplate<TFixedImage, TMovingImage>::Run(void)
   if (this->GetMovingImage() == nullptr)
   {
     this->SetMovingImageContainer(MultipleImageLoader<MovingImageType>::GenerateImageContainer(
-      this->GetMovingImageFileNameContainer(), "Moving Image", useDirCos));
+      this->GetMovingImageFileNameContainer(), "Moving Image", useDirCos, nullptr, outOfCoreDirectory));
   }
   if (this->GetFixedMask() == nullptr)
   {
     this->SetFixedMaskContainer(MultipleImageLoader<FixedMaskType>::GenerateImageContainer(
-      this->GetFixedMaskFileNameContainer(), "Fixed Mask", useDirCos));
+      this->GetFixedMaskFileNameContainer(), "Fixed Mask", useDirCos, nullptr, outOfCoreDirectory));
   }
   if (this->GetMovingMask() == nullptr)
   {
     this->SetMovingMaskContainer(MultipleImageLoader<MovingMaskType>::GenerateImageContainer(
-      this->GetMovingMaskFileNameContainer(), "Moving Mask", useDirCos));
+      this->GetMovingMaskFileNameContainer(), "Moving Mask", useDirCos, nullptr, outOfCoreDirectory));
   }
 
   /** Print the time spent on reading images. */
@@ -255,19 +277,33 @@ ElastixTemplate<TFixedImage, TMovingImage>::Run(void)
 
 template <class TFixedImage, class TMovingImage>
 int
-ElastixTemplate<TFixedImage, TMovingImage>::ApplyTransform(void)
+ElastixTemplate<TFixedImage, TMovingImage>::ApplyTransform(const bool doReadTransform)
 {
   /** Timer. */
   TimerType timer;
 
-  /** Tell all components where to find the ElastixTemplate. */
-  this->ConfigureComponents(this);
+  if (doReadTransform)
+  {
+    /** Tell all components where to find the ElastixTemplate. */
+    this->ConfigureComponents(this);
 
-  /** Call BeforeAllTransformix to do some checking. */
-  int dummy = this->BeforeAllTransformix();
-  if (dummy != 0)
+    /** Call BeforeAllTransformix to do some checking. */
+    int dummy = this->BeforeAllTransformix();
+    if (dummy != 0)
+    {
+      return dummy;
+    }
+  }
+  else
   {
-    return dummy;
+    /** The components were configured by a previous call, only
+     * check the command line arguments that may have changed since.
+     */
+    int dummy = this->BeforeEachTransformixBase();
+    if (dummy != 0)
+    {
+      return dummy;
+    }
   }
 
   /** Set the inputImage (=movingImage).
@@ -296,17 +332,28 @@ ElastixTemplate<TFixedImage, TMovingImage>::ApplyTransform(void)
 
   } // end if inputImageFileName
 
-  /** Call all the ReadFromFile() functions. */
-  timer.Reset();
-  timer.Start();
-  elxout << "Calling all ReadFromFile()'s ..." << std::endl;
-  this->GetElxResampleInterpolatorBase()->ReadFromFile();
-  this->GetElxResamplerBase()->ReadFromFile();
-  this->GetElxTransformBase()->ReadFromFile();
+  if (doReadTransform)
+  {
+    /** Call all the ReadFromFile() functions. */
+    timer.Reset();
+    timer.Start();
+    elxout << "Calling all ReadFromFile()'s ..." << std::endl;
+    this->GetElxResampleInterpolatorBase()->ReadFromFile();
+    this->GetElxResamplerBase()->ReadFromFile();
+    this->GetElxTransformBase()->ReadFromFile();
 
-  /** Tell the user. */
-  timer.Stop();
-  elxout << "  Calling all ReadFromFile()'s took " << timer.GetMean() << " s" << std::endl;
+    /** Tell the user. */
+    timer.Stop();
+    elxout << "  Calling all ReadFromFile()'s took " << timer.GetMean() << " s" << std::endl;
+  }
+  else
+  {
+    /** The transform is reused as it is. Only connect the resampler
+     * to the input image of this call.
+     */
+    elxout << "Reusing the transform from the previous call ..." << std::endl;
+    this->GetElxResamplerBase()->GetAsITKBaseType()->SetInput(this->GetMovingImage());
+  }
 
   /** Call TransformPoints.
    * Actually we could loop over all transforms.
@@ -366,6 +413,23 @@ ElastixTemplate<TFixedImage, TMovingImage>::ApplyTransform(void)
   timer.Stop();
   elxout << "  Computing spatial Jacobian done, it took " << Conversion::SecondsToDHMS(timer.GetMean(), 2) << std::endl;
 
+  /** Call ComputeInverseTransform. */
+  timer.Reset();
+  timer.Start();
+  elxout << "Compute inverse transform ..." << std::endl;
+  try
+  {
+    this->GetElxTransformBase()->ComputeInverseTransform();
+  }
+  catch (itk::ExceptionObject & excp)
+  {
+    xl::xout["error"] << excp << std::endl;
+    xl::xout["error"] << "However, transformix continues anyway." << std::endl;
+  }
+  timer.Stop();
+  elxout << "  Computing inverse transform done, it took " << Conversion::SecondsToDHMS(timer.GetMean(), 2)
+         << std::endl;
+
   /** Resample the image. */
   if (this->GetMovingImage() != nullptr)
   {
@@ -489,6 +553,14 @@ ElastixTemplate<TFixedImage, TMovingImage>::BeforeRegistration(void)
   this->AddTargetCellToIterationInfo("Time[ms]");
   this->GetIterationInfoAt("Time[ms]") << std::showpoint << std::fixed << std::setprecision(1);
 
+  /** Set up the performance telemetry, if requested. */
+  bool writePerformanceTelemetry = false;
+  this->GetConfiguration()->ReadParameter(writePerformanceTelemetry, "WritePerformanceTelemetry", 0, false);
+  if (writePerformanceTelemetry)
+  {
+    this->InitializePerformanceTelemetry();
+  }
+
   /** Print time for initializing. */
   this->m_Timer0.Stop();
   elxout << "Initialization of all components (before registration) took: "
@@ -539,13 +611,36 @@ ElastixTemplate<TFixedImage, TMovingImage>::BeforeEachResolution(void)
 
   /** Call all the BeforeEachResolution() functions. */
   this->BeforeEachResolutionBase();
-  CallInEachComponent(&BaseComponentType::BeforeEachResolutionBase);
-  CallInEachComponent(&BaseComponentType::BeforeEachResolution);
+  const auto componentTimes = this->CallInEachComponentTimed(&BaseComponentType::BeforeEachResolutionBase,
+                                                             &BaseComponentType::BeforeEachResolution);
 
-  /** Print the extra preparation time needed for this resolution. */
+  /** Print the extra preparation time needed for this resolution, followed by
+   * the time of each component that took at least a millisecond.
+   */
   this->m_Timer0.Stop();
+  std::ostringstream componentTimesStream;
+  for (const auto & componentTime : componentTimes)
+  {
+    const auto milliseconds = static_cast<unsigned long>(componentTime.second * 1000);
+    if (milliseconds > 0)
+    {
+      componentTimesStream << (componentTimesStream.tellp() > 0 ? ", " : " (") << componentTime.first << ": "
+                           << milliseconds << " ms";
+    }
+  }
+  if (componentTimesStream.tellp() > 0)
+  {
+    componentTimesStream << ')';
+  }
   elxout << "Elastix initialization of all components (for this resolution) took: "
-         << static_cast<unsigned long>(this->m_Timer0.GetMean() * 1000) << " ms.\n";
+         << static_cast<unsigned long>(this->m_Timer0.GetMean() * 1000) << " ms" << componentTimesStream.str()
+         << ".\n";
+
+  /** The telemetry of this resolution starts with that of the initialization. */
+  if (this->m_PerformanceTelemetry.IsNotNull())
+  {
+    this->m_ResolutionTelemetry = this->m_PerformanceTelemetry->Collect();
+  }
 
   /** Start ResolutionTimer, which measures the total iteration time in this resolution. */
   this->m_ResolutionTimer.Reset();
@@ -578,6 +673,13 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachResolution(void)
          << " (ITK initialization and iterating): " << this->m_ResolutionTimer.GetMean() << " s.\n";
   elxout << std::setprecision(this->GetDefaultOutputPrecision());
 
+  /** Write the telemetry summed over this resolution. */
+  if (this->m_PerformanceTelemetry.IsNotNull())
+  {
+    itk::PerformanceTelemetry::Accumulate(this->m_ResolutionTelemetry, this->m_PerformanceTelemetry->Collect());
+    this->WritePerformanceTelemetry(true, this->m_ResolutionTimer.GetMean(), this->m_ResolutionTelemetry);
+  }
+
   /** Call all the AfterEachResolution() functions. */
   this->AfterEachResolutionBase();
   CallInEachComponent(&BaseComponentType::AfterEachResolutionBase);
@@ -636,6 +738,14 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachIteration(void)
   this->m_IterationTimer.Stop();
   this->GetIterationInfoAt("Time[ms]") << this->m_IterationTimer.GetMean() * 1000.0;
 
+  /** Write the telemetry of this iteration. */
+  if (this->m_PerformanceTelemetry.IsNotNull())
+  {
+    const auto statistics = this->m_PerformanceTelemetry->Collect();
+    itk::PerformanceTelemetry::Accumulate(this->m_ResolutionTelemetry, statistics);
+    this->WritePerformanceTelemetry(false, this->m_IterationTimer.GetMean(), statistics);
+  }
+
   /** Write the iteration info of this iteration. */
   this->GetIterationInfo().WriteBufferedData();
 
@@ -736,6 +846,11 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterRegistration(void)
   elxout << "Time spent on saving the results, applying the final transform etc.: "
          << static_cast<unsigned long>(this->m_Timer0.GetMean() * 1000) << " ms.\n";
 
+  if (this->m_PerformanceTelemetryFile.is_open())
+  {
+    this->m_PerformanceTelemetryFile.close();
+  }
+
 } // end AfterRegistration()
 
 
@@ -935,6 +1050,81 @@ ElastixTemplate<TFixedImage, TMovingImage>::CallInEachComponentInt(PtrToMemberFu
 } // end CallInEachComponent()
 
 
+/**
+ * ****************** CallInEachComponentTimed ********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+std::vector<std::pair<std::string, double>>
+ElastixTemplate<TFixedImage, TMovingImage>::CallInEachComponentTimed(PtrToMemberFunction func1,
+                                                                     PtrToMemberFunction func2)
+{
+  /** Collect the components, in the order of CallInEachComponent(). */
+  std::vector<BaseComponentType *> components{ this->GetConfiguration() };
+  for (unsigned int i = 0; i < this->GetNumberOfRegistrations(); ++i)
+  {
+    components.push_back(this->GetElxRegistrationBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfTransforms(); ++i)
+  {
+    components.push_back(this->GetElxTransformBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfImageSamplers(); ++i)
+  {
+    components.push_back(this->GetElxImageSamplerBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfMetrics(); ++i)
+  {
+    components.push_back(this->GetElxMetricBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfInterpolators(); ++i)
+  {
+    components.push_back(this->GetElxInterpolatorBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfOptimizers(); ++i)
+  {
+    components.push_back(this->GetElxOptimizerBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfFixedImagePyramids(); ++i)
+  {
+    components.push_back(this->GetElxFixedImagePyramidBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfMovingImagePyramids(); ++i)
+  {
+    components.push_back(this->GetElxMovingImagePyramidBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfResampleInterpolators(); ++i)
+  {
+    components.push_back(this->GetElxResampleInterpolatorBase(i));
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfResamplers(); ++i)
+  {
+    components.push_back(this->GetElxResamplerBase(i));
+  }
+
+  /** Call func1 in all components, and then func2, timing each call. */
+  std::vector<TimerType> timers(components.size());
+  for (const auto func : { func1, func2 })
+  {
+    for (std::size_t i = 0; i < components.size(); ++i)
+    {
+      timers[i].Start();
+      ((*components[i]).*func)();
+      timers[i].Stop();
+    }
+  }
+
+  std::vector<std::pair<std::string, double>> componentTimes;
+  componentTimes.reserve(components.size());
+  for (std::size_t i = 0; i < components.size(); ++i)
+  {
+    componentTimes.emplace_back(components[i]->GetComponentLabel(), timers[i].GetTotal());
+  }
+  return componentTimes;
+
+} // end CallInEachComponentTimed()
+
+
 /**
  * ****************** ConfigureComponents *******************
  */
@@ -1039,6 +1229,105 @@ ElastixTemplate<TFixedImage, TMovingImage>::OpenIterationInfoFile(void)
 } // end OpenIterationInfoFile()
 
 
+/**
+ * ************** InitializePerformanceTelemetry *********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ElastixTemplate<TFixedImage, TMovingImage>::InitializePerformanceTelemetry(void)
+{
+  typedef typename MetricBaseType::AdvancedMetricType AdvancedMetricType;
+  typedef itk::ScaledSingleValuedNonLinearOptimizer   ScaledOptimizerType;
+
+  /** Create the PerformanceTelemetry filename. */
+  std::ostringstream makeFileName("");
+  makeFileName << this->m_Configuration->GetCommandLineArgument("-out") << "PerformanceTelemetry."
+               << this->m_Configuration->GetElastixLevel() << ".jsonl";
+  const std::string fileName = makeFileName.str();
+
+  this->m_PerformanceTelemetryFile.open(fileName.c_str());
+  if (!(this->m_PerformanceTelemetryFile.is_open()))
+  {
+    xl::xout["error"] << "ERROR: File \"" << fileName << "\" could not be opened!" << std::endl;
+    return;
+  }
+  this->m_PerformanceTelemetryFile << std::fixed << std::setprecision(3);
+
+  /** Pass the telemetry object to the components that record telemetry. */
+  this->m_PerformanceTelemetry = itk::PerformanceTelemetry::New();
+  for (unsigned int i = 0; i < this->GetNumberOfMetrics(); ++i)
+  {
+    auto * metric = dynamic_cast<AdvancedMetricType *>(this->GetElxMetricBase(i)->GetAsITKBaseType());
+    if (metric != nullptr)
+    {
+      metric->SetPerformanceTelemetry(this->m_PerformanceTelemetry);
+    }
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfImageSamplers(); ++i)
+  {
+    this->GetElxImageSamplerBase(i)->GetAsITKBaseType()->SetPerformanceTelemetry(this->m_PerformanceTelemetry);
+  }
+  for (unsigned int i = 0; i < this->GetNumberOfOptimizers(); ++i)
+  {
+    auto * optimizer = dynamic_cast<ScaledOptimizerType *>(this->GetElxOptimizerBase(i)->GetAsITKBaseType());
+    if (optimizer != nullptr)
+    {
+      optimizer->SetPerformanceTelemetry(this->m_PerformanceTelemetry);
+    }
+  }
+
+} // end InitializePerformanceTelemetry()
+
+
+/**
+ * ************** WritePerformanceTelemetry *********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ElastixTemplate<TFixedImage, TMovingImage>::WritePerformanceTelemetry(
+  const bool                                        isResolution,
+  const double                                      timeInSeconds,
+  const itk::PerformanceTelemetry::StatisticsType & statistics)
+{
+  const std::uint64_t samples = itk::PerformanceTelemetry::GetCount(statistics, "Metric.Samples");
+  const std::uint64_t validSamples = itk::PerformanceTelemetry::GetCount(statistics, "Metric.ValidSamples");
+
+  /** The total of all counters of allocated bytes. */
+  const std::string bytesAllocatedSuffix = "BytesAllocated";
+  std::uint64_t     bytesAllocated = 0;
+  for (const auto & channel : statistics)
+  {
+    if (channel.m_Name.size() >= bytesAllocatedSuffix.size() &&
+        channel.m_Name.compare(channel.m_Name.size() - bytesAllocatedSuffix.size(),
+                               bytesAllocatedSuffix.size(),
+                               bytesAllocatedSuffix) == 0)
+    {
+      bytesAllocated += channel.m_Count;
+    }
+  }
+
+  /** An iteration line has the iteration number, a resolution line the number of iterations. */
+  std::ostream & os = this->m_PerformanceTelemetryFile;
+  os << "{\"type\":\"" << (isResolution ? "resolution" : "iteration")
+     << "\",\"resolution\":" << this->GetElxRegistrationBase()->GetAsITKBaseType()->GetCurrentLevel() << ",\""
+     << (isResolution ? "iterations" : "iteration") << "\":" << this->m_IterationCounter
+     << ",\"timeMs\":" << timeInSeconds * 1000.0 << ",\"samples\":" << samples
+     << ",\"validSampleRatio\":" << (samples > 0 ? static_cast<double>(validSamples) / samples : 0.0)
+     << ",\"bytesAllocated\":" << bytesAllocated << ",\"channels\":";
+  itk::PerformanceTelemetry::WriteJSON(os, statistics);
+  os << "}\n";
+
+  /** A resolution line marks a natural point to make the file readable during the registration. */
+  if (isResolution)
+  {
+    os.flush();
+  }
+
+} // end WritePerformanceTelemetry()
+
+
 /**
  * ************** GetOriginalFixedImageDirection *********************
  * Determine the original fixed image direction (it might have been
@@ -134,23 +134,10 @@ TransformixMain::Run(void)
   elastixBase.SetInitialTransform(this->GetModifiableInitialTransform());
 
   /** ApplyTransform! */
-  try
-  {
-    errorCode = elastixBase.ApplyTransform();
-  }
-  catch (itk::ExceptionObject & excp)
-  {
-    /** We just print the exception and let the program quit. */
-    xl::xout["error"] << std::endl
-                      << "--------------- Exception ---------------" << std::endl
-                      << excp << "-----------------------------------------" << std::endl;
-    errorCode = 1;
-  }
+  errorCode = this->ApplyTransformAndStoreResults(true);
 
-  /** Save the image container. */
-  this->SetMovingImageContainer(elastixBase.GetMovingImageContainer());
-  this->SetResultImageContainer(elastixBase.GetResultImageContainer());
-  this->SetResultDeformationFieldContainer(elastixBase.GetResultDeformationFieldContainer());
+  /** The components may be reused by ApplyPreparedTransform(). */
+  this->m_TransformIsPrepared = (errorCode == 0);
 
   return errorCode;
 
@@ -193,6 +180,89 @@ TransformixMain::Run(const ArgumentMapType & argmap, const std::vector<Parameter
 } // end Run()
 
 
+/**
+ * ******************* ApplyPreparedTransform *******************
+ */
+
+int
+TransformixMain::ApplyPreparedTransform(const ArgumentMapType & argmap)
+{
+  if (!this->m_TransformIsPrepared)
+  {
+    xl::xout["error"] << "ERROR:" << std::endl;
+    xl::xout["error"] << "ApplyPreparedTransform() requires a previous successful Run()." << std::endl;
+    return 1;
+  }
+
+  /** Replace the arguments that specify the input of the previous call.
+   * The arguments that specify the transform itself, like "-tp", are kept.
+   */
+  for (const char * const key : { "-in", "-def", "-ipp", "-jac", "-jacmat", "-inv" })
+  {
+    const auto found = argmap.find(key);
+    this->m_Configuration->SetCommandLineArgument(key, found == argmap.end() ? "" : found->second);
+  }
+  const auto foundOut = argmap.find("-out");
+  if (foundOut != argmap.end())
+  {
+    this->m_Configuration->SetCommandLineArgument("-out", foundOut->second);
+  }
+
+  /** The executable always reads the input image from "-in", so forget
+   * the image of the previous call.
+   */
+  if (!BaseComponent::IsElastixLibrary())
+  {
+    this->SetMovingImageContainer(nullptr);
+  }
+
+  /** Do not pass on the results of the previous call. */
+  auto & elastixBase = this->GetElastixBase();
+  elastixBase.SetMovingImageContainer(this->GetModifiableMovingImageContainer());
+  elastixBase.SetResultImageContainer(nullptr);
+  elastixBase.SetResultDeformationFieldContainer(nullptr);
+  elastixBase.SetInverseTransformParametersMap({});
+
+  /** ApplyTransform, reusing the components of the previous call. */
+  return this->ApplyTransformAndStoreResults(false);
+
+} // end ApplyPreparedTransform()
+
+
+/**
+ * *************** ApplyTransformAndStoreResults ****************
+ */
+
+int
+TransformixMain::ApplyTransformAndStoreResults(const bool doReadTransform)
+{
+  auto & elastixBase = this->GetElastixBase();
+
+  int errorCode = 0;
+  try
+  {
+    errorCode = elastixBase.ApplyTransform(doReadTransform);
+  }
+  catch (itk::ExceptionObject & excp)
+  {
+    /** We just print the exception and let the program quit. */
+    xl::xout["error"] << std::endl
+                      << "--------------- Exception ---------------" << std::endl
+                      << excp << "-----------------------------------------" << std::endl;
+    errorCode = 1;
+  }
+
+  /** Save the image container. */
+  this->SetMovingImageContainer(elastixBase.GetMovingImageContainer());
+  this->SetResultImageContainer(elastixBase.GetResultImageContainer());
+  this->SetResultDeformationFieldContainer(elastixBase.GetResultDeformationFieldContainer());
+  this->m_InverseTransformParametersMap = elastixBase.GetInverseTransformParametersMap();
+
+  return errorCode;
+
+} // end ApplyTransformAndStoreResults()
+
+
 /**
  * ********************* SetInputImage **************************
  */
@@ -101,6 +101,32 @@ public:
   virtual void
   SetInputImageContainer(DataObjectContainerType * inputImageContainer);
 
+  /** Applies the transform of a previous successful Run() again, without
+   * recreating the components and without rereading the transform parameters.
+   * The arguments "-in", "-def", "-ipp", "-jac", "-jacmat" and "-inv" of the previous
+   * call are replaced by those in argmap; "-out" is only replaced when given.
+   * When transformix is used as a library, the input image is taken from
+   * SetInputImageContainer() instead of "-in".
+   */
+  virtual int
+  ApplyPreparedTransform(const ArgumentMapType & argmap);
+
+  /** Returns true when a previous Run() has prepared the transform. */
+  bool
+  IsTransformPrepared(void) const
+  {
+    return this->m_TransformIsPrepared;
+  }
+
+  /** Returns the parameter map of the inverse transform, computed by the last
+   * call with "-inv all". Empty otherwise.
+   */
+  ParameterMapType
+  GetInverseTransformParametersMap(void) const
+  {
+    return this->m_InverseTransformParametersMap;
+  }
+
 protected:
   TransformixMain() = default;
   ~TransformixMain() override;
@@ -112,6 +138,14 @@ protected:
   InitDBIndex(void) override;
 
 private:
+  /** Calls ApplyTransform() on the ElastixBase and stores the results. */
+  int
+  ApplyTransformAndStoreResults(const bool doReadTransform);
+
+  bool m_TransformIsPrepared{ false };
+
+  ParameterMapType m_InverseTransformParametersMap;
+
   TransformixMain(const Self &) = delete;
   void
   operator=(const Self &) = delete;
@@ -0,0 +1,251 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include <itkElastixBatchRegistrationMethod.h>
+
+#include "elxCoreMainGTestUtilities.h"
+#include "itkBatchDataCache.h"
+
+// ITK header files:
+#include <itkImage.h>
+#include <itksys/SystemTools.hxx>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+
+// Using-declarations:
+using elx::CoreMainGTestUtilities::CheckNew;
+using elx::CoreMainGTestUtilities::ConvertToOffset;
+using elx::CoreMainGTestUtilities::CreateParameterObject;
+using elx::CoreMainGTestUtilities::Deref;
+using elx::CoreMainGTestUtilities::FillImageRegion;
+using elx::CoreMainGTestUtilities::GetBinaryDirectoryPath;
+using elx::CoreMainGTestUtilities::GetTransformParametersFromMaps;
+
+
+namespace
+{
+constexpr auto ImageDimension = 2U;
+using ImageType = itk::Image<float, ImageDimension>;
+using OffsetType = itk::Offset<ImageDimension>;
+using BatchRegistrationType = itk::ElastixBatchRegistrationMethod<ImageType, ImageType>;
+using ParameterObjectType = BatchRegistrationType::ParameterObjectType;
+
+// Creates a batch that registers a fixed image to moving images that are translated by the specified offsets.
+itk::SmartPointer<BatchRegistrationType>
+CreateTranslationBatch(const std::vector<OffsetType> & translationOffsets)
+{
+  const auto                       regionSize = itk::Size<ImageDimension>::Filled(2);
+  const itk::Size<ImageDimension>  imageSize{ { 5, 6 } };
+  const itk::Index<ImageDimension> fixedImageRegionIndex{ { 1, 3 } };
+
+  const auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(imageSize);
+  fixedImage->Allocate(true);
+  FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+
+  const auto filter = CheckNew<BatchRegistrationType>();
+  filter->SetFixedImage(fixedImage);
+  for (const auto & translationOffset : translationOffsets)
+  {
+    const auto movingImage = ImageType::New();
+    movingImage->SetRegions(imageSize);
+    movingImage->Allocate(true);
+    FillImageRegion(*movingImage, fixedImageRegionIndex + translationOffset, regionSize);
+    filter->AddMovingImage(movingImage);
+  }
+  filter->SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                     { "ImageSampler", "Full" },
+                                                     { "MaximumNumberOfIterations", "2" },
+                                                     { "Metric", "AdvancedNormalizedCorrelation" },
+                                                     { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                                                     { "Transform", "TranslationTransform" } }));
+  filter->SetMaximumNumberOfConcurrentRegistrations(2);
+  return filter;
+}
+
+} // namespace
+
+
+// Tests registering one fixed image to three moving images, which are translated differently, two at a time.
+GTEST_TEST(itkElastixBatchRegistrationMethod, Translation)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+  using OffsetType = itk::Offset<ImageDimension>;
+
+  const std::vector<OffsetType> translationOffsets{ { { 1, -2 } }, { { 0, 1 } }, { { -1, -1 } } };
+  const auto                    regionSize = SizeType::Filled(2);
+  const SizeType                imageSize{ { 5, 6 } };
+  const IndexType               fixedImageRegionIndex{ { 1, 3 } };
+
+  const auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(imageSize);
+  fixedImage->Allocate(true);
+  FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+
+  const auto filter = CheckNew<itk::ElastixBatchRegistrationMethod<ImageType, ImageType>>();
+
+  filter->SetFixedImage(fixedImage);
+  for (const auto & translationOffset : translationOffsets)
+  {
+    const auto movingImage = ImageType::New();
+    movingImage->SetRegions(imageSize);
+    movingImage->Allocate(true);
+    FillImageRegion(*movingImage, fixedImageRegionIndex + translationOffset, regionSize);
+    filter->AddMovingImage(movingImage);
+  }
+  filter->SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                     { "ImageSampler", "Full" },
+                                                     { "MaximumNumberOfIterations", "2" },
+                                                     { "Metric", "AdvancedNormalizedCorrelation" },
+                                                     { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                                                     { "Transform", "TranslationTransform" } }));
+  filter->SetMaximumNumberOfConcurrentRegistrations(2);
+  filter->Update();
+
+  ASSERT_EQ(filter->GetNumberOfMovingImages(), translationOffsets.size());
+  for (unsigned int i = 0; i < translationOffsets.size(); ++i)
+  {
+    const auto transformParameters =
+      GetTransformParametersFromMaps(Deref(filter->GetTransformParameterObject(i)).GetParameterMap());
+    EXPECT_EQ(ConvertToOffset<ImageDimension>(transformParameters), translationOffsets[i]);
+    EXPECT_NE(filter->GetResultImage(i), nullptr);
+  }
+}
+
+
+// Tests that a batch without moving images throws an exception.
+GTEST_TEST(itkElastixBatchRegistrationMethod, ThrowsWithoutMovingImages)
+{
+  using ImageType = itk::Image<float, 2>;
+
+  const auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(itk::Size<2>::Filled(4));
+  fixedImage->Allocate(true);
+
+  const auto filter = CheckNew<itk::ElastixBatchRegistrationMethod<ImageType, ImageType>>();
+  filter->SetFixedImage(fixedImage);
+  filter->SetParameterObject(CreateParameterObject({ { "Transform", "TranslationTransform" } }));
+  EXPECT_THROW(filter->Update(), itk::ExceptionObject);
+}
+
+
+// Tests that each registration of a batch has its own log, and that a failed registration reports its error.
+GTEST_TEST(itkElastixBatchRegistrationMethod, LogsAndReportsErrorsPerRegistration)
+{
+  using ImageType = itk::Image<float, 2>;
+
+  const auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(itk::Size<2>::Filled(8));
+  fixedImage->Allocate(true);
+  FillImageRegion(*fixedImage, { { 2, 3 } }, itk::Size<2>::Filled(3));
+
+  const std::string outputDirectory =
+    GetBinaryDirectoryPath() + "/itkElastixBatchRegistrationMethod_LogsAndReportsErrorsPerRegistration";
+  itksys::SystemTools::MakeDirectory(outputDirectory);
+
+  const auto filter = CheckNew<itk::ElastixBatchRegistrationMethod<ImageType, ImageType>>();
+  filter->SetFixedImage(fixedImage);
+  filter->AddMovingImage(fixedImage);
+  filter->AddMovingImage(fixedImage);
+  filter->SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                     { "ImageSampler", "Full" },
+                                                     { "MaximumNumberOfIterations", "2" },
+                                                     { "Metric", "AdvancedNormalizedCorrelation" },
+                                                     { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                                                     { "Transform", "NonExistingTransform" } }));
+  filter->SetOutputDirectory(outputDirectory);
+  filter->LogToFileOn();
+  EXPECT_THROW(filter->Update(), itk::ExceptionObject);
+
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    EXPECT_TRUE(itksys::SystemTools::FileExists(outputDirectory + '/' + std::to_string(i) + "/elastix.log"));
+
+    /** The error message is more than a reference to the log. */
+    const std::string & errorMessage = filter->GetErrorMessage(i);
+    EXPECT_FALSE(errorMessage.empty());
+    EXPECT_EQ(errorMessage.find("See elastix log"), std::string::npos);
+    EXPECT_EQ(filter->GetTransformParameterObject(i), nullptr);
+  }
+}
+
+
+// Tests that the fixed-side data is computed once for the whole batch: a batch of three registrations
+// puts as many entries in the BatchDataCache as a batch of one registration.
+GTEST_TEST(itkElastixBatchRegistrationMethod, SharesFixedSideData)
+{
+  const auto getNumberOfCacheEntriesAfterUpdate = [](const std::vector<OffsetType> & translationOffsets) {
+    /** This scope keeps the cache filled after the scope of Update() has ended. */
+    const itk::BatchDataCache::Scope batchDataCacheScope;
+    CreateTranslationBatch(translationOffsets)->Update();
+    return itk::BatchDataCache::GetNumberOfEntries();
+  };
+
+  const auto numberOfEntriesOfOneRegistration = getNumberOfCacheEntriesAfterUpdate({ { { 1, -2 } } });
+  const auto numberOfEntriesOfThreeRegistrations =
+    getNumberOfCacheEntriesAfterUpdate({ { { 1, -2 } }, { { 0, 1 } }, { { -1, -1 } } });
+
+  /** At least the fixed image pyramid is shared. */
+  EXPECT_GT(numberOfEntriesOfOneRegistration, 0U);
+  EXPECT_EQ(numberOfEntriesOfThreeRegistrations, numberOfEntriesOfOneRegistration);
+  EXPECT_EQ(itk::BatchDataCache::GetNumberOfEntries(), 0U);
+}
+
+
+// Tests that the callback receives the results of each registration once, and that the batch
+// does not keep them when KeepResults is off.
+GTEST_TEST(itkElastixBatchRegistrationMethod, CallsBackPerRegistrationWithoutKeepingResults)
+{
+  const std::vector<OffsetType> translationOffsets{ { { 1, -2 } }, { { 0, 1 } }, { { -1, -1 } } };
+  std::vector<unsigned int>     numberOfCalls(translationOffsets.size());
+  std::vector<bool>             hasResultImage(translationOffsets.size());
+  std::vector<OffsetType>       estimatedOffsets(translationOffsets.size());
+
+  const auto filter = CreateTranslationBatch(translationOffsets);
+  filter->KeepResultsOff();
+  filter->SetRegistrationCompletedCallback([&](const unsigned int          index,
+                                               const ImageType *           resultImage,
+                                               const ParameterObjectType * transformParameters) {
+    ++numberOfCalls.at(index);
+    hasResultImage.at(index) = (resultImage != nullptr);
+    if (transformParameters != nullptr)
+    {
+      estimatedOffsets.at(index) = ConvertToOffset<ImageDimension>(
+        GetTransformParametersFromMaps(transformParameters->GetParameterMap()));
+    }
+  });
+  filter->Update();
+
+  for (unsigned int i = 0; i < translationOffsets.size(); ++i)
+  {
+    EXPECT_EQ(numberOfCalls[i], 1U);
+    EXPECT_TRUE(hasResultImage[i]);
+    EXPECT_EQ(estimatedOffsets[i], translationOffsets[i]);
+    EXPECT_EQ(filter->GetResultImage(i), nullptr);
+    EXPECT_EQ(filter->GetTransformParameterObject(i), nullptr);
+  }
+}
@@ -26,12 +26,16 @@
 // ITK header file:
 #include <itkImage.h>
 #include <itkIndexRange.h>
+#include <itksys/SystemTools.hxx>
 
 // GoogleTest header file:
 #include <gtest/gtest.h>
 
 #include <algorithm> // For transform
+#include <cmath>     // For exp and abs
+#include <fstream>
 #include <map>
+#include <regex>
 #include <string>
 #include <utility> // For pair
 
@@ -43,6 +47,7 @@ using elx::CoreMainGTestUtilities::CreateParameterObject;
 using elx::CoreMainGTestUtilities::Deref;
 using elx::CoreMainGTestUtilities::FillImageRegion;
 using elx::CoreMainGTestUtilities::Front;
+using elx::CoreMainGTestUtilities::GetBinaryDirectoryPath;
 using elx::CoreMainGTestUtilities::GetDataDirectoryPath;
 using elx::CoreMainGTestUtilities::GetTransformParametersFromFilter;
 using elx::GTestUtilities::MakePoint;
@@ -466,3 +471,124 @@ GTEST_TEST(itkElastixRegistrationMethod, InitialTransformParameterFileLinkToTran
     }
   }
 }
+
+
+// Tests that a B-spline registration with the interleaved and single precision control point modes
+// yields the same transform parameters as the default (double precision) mode, within tolerance.
+GTEST_TEST(itkElastixRegistrationMethod, SinglePrecisionControlPointsMatchDoublePrecision)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+
+  // Two smooth blobs, shifted with respect to each other.
+  const auto createBlobImage = [](const double centerX, const double centerY) {
+    const auto image = ImageType::New();
+    image->SetRegions(SizeType{ { 32, 32 } });
+    image->Allocate();
+    for (const auto index : itk::ImageRegionIndexRange<ImageDimension>(image->GetBufferedRegion()))
+    {
+      const double dx = index[0] - centerX;
+      const double dy = index[1] - centerY;
+      image->SetPixel(index, static_cast<float>(100.0 * std::exp(-(dx * dx + dy * dy) / 50.0)));
+    }
+    return image;
+  };
+  const auto fixedImage = createBlobImage(15.0, 16.0);
+  const auto movingImage = createBlobImage(16.5, 15.0);
+
+  const auto registerImages = [fixedImage, movingImage](const char * const useInterleaved,
+                                                        const char * const useSinglePrecision) {
+    const auto filter = CheckNew<itk::ElastixRegistrationMethod<ImageType, ImageType>>();
+    filter->SetFixedImage(fixedImage);
+    filter->SetMovingImage(movingImage);
+    filter->SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                       { "FinalGridSpacingInVoxels", "8" },
+                                                       { "ImageSampler", "Full" },
+                                                       { "MaximumNumberOfIterations", "20" },
+                                                       { "Metric", "AdvancedMeanSquares" },
+                                                       { "NumberOfResolutions", "1" },
+                                                       { "Optimizer", "RegularStepGradientDescent" },
+                                                       { "Transform", "RecursiveBSplineTransform" },
+                                                       { "UseInterleavedControlPoints", useInterleaved },
+                                                       { "UseSinglePrecisionControlPoints", useSinglePrecision } }));
+    filter->Update();
+    return GetTransformParametersFromFilter(*filter);
+  };
+
+  const auto expectedParameters = registerImages("false", "false");
+
+  for (const auto & mode : { std::make_pair("true", "false"), std::make_pair("false", "true") })
+  {
+    const auto actualParameters = registerImages(mode.first, mode.second);
+    ASSERT_EQ(actualParameters.size(), expectedParameters.size());
+
+    for (std::size_t i = 0; i < expectedParameters.size(); ++i)
+    {
+      EXPECT_NEAR(actualParameters[i], expectedParameters[i], 1e-3 * std::max(1.0, std::abs(expectedParameters[i])));
+    }
+  }
+}
+
+
+// Tests that the log reports the initialization time of all components once per resolution, followed by the
+// per-component breakdown.
+GTEST_TEST(itkElastixRegistrationMethod, LogsComponentInitializationTimePerResolution)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+  using OffsetType = itk::Offset<ImageDimension>;
+
+  const OffsetType translationOffset{ { 1, -2 } };
+  const auto       regionSize = SizeType::Filled(4);
+  const SizeType   imageSize{ { 12, 14 } };
+  const IndexType  fixedImageRegionIndex{ { 3, 6 } };
+
+  const auto fixedImage = ImageType::New();
+  fixedImage->SetRegions(imageSize);
+  fixedImage->Allocate(true);
+  FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+
+  const auto movingImage = ImageType::New();
+  movingImage->SetRegions(imageSize);
+  movingImage->Allocate(true);
+  FillImageRegion(*movingImage, fixedImageRegionIndex + translationOffset, regionSize);
+
+  const std::string outputDirectory =
+    GetBinaryDirectoryPath() + "/itkElastixRegistrationMethod_LogsComponentInitializationTimePerResolution";
+  itksys::SystemTools::MakeDirectory(outputDirectory);
+
+  const auto filter = CheckNew<itk::ElastixRegistrationMethod<ImageType, ImageType>>();
+  filter->SetFixedImage(fixedImage);
+  filter->SetMovingImage(movingImage);
+  filter->SetParameterObject(CreateParameterObject({ // Parameters in alphabetic order:
+                                                     { "ImageSampler", "Full" },
+                                                     { "MaximumNumberOfIterations", "2" },
+                                                     { "Metric", "AdvancedNormalizedCorrelation" },
+                                                     { "NumberOfResolutions", "2" },
+                                                     { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                                                     { "Transform", "TranslationTransform" } }));
+  filter->SetOutputDirectory(outputDirectory);
+  filter->LogToFileOn();
+  filter->Update();
+
+  // For example: "... took: 15 ms (Metric0: 12 ms, Optimizer0: 3 ms)." Components under a millisecond are omitted.
+  const std::string logLinePrefix = "Elastix initialization of all components (for this resolution) took: ";
+  const std::regex  logLineSuffixRegex(R"(\d+ ms( \([A-Za-z]+\d*: \d+ ms(, [A-Za-z]+\d*: \d+ ms)*\))?\.)");
+
+  std::ifstream logFile(outputDirectory + "/elastix.log");
+  ASSERT_TRUE(logFile.is_open());
+
+  unsigned int numberOfLogLines = 0;
+  for (std::string line; std::getline(logFile, line);)
+  {
+    if (line.compare(0, logLinePrefix.size(), logLinePrefix) == 0)
+    {
+      ++numberOfLogLines;
+      EXPECT_TRUE(std::regex_match(line.substr(logLinePrefix.size()), logLineSuffixRegex)) << line;
+    }
+  }
+  EXPECT_EQ(numberOfLogLines, 2U);
+}
@@ -26,6 +26,7 @@
 #include "GTesting/elxGTestUtilities.h"
 
 // ITK header files:
+#include <itkAdvancedCombinationTransform.h>
 #include <itkAffineTransform.h>
 #include <itkBSplineTransform.h>
 #include <itkCompositeTransform.h>
@@ -47,6 +48,7 @@
 #include <map>
 #include <random>
 #include <string>
+#include <vector>
 
 
 using ParameterMapType = itk::ParameterFileParser::ParameterMapType;
@@ -416,6 +418,239 @@ GTEST_TEST(itkTransformixFilter, TranslationViaExternalTransformFile)
 }
 
 
+// Tests that a filter that reuses its prepared transform yields the same output
+// for multiple moving images as a filter that starts from scratch each time.
+GTEST_TEST(itkTransformixFilter, ReusePreparedTransform)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+
+  const itk::Offset<ImageDimension> translationOffset{ { 1, -2 } };
+  const SizeType                    imageSize{ { 5, 6 } };
+
+  const auto filter = CheckNew<itk::TransformixFilter<ImageType>>();
+  filter->ReusePreparedTransformOn();
+  filter->SetTransformParameterObject(
+    CreateParameterObject({ // Parameters in alphabetic order:
+                            { "Direction", CreateDefaultDirectionParameterValues<ImageDimension>() },
+                            { "Index", ParameterValuesType(ImageDimension, "0") },
+                            { "NumberOfParameters", { std::to_string(ImageDimension) } },
+                            { "Origin", ParameterValuesType(ImageDimension, "0") },
+                            { "ResampleInterpolator", { "FinalLinearInterpolator" } },
+                            { "Size", ConvertToParameterValues(imageSize) },
+                            { "Transform", ParameterValuesType{ "TranslationTransform" } },
+                            { "TransformParameters", ConvertToParameterValues(translationOffset) },
+                            { "Spacing", ParameterValuesType(ImageDimension, "1") } }));
+
+  for (const itk::Index<ImageDimension> regionIndex :
+       { itk::Index<ImageDimension>{ { 1, 3 } }, itk::Index<ImageDimension>{ { 2, 4 } } })
+  {
+    const auto movingImage = ImageType::New();
+    movingImage->SetRegions(imageSize);
+    movingImage->Allocate(true);
+    FillImageRegion(*movingImage, regionIndex + translationOffset, SizeType::Filled(2));
+
+    filter->SetMovingImage(movingImage);
+    filter->Update();
+
+    ExpectEqualImages(Deref(filter->GetOutput()), *TranslateImage(*movingImage, translationOffset));
+  }
+}
+
+
+// Tests that resampling through a deformation field, using a prepared transform,
+// follows a modification of the initial transform between two updates.
+GTEST_TEST(itkTransformixFilter, ResampleUsingDeformationFieldFollowsModifiedInitialTransform)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using OffsetType = itk::Offset<ImageDimension>;
+  using CombinationTransformType = itk::AdvancedCombinationTransform<double, ImageDimension>;
+  using TransformixMainType = elx::TransformixMain;
+
+  const OffsetType                initialOffset{ { 1, 0 } };
+  const OffsetType                modifiedInitialOffset{ { 2, 1 } };
+  const OffsetType                currentOffset{ { 0, -2 } };
+  const itk::Size<ImageDimension> imageSize{ { 7, 8 } };
+
+  const auto movingImage = CreateImageFilledWithSequenceOfNaturalNumbers<float>(imageSize);
+  const auto expectedImage = TranslateImage(*movingImage, initialOffset + currentOffset);
+  const auto expectedModifiedImage = TranslateImage(*movingImage, modifiedInitialOffset + currentOffset);
+
+  const auto createParameterMap = [imageSize](const OffsetType & translationOffset) {
+    return ParameterMapType{ // Parameters in alphabetic order:
+                             { "Direction", CreateDefaultDirectionParameterValues<ImageDimension>() },
+                             { "FixedImageDimension", { std::to_string(ImageDimension) } },
+                             { "Index", ParameterValuesType(ImageDimension, "0") },
+                             { "MovingImageDimension", { std::to_string(ImageDimension) } },
+                             { "NumberOfParameters", { std::to_string(ImageDimension) } },
+                             { "Origin", ParameterValuesType(ImageDimension, "0") },
+                             { "ResampleInterpolator", { "FinalLinearInterpolator" } },
+                             { "ResampleUsingDeformationField", { "true" } },
+                             { "ResultImagePixelType", { "float" } },
+                             { "Size", ConvertToParameterValues(imageSize) },
+                             { "Transform", ParameterValuesType{ "TranslationTransform" } },
+                             { "TransformParameters", ConvertToParameterValues(translationOffset) },
+                             { "Spacing", ParameterValuesType(ImageDimension, "1") } };
+  };
+  std::vector<ParameterMapType> parameterMaps{ createParameterMap(initialOffset), createParameterMap(currentOffset) };
+  parameterMaps[1]["InitialTransformParametersFileName"] = { "0" };
+
+  const auto getResultImage = [](TransformixMainType & transformix) -> const ImageType & {
+    const auto & resultImageContainer = Deref(transformix.GetResultImageContainer());
+    return Deref(dynamic_cast<const ImageType *>(resultImageContainer.ElementAt(0).GetPointer()));
+  };
+
+  const elx::xoutManager manager("", false, false);
+
+  const auto inputImageContainer = TransformixMainType::DataObjectContainerType::New();
+  inputImageContainer->InsertElement(0, movingImage);
+
+  const auto transformix = CheckNew<TransformixMainType>();
+  transformix->SetInputImageContainer(inputImageContainer);
+  const TransformixMainType::ArgumentMapType argumentMap{ { "-out", "output_path_not_set" } };
+
+  ASSERT_EQ(transformix->Run(argumentMap, parameterMaps), 0);
+  ExpectEqualImages(getResultImage(*transformix), *expectedImage);
+
+  // Modify the initial transform, without touching the last transform of the chain.
+  const auto & transformContainer = Deref(transformix->GetElastixBase().GetTransformContainer());
+  auto &       lastTransform =
+    Deref(dynamic_cast<CombinationTransformType *>(transformContainer.ElementAt(0).GetPointer()));
+  auto &                                   initialTransform = Deref(lastTransform.GetModifiableInitialTransform());
+  CombinationTransformType::ParametersType initialParameters(ImageDimension);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    initialParameters[i] = modifiedInitialOffset[i];
+  }
+  initialTransform.SetParameters(initialParameters);
+
+  transformix->SetInputImageContainer(inputImageContainer);
+  ASSERT_EQ(transformix->ApplyPreparedTransform(argumentMap), 0);
+  ExpectEqualImages(getResultImage(*transformix), *expectedModifiedImage);
+}
+
+
+// Tests that the inverse of a translation, computed by ComputeInverseTransformOn(),
+// is a B-spline transform that translates back.
+GTEST_TEST(itkTransformixFilter, ComputeInverseTransformOfTranslation)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+
+  const itk::Offset<ImageDimension> translationOffset{ { 1, -2 } };
+  const SizeType                    imageSize{ { 9, 8 } };
+
+  const auto movingImage = ImageType::New();
+  movingImage->SetRegions(imageSize);
+  movingImage->Allocate(true);
+
+  const auto filter = CheckNew<itk::TransformixFilter<ImageType>>();
+  filter->ComputeInverseTransformOn();
+  filter->SetMovingImage(movingImage);
+  filter->SetTransformParameterObject(
+    CreateParameterObject({ // Parameters in alphabetic order:
+                            { "Direction", CreateDefaultDirectionParameterValues<ImageDimension>() },
+                            { "Index", ParameterValuesType(ImageDimension, "0") },
+                            { "NumberOfParameters", { std::to_string(ImageDimension) } },
+                            { "Origin", ParameterValuesType(ImageDimension, "0") },
+                            { "ResampleInterpolator", { "FinalLinearInterpolator" } },
+                            { "Size", ConvertToParameterValues(imageSize) },
+                            { "Transform", ParameterValuesType{ "TranslationTransform" } },
+                            { "TransformParameters", ConvertToParameterValues(translationOffset) },
+                            { "Spacing", ParameterValuesType(ImageDimension, "1") } }));
+  filter->Update();
+
+  const auto * const inverseTransformParameterObject = filter->GetInverseTransformParameterObject();
+  ASSERT_NE(inverseTransformParameterObject, nullptr);
+  const auto inverseTransformParameterMap = inverseTransformParameterObject->GetParameterMap(0);
+  EXPECT_EQ(inverseTransformParameterMap.at("Transform"), ParameterValuesType{ "BSplineTransform" });
+
+  // The deformation field of the inverse should undo the translation.
+  const auto inverseFilter = CheckNew<itk::TransformixFilter<ImageType>>();
+  inverseFilter->ComputeDeformationFieldOn();
+  inverseFilter->SetTransformParameterObject(CreateParameterObject(inverseTransformParameterMap));
+  inverseFilter->Update();
+
+  using DeformationFieldType = itk::TransformixFilter<ImageType>::OutputDeformationFieldType;
+  for (const auto & displacement :
+       itk::ImageBufferRange<const DeformationFieldType>(Deref(inverseFilter->GetOutputDeformationField())))
+  {
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      EXPECT_NEAR(displacement[i], -translationOffset[i], 1e-3);
+    }
+  }
+}
+
+
+// Tests that the inverse of a B-spline transform, computed by ComputeInverseTransformOn(),
+// maps every voxel y back onto itself: T(T^-1(y)) = y, away from the border of the domain.
+GTEST_TEST(itkTransformixFilter, ComputeInverseTransformOfBSplineRoundTrip)
+{
+  constexpr auto ImageDimension = 2U;
+  using ImageType = itk::Image<float, ImageDimension>;
+  using BSplineTransformType = itk::BSplineTransform<double, ImageDimension>;
+
+  const auto imageSize = MakeSize(21, 17);
+
+  const auto movingImage = ImageType::New();
+  movingImage->SetRegions(imageSize);
+  movingImage->Allocate(true);
+
+  const auto forwardTransform = BSplineTransformType::New();
+  forwardTransform->SetTransformDomainPhysicalDimensions(ConvertToItkVector(imageSize));
+  forwardTransform->SetTransformDomainMeshSize(MakeSize(2, 2));
+  forwardTransform->SetParameters(GeneratePseudoRandomParameters(forwardTransform->GetParameters().size(), -1.0));
+
+  const auto filter = CheckNew<itk::TransformixFilter<ImageType>>();
+  filter->ComputeInverseTransformOn();
+  filter->SetMovingImage(movingImage);
+  filter->SetTransformParameterObject(CreateParameterObject(
+    { // Parameters in alphabetic order:
+      { "Direction", CreateDefaultDirectionParameterValues<ImageDimension>() },
+      { "Index", ParameterValuesType(ImageDimension, "0") },
+      { "ITKTransformParameters", ConvertToParameterValues(forwardTransform->GetParameters()) },
+      { "ITKTransformFixedParameters", ConvertToParameterValues(forwardTransform->GetFixedParameters()) },
+      { "Origin", ParameterValuesType(ImageDimension, "0") },
+      { "ResampleInterpolator", { "FinalLinearInterpolator" } },
+      { "Size", ConvertToParameterValues(imageSize) },
+      { "Transform", { "BSplineTransform" } },
+      { "Spacing", ParameterValuesType(ImageDimension, "1") } }));
+  filter->Update();
+
+  const auto * const inverseTransformParameterObject = filter->GetInverseTransformParameterObject();
+  ASSERT_NE(inverseTransformParameterObject, nullptr);
+
+  const auto inverseFilter = CheckNew<itk::TransformixFilter<ImageType>>();
+  inverseFilter->ComputeDeformationFieldOn();
+  inverseFilter->SetTransformParameterObject(
+    CreateParameterObject(inverseTransformParameterObject->GetParameterMap(0)));
+  inverseFilter->Update();
+
+  const auto & inverseDeformationField = Deref(inverseFilter->GetOutputDeformationField());
+  ASSERT_EQ(inverseDeformationField.GetBufferedRegion().GetSize(), imageSize);
+
+  constexpr itk::IndexValueType margin = 2;
+  for (itk::IndexValueType y1 = margin; y1 < static_cast<itk::IndexValueType>(imageSize[1]) - margin; ++y1)
+  {
+    for (itk::IndexValueType y0 = margin; y0 < static_cast<itk::IndexValueType>(imageSize[0]) - margin; ++y0)
+    {
+      const auto                                 displacement = inverseDeformationField.GetPixel({ { y0, y1 } });
+      const BSplineTransformType::InputPointType y = MakePoint(static_cast<double>(y0), static_cast<double>(y1));
+      BSplineTransformType::InputPointType       x = y;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        x[i] += displacement[i];
+      }
+      EXPECT_LT(y.EuclideanDistanceTo(forwardTransform->TransformPoint(x)), 0.05) << " y = " << y;
+    }
+  }
+}
+
+
 GTEST_TEST(itkTransformixFilter, ITKTranslationTransform2D)
 {
   constexpr auto ImageDimension = 2U;
@@ -22,8 +22,13 @@
 #include "elxElastixMain.h"
 #include <Core/elxVersionMacros.h>
 #include "itkUseMevisDicomTiff.h"
+#include "elxParameterObject.h"
+#include "itkElastixBatchRegistrationMethod.h"
+#include "itkImageFileCastWriter.h"
 
 // ITK header files:
+#include <itkImageFileReader.h>
+#include <itkImageIOFactory.h>
 #include <itkTimeProbe.h>
 #include <itksys/SystemInformation.hxx>
 #include <itksys/SystemTools.hxx>
@@ -31,7 +36,10 @@
 // Standard C++ header files:
 #include <cassert>
 #include <climits> // For UINT_MAX.
+#include <algorithm>
 #include <cstddef> // For size_t.
+#include <cstdlib> // For atoi.
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <queue>
@@ -40,8 +48,13 @@
 int
 main(int argc, char ** argv)
 {
-  elastix::BaseComponent::InitializeElastixExecutable();
-  assert(!elastix::BaseComponent::IsElastixLibrary());
+  /** A batch registration runs its registrations through the library interface, see RunBatchRegistration(). */
+  const bool isBatchRegistration = std::find(argv + 1, argv + argc, std::string("-mlist")) != argv + argc;
+  if (!isBatchRegistration)
+  {
+    elastix::BaseComponent::InitializeElastixExecutable();
+  }
+  assert(elastix::BaseComponent::IsElastixLibrary() == isBatchRegistration);
 
   /** Check if "--help" or "--version" was asked for. */
   if (argc == 1)
@@ -205,6 +218,12 @@ main(int argc, char ** argv)
     return returndummy;
   }
 
+  /** Register the moving images of a list, if "-mlist" is given. */
+  if (argMap.count("-mlist") > 0)
+  {
+    return RunBatchRegistration(argMap, parameterFileList, outFolder);
+  }
+
   elxout << std::endl;
 
   /** Declare a timer, start it and print the start time. */
@@ -333,6 +352,267 @@ main(int argc, char ** argv)
 } // end main
 
 
+/**
+ * ******************* RunBatchRegistration *********************
+ */
+
+namespace
+{
+
+/** Registers the moving images to the fixed image by an itk::ElastixBatchRegistrationMethod, for
+ * images of the specified dimension. The images are read and registered as "float" images.
+ */
+template <unsigned int VDimension>
+int
+RunBatchRegistrationOfDimension(const std::map<std::string, std::string> & argMap,
+                                elx::ParameterObject::ParameterMapVectorType parameterMaps,
+                                const std::vector<std::string> &           movingImageFileNames,
+                                const std::string &                        outFolder)
+{
+  /** Some typedef's. */
+  typedef itk::Image<float, VDimension>                             ImageType;
+  typedef itk::ElastixBatchRegistrationMethod<ImageType, ImageType> BatchRegistrationType;
+  typedef typename BatchRegistrationType::FixedMaskType             FixedMaskType;
+  typedef elx::ParameterObject::ParameterMapType                    ParameterMapType;
+
+  /** The registrations of the batch register "float" images. */
+  for (auto & parameterMap : parameterMaps)
+  {
+    for (const std::string key : { "FixedInternalImagePixelType", "MovingInternalImagePixelType" })
+    {
+      const auto found = parameterMap.find(key);
+      if (found != parameterMap.end() && !found->second.empty() && found->second.front() != "float")
+      {
+        xl::xout["warning"] << "WARNING: The (" << key << ' ' << found->second.front()
+                            << ") is replaced by \"float\", as the registrations of \"-mlist\" use float images."
+                            << std::endl;
+      }
+      parameterMap[key] = { "float" };
+    }
+  }
+
+  /** The result image is written after the registration, as specified by the last parameter file. */
+  const ParameterMapType & lastParameterMap = parameterMaps.back();
+  const auto getParameter = [&lastParameterMap](const std::string & key, const std::string & defaultValue) {
+    const auto found = lastParameterMap.find(key);
+    return (found == lastParameterMap.end() || found->second.empty()) ? defaultValue : found->second.front();
+  };
+  std::string resultImagePixelType = getParameter("ResultImagePixelType", "short");
+  std::replace(resultImagePixelType.begin(), resultImagePixelType.end(), ' ', '_');
+  const std::string resultImageFileName =
+    "result." + std::to_string(parameterMaps.size() - 1) + '.' + getParameter("ResultImageFormat", "mhd");
+
+  const auto batchRegistration = BatchRegistrationType::New();
+
+  /** The fixed image and mask are shared by all registrations. */
+  const auto fixedImageReader = itk::ImageFileReader<ImageType>::New();
+  fixedImageReader->SetFileName(argMap.at("-f"));
+  batchRegistration->SetFixedImage(fixedImageReader->GetOutput());
+  const auto fixedMaskReader = itk::ImageFileReader<FixedMaskType>::New();
+  if (argMap.count("-fMask") > 0)
+  {
+    fixedMaskReader->SetFileName(argMap.at("-fMask"));
+    batchRegistration->SetFixedMask(fixedMaskReader->GetOutput());
+  }
+
+  /** A moving image is only read when its registration starts, and released when it is done. Its
+   * header is read here, so that the image IO is not created concurrently.
+   */
+  std::vector<typename itk::ImageFileReader<ImageType>::Pointer> movingImageReaders;
+  for (const auto & movingImageFileName : movingImageFileNames)
+  {
+    const auto movingImageReader = itk::ImageFileReader<ImageType>::New();
+    movingImageReader->SetFileName(movingImageFileName);
+    movingImageReader->UpdateOutputInformation();
+    movingImageReader->GetOutput()->ReleaseDataFlagOn();
+    batchRegistration->AddMovingImage(movingImageReader->GetOutput());
+    movingImageReaders.push_back(movingImageReader);
+  }
+
+  const auto parameterObject = elx::ParameterObject::New();
+  parameterObject->SetParameterMap(parameterMaps);
+  batchRegistration->SetParameterObject(parameterObject);
+  batchRegistration->SetOutputDirectory(outFolder);
+  batchRegistration->LogToFileOn();
+  if (argMap.count("-threads") > 0)
+  {
+    batchRegistration->SetNumberOfThreads(std::atoi(argMap.at("-threads").c_str()));
+  }
+  if (argMap.count("-concurrent") > 0)
+  {
+    batchRegistration->SetMaximumNumberOfConcurrentRegistrations(
+      static_cast<unsigned int>(std::max(1, std::atoi(argMap.at("-concurrent").c_str()))));
+  }
+
+  /** The results of a registration are written and released as soon as it is done,
+   * so that the memory does not grow with the number of moving images.
+   */
+  std::vector<bool> isRegistered(movingImageFileNames.size(), false);
+  batchRegistration->KeepResultsOff();
+  batchRegistration->SetRegistrationCompletedCallback(
+    [&](const unsigned int index, const ImageType * resultImage, const elx::ParameterObject *) {
+      movingImageReaders[index]->GetOutput()->ReleaseData();
+
+      const std::string & errorMessage = batchRegistration->GetErrorMessage(index);
+      if (!errorMessage.empty())
+      {
+        xl::xout["error"] << "  " << index << ": \"" << movingImageFileNames[index] << "\" failed, see also \""
+                          << outFolder << index << "/elastix.log\":\n"
+                          << errorMessage << std::endl;
+        return;
+      }
+
+      if (resultImage != nullptr)
+      {
+        /** Write the result image, in the pixel type of the parameter file. */
+        const auto writer = itk::ImageFileCastWriter<ImageType>::New();
+        writer->SetInput(resultImage);
+        writer->SetFileName(outFolder + std::to_string(index) + '/' + resultImageFileName);
+        writer->SetOutputComponentType(resultImagePixelType.c_str());
+        writer->SetUseCompression(getParameter("CompressResultImage", "false") == "true");
+        try
+        {
+          writer->Update();
+        }
+        catch (const itk::ExceptionObject & excp)
+        {
+          xl::xout["error"] << "  " << index << ": \"" << movingImageFileNames[index]
+                            << "\" was registered, but writing its result image failed:\n"
+                            << excp.GetDescription() << std::endl;
+          return;
+        }
+      }
+
+      elxout << "  " << index << ": \"" << movingImageFileNames[index] << "\" was registered." << std::endl;
+      isRegistered[index] = true;
+    });
+
+  elxout << "\nelastix registers " << movingImageFileNames.size() << " moving images from \"" << argMap.at("-mlist")
+         << "\", " << batchRegistration->GetMaximumNumberOfConcurrentRegistrations() << " at a time.\n"
+         << "The log of moving image i is written to \"" << outFolder << "i/elastix.log\".\n"
+         << std::endl;
+
+  itk::TimeProbe totaltimer;
+  totaltimer.Start();
+  try
+  {
+    batchRegistration->Update();
+  }
+  catch (const itk::ExceptionObject & excp)
+  {
+    /** A failed registration is reported by the callback, with its moving image. Any other error is reported here. */
+    unsigned int numberOfFailedRegistrations{};
+    for (unsigned int index = 0; index < movingImageFileNames.size(); ++index)
+    {
+      numberOfFailedRegistrations += batchRegistration->GetErrorMessage(index).empty() ? 0 : 1;
+    }
+    if (numberOfFailedRegistrations == 0)
+    {
+      xl::xout["error"] << "ERROR: " << excp.GetDescription() << std::endl;
+      return -1;
+    }
+  }
+  totaltimer.Stop();
+  elxout << "\nTotal time elapsed: " << ConvertSecondsToDHMS(totaltimer.GetMean(), 1) << ".\n" << std::endl;
+
+  return std::all_of(isRegistered.cbegin(), isRegistered.cend(), [](const bool registered) { return registered; })
+           ? 0
+           : 1;
+
+} // end RunBatchRegistrationOfDimension()
+
+} // end namespace
+
+
+int
+RunBatchRegistration(const std::map<std::string, std::string> & argMap,
+                     std::queue<std::string>                    parameterFileList,
+                     const std::string &                        outFolder)
+{
+  /** The arguments that are not passed to the registrations of a batch. */
+  for (const std::string key : { "-m", "-mMask", "-t0", "-fp", "-mp" })
+  {
+    if (argMap.count(key) > 0)
+    {
+      xl::xout["error"] << "ERROR: The command line option \"" << key << "\" cannot be combined with \"-mlist\"."
+                        << std::endl;
+      return -1;
+    }
+  }
+  if (argMap.count("-f") == 0)
+  {
+    xl::xout["error"] << "ERROR: No CommandLine option \"-f\" given!" << std::endl;
+    return -1;
+  }
+
+  /** Read the moving image file names, one per line. */
+  const std::string        movingImageListFileName = argMap.at("-mlist");
+  std::vector<std::string> movingImageFileNames;
+  std::ifstream            movingImageListFile(movingImageListFileName);
+  std::string              line;
+  while (std::getline(movingImageListFile, line))
+  {
+    line = itksys::SystemTools::TrimWhitespace(line);
+    if (!line.empty())
+    {
+      movingImageFileNames.push_back(line);
+    }
+  }
+  if (movingImageFileNames.empty())
+  {
+    xl::xout["error"] << "ERROR: No moving images found in \"" << movingImageListFileName << "\", given by \"-mlist\"."
+                      << std::endl;
+    return -1;
+  }
+
+  std::vector<std::string> parameterFileNames;
+  for (; !parameterFileList.empty(); parameterFileList.pop())
+  {
+    parameterFileNames.push_back(parameterFileList.front());
+  }
+
+  try
+  {
+    const auto parameterObject = elx::ParameterObject::New();
+    parameterObject->ReadParameterFile(parameterFileNames);
+
+    /** The dimension of the registrations is the one of the fixed image. */
+    const itk::ImageIOBase::Pointer imageIO =
+      itk::ImageIOFactory::CreateImageIO(argMap.at("-f").c_str(), itk::ImageIOFactory::ReadMode);
+    if (imageIO.IsNull())
+    {
+      xl::xout["error"] << "ERROR: Cannot read the fixed image \"" << argMap.at("-f") << "\"." << std::endl;
+      return -1;
+    }
+    imageIO->SetFileName(argMap.at("-f"));
+    imageIO->ReadImageInformation();
+
+    switch (imageIO->GetNumberOfDimensions())
+    {
+      case 2:
+        return RunBatchRegistrationOfDimension<2>(
+          argMap, parameterObject->GetParameterMap(), movingImageFileNames, outFolder);
+      case 3:
+        return RunBatchRegistrationOfDimension<3>(
+          argMap, parameterObject->GetParameterMap(), movingImageFileNames, outFolder);
+      case 4:
+        return RunBatchRegistrationOfDimension<4>(
+          argMap, parameterObject->GetParameterMap(), movingImageFileNames, outFolder);
+      default:
+        xl::xout["error"] << "ERROR: The fixed image has dimension " << imageIO->GetNumberOfDimensions()
+                          << ", while \"-mlist\" supports dimension 2, 3 and 4." << std::endl;
+        return -1;
+    }
+  }
+  catch (const itk::ExceptionObject & excp)
+  {
+    xl::xout["error"] << "ERROR: " << excp.GetDescription() << std::endl;
+    return -1;
+  }
+
+} // end RunBatchRegistration()
+
+
 /**
  * *********************** PrintHelp ****************************
  */
@@ -366,7 +646,12 @@ PrintHelp(void)
             << "  -t0       parameter file for initial transform\n"
             << "  -priority set the process priority to high, abovenormal, normal (default),\n"
             << "            belownormal, or idle (Windows only option)\n"
-            << "  -threads  set the maximum number of threads of elastix\n\n";
+            << "  -threads  set the maximum number of threads of elastix\n"
+            << "  -mlist    text file with one moving image per line, replacing \"-m\";\n"
+            << "            the results and the log of moving image i are written to the\n"
+            << "            subdirectory i of \"-out\"; the images are registered as float images,\n"
+            << "            and \"-mMask\", \"-t0\", \"-fp\" and \"-mp\" are not supported\n"
+            << "  -concurrent  the number of \"-mlist\" registrations that run at the same time (default 2)\n\n";
 
   /** The parameter file.*/
   std::cout << "The parameter-file must contain all the information "
@@ -22,6 +22,8 @@
 #include <ctime>
 #include <cmath>   // For fmod.
 #include <iomanip> // std::setprecision
+#include <map>
+#include <queue>
 #include <sstream>
 #include <string>
 
@@ -38,6 +40,26 @@
 void
 PrintHelp(void);
 
+/** Declare RunBatchRegistration function, which registers each moving image of a list to
+ * the fixed image by an itk::ElastixBatchRegistrationMethod, running a number of
+ * registrations concurrently. The fixed image is read only once, and the work that
+ * depends only on the fixed image is shared. The images are registered as float images.
+ *
+ * \commandlinearg -mlist: optional argument for elastix, a text file with the file name
+ *    of one moving image per line. Replaces "-m". The results and the elastix.log of the
+ *    i-th moving image are written to the subdirectory i of the output directory, as soon
+ *    as its registration is done, and then released from memory. It cannot
+ *    be combined with "-mMask", "-t0", "-fp" and "-mp". \n
+ *    example: <tt>elastix -f fixed.mhd -mlist moving.txt -out out -p par.txt</tt> \n
+ * \commandlinearg -concurrent: optional argument for elastix, the number of registrations
+ *    of "-mlist" that run at the same time. The default is 2. \n
+ *    example: <tt>elastix ... -mlist moving.txt -concurrent 4</tt> \n
+ */
+int
+RunBatchRegistration(const std::map<std::string, std::string> & argMap,
+                     std::queue<std::string>                    parameterFileList,
+                     const std::string &                        outFolder);
+
 /** ConvertSecondsToDHMS
  *
  */
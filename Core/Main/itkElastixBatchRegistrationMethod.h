@@ -0,0 +1,229 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkElastixBatchRegistrationMethod_h
+#define itkElastixBatchRegistrationMethod_h
+
+#include "itkElastixRegistrationMethod.h"
+#include "itkPlatformMultiThreader.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * \class ElastixBatchRegistrationMethod
+ * \brief Registers one fixed image to many moving images, with the same parameters.
+ *
+ * This is the use case of atlas construction and multi-atlas segmentation. The
+ * registrations run concurrently, at most MaximumNumberOfConcurrentRegistrations
+ * at a time, each in a thread of the batch's own threader. Each running
+ * registration holds its own moving image pyramid, transform and optimizer. The
+ * NumberOfThreads are divided over the metrics of the concurrent registrations;
+ * the global ITK thread settings are left as they are.
+ *
+ * The fixed-side data is prepared once for all registrations: during Update() an
+ * itk::BatchDataCache is enabled, through which the registrations share the fixed
+ * image pyramid, the eroded fixed masks and the fixed image extrema of the
+ * limiters.
+ *
+ * When an OutputDirectory is given, registration i writes its files to the
+ * subdirectory "<OutputDirectory>/<i>/", which is created when necessary. With
+ * LogToFileOn(), this includes its own "elastix.log": each registration sets up the
+ * "xout" log streams for its own thread only. Messages that elastix writes from the
+ * ITK worker threads go to the global "xout" log streams instead.
+ * Set the parameter (WriteResultImage "false") to keep only the transform
+ * parameters of all registrations in memory, and not their result images.
+ *
+ * To bound the memory of a large batch, set a RegistrationCompletedCallback, which
+ * receives the results of each registration as soon as it is done, for example to
+ * write them, and call KeepResultsOff(), so that the batch releases them afterwards.
+ *
+ * \ingroup Elastix
+ */
+
+namespace itk
+{
+
+template <typename TFixedImage, typename TMovingImage>
+class ITK_TEMPLATE_EXPORT ElastixBatchRegistrationMethod : public Object
+{
+public:
+  /** Standard ITK typedefs. */
+  typedef ElastixBatchRegistrationMethod Self;
+  typedef Object                         Superclass;
+  typedef SmartPointer<Self>             Pointer;
+  typedef SmartPointer<const Self>       ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ElastixBatchRegistrationMethod, Object);
+
+  /** Typedefs. */
+  typedef ElastixRegistrationMethod<TFixedImage, TMovingImage> RegistrationMethodType;
+  typedef typename RegistrationMethodType::FixedMaskType       FixedMaskType;
+  typedef typename RegistrationMethodType::ParameterObjectType ParameterObjectType;
+
+  using FixedImageType = TFixedImage;
+  using MovingImageType = TMovingImage;
+  using ResultImageType = typename RegistrationMethodType::ResultImageType;
+
+  /** The type of the function that receives the results of a registration as soon as
+   * it is done: the index of its moving image, its result image (null when it failed, or
+   * when (WriteResultImage "false")) and its transform parameters (null when it failed).
+   */
+  using RegistrationCompletedCallbackType =
+    std::function<void(unsigned int, const ResultImageType *, const ParameterObjectType *)>;
+
+  /** Set/Get the fixed image and the optional fixed mask, shared by all registrations. */
+  itkSetObjectMacro(FixedImage, FixedImageType);
+  itkGetConstObjectMacro(FixedImage, FixedImageType);
+  itkSetObjectMacro(FixedMask, FixedMaskType);
+  itkGetConstObjectMacro(FixedMask, FixedMaskType);
+
+  /** Add/Get/NumberOf moving images: one registration per moving image. */
+  void
+  AddMovingImage(MovingImageType * movingImage);
+  void
+  RemoveAllMovingImages();
+  const MovingImageType *
+  GetMovingImage(const unsigned int index) const;
+  unsigned int
+  GetNumberOfMovingImages() const;
+
+  /** Set/Get the parameter object, used by all registrations. */
+  itkSetObjectMacro(ParameterObject, ParameterObjectType);
+  itkGetModifiableObjectMacro(ParameterObject, ParameterObjectType);
+
+  /** Set/Get the output directory. Optional. */
+  itkSetMacro(OutputDirectory, std::string);
+  itkGetConstMacro(OutputDirectory, std::string);
+
+  /** Set/Get whether each registration writes an "elastix.log" to its subdirectory of
+   * the OutputDirectory. Default false.
+   */
+  itkSetMacro(LogToFile, bool);
+  itkGetConstMacro(LogToFile, bool);
+  itkBooleanMacro(LogToFile);
+
+  /** Set/Get the total number of threads. Default 0: the ITK default. */
+  itkSetMacro(NumberOfThreads, int);
+  itkGetConstMacro(NumberOfThreads, int);
+
+  /** Set/Get the maximum number of registrations that run at the same time. Default 2. */
+  itkSetClampMacro(MaximumNumberOfConcurrentRegistrations, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(MaximumNumberOfConcurrentRegistrations, unsigned int);
+
+  /** Set the function that is called when a registration is done, successfully or not.
+   * It is called from the thread that ran the registration, but never concurrently with
+   * itself. It may call GetErrorMessage() for the index that it receives. When it throws
+   * an exception, the registration is reported as failed.
+   */
+  void
+  SetRegistrationCompletedCallback(const RegistrationCompletedCallbackType & callback);
+
+  /** Set/Get whether the results of the registrations are kept until the next Update(),
+   * for GetResultImage() and GetTransformParameterObject(). Default true.
+   */
+  itkSetMacro(KeepResults, bool);
+  itkGetConstMacro(KeepResults, bool);
+  itkBooleanMacro(KeepResults);
+
+  /** Runs all registrations. Throws an exception when at least one of them failed;
+   * the results of the others are still available then.
+   */
+  void
+  Update();
+
+  /** The result image of the registration of the moving image with the given index,
+   * or null when it failed, when (WriteResultImage "false"), or when KeepResults is false.
+   */
+  const ResultImageType *
+  GetResultImage(const unsigned int index) const;
+
+  /** The transform parameters of the registration of the moving image with the
+   * given index, or null when it failed, or when KeepResults is false.
+   */
+  const ParameterObjectType *
+  GetTransformParameterObject(const unsigned int index) const;
+
+  /** The error message of the registration of the moving image with the given index,
+   * or an empty string when it succeeded.
+   */
+  const std::string &
+  GetErrorMessage(const unsigned int index) const;
+
+protected:
+  ElastixBatchRegistrationMethod();
+  ~ElastixBatchRegistrationMethod() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ElastixBatchRegistrationMethod(const Self &) = delete;
+  void
+  operator=(const Self &) = delete;
+
+  /** Runs the registration of the moving image with the given index, and returns its results. */
+  void
+  RunRegistration(const unsigned int                      index,
+                  typename ResultImageType::Pointer &     resultImage,
+                  typename ParameterObjectType::Pointer & transformParameterObject);
+
+  /** Passes the results of a registration to the callback, and keeps them when KeepResults is true. */
+  void
+  CompleteRegistration(const unsigned int    index,
+                       ResultImageType *     resultImage,
+                       ParameterObjectType * transformParameterObject);
+
+  /** Runs registrations until none is left, in each thread of m_Threader. */
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  RunRegistrationsThreaderCallback(void * arg);
+
+  typename FixedImageType::Pointer                   m_FixedImage;
+  typename FixedMaskType::Pointer                    m_FixedMask;
+  std::vector<typename MovingImageType::Pointer>     m_MovingImages;
+  typename ParameterObjectType::Pointer              m_ParameterObject;
+  std::string                                        m_OutputDirectory;
+  bool                                               m_LogToFile;
+  int                                                m_NumberOfThreads;
+  unsigned int                                       m_MaximumNumberOfConcurrentRegistrations;
+  RegistrationCompletedCallbackType                  m_RegistrationCompletedCallback;
+  bool                                               m_KeepResults;
+  std::vector<typename ResultImageType::Pointer>     m_ResultImages;
+  std::vector<typename ParameterObjectType::Pointer> m_TransformParameterObjects;
+  std::vector<std::string>                           m_ErrorMessages;
+
+  /** The threader that runs the registrations, and the state that its threads share during Update(). */
+  PlatformMultiThreader::Pointer m_Threader;
+  std::atomic<unsigned int>      m_NextRegistrationIndex;
+  int                            m_NumberOfThreadsPerRegistration;
+  std::mutex                     m_CallbackMutex;
+};
+
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkElastixBatchRegistrationMethod.hxx"
+#endif
+
+#endif // itkElastixBatchRegistrationMethod_h
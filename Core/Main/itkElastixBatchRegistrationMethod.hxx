@@ -0,0 +1,322 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkElastixBatchRegistrationMethod_hxx
+#define itkElastixBatchRegistrationMethod_hxx
+
+#include "itkElastixBatchRegistrationMethod.h"
+#include "itkBatchDataCache.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+namespace itk
+{
+
+template <typename TFixedImage, typename TMovingImage>
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::ElastixBatchRegistrationMethod()
+{
+  this->m_LogToFile = false;
+  this->m_NumberOfThreads = 0;
+  this->m_MaximumNumberOfConcurrentRegistrations = 2;
+  this->m_KeepResults = true;
+  this->m_Threader = PlatformMultiThreader::New();
+  this->m_NextRegistrationIndex = 0;
+  this->m_NumberOfThreadsPerRegistration = 1;
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::AddMovingImage(MovingImageType * movingImage)
+{
+  this->m_MovingImages.push_back(movingImage);
+  this->Modified();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::RemoveAllMovingImages()
+{
+  this->m_MovingImages.clear();
+  this->Modified();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetMovingImage(const unsigned int index) const
+  -> const MovingImageType *
+{
+  return this->m_MovingImages.at(index);
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+unsigned int
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetNumberOfMovingImages() const
+{
+  return static_cast<unsigned int>(this->m_MovingImages.size());
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::SetRegistrationCompletedCallback(
+  const RegistrationCompletedCallbackType & callback)
+{
+  this->m_RegistrationCompletedCallback = callback;
+  this->Modified();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetResultImage(const unsigned int index) const
+  -> const ResultImageType *
+{
+  return this->m_ResultImages.at(index);
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetTransformParameterObject(const unsigned int index) const
+  -> const ParameterObjectType *
+{
+  return this->m_TransformParameterObjects.at(index);
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+auto
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::GetErrorMessage(const unsigned int index) const
+  -> const std::string &
+{
+  return this->m_ErrorMessages.at(index);
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::Update()
+{
+  const auto numberOfRegistrations = static_cast<unsigned int>(this->m_MovingImages.size());
+  this->m_ResultImages.assign(numberOfRegistrations, nullptr);
+  this->m_TransformParameterObjects.assign(numberOfRegistrations, nullptr);
+  this->m_ErrorMessages.assign(numberOfRegistrations, std::string());
+
+  if (this->m_FixedImage.IsNull())
+  {
+    itkExceptionMacro("No fixed image.");
+  }
+  if (this->m_MovingImages.empty())
+  {
+    itkExceptionMacro("No moving images.");
+  }
+  if (this->m_ParameterObject.IsNull())
+  {
+    itkExceptionMacro("No parameter object.");
+  }
+  if (this->m_LogToFile && this->m_OutputDirectory.empty())
+  {
+    itkExceptionMacro("LogToFileOn() requires an output directory to be specified.");
+  }
+
+  /** Bring the shared inputs up to date before the registrations use them concurrently. */
+  this->m_FixedImage->UpdateLargestPossibleRegion();
+  if (this->m_FixedMask.IsNotNull())
+  {
+    this->m_FixedMask->UpdateLargestPossibleRegion();
+  }
+
+  /** The threads of the batch's own threader run the registrations. Each registration
+   * limits the threads of its metric to its share of the NumberOfThreads.
+   */
+  const unsigned int numberOfWorkers =
+    std::min(this->m_MaximumNumberOfConcurrentRegistrations, numberOfRegistrations);
+  const int totalNumberOfThreads = this->m_NumberOfThreads > 0
+                                     ? this->m_NumberOfThreads
+                                     : static_cast<int>(MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+  this->m_NumberOfThreadsPerRegistration = std::max(1, totalNumberOfThreads / static_cast<int>(numberOfWorkers));
+  this->m_NextRegistrationIndex = 0;
+  this->m_Threader->SetMaximumNumberOfThreads(numberOfWorkers);
+  this->m_Threader->SetNumberOfWorkUnits(numberOfWorkers);
+  this->m_Threader->SetSingleMethod(this->RunRegistrationsThreaderCallback, this);
+  {
+    const BatchDataCache::Scope batchDataCacheScope;
+    this->m_Threader->SingleMethodExecute();
+  }
+
+  /** Report all failed registrations at once. */
+  std::ostringstream errors;
+  for (unsigned int index = 0; index < numberOfRegistrations; ++index)
+  {
+    if (!this->m_ErrorMessages[index].empty())
+    {
+      errors << "\nThe registration of moving image " << index << " failed: " << this->m_ErrorMessages[index];
+    }
+  }
+  if (!errors.str().empty())
+  {
+    itkExceptionMacro(<< "Errors occurred during the batch registration:" << errors.str());
+  }
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::RunRegistrationsThreaderCallback(void * arg)
+{
+  const auto * const infoStruct = static_cast<PlatformMultiThreader::WorkUnitInfo *>(arg);
+  Self &             self = *static_cast<Self *>(infoStruct->UserData);
+
+  /** Each thread takes the next registration, until none is left. */
+  const auto numberOfRegistrations = static_cast<unsigned int>(self.m_MovingImages.size());
+  for (unsigned int index = self.m_NextRegistrationIndex++; index < numberOfRegistrations;
+       index = self.m_NextRegistrationIndex++)
+  {
+    typename ResultImageType::Pointer     resultImage;
+    typename ParameterObjectType::Pointer transformParameterObject;
+    try
+    {
+      self.RunRegistration(index, resultImage, transformParameterObject);
+    }
+    catch (const std::exception & e)
+    {
+      self.m_ErrorMessages[index] = e.what();
+    }
+    catch (...)
+    {
+      self.m_ErrorMessages[index] = "Unknown exception.";
+    }
+
+    try
+    {
+      self.CompleteRegistration(index, resultImage, transformParameterObject);
+    }
+    catch (const std::exception & e)
+    {
+      self.m_ErrorMessages[index] += std::string("\nThe RegistrationCompletedCallback failed: ") + e.what();
+    }
+    catch (...)
+    {
+      self.m_ErrorMessages[index] += "\nThe RegistrationCompletedCallback failed.";
+    }
+  }
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::RunRegistration(
+  const unsigned int                      index,
+  typename ResultImageType::Pointer &     resultImage,
+  typename ParameterObjectType::Pointer & transformParameterObject)
+{
+  const auto registration = RegistrationMethodType::New();
+  registration->m_RunConcurrently = true;
+  registration->SetLogToFile(this->m_LogToFile);
+  registration->SetNumberOfThreads(this->m_NumberOfThreadsPerRegistration);
+
+  /** The registrations do not share any data object, only the pixel buffers of
+   * the fixed image and mask, which identify them in the BatchDataCache.
+   */
+  const auto fixedImage = FixedImageType::New();
+  fixedImage->Graft(this->m_FixedImage);
+  registration->SetFixedImage(fixedImage);
+  if (this->m_FixedMask.IsNotNull())
+  {
+    const auto fixedMask = FixedMaskType::New();
+    fixedMask->Graft(this->m_FixedMask);
+    registration->SetFixedMask(fixedMask);
+  }
+  registration->SetMovingImage(this->m_MovingImages[index]);
+
+  const auto parameterObject = ParameterObjectType::New();
+  parameterObject->SetParameterMap(this->m_ParameterObject->GetParameterMap());
+  registration->SetParameterObject(parameterObject);
+
+  if (!this->m_OutputDirectory.empty())
+  {
+    std::string outputDirectory = this->m_OutputDirectory;
+    if (outputDirectory.back() != '/' && outputDirectory.back() != '\\')
+    {
+      outputDirectory += '/';
+    }
+    outputDirectory += std::to_string(index) + '/';
+    itksys::SystemTools::MakeDirectory(outputDirectory);
+    registration->SetOutputDirectory(outputDirectory);
+  }
+
+  registration->Update();
+
+  if (registration->GetOutput()->GetBufferedRegion().GetNumberOfPixels() > 0)
+  {
+    resultImage = registration->GetOutput();
+  }
+  transformParameterObject = registration->GetTransformParameterObject();
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::CompleteRegistration(
+  const unsigned int    index,
+  ResultImageType *     resultImage,
+  ParameterObjectType * transformParameterObject)
+{
+  if (this->m_RegistrationCompletedCallback)
+  {
+    const std::lock_guard<std::mutex> lock(this->m_CallbackMutex);
+    this->m_RegistrationCompletedCallback(index, resultImage, transformParameterObject);
+  }
+
+  if (this->m_KeepResults)
+  {
+    this->m_ResultImages[index] = resultImage;
+    this->m_TransformParameterObjects[index] = transformParameterObject;
+  }
+}
+
+
+template <typename TFixedImage, typename TMovingImage>
+void
+ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FixedImage: " << this->m_FixedImage.GetPointer() << std::endl;
+  os << indent << "FixedMask: " << this->m_FixedMask.GetPointer() << std::endl;
+  os << indent << "NumberOfMovingImages: " << this->m_MovingImages.size() << std::endl;
+  os << indent << "ParameterObject: " << this->m_ParameterObject.GetPointer() << std::endl;
+  os << indent << "OutputDirectory: " << this->m_OutputDirectory << std::endl;
+  os << indent << "LogToFile: " << this->m_LogToFile << std::endl;
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
+  os << indent << "MaximumNumberOfConcurrentRegistrations: " << this->m_MaximumNumberOfConcurrentRegistrations
+     << std::endl;
+  os << indent << "KeepResults: " << this->m_KeepResults << std::endl;
+}
+
+} // namespace itk
+
+#endif // itkElastixBatchRegistrationMethod_hxx
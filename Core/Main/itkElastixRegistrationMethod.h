@@ -50,6 +50,9 @@
 namespace itk
 {
 
+template <typename TFixedImage, typename TMovingImage>
+class ElastixBatchRegistrationMethod;
+
 template <typename TFixedImage, typename TMovingImage>
 class ITK_TEMPLATE_EXPORT ElastixRegistrationMethod : public itk::ImageSource<TFixedImage>
 {
@@ -255,6 +258,9 @@ protected:
   MakeOutput(DataObjectPointerArraySizeType idx) override;
 
 private:
+  /** The batch registration runs its registrations concurrently, each logging in its own thread. */
+  friend class ElastixBatchRegistrationMethod<TFixedImage, TMovingImage>;
+
   ElastixRegistrationMethod(const Self &) = delete;
   void
   operator=(const Self &) = delete;
@@ -285,6 +291,13 @@ private:
   bool m_LogToConsole;
   bool m_LogToFile;
 
+  /** True when this registration runs concurrently with others, each in its own
+   * thread. GenerateData() then sets up the "xout" output streams for the calling
+   * thread only, instead of the global ones, and the NumberOfThreads only limits
+   * the threads of the metric, not the global maximum number of ITK threads.
+   */
+  bool m_RunConcurrently;
+
   int m_NumberOfThreads;
 
   unsigned int m_InputUID;
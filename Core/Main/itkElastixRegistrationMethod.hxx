@@ -39,6 +39,7 @@
 #include "itkElastixRegistrationMethod.h"
 
 #include <algorithm> // For find.
+#include <memory>    // For unique_ptr.
 
 namespace itk
 {
@@ -61,6 +62,7 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::ElastixRegistrationMethod(
 
   this->m_LogToConsole = false;
   this->m_LogToFile = false;
+  this->m_RunConcurrently = false;
 
   this->m_NumberOfThreads = 0;
 
@@ -216,8 +218,17 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
     argumentMap.insert(ArgumentMapEntryType("-threads", std::to_string(this->m_NumberOfThreads)));
   }
 
-  // Setup xout
-  const elastix::xoutManager manager(logFileName, this->GetLogToFile(), this->GetLogToConsole());
+  // Setup xout, only for the calling thread when this registration runs concurrently with others
+  std::unique_ptr<const elastix::xoutManager>       manager;
+  std::unique_ptr<const elastix::xoutThreadManager> threadManager;
+  if (this->m_RunConcurrently)
+  {
+    threadManager.reset(new elastix::xoutThreadManager(logFileName, this->GetLogToFile(), this->GetLogToConsole()));
+  }
+  else
+  {
+    manager.reset(new elastix::xoutManager(logFileName, this->GetLogToFile(), this->GetLogToConsole()));
+  }
 
   // Run the (possibly multiple) registration(s)
   for (unsigned int i = 0; i < parameterMapVector.size(); ++i)
@@ -240,6 +251,7 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
 
     // Set elastix levels
     elastix->SetElastixLevel(i);
+    elastix->SetLimitGlobalMaximumNumberOfThreads(!this->m_RunConcurrently);
     elastix->SetTotalNumberOfElastixLevels(parameterMapVector.size());
 
     // Set stuff we get from a previous registration
@@ -264,6 +276,10 @@ ElastixRegistrationMethod<TFixedImage, TMovingImage>::GenerateData()
 
     if (isError != 0)
     {
+      if (threadManager != nullptr && !threadManager->GetErrorMessages().empty())
+      {
+        itkExceptionMacro(<< "Internal elastix error: " << threadManager->GetErrorMessages());
+      }
       itkExceptionMacro(<< "Internal elastix error: See elastix log (use LogToConsoleOn() or LogToFileOn()).");
     }
 
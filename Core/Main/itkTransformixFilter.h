@@ -135,6 +135,13 @@ public:
   itkGetConstMacro(ComputeDeformationField, bool);
   itkBooleanMacro(ComputeDeformationField);
 
+  /** Compute inverse transform On/Off. After the update, the inverse is available
+   * as a B-spline transform from GetInverseTransformParameterObject().
+   */
+  itkSetMacro(ComputeInverseTransform, bool);
+  itkGetConstMacro(ComputeInverseTransform, bool);
+  itkBooleanMacro(ComputeInverseTransform);
+
   /** Get/Set transform parameter object. */
   virtual void
   SetTransformParameterObject(ParameterObjectType * transformParameterObject);
@@ -145,6 +152,12 @@ public:
   const ParameterObjectType *
   GetTransformParameterObject() const;
 
+  /** Get the inverse transform, computed by the last update when ComputeInverseTransform
+   * is on. Returns null otherwise.
+   */
+  const ParameterObjectType *
+  GetInverseTransformParameterObject() const;
+
   using Superclass::GetOutput;
   DataObject *
   GetOutput(unsigned int idx);
@@ -188,6 +201,15 @@ public:
   itkGetConstMacro(LogToFile, bool);
   itkBooleanMacro(LogToFile);
 
+  /** Reuse the transform of the previous update on/off. When on, the transform
+   * parameter maps are parsed and the transformix components are created only once,
+   * as long as the TransformParameterObject is not modified. This speeds up
+   * applying the same transform to many images or point sets.
+   */
+  itkSetMacro(ReusePreparedTransform, bool);
+  itkGetConstMacro(ReusePreparedTransform, bool);
+  itkBooleanMacro(ReusePreparedTransform);
+
 protected:
   TransformixFilter();
 
@@ -222,12 +244,20 @@ private:
   bool        m_ComputeSpatialJacobian;
   bool        m_ComputeDeterminantOfSpatialJacobian;
   bool        m_ComputeDeformationField;
+  bool        m_ComputeInverseTransform;
+
+  ParameterObjectPointer m_InverseTransformParameterObject;
 
   std::string m_OutputDirectory;
   std::string m_LogFileName;
 
   bool m_LogToConsole;
   bool m_LogToFile;
+
+  bool                   m_ReusePreparedTransform;
+  TransformixMainPointer m_PreparedTransformixMain;
+  ParameterObjectPointer m_PreparedTransformParameterObject;
+  ModifiedTimeType       m_PreparedTransformParameterObjectMTime;
 };
 
 } // namespace itk
@@ -53,12 +53,16 @@ TransformixFilter<TMovingImage>::TransformixFilter()
   this->m_ComputeSpatialJacobian = false;
   this->m_ComputeDeterminantOfSpatialJacobian = false;
   this->m_ComputeDeformationField = false;
+  this->m_ComputeInverseTransform = false;
 
   this->m_OutputDirectory = "";
   this->m_LogFileName = "";
 
   this->m_LogToConsole = false;
   this->m_LogToFile = false;
+
+  this->m_ReusePreparedTransform = false;
+  this->m_PreparedTransformParameterObjectMTime = 0;
 }
 
 
@@ -74,13 +78,14 @@ TransformixFilter<TMovingImage>::GenerateData()
 
   if (this->IsEmpty(this->GetMovingImage()) && this->GetFixedPointSetFileName().empty() &&
       !this->GetComputeSpatialJacobian() && !this->GetComputeDeterminantOfSpatialJacobian() &&
-      !this->GetComputeDeformationField())
+      !this->GetComputeDeformationField() && !this->GetComputeInverseTransform())
   {
     itkExceptionMacro("Expected at least one of SetMovingImage(), "
                       << "SetFixedPointSetFileName() "
                       << "ComputeSpatialJacobianOn(), "
-                      << "ComputeDeterminantOfSpatialJacobianOn() or "
-                      << "ComputeDeformationFieldOn(), "
+                      << "ComputeDeterminantOfSpatialJacobianOn(), "
+                      << "ComputeDeformationFieldOn() or "
+                      << "ComputeInverseTransformOn(), "
                       << "to be active.\"");
   }
 
@@ -115,6 +120,11 @@ TransformixFilter<TMovingImage>::GenerateData()
     argumentMap.insert(ArgumentMapEntryType("-def", this->GetFixedPointSetFileName()));
   }
 
+  if (this->GetComputeInverseTransform())
+  {
+    argumentMap.insert(ArgumentMapEntryType("-inv", "all"));
+  }
+
   // Setup output directory
   // Only the input "MovingImage" does not require an output directory
   if ((this->GetComputeSpatialJacobian() || this->GetComputeDeterminantOfSpatialJacobian() ||
@@ -161,8 +171,19 @@ TransformixFilter<TMovingImage>::GenerateData()
   // Setup xout
   const elx::xoutManager manager(logFileName, this->GetLogToFile(), this->GetLogToConsole());
 
+  // Get ParameterMap
+  ParameterObjectPointer transformParameterObject = this->GetTransformParameterObject();
+
+  // Reuse the transformix instance of the previous update, if the transform did not change
+  const bool reusePreparedTransform =
+    this->GetReusePreparedTransform() && this->m_PreparedTransformixMain.IsNotNull() &&
+    this->m_PreparedTransformixMain->IsTransformPrepared() &&
+    this->m_PreparedTransformParameterObject == transformParameterObject &&
+    this->m_PreparedTransformParameterObjectMTime == transformParameterObject->GetMTime();
+
   // Instantiate transformix
-  TransformixMainPointer transformix = TransformixMainType::New();
+  TransformixMainPointer transformix =
+    reusePreparedTransform ? this->m_PreparedTransformixMain : TransformixMainType::New();
 
   // Setup transformix for warping input image if given
   DataObjectContainerPointer inputImageContainer = nullptr;
@@ -170,45 +191,71 @@ TransformixFilter<TMovingImage>::GenerateData()
   {
     inputImageContainer = DataObjectContainerType::New();
     inputImageContainer->InsertElement(0, const_cast<InputImageType *>(this->GetMovingImage()));
-    transformix->SetInputImageContainer(inputImageContainer);
   }
+  transformix->SetInputImageContainer(inputImageContainer);
 
-  // Get ParameterMap
-  ParameterObjectPointer transformParameterObject = this->GetTransformParameterObject();
-  ParameterMapVectorType transformParameterMapVector = transformParameterObject->GetParameterMap();
-
-  // Assert user did not set empty parameter map
-  if (transformParameterMapVector.empty())
+  unsigned int isError = 0;
+  if (reusePreparedTransform)
   {
-    itkExceptionMacro("Empty parameter map in parameter object.");
+    // Run transformix, with the components of the previous update
+    try
+    {
+      isError = transformix->ApplyPreparedTransform(argumentMap);
+    }
+    catch (itk::ExceptionObject & e)
+    {
+      itkExceptionMacro("Errors occured during execution: " << e.what());
+    }
   }
-
-  // Set pixel types from input image, override user settings
-  for (unsigned int i = 0; i < transformParameterMapVector.size(); ++i)
+  else
   {
-    transformParameterMapVector[i]["FixedImageDimension"] =
-      ParameterValueVectorType(1, std::to_string(movingImageDimension));
-    transformParameterMapVector[i]["MovingImageDimension"] =
-      ParameterValueVectorType(1, std::to_string(movingImageDimension));
-    transformParameterMapVector[i]["ResultImagePixelType"] =
-      ParameterValueVectorType(1, elastix::PixelType<typename TMovingImage::PixelType>::ToString());
-
-    if (i > 0)
+    ParameterMapVectorType transformParameterMapVector = transformParameterObject->GetParameterMap();
+
+    // Assert user did not set empty parameter map
+    if (transformParameterMapVector.empty())
     {
-      transformParameterMapVector[i]["InitialTransformParametersFileName"] =
-        ParameterValueVectorType(1, std::to_string(i - 1));
+      itkExceptionMacro("Empty parameter map in parameter object.");
     }
-  }
 
-  // Run transformix
-  unsigned int isError = 0;
-  try
-  {
-    isError = transformix->Run(argumentMap, transformParameterMapVector);
-  }
-  catch (itk::ExceptionObject & e)
-  {
-    itkExceptionMacro("Errors occured during execution: " << e.what());
+    // Set pixel types from input image, override user settings
+    for (unsigned int i = 0; i < transformParameterMapVector.size(); ++i)
+    {
+      transformParameterMapVector[i]["FixedImageDimension"] =
+        ParameterValueVectorType(1, std::to_string(movingImageDimension));
+      transformParameterMapVector[i]["MovingImageDimension"] =
+        ParameterValueVectorType(1, std::to_string(movingImageDimension));
+      transformParameterMapVector[i]["ResultImagePixelType"] =
+        ParameterValueVectorType(1, elastix::PixelType<typename TMovingImage::PixelType>::ToString());
+
+      if (i > 0)
+      {
+        transformParameterMapVector[i]["InitialTransformParametersFileName"] =
+          ParameterValueVectorType(1, std::to_string(i - 1));
+      }
+    }
+
+    // Run transformix
+    try
+    {
+      isError = transformix->Run(argumentMap, transformParameterMapVector);
+    }
+    catch (itk::ExceptionObject & e)
+    {
+      itkExceptionMacro("Errors occured during execution: " << e.what());
+    }
+
+    // Keep the components alive for the next update, if desired
+    if (this->GetReusePreparedTransform())
+    {
+      this->m_PreparedTransformixMain = transformix;
+      this->m_PreparedTransformParameterObject = transformParameterObject;
+      this->m_PreparedTransformParameterObjectMTime = transformParameterObject->GetMTime();
+    }
+    else
+    {
+      this->m_PreparedTransformixMain = nullptr;
+      this->m_PreparedTransformParameterObject = nullptr;
+    }
   }
 
   if (isError != 0)
@@ -230,6 +277,14 @@ TransformixFilter<TMovingImage>::GenerateData()
   {
     this->GraftOutput("ResultDeformationField", resultDeformationFieldContainer->ElementAt(0));
   }
+  // Optionally, save the inverse transform
+  this->m_InverseTransformParameterObject = nullptr;
+  const ParameterMapType inverseTransformParameterMap = transformix->GetInverseTransformParametersMap();
+  if (this->GetComputeInverseTransform() && !inverseTransformParameterMap.empty())
+  {
+    this->m_InverseTransformParameterObject = ParameterObjectType::New();
+    this->m_InverseTransformParameterObject->SetParameterMap(inverseTransformParameterMap);
+  }
 }
 
 
@@ -442,6 +497,14 @@ TransformixFilter<TMovingImage>::GetTransformParameterObject() const
 }
 
 
+template <typename TMovingImage>
+const typename TransformixFilter<TMovingImage>::ParameterObjectType *
+TransformixFilter<TMovingImage>::GetInverseTransformParameterObject() const
+{
+  return this->m_InverseTransformParameterObject.GetPointer();
+}
+
+
 template <typename TMovingImage>
 typename TransformixFilter<TMovingImage>::OutputDeformationFieldType *
 TransformixFilter<TMovingImage>::GetOutputDeformationField()
@@ -27,7 +27,125 @@
 #include <itkTimeProbe.h>
 
 // Standard C++ header files:
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+/**
+ * *********************** RunBatch ****************************
+ *
+ * Reads requests, one per line, from the specified source ("stdin", or the
+ * name of a file or named pipe), and applies the prepared transform to each
+ * of them. A request consists of "-key value" pairs, for example:
+ *   -in image.mhd -out outputdir/ -def points.txt
+ * The line "quit" or the end of the input stops the batch.
+ */
+
+int
+RunBatch(elx::TransformixMain & transformix, const std::string & source)
+{
+  typedef elx::TransformixMain::ArgumentMapType ArgumentMapType;
+
+  std::ifstream fileStream;
+  if (source != "stdin")
+  {
+    fileStream.open(source);
+    if (!fileStream.is_open())
+    {
+      xl::xout["error"] << "ERROR: the batch input \"" << source << "\" could not be opened." << std::endl;
+      return 1;
+    }
+  }
+  std::istream & input = (source == "stdin") ? std::cin : fileStream;
+
+  int          returndummy = 0;
+  unsigned int requestNumber = 0;
+  std::string  line;
+  while (std::getline(input, line))
+  {
+    /** Split the line into words. */
+    std::istringstream             lineStream(line);
+    const std::vector<std::string> words{ std::istream_iterator<std::string>(lineStream),
+                                          std::istream_iterator<std::string>() };
+    if (words.empty())
+    {
+      continue;
+    }
+    if (words.size() == 1 && words.front() == "quit")
+    {
+      break;
+    }
+
+    ++requestNumber;
+    if (words.size() % 2 != 0)
+    {
+      xl::xout["error"] << "ERROR: batch request " << requestNumber << " should consist of \"-key value\" pairs."
+                        << std::endl;
+      returndummy |= 1;
+      continue;
+    }
+
+    /** Put the words into an argument map. */
+    ArgumentMapType argMap;
+    bool            isValidRequest = true;
+    for (std::size_t i = 0; i < words.size(); i += 2)
+    {
+      const std::string & key = words[i];
+      std::string         value = words[i + 1];
+
+      if (key == "-out")
+      {
+        /** Make sure that last character of the output folder equals a '/' or '\'. */
+        const char last = value.back();
+        if (last != '/' && last != '\\')
+        {
+          value.append("/");
+        }
+        value = elx::Conversion::ToNativePathNameSeparators(value);
+
+        if (!itksys::SystemTools::FileIsDirectory(value))
+        {
+          xl::xout["error"] << "ERROR: the output directory \"" << value << "\" does not exist." << std::endl;
+          isValidRequest = false;
+        }
+      }
+      argMap[key] = value;
+    }
+    if (!isValidRequest)
+    {
+      returndummy |= 1;
+      continue;
+    }
+
+    /** Apply the transform, reusing the components of the previous request. */
+    itk::TimeProbe timer;
+    timer.Start();
+    elxout << "\nRunning batch request " << requestNumber << ": " << line << "\n" << std::endl;
+    const int errorCode = transformix.ApplyPreparedTransform(argMap);
+    timer.Stop();
+
+    if (errorCode != 0)
+    {
+      xl::xout["error"] << "Errors occurred in batch request " << requestNumber << std::endl;
+      returndummy |= errorCode;
+    }
+    else
+    {
+      elxout << "Batch request " << requestNumber << " done, it took " << ConvertSecondsToDHMS(timer.GetMean(), 2)
+             << std::endl;
+    }
+  }
+
+  return returndummy;
+
+} // end RunBatch()
+
+} // namespace
 
 
 int
@@ -128,12 +246,15 @@ main(int argc, char ** argv)
     returndummy |= -1;
   }
 
-  /** Check that at least one of the following options is given. */
-  if (argMap.count("-in") == 0 && argMap.count("-ipp") == 0 && argMap.count("-def") == 0 && argMap.count("-jac") == 0 &&
-      argMap.count("-jacmat") == 0)
+  /** Check that at least one of the following options is given.
+   * In batch mode, the inputs are given by the batch requests.
+   */
+  if (argMap.count("-batch") == 0 && argMap.count("-in") == 0 && argMap.count("-ipp") == 0 &&
+      argMap.count("-def") == 0 && argMap.count("-jac") == 0 && argMap.count("-jacmat") == 0 &&
+      argMap.count("-inv") == 0)
   {
     std::cerr << "ERROR: At least one of the CommandLine options \"-in\", "
-              << "\"-def\", \"-jac\", or \"-jacmat\" should be given!" << std::endl;
+              << "\"-def\", \"-jac\", \"-jacmat\", or \"-inv\" should be given!" << std::endl;
     returndummy |= -1;
   }
 
@@ -211,6 +332,12 @@ main(int argc, char ** argv)
     return returndummy;
   }
 
+  /** In batch mode, apply the prepared transform to each of the requests. */
+  if (argMap.count("-batch") > 0)
+  {
+    returndummy = RunBatch(*transformix, argMap["-batch"]);
+  }
+
   /** Stop timer and print it. */
   totaltimer.Stop();
   elxout << "\ntransformix has finished at " << GetCurrentDateAndTime() << "." << std::endl;
@@ -258,10 +385,18 @@ PrintHelp(void)
             << "            spatial Jacobian\n"
             << "  -jacmat   use \"-jacmat all\" to generate an image with the spatial Jacobian\n"
             << "            matrix at each voxel\n"
+            << "  -inv      use \"-inv all\" to compute the inverse of the transform, as an\n"
+            << "            inverse deformation field on the grid of the input image (or of the\n"
+            << "            output grid), and as a B-spline transform-parameter file\n"
             << "  -priority set the process priority to high, abovenormal, normal (default),\n"
             << "            belownormal, or idle (Windows only option)\n"
             << "  -threads  set the maximum number of threads of transformix\n"
-            << "\nAt least one of the options \"-in\", \"-def\", \"-jac\", or \"-jacmat\" should be given.\n\n";
+            << "  -batch    use \"-batch stdin\", or the name of a file or named pipe, to apply\n"
+            << "            the transform to many inputs. The transform is read only once. Each\n"
+            << "            line holds the options of one request, like \"-in image.mhd -out dir/\",\n"
+            << "            and the line \"quit\" ends the batch.\n"
+            << "\nAt least one of the options \"-in\", \"-def\", \"-jac\", \"-jacmat\", \"-inv\", or \"-batch\"\n"
+            << "should be given.\n\n";
 
   /** The parameter file. */
   std::cout << "The transform-parameter file must contain all the information "
@@ -29,6 +29,9 @@
 // Multi-threading using ITK threads
 #include "itkPlatformMultiThreader.h"
 
+// Multi-threading using the parameter update kernel of the optimizers
+#include "itkParameterUpdateKernel.h"
+
 // Multi-threading using OpenMP
 #ifdef ELASTIX_USE_OPENMP
 #  include <omp.h>
@@ -76,6 +79,9 @@ public:
   bool                               m_UseOpenMP;
   bool                               m_UseEigen;
   bool                               m_UseMultiThreaded;
+  bool                               m_UseKernel;
+
+  itk::ParameterUpdateKernel::Pointer m_Kernel;
 
   struct MultiThreaderParameterType
   {
@@ -92,6 +98,9 @@ public:
     this->m_UseOpenMP = false;
     this->m_UseEigen = false;
     this->m_UseMultiThreaded = false;
+    this->m_UseKernel = false;
+    this->m_Kernel = itk::ParameterUpdateKernel::New();
+    this->m_Kernel->SetNumberOfWorkUnits(8);
   }
 
 
@@ -101,7 +110,11 @@ public:
     const unsigned int spaceDimension = m_NumberOfParameters;
     ParametersType &   newPosition = this->m_CurrentPosition;
 
-    if (!this->m_UseMultiThreaded)
+    if (this->m_UseKernel)
+    {
+      this->m_Kernel->Step(newPosition, -this->m_LearningRate, this->m_Gradient);
+    }
+    else if (!this->m_UseMultiThreaded)
     {
       /** Get a pointer to the current position. */
       const InternalScalarType * currentPosition = this->m_CurrentPosition.data_block();
@@ -318,6 +331,27 @@ main(void)
       timeCollector.Stop("ITK (mt)");
     }
 
+    /** Time the parameter update kernel, and check that it gives the same result. */
+    optimizer->m_UseMultiThreaded = false;
+    optimizer->m_CurrentPosition = curPos;
+    optimizer->AdvanceOneStep();
+    const ParametersType stPosition = optimizer->m_CurrentPosition;
+    optimizer->m_CurrentPosition = curPos;
+    optimizer->m_UseKernel = true;
+    optimizer->AdvanceOneStep();
+    if (optimizer->m_CurrentPosition != stPosition)
+    {
+      std::cerr << "ERROR: the parameter update kernel gives a different result." << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int i = 0; i < rep; ++i)
+    {
+      timeCollector.Start("Kernel (mt)");
+      optimizer->AdvanceOneStep();
+      timeCollector.Stop("Kernel (mt)");
+    }
+    optimizer->m_UseKernel = false;
+
     /** Time the OpenMP multi-threaded implementation. */
 #ifdef ELASTIX_USE_OPENMP
     optimizer->m_UseOpenMP = true;
@@ -0,0 +1,172 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPersistentPlatformMultiThreader.h"
+#include "itkPlatformMultiThreader.h"
+
+// Report timings
+#include "itkTimeProbesCollectorBase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// Compares the overhead of PlatformMultiThreader, which starts new threads in each
+// SingleMethodExecute(), with PersistentPlatformMultiThreader, which keeps its threads.
+// Each "iteration" mimics a metric evaluation with a few thousand samples: a threaded
+// evaluation of the samples, followed by a threaded accumulation of the derivatives.
+
+namespace
+{
+typedef itk::PlatformMultiThreader::WorkUnitInfo ThreadInfoType;
+
+struct IterationData
+{
+  unsigned int                     m_NumberOfSamples;
+  unsigned int                     m_NumberOfParameters;
+  std::vector<std::vector<double>> m_ThreaderDerivatives;
+  std::vector<double>              m_Derivative;
+};
+
+
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+EvaluateSamplesThreaderCallback(void * arg)
+{
+  const ThreadInfoType * infoStruct = static_cast<ThreadInfoType *>(arg);
+  IterationData *        data = static_cast<IterationData *>(infoStruct->UserData);
+  const unsigned int     threadID = infoStruct->WorkUnitID;
+  const unsigned int     numberOfThreads = infoStruct->NumberOfWorkUnits;
+
+  const unsigned int chunk = (data->m_NumberOfSamples + numberOfThreads - 1) / numberOfThreads;
+  const unsigned int begin = std::min(threadID * chunk, data->m_NumberOfSamples);
+  const unsigned int end = std::min(begin + chunk, data->m_NumberOfSamples);
+
+  std::vector<double> & derivative = data->m_ThreaderDerivatives[threadID];
+  for (unsigned int i = begin; i < end; ++i)
+  {
+    derivative[i % data->m_NumberOfParameters] += std::sin(0.001 * i);
+  }
+
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+}
+
+
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+AccumulateDerivativesThreaderCallback(void * arg)
+{
+  const ThreadInfoType * infoStruct = static_cast<ThreadInfoType *>(arg);
+  IterationData *        data = static_cast<IterationData *>(infoStruct->UserData);
+  const unsigned int     threadID = infoStruct->WorkUnitID;
+  const unsigned int     numberOfThreads = infoStruct->NumberOfWorkUnits;
+
+  const unsigned int chunk = (data->m_NumberOfParameters + numberOfThreads - 1) / numberOfThreads;
+  const unsigned int begin = std::min(threadID * chunk, data->m_NumberOfParameters);
+  const unsigned int end = std::min(begin + chunk, data->m_NumberOfParameters);
+
+  for (unsigned int j = begin; j < end; ++j)
+  {
+    double sum = 0.0;
+    for (auto & threaderDerivative : data->m_ThreaderDerivatives)
+    {
+      sum += threaderDerivative[j];
+      threaderDerivative[j] = 0.0;
+    }
+    data->m_Derivative[j] = sum;
+  }
+
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+}
+
+
+/** Runs the iterations with the given threader, and returns the final derivative. */
+std::vector<double>
+RunIterations(itk::PlatformMultiThreader *   threader,
+              const unsigned int             numberOfSamples,
+              const unsigned int             numberOfIterations,
+              itk::TimeProbesCollectorBase & timeCollector,
+              const std::string &            label)
+{
+  IterationData data;
+  data.m_NumberOfSamples = numberOfSamples;
+  data.m_NumberOfParameters = 1000;
+  data.m_ThreaderDerivatives.assign(threader->GetNumberOfWorkUnits(),
+                                    std::vector<double>(data.m_NumberOfParameters, 0.0));
+  data.m_Derivative.assign(data.m_NumberOfParameters, 0.0);
+
+  for (unsigned int it = 0; it < numberOfIterations; ++it)
+  {
+    timeCollector.Start(label.c_str());
+    threader->SetSingleMethod(EvaluateSamplesThreaderCallback, &data);
+    threader->SingleMethodExecute();
+    threader->SetSingleMethod(AccumulateDerivativesThreaderCallback, &data);
+    threader->SingleMethodExecute();
+    timeCollector.Stop(label.c_str());
+  }
+
+  return data.m_Derivative;
+}
+
+} // namespace
+
+//-------------------------------------------------------------------------------------
+
+int
+main(void)
+{
+  /** The number of iterations. Distinguish between Debug and Release mode. */
+#ifndef NDEBUG
+  const unsigned int numberOfIterations = 200;
+#else
+  const unsigned int numberOfIterations = 2000;
+#endif
+
+  const auto platformThreader = itk::PlatformMultiThreader::New();
+  const auto persistentThreader = itk::PersistentPlatformMultiThreader::New();
+  persistentThreader->SetNumberOfWorkUnits(platformThreader->GetNumberOfWorkUnits());
+  std::cout << "Number of work units: " << platformThreader->GetNumberOfWorkUnits() << "\n" << std::endl;
+
+  for (const unsigned int numberOfSamples : { 2000u, 5000u })
+  {
+    std::cout << "Number of samples: " << numberOfSamples << ", iterations: " << numberOfIterations << std::endl;
+
+    itk::TimeProbesCollectorBase timeCollector;
+    const auto                   platformDerivative =
+      RunIterations(platformThreader, numberOfSamples, numberOfIterations, timeCollector, "PlatformMultiThreader");
+    const auto persistentDerivative = RunIterations(
+      persistentThreader, numberOfSamples, numberOfIterations, timeCollector, "PersistentPlatformMultiThreader");
+    timeCollector.Report();
+    std::cout << std::endl;
+
+    /** Both threaders must compute the same. */
+    for (std::size_t j = 0; j < platformDerivative.size(); ++j)
+    {
+      if (std::abs(platformDerivative[j] - persistentDerivative[j]) > 1e-10)
+      {
+        std::cerr << "ERROR: the derivatives differ at " << j << ": " << platformDerivative[j] << " versus "
+                  << persistentDerivative[j] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main